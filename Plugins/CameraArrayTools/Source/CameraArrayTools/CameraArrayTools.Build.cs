@@ -43,13 +43,32 @@ public class CameraArrayTools : ModuleRules
 				"SlateCore",
 				"Renderer",
 				"ImageWrapper",
+				"ImageCore",
 				"RHI",
-				"RenderCore"
+				"RenderCore",
+				"LevelSequence",
+				"MovieScene",
+				"Json",
+				"CameraArrayToolsExr"
 				//"UnrealEd",
 				// ... add private dependencies that you statically link with here ...	
 			}
 		);
 
+		// PNG与EXR由插件直接编码，以便控制压缩参数；EXR编码在需要异常的CameraArrayToolsExr模块中
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
+		// 路径追踪降噪使用引擎自带的Open Image Denoise，只有Win64提供
+		if (Target.Platform == UnrealTargetPlatform.Win64)
+		{
+			AddEngineThirdPartyPrivateStaticDependencies(Target, "IntelOIDN");
+			PrivateDefinitions.Add("WITH_CAMERA_ARRAY_OIDN=1");
+		}
+		else
+		{
+			PrivateDefinitions.Add("WITH_CAMERA_ARRAY_OIDN=0");
+		}
+
 		if (Target.bBuildEditor)
 		{
 			PrivateDependencyModuleNames.Add("UnrealEd");
@@ -0,0 +1,72 @@
+#include "CameraArrayAccumulation.h"
+#include "CanvasItem.h"
+#include "CanvasTypes.h"
+#include "Engine/Engine.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/World.h"
+#include "TextureResource.h"
+
+namespace
+{
+	float Halton(int32 Index, int32 Base)
+	{
+		float Result = 0.0f;
+		float Fraction = 1.0f / Base;
+		while (Index > 0)
+		{
+			Result += Fraction * (Index % Base);
+			Index /= Base;
+			Fraction /= Base;
+		}
+		return Result;
+	}
+}
+
+FVector2D CameraArrayAccumulation::GetJitter(int32 SampleIndex)
+{
+	// 跳过序号0，否则第一个采样总是落在像素左上角
+	return FVector2D(Halton(SampleIndex + 1, 2) - 0.5f, Halton(SampleIndex + 1, 3) - 0.5f);
+}
+
+double CameraArrayAccumulation::GetShutterOffset(int32 SampleIndex, int32 NumSamples, float ShutterFraction)
+{
+	if (NumSamples <= 1 || ShutterFraction <= 0.0f)
+	{
+		return 0.0;
+	}
+	return ShutterFraction * ((SampleIndex + 0.5) / NumSamples - 0.5);
+}
+
+FMatrix CameraArrayAccumulation::MakeJitteredProjection(float FOVDegrees, int32 Width, int32 Height, const FVector2D& JitterPixels)
+{
+	// 与SceneCaptureRendering中BuildProjectionMatrix相同：水平FOV，纵向按宽高比缩放，远平面无穷远
+	const float HalfFOV = FMath::DegreesToRadians(FMath::Clamp(FOVDegrees, 0.001f, 179.0f)) * 0.5f;
+	const float YAxisMultiplier = static_cast<float>(Width) / FMath::Max(Height, 1);
+	FMatrix Projection = FReversedZPerspectiveMatrix(HalfFOV, HalfFOV, 1.0f, YAxisMultiplier, GNearClippingPlane, GNearClippingPlane);
+	ApplyJitter(Projection, Width, Height, JitterPixels);
+	return Projection;
+}
+
+void CameraArrayAccumulation::ApplyJitter(FMatrix& Projection, int32 Width, int32 Height, const FVector2D& JitterPixels)
+{
+	// 与TAA抖动的写法一致：裁剪空间偏移 = 像素偏移 * 2 / 尺寸，Y轴向下
+	Projection.M[2][0] += JitterPixels.X * 2.0f / FMath::Max(Width, 1);
+	Projection.M[2][1] -= JitterPixels.Y * 2.0f / FMath::Max(Height, 1);
+}
+
+void CameraArrayAccumulation::Composite(UWorld* World, UTextureRenderTarget2D* Source, UTextureRenderTarget2D* Dest, float Weight, bool bOverwrite)
+{
+	FTextureRenderTargetResource* DestResource = Dest->GameThread_GetRenderTargetResource();
+	FTextureResource* SourceResource = Source->GetResource();
+	if (!DestResource || !SourceResource)
+	{
+		return;
+	}
+
+	// 加法混合只写RGB；覆盖写入时alpha随源一起写入，权重不作用于alpha
+	FCanvas Canvas(DestResource, nullptr, World, World->GetFeatureLevel());
+	FCanvasTileItem Tile(FVector2D::ZeroVector, SourceResource, FVector2D(Dest->SizeX, Dest->SizeY), FLinearColor(Weight, Weight, Weight, 1.0f));
+	Tile.BlendMode = bOverwrite ? SE_BLEND_Opaque : SE_BLEND_Additive;
+	Canvas.DrawItem(Tile);
+	Canvas.Flush_GameThread(true);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+class UTextureRenderTarget2D;
+
+// 抖动累积：同一视角以不同的亚像素投影偏移（可选再加上快门内的时间偏移）捕获K次，
+// 在GPU上的浮点缓冲里按1/K加权求和，相当于Movie Render Queue的空间采样，结果只由采样数决定
+namespace CameraArrayAccumulation
+{
+	// 第SampleIndex个采样的亚像素偏移（像素，-0.5~0.5），Halton(2,3)序列，同一采样数下结果总是相同
+	FVector2D GetJitter(int32 SampleIndex);
+
+	// 第SampleIndex个采样在快门内的时间偏移（帧），以当前帧为中心分层均匀分布
+	double GetShutterOffset(int32 SampleIndex, int32 NumSamples, float ShutterFraction);
+
+	// 与场景捕获组件默认一致的反向Z透视投影，加上亚像素偏移
+	FMatrix MakeJitteredProjection(float FOVDegrees, int32 Width, int32 Height, const FVector2D& JitterPixels);
+
+	// 在已有的投影（例如区域捕获的离轴投影）上加亚像素偏移，Width与Height为RenderTarget尺寸
+	void ApplyJitter(FMatrix& Projection, int32 Width, int32 Height, const FVector2D& JitterPixels);
+
+	// 用画布把Source乘以Weight后覆盖写入（bOverwrite）或加到Dest上；两者都应为线性浮点格式，绘制按提交顺序在渲染线程执行
+	void Composite(UWorld* World, UTextureRenderTarget2D* Source, UTextureRenderTarget2D* Dest, float Weight, bool bOverwrite);
+}
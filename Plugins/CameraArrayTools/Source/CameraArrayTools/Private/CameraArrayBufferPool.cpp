@@ -0,0 +1,103 @@
+#include "CameraArrayBufferPool.h"
+#include "Misc/ScopeLock.h"
+
+FCameraArrayBufferPool& FCameraArrayBufferPool::Get()
+{
+	static FCameraArrayBufferPool Pool;
+	return Pool;
+}
+
+// 等级为 2^k 的 4/4、5/4、6/4、7/4 倍，向上取整最多浪费1/4
+int64 FCameraArrayBufferPool::GetSizeClassAtLeast(int64 NumBytes)
+{
+	const int64 Clamped = FMath::Max(NumBytes, MinPooledBytes);
+	const int64 Step = (int64(1) << FMath::FloorLog2_64(static_cast<uint64>(Clamped))) / 4;
+	return (Clamped + Step - 1) / Step * Step;
+}
+
+int64 FCameraArrayBufferPool::GetSizeClassAtMost(int64 NumBytes)
+{
+	const int64 Step = (int64(1) << FMath::FloorLog2_64(static_cast<uint64>(NumBytes))) / 4;
+	return NumBytes / Step * Step;
+}
+
+void FCameraArrayBufferPool::Acquire(int64 NumBytes, TArray64<uint8>& Out)
+{
+	const int64 SizeClass = GetSizeClassAtLeast(NumBytes);
+	{
+		FScopeLock Lock(&Mutex);
+		++NumAcquires;
+		TArray<TArray64<uint8>>* Bucket = FreeBuffers.Find(SizeClass);
+		if (Bucket && Bucket->Num() > 0)
+		{
+			Out = Bucket->Pop(false);
+			PooledBytes -= Out.Max();
+			BytesRecycled += NumBytes;
+			++NumHits;
+			Out.SetNumUninitialized(NumBytes, false);
+			return;
+		}
+		BytesAllocated += SizeClass;
+	}
+
+	// 在锁外分配；按等级的大小预留，归还后可服务同一等级的任何申请
+	Out.Empty(SizeClass);
+	Out.SetNumUninitialized(NumBytes, false);
+}
+
+void FCameraArrayBufferPool::Recycle(TArray64<uint8>&& Buffer)
+{
+	TArray64<uint8> Local = MoveTemp(Buffer);
+	const int64 Capacity = Local.Max();
+	if (Capacity < MinPooledBytes)
+	{
+		return;
+	}
+
+	FScopeLock Lock(&Mutex);
+	if (PooledBytes + Capacity > MaxPooledBytes)
+	{
+		return; // 超出上限，离开作用域时释放
+	}
+	Local.Reset();
+	PooledBytes += Capacity;
+	PeakPooledBytes = FMath::Max(PeakPooledBytes, PooledBytes);
+	FreeBuffers.FindOrAdd(GetSizeClassAtMost(Capacity)).Add(MoveTemp(Local));
+}
+
+void FCameraArrayBufferPool::SetMaxPooledBytes(int64 Bytes)
+{
+	FScopeLock Lock(&Mutex);
+	MaxPooledBytes = FMath::Max<int64>(Bytes, 0);
+}
+
+void FCameraArrayBufferPool::Trim()
+{
+	// 在锁外释放
+	TMap<int64, TArray<TArray64<uint8>>> Released;
+	{
+		FScopeLock Lock(&Mutex);
+		Released = MoveTemp(FreeBuffers);
+		FreeBuffers.Reset();
+		PooledBytes = 0;
+	}
+}
+
+void FCameraArrayBufferPool::ResetStats()
+{
+	FScopeLock Lock(&Mutex);
+	NumAcquires = 0;
+	NumHits = 0;
+	BytesRecycled = 0;
+	BytesAllocated = 0;
+	PeakPooledBytes = PooledBytes;
+}
+
+FString FCameraArrayBufferPool::Describe() const
+{
+	FScopeLock Lock(&Mutex);
+	const double ToMB = 1.0 / (1024.0 * 1024.0);
+	return FString::Printf(TEXT("缓冲池：申请 %lld 次，命中 %lld 次 (%.1f%%)，复用 %.0f MB，新分配 %.0f MB，空闲峰值 %.0f MB"),
+		NumAcquires, NumHits, NumAcquires > 0 ? 100.0 * NumHits / NumAcquires : 0.0,
+		BytesRecycled * ToMB, BytesAllocated * ToMB, PeakPooledBytes * ToMB);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 按大小分级的字节缓冲池：同一批量中每帧的回读、像素处理与编码输出大小几乎不变，
+// 用完的缓冲按容量归入1/4倍程的等级，下一帧申请同一等级时直接复用，稳定后每帧不再向系统申请内存
+class FCameraArrayBufferPool
+{
+public:
+	static FCameraArrayBufferPool& Get();
+
+	// Out的元素数设为NumBytes，内容未初始化
+	void Acquire(int64 NumBytes, TArray64<uint8>& Out);
+	void Recycle(TArray64<uint8>&& Buffer);
+
+	// 空闲缓冲的总量上限，超出时归还的缓冲直接释放
+	void SetMaxPooledBytes(int64 Bytes);
+
+	// 释放所有空闲缓冲，批量结束时调用
+	void Trim();
+
+	void ResetStats();
+	FString Describe() const;
+
+private:
+	// 小于此大小的缓冲交给引擎的分箱分配器
+	static constexpr int64 MinPooledBytes = 64 * 1024;
+
+	static int64 GetSizeClassAtLeast(int64 NumBytes);
+	static int64 GetSizeClassAtMost(int64 NumBytes);
+
+	mutable FCriticalSection Mutex;
+	TMap<int64, TArray<TArray64<uint8>>> FreeBuffers;
+	int64 PooledBytes = 0;
+	int64 MaxPooledBytes = 2048ll * 1024 * 1024;
+
+	int64 NumAcquires = 0;
+	int64 NumHits = 0;
+	int64 BytesRecycled = 0;
+	int64 BytesAllocated = 0;
+	int64 PeakPooledBytes = 0;
+};
+
+// 从池中取出的缓冲，析构时自动归还；可在容量内调整元素数
+class FCameraArrayPooledBuffer
+{
+public:
+	FCameraArrayPooledBuffer() = default;
+	explicit FCameraArrayPooledBuffer(int64 NumBytes)
+	{
+		FCameraArrayBufferPool::Get().Acquire(NumBytes, Bytes);
+	}
+	~FCameraArrayPooledBuffer()
+	{
+		Reset();
+	}
+
+	FCameraArrayPooledBuffer(FCameraArrayPooledBuffer&& Other)
+		: Bytes(MoveTemp(Other.Bytes))
+	{
+	}
+	FCameraArrayPooledBuffer& operator=(FCameraArrayPooledBuffer&& Other)
+	{
+		if (this != &Other)
+		{
+			Reset();
+			Bytes = MoveTemp(Other.Bytes);
+		}
+		return *this;
+	}
+	FCameraArrayPooledBuffer(const FCameraArrayPooledBuffer&) = delete;
+	FCameraArrayPooledBuffer& operator=(const FCameraArrayPooledBuffer&) = delete;
+
+	void Reset()
+	{
+		if (Bytes.Max() > 0)
+		{
+			FCameraArrayBufferPool::Get().Recycle(MoveTemp(Bytes));
+		}
+	}
+
+	TArray64<uint8>& GetArray() { return Bytes; }
+	const TArray64<uint8>& GetArray() const { return Bytes; }
+
+	uint8* GetData() { return Bytes.GetData(); }
+	const uint8* GetData() const { return Bytes.GetData(); }
+	int64 Num() const { return Bytes.Num(); }
+
+	template <typename ElementType>
+	ElementType* GetData() { return reinterpret_cast<ElementType*>(Bytes.GetData()); }
+	template <typename ElementType>
+	const ElementType* GetData() const { return reinterpret_cast<const ElementType*>(Bytes.GetData()); }
+	template <typename ElementType>
+	int64 Num() const { return Bytes.Num() / static_cast<int64>(sizeof(ElementType)); }
+
+private:
+	TArray64<uint8> Bytes;
+};
@@ -0,0 +1,100 @@
+#include "CameraArrayCalibration.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace CameraArrayCalibration
+{
+	static bool ParseIntrinsics(const FJsonObject& Object, FCameraArrayIntrinsics& Out)
+	{
+		Object.TryGetNumberField(TEXT("width"), Out.ImageWidth);
+		Object.TryGetNumberField(TEXT("height"), Out.ImageHeight);
+
+		const TArray<TSharedPtr<FJsonValue>>* Matrix = nullptr;
+		if (Object.TryGetArrayField(TEXT("K"), Matrix) && Matrix->Num() == 9)
+		{
+			Out.Fx = (*Matrix)[0]->AsNumber();
+			Out.Cx = (*Matrix)[2]->AsNumber();
+			Out.Fy = (*Matrix)[4]->AsNumber();
+			Out.Cy = (*Matrix)[5]->AsNumber();
+		}
+		else
+		{
+			Object.TryGetNumberField(TEXT("fx"), Out.Fx);
+			Object.TryGetNumberField(TEXT("fy"), Out.Fy);
+			Object.TryGetNumberField(TEXT("cx"), Out.Cx);
+			Object.TryGetNumberField(TEXT("cy"), Out.Cy);
+		}
+
+		// OpenCV的畸变系数顺序为 k1, k2, p1, p2, k3
+		const TArray<TSharedPtr<FJsonValue>>* Dist = nullptr;
+		if (Object.TryGetArrayField(TEXT("dist"), Dist))
+		{
+			double* const Targets[] = { &Out.K1, &Out.K2, &Out.P1, &Out.P2, &Out.K3 };
+			for (int32 i = 0; i < Dist->Num() && i < UE_ARRAY_COUNT(Targets); ++i)
+			{
+				*Targets[i] = (*Dist)[i]->AsNumber();
+			}
+		}
+		else
+		{
+			Object.TryGetNumberField(TEXT("k1"), Out.K1);
+			Object.TryGetNumberField(TEXT("k2"), Out.K2);
+			Object.TryGetNumberField(TEXT("k3"), Out.K3);
+			Object.TryGetNumberField(TEXT("p1"), Out.P1);
+			Object.TryGetNumberField(TEXT("p2"), Out.P2);
+		}
+
+		// 未给出主点时取图像中心
+		if (Out.Cx == 0.0 && Out.Cy == 0.0 && Out.ImageWidth > 0 && Out.ImageHeight > 0)
+		{
+			Out.Cx = Out.ImageWidth * 0.5 - 0.5;
+			Out.Cy = Out.ImageHeight * 0.5 - 0.5;
+		}
+		return Out.IsValid();
+	}
+
+	bool LoadIntrinsicsFromJson(const FString& FilePath, TArray<FCameraArrayIntrinsics>& OutIntrinsics, FString& OutError)
+	{
+		FString Text;
+		if (!FFileHelper::LoadFileToString(Text, *FilePath))
+		{
+			OutError = FString::Printf(TEXT("无法读取文件 %s"), *FilePath);
+			return false;
+		}
+
+		TSharedPtr<FJsonValue> Root;
+		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+		if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+		{
+			OutError = FString::Printf(TEXT("JSON解析失败: %s"), *Reader->GetErrorMessage());
+			return false;
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* Cameras = nullptr;
+		if (Root->Type == EJson::Array)
+		{
+			Cameras = &Root->AsArray();
+		}
+		else if (Root->Type != EJson::Object || !Root->AsObject()->TryGetArrayField(TEXT("cameras"), Cameras))
+		{
+			OutError = TEXT("缺少 cameras 数组");
+			return false;
+		}
+
+		OutIntrinsics.Reset(Cameras->Num());
+		for (int32 i = 0; i < Cameras->Num(); ++i)
+		{
+			const TSharedPtr<FJsonObject>* CameraObject = nullptr;
+			FCameraArrayIntrinsics Intrinsics;
+			if (!(*Cameras)[i]->TryGetObject(CameraObject) || !ParseIntrinsics(**CameraObject, Intrinsics))
+			{
+				OutError = FString::Printf(TEXT("第 %d 个相机缺少有效的焦距"), i);
+				return false;
+			}
+			OutIntrinsics.Add(Intrinsics);
+		}
+		return true;
+	}
+}
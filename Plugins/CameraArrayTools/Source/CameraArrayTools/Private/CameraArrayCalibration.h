@@ -0,0 +1,13 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraArrayIntrinsics.h"
+
+// 标定文件读取
+namespace CameraArrayCalibration
+{
+	// JSON内参：顶层为数组或 {"cameras": [...]}，每项可以写成
+	//   {"width", "height", "fx", "fy", "cx", "cy", "k1", "k2", "k3", "p1", "p2"}
+	// 或OpenCV风格 {"width", "height", "K": [3x3按行], "dist": [k1, k2, p1, p2, k3]}
+	bool LoadIntrinsicsFromJson(const FString& FilePath, TArray<FCameraArrayIntrinsics>& OutIntrinsics, FString& OutError);
+}
@@ -0,0 +1,149 @@
+#include "CameraArrayContactSheet.h"
+#include "IImageWrapperModule.h"
+#include "IImageWrapper.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "HAL/PlatformFileManager.h"
+
+FCameraArrayContactSheet::FCameraArrayContactSheet(int32 InNumTiles, int32 InTileWidth, int32 InTileHeight,
+	FIntPoint InSourceSize, ECameraArrayContactSheetFilter InFilter)
+	: NumTiles(FMath::Max(InNumTiles, 1))
+	, TileWidth(FMath::Max(InTileWidth, 1))
+	, TileHeight(FMath::Max(InTileHeight, 1))
+	, Filter(InFilter)
+{
+	// 让整张图接近正方形：Columns * TileWidth ≈ Rows * TileHeight
+	Columns = FMath::Clamp(FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumTiles) * TileHeight / TileWidth)), 1, NumTiles);
+	Rows = FMath::DivideAndRoundUp(NumTiles, Columns);
+
+	if (Filter == ECameraArrayContactSheetFilter::Lanczos)
+	{
+		LanczosKernel.Build(InSourceSize.X, InSourceSize.Y, TileWidth, TileHeight);
+	}
+
+	Canvas.SetNumZeroed(GetWidth() * GetHeight());
+	for (FColor& Pixel : Canvas)
+	{
+		Pixel.A = 255;
+	}
+}
+
+FIntPoint FCameraArrayContactSheet::GetFitSize(int32 Width, int32 Height) const
+{
+	// 与格子宽高比相同的帧正好铺满，不产生取整误差
+	if (static_cast<int64>(Width) * TileHeight == static_cast<int64>(Height) * TileWidth)
+	{
+		return FIntPoint(TileWidth, TileHeight);
+	}
+	if (static_cast<int64>(Width) * TileHeight > static_cast<int64>(Height) * TileWidth)
+	{
+		const int32 FitHeight = FMath::RoundToInt32(static_cast<double>(TileWidth) * Height / Width);
+		return FIntPoint(TileWidth, FMath::Clamp(FitHeight, 1, TileHeight));
+	}
+	const int32 FitWidth = FMath::RoundToInt32(static_cast<double>(TileHeight) * Width / Height);
+	return FIntPoint(FMath::Clamp(FitWidth, 1, TileWidth), TileHeight);
+}
+
+template <typename PixelType>
+void FCameraArrayContactSheet::Resample(const PixelType* Src, int32 Width, int32 Height, PixelType* Dst, const FIntPoint& DstSize) const
+{
+	if (Filter == ECameraArrayContactSheetFilter::Lanczos)
+	{
+		if (LanczosKernel.Matches(Width, Height, DstSize.X, DstSize.Y))
+		{
+			CameraArrayImageResample::LanczosResample(LanczosKernel, Src, Dst);
+		}
+		else
+		{
+			// 尺寸与预期不符（区域捕获的裁剪图，或视口截图的文件被手动替换），临时构建一次权重表
+			CameraArrayImageResample::FLanczosKernel LocalKernel;
+			LocalKernel.Build(Width, Height, DstSize.X, DstSize.Y);
+			CameraArrayImageResample::LanczosResample(LocalKernel, Src, Dst);
+		}
+		return;
+	}
+	CameraArrayImageResample::BoxDownsample(Src, Width, Height, Dst, DstSize.X, DstSize.Y);
+}
+
+void FCameraArrayContactSheet::AddFrame(int32 TileIndex, const FColor* Pixels, int32 Width, int32 Height)
+{
+	if (TileIndex < 0 || TileIndex >= NumTiles || !Pixels || Width <= 0 || Height <= 0)
+	{
+		return;
+	}
+
+	const FIntPoint FitSize = GetFitSize(Width, Height);
+	TArray<FColor> Tile;
+	Tile.SetNumUninitialized(FitSize.X * FitSize.Y);
+	Resample(Pixels, Width, Height, Tile.GetData(), FitSize);
+	CopyTile(TileIndex, Tile.GetData(), FitSize);
+}
+
+void FCameraArrayContactSheet::AddFrame(int32 TileIndex, const FLinearColor* Pixels, int32 Width, int32 Height)
+{
+	if (TileIndex < 0 || TileIndex >= NumTiles || !Pixels || Width <= 0 || Height <= 0)
+	{
+		return;
+	}
+
+	const FIntPoint FitSize = GetFitSize(Width, Height);
+	TArray<FLinearColor> LinearTile;
+	LinearTile.SetNumUninitialized(FitSize.X * FitSize.Y);
+	Resample(Pixels, Width, Height, LinearTile.GetData(), FitSize);
+
+	TArray<FColor> Tile;
+	Tile.SetNumUninitialized(LinearTile.Num());
+	for (int32 i = 0; i < LinearTile.Num(); ++i)
+	{
+		Tile[i] = LinearTile[i].ToFColorSRGB();
+	}
+	CopyTile(TileIndex, Tile.GetData(), FitSize);
+}
+
+// Size小于格子时居中放置，四周填黑
+void FCameraArrayContactSheet::CopyTile(int32 TileIndex, const FColor* Tile, const FIntPoint& Size)
+{
+	const int32 TileX = (TileIndex % Columns) * TileWidth;
+	const int32 TileY = (TileIndex / Columns) * TileHeight;
+	const int32 OffsetX = TileX + (TileWidth - Size.X) / 2;
+	const int32 OffsetY = TileY + (TileHeight - Size.Y) / 2;
+	const int32 CanvasWidth = GetWidth();
+	if (Size.X != TileWidth || Size.Y != TileHeight)
+	{
+		for (int32 Y = 0; Y < TileHeight; ++Y)
+		{
+			FColor* CanvasRow = &Canvas[(TileY + Y) * CanvasWidth + TileX];
+			for (int32 X = 0; X < TileWidth; ++X)
+			{
+				CanvasRow[X] = FColor::Black;
+			}
+		}
+	}
+	for (int32 Y = 0; Y < Size.Y; ++Y)
+	{
+		FColor* CanvasRow = &Canvas[(OffsetY + Y) * CanvasWidth + OffsetX];
+		FMemory::Memcpy(CanvasRow, Tile + Y * Size.X, Size.X * sizeof(FColor));
+		for (int32 X = 0; X < Size.X; ++X)
+		{
+			CanvasRow[X].A = 255;
+		}
+	}
+}
+
+bool FCameraArrayContactSheet::SaveToFile(const FString& FilePath) const
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	const EImageFormat ImageFormat = ImageWrapperModule.GetImageFormatFromExtension(*FPaths::GetExtension(FilePath));
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(
+		ImageFormat == EImageFormat::Invalid ? EImageFormat::JPEG : ImageFormat);
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(Canvas.GetData(), Canvas.Num() * sizeof(FColor), GetWidth(), GetHeight(), ERGBFormat::BGRA, 8))
+	{
+		UE_LOG(LogTemp, Error, TEXT("为 %s 编码联系表失败。"), *FilePath);
+		return false;
+	}
+	return FFileHelper::SaveArrayToFile(ImageWrapper->GetCompressed(), *FilePath);
+}
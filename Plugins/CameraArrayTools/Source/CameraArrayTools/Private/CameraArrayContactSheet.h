@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraArrayManager.h"
+#include "CameraArrayImageResample.h"
+
+// 联系表：把所有视角缩小后按网格拼成一张总览图
+// 每帧在写出它的后台线程上缩小并写入自己的格子，格子互不重叠，因此无需加锁，最后一帧写完时总览图即已完成
+class FCameraArrayContactSheet
+{
+public:
+	FCameraArrayContactSheet(int32 InNumTiles, int32 InTileWidth, int32 InTileHeight,
+		FIntPoint InSourceSize, ECameraArrayContactSheetFilter InFilter);
+
+	// 宽高比与格子不同的帧（例如区域捕获的裁剪图）保持比例缩放，居中放入格子，其余部分为黑色
+	void AddFrame(int32 TileIndex, const FColor* Pixels, int32 Width, int32 Height);
+
+	// HDR帧在线性空间缩小后再转换为sRGB
+	void AddFrame(int32 TileIndex, const FLinearColor* Pixels, int32 Width, int32 Height);
+
+	bool SaveToFile(const FString& FilePath) const;
+
+	int32 GetWidth() const { return Columns * TileWidth; }
+	int32 GetHeight() const { return Rows * TileHeight; }
+
+private:
+	// 源图保持宽高比放进格子后的尺寸
+	FIntPoint GetFitSize(int32 Width, int32 Height) const;
+
+	template <typename PixelType>
+	void Resample(const PixelType* Src, int32 Width, int32 Height, PixelType* Dst, const FIntPoint& DstSize) const;
+
+	void CopyTile(int32 TileIndex, const FColor* Tile, const FIntPoint& Size);
+
+	int32 NumTiles = 0;
+	int32 Columns = 1;
+	int32 Rows = 1;
+	int32 TileWidth = 1;
+	int32 TileHeight = 1;
+	ECameraArrayContactSheetFilter Filter = ECameraArrayContactSheetFilter::Box;
+
+	// 所有帧尺寸相同，Lanczos权重表只在构造时计算一次
+	CameraArrayImageResample::FLanczosKernel LanczosKernel;
+
+	TArray<FColor> Canvas;
+};
@@ -0,0 +1,310 @@
+#include "CameraArrayCoverage.h"
+#include "CameraArraySpatialIndex.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "CollisionQueryParams.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "StaticMeshResources.h"
+
+namespace
+{
+	// 射线终点沿法线离开表面的距离（厘米），避免射线打到采样点所在的三角形本身
+	constexpr double SurfaceOffset = 1.0;
+
+	// 每个任务处理的采样点数，同一批的点在一个工作线程上依次追踪
+	constexpr int32 SamplesPerBatch = 64;
+
+	struct FMeshSource
+	{
+		const FStaticMeshLODResources* LOD = nullptr;
+		FTransform Transform;
+		FMatrix NormalMatrix;
+	};
+}
+
+bool CameraArrayCoverage::SampleSurface(const AActor* Actor, int32 NumSamples, TArray<FSurfaceSample>& OutSamples, TArray<FSurface>& OutSurfaces)
+{
+	OutSamples.Reset();
+	OutSurfaces.Reset();
+	if (!IsValid(Actor) || NumSamples <= 0)
+	{
+		return false;
+	}
+
+	// 所有三角形的面积前缀和，按面积取三角形
+	TArray<FMeshSource> Sources;
+	TArray<TPair<int32, int32>> Triangles; // 表面索引，三角形首个索引的位置
+	TArray<double> CumulativeArea;
+	double TotalArea = 0.0;
+
+	TInlineComponentArray<UStaticMeshComponent*> Components(Actor);
+	for (const UStaticMeshComponent* Component : Components)
+	{
+		const UStaticMesh* Mesh = Component->GetStaticMesh();
+		const FStaticMeshRenderData* RenderData = Mesh ? Mesh->GetRenderData() : nullptr;
+		if (!RenderData || RenderData->LODResources.IsEmpty())
+		{
+			continue;
+		}
+		const FStaticMeshLODResources& LOD = RenderData->LODResources[0];
+		const FIndexArrayView Indices = LOD.IndexBuffer.GetArrayView();
+		if (Indices.Num() < 3 || !LOD.VertexBuffers.PositionVertexBuffer.GetVertexData() || !LOD.VertexBuffers.StaticMeshVertexBuffer.GetTangentData())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("覆盖分析：无法读取 %s 的网格数据，跳过。"), *Component->GetName());
+			continue;
+		}
+
+		const int32 SurfaceIndex = Sources.Num();
+		FMeshSource& Source = Sources.AddDefaulted_GetRef();
+		Source.LOD = &LOD;
+		Source.Transform = Component->GetComponentTransform();
+		Source.NormalMatrix = Source.Transform.ToMatrixWithScale().Inverse().GetTransposed();
+
+		FSurface& Surface = OutSurfaces.AddDefaulted_GetRef();
+		Surface.Name = Component->GetName();
+		for (int32 First = 0; First + 2 < Indices.Num(); First += 3)
+		{
+			const FVector A = Source.Transform.TransformPosition(FVector(LOD.VertexBuffers.PositionVertexBuffer.VertexPosition(Indices[First])));
+			const FVector B = Source.Transform.TransformPosition(FVector(LOD.VertexBuffers.PositionVertexBuffer.VertexPosition(Indices[First + 1])));
+			const FVector C = Source.Transform.TransformPosition(FVector(LOD.VertexBuffers.PositionVertexBuffer.VertexPosition(Indices[First + 2])));
+			const double Area = 0.5 * FVector::CrossProduct(B - A, C - A).Size();
+			if (Area <= 0.0)
+			{
+				continue;
+			}
+			TotalArea += Area;
+			Surface.Area += Area;
+			Triangles.Emplace(SurfaceIndex, First);
+			CumulativeArea.Add(TotalArea);
+		}
+	}
+	if (Triangles.IsEmpty())
+	{
+		return false;
+	}
+
+	FRandomStream Stream(0x43415256);
+	OutSamples.Reserve(NumSamples);
+	for (int32 i = 0; i < NumSamples; ++i)
+	{
+		const int32 Triangle = FMath::Min(Algo::UpperBound(CumulativeArea, Stream.FRand() * TotalArea), Triangles.Num() - 1);
+		const FMeshSource& Source = Sources[Triangles[Triangle].Key];
+		const FStaticMeshVertexBuffers& Buffers = Source.LOD->VertexBuffers;
+		const FIndexArrayView Indices = Source.LOD->IndexBuffer.GetArrayView();
+		const int32 First = Triangles[Triangle].Value;
+		const uint32 V0 = Indices[First];
+		const uint32 V1 = Indices[First + 1];
+		const uint32 V2 = Indices[First + 2];
+
+		// 三角形内的均匀重心坐标
+		const float R1 = FMath::Sqrt(Stream.FRand());
+		const float R2 = Stream.FRand();
+		const float W0 = 1.0f - R1;
+		const float W1 = R1 * (1.0f - R2);
+		const float W2 = R1 * R2;
+
+		const FVector3f LocalPosition = Buffers.PositionVertexBuffer.VertexPosition(V0) * W0 +
+			Buffers.PositionVertexBuffer.VertexPosition(V1) * W1 + Buffers.PositionVertexBuffer.VertexPosition(V2) * W2;
+		const FVector3f LocalNormal = FVector3f(Buffers.StaticMeshVertexBuffer.VertexTangentZ(V0)) * W0 +
+			FVector3f(Buffers.StaticMeshVertexBuffer.VertexTangentZ(V1)) * W1 + FVector3f(Buffers.StaticMeshVertexBuffer.VertexTangentZ(V2)) * W2;
+
+		FSurfaceSample& Sample = OutSamples.AddDefaulted_GetRef();
+		Sample.Location = Source.Transform.TransformPosition(FVector(LocalPosition));
+		Sample.Normal = Source.NormalMatrix.TransformVector(FVector(LocalNormal)).GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+		Sample.SurfaceIndex = Triangles[Triangle].Key;
+	}
+	return true;
+}
+
+int64 CameraArrayCoverage::ComputeVisibility(const UWorld* World, const FCameraArraySpatialIndex& Index, const TArray<FVector>& CameraLocations,
+	const TArray<FSurfaceSample>& Samples, float MaxViewAngleDegrees, TArray<TArray<int32>>& OutVisibleCameras)
+{
+	OutVisibleCameras.Reset();
+	OutVisibleCameras.SetNum(Samples.Num());
+	if (!World)
+	{
+		return 0;
+	}
+
+	const double CosMaxAngle = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(MaxViewAngleDegrees, 0.0f, 90.0f)));
+	FCollisionQueryParams Params(FName(TEXT("CameraArrayCoverage")), true);
+	FThreadSafeCounter64 NumTraces;
+
+	// 场景查询可以在多个线程上同时进行，游戏线程在ParallelFor中等待，期间场景不会改变
+	ParallelFor(FMath::DivideAndRoundUp(Samples.Num(), SamplesPerBatch), [&](int32 Batch)
+	{
+		TArray<int32> Candidates;
+		int64 BatchTraces = 0;
+		const int32 End = FMath::Min((Batch + 1) * SamplesPerBatch, Samples.Num());
+		for (int32 i = Batch * SamplesPerBatch; i < End; ++i)
+		{
+			const FSurfaceSample& Sample = Samples[i];
+			const FVector TraceEnd = Sample.Location + Sample.Normal * SurfaceOffset;
+			TArray<int32>& Visible = OutVisibleCameras[i];
+
+			// 候选相机按索引升序，可见列表也保持升序
+			Index.FindContainingPoint(Sample.Location, Candidates);
+			for (const int32 CameraIndex : Candidates)
+			{
+				const FVector ToCamera = CameraLocations[CameraIndex] - Sample.Location;
+				const double Distance = ToCamera.Size();
+				if (Distance <= SurfaceOffset || FVector::DotProduct(Sample.Normal, ToCamera) < CosMaxAngle * Distance)
+				{
+					continue;
+				}
+				++BatchTraces;
+				if (!World->LineTraceTestByChannel(CameraLocations[CameraIndex], TraceEnd, ECC_Visibility, Params))
+				{
+					Visible.Add(CameraIndex);
+				}
+			}
+		}
+		NumTraces.Add(BatchTraces);
+	});
+	return NumTraces.GetValue();
+}
+
+double CameraArrayCoverage::FReport::GetFractionSeenBy(int32 NumViews) const
+{
+	if (NumSamples == 0 || ViewHistogram.IsEmpty())
+	{
+		return 0.0;
+	}
+	int32 Count = 0;
+	for (int32 k = FMath::Clamp(NumViews, 0, ViewHistogram.Num() - 1); k < ViewHistogram.Num(); ++k)
+	{
+		Count += ViewHistogram[k];
+	}
+	return static_cast<double>(Count) / NumSamples;
+}
+
+FString CameraArrayCoverage::FReport::Describe(const TArray<FSurface>& SurfaceInfo) const
+{
+	FString Text = FString::Printf(TEXT("覆盖分析：%d 个采样点，表面积 %.2f 平方米，平均每点被 %.1f 个相机看到；至少 1 个相机 %.1f%%，至少 %d 个相机 %.1f%%"),
+		NumSamples, TotalArea / 10000.0, MeanViews, GetFractionSeenBy(1) * 100.0, MinViews, GetFractionSeenBy(MinViews) * 100.0);
+
+	Text += TEXT("\n  可见相机数分布：");
+	for (int32 k = 0; k < ViewHistogram.Num(); ++k)
+	{
+		Text += FString::Printf(TEXT("%s%d: %.1f%%  "), k == ViewHistogram.Num() - 1 ? TEXT("≥") : TEXT(""), k,
+			NumSamples > 0 ? 100.0 * ViewHistogram[k] / NumSamples : 0.0);
+	}
+
+	for (int32 i = 0; i < Surfaces.Num() && i < SurfaceInfo.Num(); ++i)
+	{
+		const FSurfaceReport& Surface = Surfaces[i];
+		const double Scale = Surface.NumSamples > 0 ? 100.0 / Surface.NumSamples : 0.0;
+		Text += FString::Printf(TEXT("\n  %s：%.2f 平方米，%d 个点，覆盖 %.1f%%，至少 %d 个相机 %.1f%%"),
+			*SurfaceInfo[i].Name, SurfaceInfo[i].Area / 10000.0, Surface.NumSamples, Surface.NumCovered * Scale, MinViews, Surface.NumWellCovered * Scale);
+	}
+
+	int32 NumBlind = 0;
+	int32 NumWithNeighbor = 0;
+	double OverlapSum = 0.0;
+	for (const FCameraReport& Camera : Cameras)
+	{
+		if (Camera.VisibleSamples == 0)
+		{
+			++NumBlind;
+			continue;
+		}
+		if (Camera.Neighbor != INDEX_NONE)
+		{
+			++NumWithNeighbor;
+			OverlapSum += static_cast<double>(Camera.SharedWithNeighbor) / Camera.VisibleSamples;
+		}
+	}
+	Text += FString::Printf(TEXT("\n  %d/%d 个相机看不到目标；能看到目标的相机与最近邻居的平均重叠 %.1f%%"),
+		NumBlind, Cameras.Num(), NumWithNeighbor > 0 ? OverlapSum / NumWithNeighbor * 100.0 : 0.0);
+	return Text;
+}
+
+void CameraArrayCoverage::BuildReport(const TArray<FSurfaceSample>& Samples, const TArray<FSurface>& Surfaces, const TArray<TArray<int32>>& VisibleCameras,
+	const TArray<FVector>& CameraLocations, const TArray<int32>& Neighbors, int32 MinViews, FReport& OutReport)
+{
+	OutReport = FReport();
+	OutReport.MinViews = FMath::Max(MinViews, 1);
+	OutReport.NumSamples = Samples.Num();
+	OutReport.ViewHistogram.SetNumZeroed(2 * OutReport.MinViews + 1);
+	OutReport.Surfaces.SetNum(Surfaces.Num());
+	for (const FSurface& Surface : Surfaces)
+	{
+		OutReport.TotalArea += Surface.Area;
+	}
+
+	OutReport.Cameras.SetNum(CameraLocations.Num());
+	for (int32 CameraIndex = 0; CameraIndex < CameraLocations.Num(); ++CameraIndex)
+	{
+		FCameraReport& Camera = OutReport.Cameras[CameraIndex];
+		Camera.Neighbor = Neighbors.IsValidIndex(CameraIndex) ? Neighbors[CameraIndex] : INDEX_NONE;
+		if (Camera.Neighbor != INDEX_NONE)
+		{
+			Camera.Baseline = FVector::Dist(CameraLocations[CameraIndex], CameraLocations[Camera.Neighbor]);
+		}
+	}
+
+	int64 TotalViews = 0;
+	for (int32 i = 0; i < Samples.Num(); ++i)
+	{
+		const TArray<int32>& Visible = VisibleCameras[i];
+		const int32 NumViews = Visible.Num();
+		++OutReport.ViewHistogram[FMath::Min(NumViews, OutReport.ViewHistogram.Num() - 1)];
+		TotalViews += NumViews;
+
+		if (OutReport.Surfaces.IsValidIndex(Samples[i].SurfaceIndex))
+		{
+			FSurfaceReport& Surface = OutReport.Surfaces[Samples[i].SurfaceIndex];
+			++Surface.NumSamples;
+			Surface.NumCovered += NumViews > 0 ? 1 : 0;
+			Surface.NumWellCovered += NumViews >= OutReport.MinViews ? 1 : 0;
+		}
+
+		for (const int32 CameraIndex : Visible)
+		{
+			FCameraReport& Camera = OutReport.Cameras[CameraIndex];
+			++Camera.VisibleSamples;
+			Camera.UniqueSamples += NumViews == 1 ? 1 : 0;
+			if (Camera.Neighbor != INDEX_NONE && Algo::BinarySearch(Visible, Camera.Neighbor) != INDEX_NONE)
+			{
+				++Camera.SharedWithNeighbor;
+			}
+		}
+	}
+	OutReport.MeanViews = Samples.Num() > 0 ? static_cast<double>(TotalViews) / Samples.Num() : 0.0;
+}
+
+bool CameraArrayCoverage::SaveCameraCsv(const FReport& Report, const TArray<FString>& CameraNames, const FString& Path)
+{
+	FString Csv = TEXT("Camera,VisibleSamples,VisiblePercent,UniqueSamples,Neighbor,BaselineCm,NeighborOverlapPercent\n");
+	for (int32 i = 0; i < Report.Cameras.Num(); ++i)
+	{
+		const FCameraReport& Camera = Report.Cameras[i];
+		Csv += FString::Printf(TEXT("%s,%d,%.2f,%d,%s,%.2f,%.2f\n"),
+			CameraNames.IsValidIndex(i) ? *CameraNames[i] : TEXT(""),
+			Camera.VisibleSamples,
+			Report.NumSamples > 0 ? 100.0 * Camera.VisibleSamples / Report.NumSamples : 0.0,
+			Camera.UniqueSamples,
+			CameraNames.IsValidIndex(Camera.Neighbor) ? *CameraNames[Camera.Neighbor] : TEXT(""),
+			Camera.Baseline,
+			Camera.VisibleSamples > 0 ? 100.0 * Camera.SharedWithNeighbor / Camera.VisibleSamples : 0.0);
+	}
+	return FFileHelper::SaveStringToFile(Csv, *Path);
+}
+
+bool CameraArrayCoverage::SaveSampleCsv(const TArray<FSurfaceSample>& Samples, const TArray<FSurface>& Surfaces, const TArray<TArray<int32>>& VisibleCameras, const FString& Path)
+{
+	FString Csv = TEXT("X,Y,Z,NX,NY,NZ,Surface,Views\n");
+	for (int32 i = 0; i < Samples.Num(); ++i)
+	{
+		const FSurfaceSample& Sample = Samples[i];
+		Csv += FString::Printf(TEXT("%.3f,%.3f,%.3f,%.4f,%.4f,%.4f,%s,%d\n"),
+			Sample.Location.X, Sample.Location.Y, Sample.Location.Z, Sample.Normal.X, Sample.Normal.Y, Sample.Normal.Z,
+			Surfaces.IsValidIndex(Sample.SurfaceIndex) ? *Surfaces[Sample.SurfaceIndex].Name : TEXT(""), VisibleCameras[i].Num());
+	}
+	return FFileHelper::SaveStringToFile(Csv, *Path);
+}
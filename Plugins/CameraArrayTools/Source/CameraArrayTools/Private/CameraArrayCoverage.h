@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UWorld;
+class FCameraArraySpatialIndex;
+
+// 覆盖分析：在目标表面按面积均匀取点，统计每个点能被哪些相机看到（在视锥内、朝向相机且视线不被遮挡）
+// 候选相机来自空间索引的视锥查询，遮挡用逐点的射线检测，采样点分批在任务图的工作线程上并行处理
+namespace CameraArrayCoverage
+{
+	// 目标上每个静态网格组件算一个表面
+	struct FSurface
+	{
+		FString Name;
+		double Area = 0.0;
+	};
+
+	struct FSurfaceSample
+	{
+		FVector Location = FVector::ZeroVector;
+		FVector Normal = FVector::UpVector;
+		int32 SurfaceIndex = INDEX_NONE;
+	};
+
+	// 在Actor所有静态网格组件LOD0的三角形上按面积取NumSamples个点，法线由顶点法线插值；种子固定，同一场景结果相同
+	// 网格的CPU数据不可读（例如打包后未开启CPU访问）时跳过该组件
+	bool SampleSurface(const AActor* Actor, int32 NumSamples, TArray<FSurfaceSample>& OutSamples, TArray<FSurface>& OutSurfaces);
+
+	// OutVisibleCameras[i]是第i个采样点可见的相机索引（升序）；CameraLocations按相机索引排列
+	// 观察方向与表面法线的夹角超过MaxViewAngleDegrees的相机不计入；返回执行的射线检测次数
+	int64 ComputeVisibility(const UWorld* World, const FCameraArraySpatialIndex& Index, const TArray<FVector>& CameraLocations,
+		const TArray<FSurfaceSample>& Samples, float MaxViewAngleDegrees, TArray<TArray<int32>>& OutVisibleCameras);
+
+	struct FCameraReport
+	{
+		int32 VisibleSamples = 0;
+
+		// 只有这个相机能看到的采样点
+		int32 UniqueSamples = 0;
+
+		// 位置最近的相机、两者的距离（基线）以及两者都能看到的采样点
+		int32 Neighbor = INDEX_NONE;
+		double Baseline = 0.0;
+		int32 SharedWithNeighbor = 0;
+	};
+
+	struct FSurfaceReport
+	{
+		int32 NumSamples = 0;
+		int32 NumCovered = 0;
+		int32 NumWellCovered = 0;
+	};
+
+	// MinViews为“覆盖充分”所需的最少相机数
+	struct FReport
+	{
+		int32 MinViews = 1;
+		int32 NumSamples = 0;
+		double TotalArea = 0.0;
+
+		// ViewHistogram[k]是恰好被k个相机看到的采样点数，最后一格包含更多相机的点
+		TArray<int32> ViewHistogram;
+		double MeanViews = 0.0;
+		TArray<FCameraReport> Cameras;
+		TArray<FSurfaceReport> Surfaces;
+
+		// 采样点按面积均匀分布，点的比例即面积的比例
+		double GetFractionSeenBy(int32 NumViews) const;
+		FString Describe(const TArray<FSurface>& SurfaceInfo) const;
+	};
+
+	// Neighbors与CameraLocations按相机索引排列，没有邻居的相机为INDEX_NONE
+	void BuildReport(const TArray<FSurfaceSample>& Samples, const TArray<FSurface>& Surfaces, const TArray<TArray<int32>>& VisibleCameras,
+		const TArray<FVector>& CameraLocations, const TArray<int32>& Neighbors, int32 MinViews, FReport& OutReport);
+
+	// 每个相机一行：可见点数与比例、独有点数、最近邻居、基线与重叠比例
+	bool SaveCameraCsv(const FReport& Report, const TArray<FString>& CameraNames, const FString& Path);
+
+	// 每个采样点一行：位置、法线、所属表面与可见相机数
+	bool SaveSampleCsv(const TArray<FSurfaceSample>& Samples, const TArray<FSurface>& Surfaces, const TArray<TArray<int32>>& VisibleCameras, const FString& Path);
+}
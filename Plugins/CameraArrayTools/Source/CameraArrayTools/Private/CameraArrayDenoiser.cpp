@@ -0,0 +1,133 @@
+#include "CameraArrayDenoiser.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/ScopeLock.h"
+
+#if WITH_CAMERA_ARRAY_OIDN
+#include "OpenImageDenoise/oidn.hpp"
+#endif
+
+namespace
+{
+#if WITH_CAMERA_ARRAY_OIDN
+	// 设备与滤波器创建时要加载网络权重，所有帧共用；尺寸不变时重新提交滤波器几乎没有开销
+	struct FDenoiserDevice
+	{
+		FCriticalSection Mutex;
+		oidn::DeviceRef Device;
+		oidn::FilterRef Filter;
+		oidn::FilterRef FilterWithAux;
+		bool bInitialized = false;
+	};
+
+	FDenoiserDevice& GetDenoiserDevice()
+	{
+		static FDenoiserDevice Instance;
+		return Instance;
+	}
+
+	bool CheckError(const oidn::DeviceRef& Device, const TCHAR* Context)
+	{
+		const char* Message = nullptr;
+		if (Device.getError(Message) != oidn::Error::None)
+		{
+			UE_LOG(LogTemp, Error, TEXT("CameraArrayDenoiser: %s失败：%s"), Context, Message ? UTF8_TO_TCHAR(Message) : TEXT(""));
+			return false;
+		}
+		return true;
+	}
+
+	// 调用前需持有Mutex
+	bool EnsureDevice(FDenoiserDevice& State)
+	{
+		if (!State.bInitialized)
+		{
+			State.bInitialized = true;
+			State.Device = oidn::newDevice(oidn::DeviceType::CPU);
+			// 留一半核心给渲染线程与其他写出任务，降噪与下一个相机的渲染同时进行
+			State.Device.set("numThreads", FMath::Max(1, FPlatformMisc::NumberOfCoresIncludingHyperthreads() / 2));
+			State.Device.commit();
+			if (!CheckError(State.Device, TEXT("创建降噪设备")))
+			{
+				State.Device = oidn::DeviceRef();
+				return false;
+			}
+			State.Filter = State.Device.newFilter("RT");
+			State.FilterWithAux = State.Device.newFilter("RT");
+		}
+		return static_cast<bool>(State.Device);
+	}
+#endif
+}
+
+namespace CameraArrayDenoiser
+{
+	bool IsAvailable()
+	{
+#if WITH_CAMERA_ARRAY_OIDN
+		FDenoiserDevice& State = GetDenoiserDevice();
+		FScopeLock Lock(&State.Mutex);
+		return EnsureDevice(State);
+#else
+		return false;
+#endif
+	}
+
+	bool Denoise(FLinearColor* Color, const FFloat16Color* Albedo, const FFloat16Color* Normal, int32 Width, int32 Height, bool bHdr)
+	{
+#if WITH_CAMERA_ARRAY_OIDN
+		if (!Color || Width <= 0 || Height <= 0)
+		{
+			return false;
+		}
+
+		FDenoiserDevice& State = GetDenoiserDevice();
+		FScopeLock Lock(&State.Mutex);
+		if (!EnsureDevice(State))
+		{
+			return false;
+		}
+
+		// 原地降噪：像素步长跳过A通道，输出覆盖输入
+		const bool bHasAux = Albedo && Normal;
+		oidn::FilterRef& Filter = bHasAux ? State.FilterWithAux : State.Filter;
+		Filter.setImage("color", Color, oidn::Format::Float3, Width, Height, 0, sizeof(FLinearColor));
+		Filter.setImage("output", Color, oidn::Format::Float3, Width, Height, 0, sizeof(FLinearColor));
+
+		// 法线必须与反照率一起提供；辅助通道来自光栅化，本身没有噪点
+		if (bHasAux)
+		{
+			Filter.setImage("albedo", const_cast<FFloat16Color*>(Albedo), oidn::Format::Half3, Width, Height, 0, sizeof(FFloat16Color));
+			Filter.setImage("normal", const_cast<FFloat16Color*>(Normal), oidn::Format::Half3, Width, Height, 0, sizeof(FFloat16Color));
+			Filter.set("cleanAux", true);
+		}
+		Filter.set("hdr", bHdr);
+		Filter.set("srgb", !bHdr);
+		Filter.set("maxMemoryMB", static_cast<int>(MaxScratchBytes / (1024 * 1024)));
+		Filter.commit();
+		Filter.execute();
+		return CheckError(State.Device, TEXT("降噪"));
+#else
+		return false;
+#endif
+	}
+}
+
+void FCameraArrayDenoiseStats::Record(double Seconds, bool bSucceeded)
+{
+	FScopeLock Lock(&Mutex);
+	++NumFrames;
+	NumFailures += bSucceeded ? 0 : 1;
+	TotalSeconds += Seconds;
+	MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+}
+
+FString FCameraArrayDenoiseStats::Describe() const
+{
+	FScopeLock Lock(&Mutex);
+	if (NumFrames == 0)
+	{
+		return TEXT("降噪：没有降噪的帧");
+	}
+	return FString::Printf(TEXT("降噪：%d 帧在后台线程平均 %.3f 秒（最长 %.2f 秒），失败 %d 次"),
+		NumFrames, TotalSeconds / NumFrames, MaxSeconds, NumFailures);
+}
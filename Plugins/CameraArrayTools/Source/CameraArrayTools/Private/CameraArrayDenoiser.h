@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraArrayBufferPool.h"
+
+// 路径追踪降噪：用引擎自带的Open Image Denoise在CPU上降噪，输入渲染图像与同视角的反照率、法线辅助通道
+// 所有帧共用一个设备，设备内部用自己的线程池并行，多个后台线程同时调用时依次执行
+namespace CameraArrayDenoiser
+{
+	// 降噪滤波器分块处理时的内存上限，整个进程只有一份
+	constexpr int64 MaxScratchBytes = 512ll * 1024 * 1024;
+
+	// 当前平台是否编译了降噪器，并且设备创建成功
+	bool IsAvailable();
+
+	// 在调用线程上同步降噪，结果写回Color（只处理RGB，保留A）：
+	// bHdr时Color为线性HDR；否则为sRGB编码的[0,1]值。Albedo与Normal为半精度，尺寸与Color相同，可以为空
+	bool Denoise(FLinearColor* Color, const FFloat16Color* Albedo, const FFloat16Color* Normal, int32 Width, int32 Height, bool bHdr);
+}
+
+// 一次批量的降噪统计：降噪在后台线程进行，统计需要加锁
+class FCameraArrayDenoiseStats
+{
+public:
+	void Record(double Seconds, bool bSucceeded);
+	FString Describe() const;
+
+private:
+	mutable FCriticalSection Mutex;
+	int32 NumFrames = 0;
+	int32 NumFailures = 0;
+	double TotalSeconds = 0.0;
+	double MaxSeconds = 0.0;
+};
+
+// 一帧的降噪辅助通道，在渲染线程与渲染图像一起回读
+struct FCameraArrayDenoiseAovs
+{
+	FCameraArrayPooledBuffer Albedo;
+	FCameraArrayPooledBuffer Normal;
+	TSharedPtr<FCameraArrayDenoiseStats, ESPMode::ThreadSafe> Stats;
+};
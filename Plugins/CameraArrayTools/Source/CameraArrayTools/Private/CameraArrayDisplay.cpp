@@ -0,0 +1,84 @@
+#include "CameraArrayDisplay.h"
+#include "Components/LineBatchComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+
+void CameraArrayDisplay::WriteCameraLines(FBatchedLine* OutLines, const FTransform& Transform, float HorizontalFOVDegrees, float AspectRatio,
+	float Length, const FLinearColor& Color, float Thickness)
+{
+	const double TanHalfX = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(HorizontalFOVDegrees, 1.0f, 170.0f) * 0.5f));
+	const double TanHalfY = TanHalfX / FMath::Max(AspectRatio, UE_KINDA_SMALL_NUMBER);
+	const double HalfWidth = Length * TanHalfX;
+	const double HalfHeight = Length * TanHalfY;
+
+	int32 NumLines = 0;
+	auto AddLine = [&](const FVector& LocalStart, const FVector& LocalEnd)
+	{
+		OutLines[NumLines++] = FBatchedLine(Transform.TransformPosition(LocalStart), Transform.TransformPosition(LocalEnd), Color, 0.0f, Thickness, SDPG_World);
+	};
+
+	// 机身：镜头后方的方框
+	const FVector BodyMin(-0.4 * Length, -0.1 * Length, -0.15 * Length);
+	const FVector BodyMax(0.0, 0.1 * Length, 0.15 * Length);
+	auto BodyCorner = [&BodyMin, &BodyMax](int32 Corner)
+	{
+		return FVector((Corner & 1) ? BodyMax.X : BodyMin.X, (Corner & 2) ? BodyMax.Y : BodyMin.Y, (Corner & 4) ? BodyMax.Z : BodyMin.Z);
+	};
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		for (int32 Axis = 1; Axis < 8; Axis <<= 1)
+		{
+			if (!(Corner & Axis))
+			{
+				AddLine(BodyCorner(Corner), BodyCorner(Corner | Axis));
+			}
+		}
+	}
+
+	// 视锥：从镜头到远端四角，以及远端矩形
+	const FVector FarCorners[4] = {
+		FVector(Length, -HalfWidth, HalfHeight),
+		FVector(Length, HalfWidth, HalfHeight),
+		FVector(Length, HalfWidth, -HalfHeight),
+		FVector(Length, -HalfWidth, -HalfHeight),
+	};
+	for (int32 i = 0; i < 4; ++i)
+	{
+		AddLine(FVector::ZeroVector, FarCorners[i]);
+		AddLine(FarCorners[i], FarCorners[(i + 1) % 4]);
+	}
+
+	// 远端矩形上边的三角形指示画面上方
+	const FVector UpTip(Length, 0.0, HalfHeight + 0.5 * FMath::Min(HalfWidth, HalfHeight));
+	AddLine(FarCorners[0], UpTip);
+	AddLine(UpTip, FarCorners[1]);
+
+	check(NumLines == LinesPerCamera);
+}
+
+void CameraArrayDisplay::WriteEmptyLines(FBatchedLine* OutLines)
+{
+	for (int32 i = 0; i < LinesPerCamera; ++i)
+	{
+		OutLines[i] = FBatchedLine(FVector::ZeroVector, FVector::ZeroVector, FLinearColor::Transparent, 0.0f, 0.0f, SDPG_World);
+	}
+}
+
+void CameraArrayDisplay::SetCameraVisualizationVisible(AActor* Camera, bool bVisible)
+{
+#if WITH_EDITOR
+	if (!IsValid(Camera))
+	{
+		return;
+	}
+
+	TInlineComponentArray<UPrimitiveComponent*> Components(Camera);
+	for (UPrimitiveComponent* Component : Components)
+	{
+		if (Component->IsVisualizationComponent() && Component->IsVisible() != bVisible)
+		{
+			Component->SetVisibility(bVisible);
+		}
+	}
+#endif
+}
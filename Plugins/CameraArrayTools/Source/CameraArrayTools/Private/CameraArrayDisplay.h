@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+struct FBatchedLine;
+
+// 合批绘制相机：所有相机的机身与视锥写进管理器的一个线框组件，一次绘制，代替每个相机自带的模型与视锥组件
+namespace CameraArrayDisplay
+{
+	// 每个相机固定的线段数：机身方框12条、视锥8条、指示上方的三角形2条；第i个相机的线段从i * LinesPerCamera开始
+	constexpr int32 LinesPerCamera = 22;
+
+	// 写出一个相机的线段，Length为视锥的长度（厘米），机身尺寸随之缩放
+	void WriteCameraLines(FBatchedLine* OutLines, const FTransform& Transform, float HorizontalFOVDegrees, float AspectRatio,
+		float Length, const FLinearColor& Color, float Thickness);
+
+	// 不可见的占位线段，用于无效相机，使其余相机的位置保持不变
+	void WriteEmptyLines(FBatchedLine* OutLines);
+
+	// 显示或隐藏相机自带的编辑器可视化组件（相机模型、视锥、对焦平面），相机本身与其参数不受影响
+	void SetCameraVisualizationVisible(AActor* Camera, bool bVisible);
+}
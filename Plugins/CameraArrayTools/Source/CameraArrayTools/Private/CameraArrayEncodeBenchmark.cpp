@@ -0,0 +1,223 @@
+#include "CameraArrayEncodeBenchmark.h"
+#include "CameraArrayImageEncoder.h"
+#include "IImageWrapperModule.h"
+#include "IImageWrapper.h"
+#include "ImageCore.h"
+#include "Misc/FileHelper.h"
+#include "Modules/ModuleManager.h"
+
+namespace CameraArrayEncodeBenchmark
+{
+	static constexpr int32 NumIterations = 3;
+
+	struct FResult
+	{
+		FString Group;
+		FString Name;
+		double Milliseconds = 0.0;
+		int64 Bytes = 0;
+		int64 RawBytes = 0;
+		bool bPareto = false;
+	};
+
+	static void AddConfigurations(TArray<FCameraArrayEncodeSettings>& OutSettings)
+	{
+		FCameraArrayEncodeSettings Settings;
+
+		Settings.Format = ECameraArrayImageFormat::PNG;
+		for (const int32 Level : { 0, 1, 3, 6, 9 })
+		{
+			for (const ECameraArrayPngFilter Filter : { ECameraArrayPngFilter::None, ECameraArrayPngFilter::Up, ECameraArrayPngFilter::Paeth, ECameraArrayPngFilter::Adaptive })
+			{
+				Settings.PngCompressionLevel = Level;
+				Settings.PngFilter = Filter;
+				OutSettings.Add(Settings);
+			}
+		}
+
+		Settings.Format = ECameraArrayImageFormat::QOI;
+		OutSettings.Add(Settings);
+		Settings.Format = ECameraArrayImageFormat::BMP;
+		OutSettings.Add(Settings);
+		Settings.Format = ECameraArrayImageFormat::TGA;
+		OutSettings.Add(Settings);
+
+		Settings.Format = ECameraArrayImageFormat::JPEG;
+		for (const int32 Quality : { 75, 85, 95 })
+		{
+			Settings.JpegQuality = Quality;
+			OutSettings.Add(Settings);
+		}
+
+		Settings.Format = ECameraArrayImageFormat::EXR;
+		for (const ECameraArrayExrCodec Codec : { ECameraArrayExrCodec::None, ECameraArrayExrCodec::ZIP, ECameraArrayExrCodec::PIZ, ECameraArrayExrCodec::DWAA })
+		{
+			Settings.ExrCodec = Codec;
+			OutSettings.Add(Settings);
+		}
+
+		Settings.PngFilter = ECameraArrayPngFilter::Up;
+		for (const int32 Level : { 0, 1, 3, 6 })
+		{
+			Settings.PngCompressionLevel = Level;
+			Settings.Format = ECameraArrayImageFormat::PNG16;
+			OutSettings.Add(Settings);
+			Settings.Format = ECameraArrayImageFormat::TIFF;
+			OutSettings.Add(Settings);
+		}
+	}
+
+	// 取多次中最快的一次，减少线程调度带来的抖动
+	template <typename EncodeFunc>
+	static bool Measure(EncodeFunc&& Encode, double& OutMilliseconds, int64& OutBytes)
+	{
+		OutMilliseconds = TNumericLimits<double>::Max();
+		TArray64<uint8> Data;
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			const double Start = FPlatformTime::Seconds();
+			if (!Encode(Data))
+			{
+				return false;
+			}
+			OutMilliseconds = FMath::Min(OutMilliseconds, (FPlatformTime::Seconds() - Start) * 1000.0);
+		}
+		OutBytes = Data.Num();
+		return true;
+	}
+
+	static void MarkParetoPoints(TArray<FResult>& Results)
+	{
+		for (FResult& Candidate : Results)
+		{
+			Candidate.bPareto = !Results.ContainsByPredicate([&Candidate](const FResult& Other)
+			{
+				return &Other != &Candidate && Other.Group == Candidate.Group &&
+					Other.Milliseconds <= Candidate.Milliseconds && Other.Bytes <= Candidate.Bytes &&
+					(Other.Milliseconds < Candidate.Milliseconds || Other.Bytes < Candidate.Bytes);
+			});
+		}
+	}
+
+	void Run(const FImage& Source, const FString& CsvPath)
+	{
+		FImage Ldr;
+		FImage Hdr;
+		Source.CopyTo(Ldr, ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+		Source.CopyTo(Hdr, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+		const int32 Width = Source.SizeX;
+		const int32 Height = Source.SizeY;
+		const FColor* LdrPixels = Ldr.AsBGRA8().GetData();
+		const FLinearColor* HdrPixels = Hdr.AsRGBA32F().GetData();
+		const int64 LdrRawBytes = static_cast<int64>(Width) * Height * 3;
+		const int64 HdrRawBytes = static_cast<int64>(Width) * Height * 4 * sizeof(FFloat16);
+		const int64 Uint16RawBytes = static_cast<int64>(Width) * Height * 3 * sizeof(uint16);
+
+		TArray<FResult> Results;
+
+		// 引擎ImageWrapper的PNG，作为改用插件编码之前的基准
+		{
+			FResult& Result = Results.AddDefaulted_GetRef();
+			Result.Group = TEXT("8-bit lossless");
+			Result.Name = TEXT("PNG ImageWrapper");
+			Result.RawBytes = LdrRawBytes;
+			IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+			Measure([&](TArray64<uint8>& Out)
+			{
+				TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+				if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(LdrPixels, static_cast<int64>(Width) * Height * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
+				{
+					return false;
+				}
+				Out = ImageWrapper->GetCompressed();
+				return true;
+			}, Result.Milliseconds, Result.Bytes);
+		}
+
+		TArray<FCameraArrayEncodeSettings> Configurations;
+		AddConfigurations(Configurations);
+		for (const FCameraArrayEncodeSettings& Settings : Configurations)
+		{
+			const bool bExr = Settings.Format == ECameraArrayImageFormat::EXR;
+			const bool bUint16 = Settings.Format == ECameraArrayImageFormat::PNG16 || Settings.Format == ECameraArrayImageFormat::TIFF;
+			const bool bHdr = bExr || bUint16;
+			FResult Result;
+			Result.Group = bExr ? TEXT("EXR") : bUint16 ? TEXT("16-bit") : Settings.Format == ECameraArrayImageFormat::JPEG ? TEXT("JPEG") : TEXT("8-bit lossless");
+			Result.Name = Settings.Describe();
+			Result.RawBytes = bExr ? HdrRawBytes : bUint16 ? Uint16RawBytes : LdrRawBytes;
+			const bool bSucceeded = Measure([&](TArray64<uint8>& Out)
+			{
+				return bHdr ? CameraArrayImageEncoder::EncodeHdr(Settings, HdrPixels, Width, Height, Out)
+					: CameraArrayImageEncoder::EncodeLdr(Settings, LdrPixels, Width, Height, Out);
+			}, Result.Milliseconds, Result.Bytes);
+			if (bSucceeded)
+			{
+				Results.Add(MoveTemp(Result));
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("编码性能测试: %s 编码失败，跳过。"), *Result.Name);
+			}
+		}
+
+		MarkParetoPoints(Results);
+
+		UE_LOG(LogTemp, Log, TEXT("编码性能测试: %dx%d，每项取 %d 次中最快的一次，* 为同类中的帕累托点"), Width, Height, NumIterations);
+		FString Csv = TEXT("Group,Settings,Milliseconds,MBPerSecond,Bytes,Ratio,Pareto\n");
+		for (const FResult& Result : Results)
+		{
+			const double MBPerSecond = Result.RawBytes / (1024.0 * 1024.0) / FMath::Max(Result.Milliseconds / 1000.0, 1e-9);
+			const double Ratio = static_cast<double>(Result.Bytes) / FMath::Max<int64>(Result.RawBytes, 1);
+			UE_LOG(LogTemp, Log, TEXT("  %s %-16s %-20s %9.2f ms %8.1f MB/s %10lld bytes %6.1f%%"),
+				Result.bPareto ? TEXT("*") : TEXT(" "), *Result.Group, *Result.Name, Result.Milliseconds, MBPerSecond, Result.Bytes, Ratio * 100.0);
+			Csv += FString::Printf(TEXT("%s,%s,%.3f,%.1f,%lld,%.4f,%d\n"),
+				*Result.Group, *Result.Name, Result.Milliseconds, MBPerSecond, Result.Bytes, Ratio, Result.bPareto ? 1 : 0);
+		}
+
+		if (!CsvPath.IsEmpty())
+		{
+			if (FFileHelper::SaveStringToFile(Csv, *CsvPath))
+			{
+				UE_LOG(LogTemp, Log, TEXT("编码性能测试: 结果已保存到 %s"), *CsvPath);
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("编码性能测试: 无法写入 %s"), *CsvPath);
+			}
+		}
+	}
+
+	void MakeTestImage(int32 Width, int32 Height, FImage& OutImage)
+	{
+		OutImage.Init(Width, Height, ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+		TArrayView64<FColor> Pixels = OutImage.AsBGRA8();
+		for (int32 Y = 0; Y < Height; ++Y)
+		{
+			for (int32 X = 0; X < Width; ++X)
+			{
+				const float U = static_cast<float>(X) / FMath::Max(Width - 1, 1);
+				const float V = static_cast<float>(Y) / FMath::Max(Height - 1, 1);
+				FColor& Pixel = Pixels[static_cast<int64>(Y) * Width + X];
+				if (U < 0.4f)
+				{
+					// 天空一样的平滑渐变
+					Pixel = FLinearColor(0.2f + 0.3f * V, 0.4f + 0.2f * V, 0.9f - 0.3f * U, 1.0f).ToFColor(true);
+				}
+				else if (U < 0.7f)
+				{
+					// 大面积纯色块
+					const int32 Block = (X / 64 + Y / 64) % 4;
+					Pixel = FColor(40 + Block * 50, 80 + Block * 30, 120 - Block * 20, 255);
+				}
+				else
+				{
+					// 带纹理的表面与路径追踪噪点
+					const uint32 Hash = static_cast<uint32>(X) * 73856093u ^ static_cast<uint32>(Y) * 19349663u;
+					const uint8 Noise = static_cast<uint8>((Hash * 2654435761u) >> 24);
+					const uint8 Base = static_cast<uint8>(128 + 60 * FMath::Sin(X * 0.05f) * FMath::Cos(Y * 0.07f));
+					Pixel = FColor(static_cast<uint8>((Base * 3 + Noise) / 4), Base, static_cast<uint8>((Base + Noise) / 2), 255);
+				}
+			}
+		}
+	}
+}
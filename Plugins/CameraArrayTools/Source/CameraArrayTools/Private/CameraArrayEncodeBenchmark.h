@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FImage;
+
+// 编码性能测试：对同一张图像逐个运行各格式与压缩参数，记录耗时与文件大小，
+// 并在每一类（8位无损、JPEG、EXR、16位整数）中标出耗时与大小都不被其他设置同时超过的帕累托点
+namespace CameraArrayEncodeBenchmark
+{
+	// 在调用线程上同步运行，结果写入日志，CsvPath非空时另存一份CSV
+	void Run(const FImage& Source, const FString& CsvPath);
+
+	// 没有已渲染的图像时使用：平滑渐变、纯色块与噪点各占一部分，近似渲染结果的可压缩性
+	void MakeTestImage(int32 Width, int32 Height, FImage& OutImage);
+}
@@ -0,0 +1,683 @@
+#include "CameraArrayImageEncoder.h"
+#include "CameraArrayBufferPool.h"
+#include "CameraArrayExrEncoder.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeLock.h"
+#include "Math/VectorRegister.h"
+#include "IImageWrapperModule.h"
+#include "IImageWrapper.h"
+#include "Modules/ModuleManager.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+#include <atomic>
+
+FString FCameraArrayEncodeSettings::Describe() const
+{
+	switch (Format)
+	{
+	case ECameraArrayImageFormat::PNG:
+	case ECameraArrayImageFormat::PNG16:
+		return FString::Printf(TEXT("%s L%d %s"), Format == ECameraArrayImageFormat::PNG ? TEXT("PNG") : TEXT("PNG16"),
+			PngCompressionLevel, *StaticEnum<ECameraArrayPngFilter>()->GetNameStringByValue(static_cast<int64>(PngFilter)));
+	case ECameraArrayImageFormat::TIFF:
+		return FString::Printf(TEXT("TIFF16 L%d"), PngCompressionLevel);
+	case ECameraArrayImageFormat::JPEG:
+		return FString::Printf(TEXT("JPEG Q%d"), JpegQuality);
+	case ECameraArrayImageFormat::EXR:
+		return FString::Printf(TEXT("EXR %s"), *StaticEnum<ECameraArrayExrCodec>()->GetNameStringByValue(static_cast<int64>(ExrCodec)));
+	default:
+		return StaticEnum<ECameraArrayImageFormat>()->GetNameStringByValue(static_cast<int64>(Format));
+	}
+}
+
+namespace CameraArrayImageEncoder
+{
+	static void WriteBigEndian32(uint8* Dst, uint32 Value)
+	{
+		Dst[0] = static_cast<uint8>(Value >> 24);
+		Dst[1] = static_cast<uint8>(Value >> 16);
+		Dst[2] = static_cast<uint8>(Value >> 8);
+		Dst[3] = static_cast<uint8>(Value);
+	}
+
+	// ---- PNG ----
+	// 图像按行分成若干条带，每条带独立滤波和deflate，条带之间用前一条带末尾32KB作为预设字典，
+	// 以同步刷新结尾拼成一条zlib流（与pigz相同的做法），压缩率几乎不受影响
+
+	static constexpr int64 PngStripeBytes = 256 * 1024;
+	static constexpr int32 DeflateWindowBytes = 32 * 1024;
+
+	static FORCEINLINE uint8 PaethPredictor(int32 A, int32 B, int32 C)
+	{
+		const int32 P = A + B - C;
+		const int32 PA = FMath::Abs(P - A);
+		const int32 PB = FMath::Abs(P - B);
+		const int32 PC = FMath::Abs(P - C);
+		return static_cast<uint8>(PA <= PB && PA <= PC ? A : PB <= PC ? B : C);
+	}
+
+	// Prev为上一行，第一行时为全零行；Bpp为每像素字节数，16位时按字节做同样的差分
+	static void FilterRow(ECameraArrayPngFilter Filter, const uint8* Row, const uint8* Prev, int32 RowBytes, int32 Bpp, uint8* Out)
+	{
+		switch (Filter)
+		{
+		case ECameraArrayPngFilter::Sub:
+			*Out++ = 1;
+			for (int32 i = 0; i < RowBytes; ++i)
+			{
+				Out[i] = Row[i] - (i >= Bpp ? Row[i - Bpp] : 0);
+			}
+			break;
+		case ECameraArrayPngFilter::Up:
+			*Out++ = 2;
+			for (int32 i = 0; i < RowBytes; ++i)
+			{
+				Out[i] = Row[i] - Prev[i];
+			}
+			break;
+		case ECameraArrayPngFilter::Paeth:
+			*Out++ = 4;
+			for (int32 i = 0; i < Bpp; ++i)
+			{
+				Out[i] = Row[i] - Prev[i];
+			}
+			for (int32 i = Bpp; i < RowBytes; ++i)
+			{
+				Out[i] = Row[i] - PaethPredictor(Row[i - Bpp], Prev[i], Prev[i - Bpp]);
+			}
+			break;
+		case ECameraArrayPngFilter::None:
+		default:
+			*Out++ = 0;
+			FMemory::Memcpy(Out, Row, RowBytes);
+			break;
+		}
+	}
+
+	static void FilterRowAverage(const uint8* Row, const uint8* Prev, int32 RowBytes, int32 Bpp, uint8* Out)
+	{
+		*Out++ = 3;
+		for (int32 i = 0; i < RowBytes; ++i)
+		{
+			const int32 Left = i >= Bpp ? Row[i - Bpp] : 0;
+			Out[i] = Row[i] - static_cast<uint8>((Left + Prev[i]) >> 1);
+		}
+	}
+
+	// 按有符号字节绝对值之和选取每行的滤波方式，与libpng的启发式相同
+	static uint64 SumAbsSigned(const uint8* Filtered, int32 RowBytes)
+	{
+		uint64 Sum = 0;
+		for (int32 i = 1; i <= RowBytes; ++i)
+		{
+			Sum += FMath::Abs(static_cast<int32>(static_cast<int8>(Filtered[i])));
+		}
+		return Sum;
+	}
+
+	static void FilterRowAdaptive(const uint8* Row, const uint8* Prev, int32 RowBytes, int32 Bpp, uint8* Out, TArray<uint8>& Scratch)
+	{
+		const int32 FilteredBytes = RowBytes + 1;
+		Scratch.SetNumUninitialized(FilteredBytes);
+
+		FilterRow(ECameraArrayPngFilter::None, Row, Prev, RowBytes, Bpp, Out);
+		uint64 BestSum = SumAbsSigned(Out, RowBytes);
+		auto TryCandidate = [&]()
+		{
+			const uint64 Sum = SumAbsSigned(Scratch.GetData(), RowBytes);
+			if (Sum < BestSum)
+			{
+				BestSum = Sum;
+				FMemory::Memcpy(Out, Scratch.GetData(), FilteredBytes);
+			}
+		};
+
+		FilterRow(ECameraArrayPngFilter::Sub, Row, Prev, RowBytes, Bpp, Scratch.GetData());
+		TryCandidate();
+		FilterRow(ECameraArrayPngFilter::Up, Row, Prev, RowBytes, Bpp, Scratch.GetData());
+		TryCandidate();
+		FilterRowAverage(Row, Prev, RowBytes, Bpp, Scratch.GetData());
+		TryCandidate();
+		FilterRow(ECameraArrayPngFilter::Paeth, Row, Prev, RowBytes, Bpp, Scratch.GetData());
+		TryCandidate();
+	}
+
+	static void AppendPngChunk(TArray64<uint8>& Out, const char* Type, const uint8* Data, int64 Size)
+	{
+		uint8 Header[8];
+		WriteBigEndian32(Header, static_cast<uint32>(Size));
+		FMemory::Memcpy(Header + 4, Type, 4);
+		Out.Append(Header, 8);
+
+		// zlib的crc32在数据指针为空时返回初始值，IEND这样的空块只对类型求校验
+		uLong Crc = crc32(0L, Header + 4, 4);
+		if (Size > 0)
+		{
+			Out.Append(Data, Size);
+			Crc = crc32(Crc, Data, static_cast<uInt>(Size));
+		}
+		uint8 Tail[4];
+		WriteBigEndian32(Tail, static_cast<uint32>(Crc));
+		Out.Append(Tail, 4);
+	}
+
+	// bZlibWrapper为false时输出裸deflate流，用于拼接；TIFF的每个条带则是完整的zlib流
+	static bool DeflateStripe(const TArray64<uint8>& Input, const uint8* Dictionary, int32 DictionaryBytes, int32 Level, int32 Strategy, bool bFinal, bool bZlibWrapper, TArray64<uint8>& OutCompressed)
+	{
+		z_stream Stream;
+		FMemory::Memzero(Stream);
+		if (deflateInit2(&Stream, Level, Z_DEFLATED, bZlibWrapper ? MAX_WBITS : -MAX_WBITS, 8, Strategy) != Z_OK)
+		{
+			return false;
+		}
+		if (DictionaryBytes > 0)
+		{
+			deflateSetDictionary(&Stream, Dictionary, DictionaryBytes);
+		}
+
+		// 同步刷新最多再多出一个空的存储块
+		OutCompressed.SetNumUninitialized(deflateBound(&Stream, static_cast<uLong>(Input.Num())) + 64);
+		Stream.next_in = const_cast<Bytef*>(Input.GetData());
+		Stream.avail_in = static_cast<uInt>(Input.Num());
+		Stream.next_out = OutCompressed.GetData();
+		Stream.avail_out = static_cast<uInt>(OutCompressed.Num());
+
+		const int32 Result = deflate(&Stream, bFinal ? Z_FINISH : Z_SYNC_FLUSH);
+		const bool bSucceeded = bFinal ? Result == Z_STREAM_END : (Result == Z_OK && Stream.avail_in == 0);
+		OutCompressed.SetNum(Stream.total_out, false);
+		deflateEnd(&Stream);
+		return bSucceeded;
+	}
+
+	// ConvertRow把第Y行写成PNG的RGB样本（16位时为大端序），可能被多个线程同时调用
+	static bool EncodePng(const FCameraArrayEncodeSettings& Settings, int32 Width, int32 Height, int32 BitDepth, TFunctionRef<void(int32, uint8*)> ConvertRow, TArray64<uint8>& OutData)
+	{
+		const int32 Bpp = 3 * BitDepth / 8;
+		const int32 RowBytes = Width * Bpp;
+		const int32 Level = FMath::Clamp(Settings.PngCompressionLevel, 0, 9);
+		const int32 Strategy = Settings.PngFilter == ECameraArrayPngFilter::None ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+		const int32 RowsPerStripe = FMath::Max<int32>(1, static_cast<int32>(PngStripeBytes / (RowBytes + 1)));
+		const int32 NumStripes = FMath::DivideAndRoundUp(Height, RowsPerStripe);
+
+		// 第一遍：转换并滤波，每个条带需要自己上方的一行作为预测
+		// 条带缓冲都从缓冲池取，同尺寸的帧之间复用
+		TArray<FCameraArrayPooledBuffer> Filtered;
+		Filtered.SetNum(NumStripes);
+		ParallelFor(NumStripes, [&](int32 Stripe)
+		{
+			const int32 FirstRow = Stripe * RowsPerStripe;
+			const int32 EndRow = FMath::Min(FirstRow + RowsPerStripe, Height);
+			TArray<uint8> Rows[2];
+			Rows[0].SetNumZeroed(RowBytes);
+			Rows[1].SetNumZeroed(RowBytes);
+			TArray<uint8> Scratch;
+
+			int32 Current = 0;
+			if (FirstRow > 0)
+			{
+				ConvertRow(FirstRow - 1, Rows[1].GetData());
+			}
+
+			Filtered[Stripe] = FCameraArrayPooledBuffer(static_cast<int64>(EndRow - FirstRow) * (RowBytes + 1));
+			TArray64<uint8>& Out = Filtered[Stripe].GetArray();
+			for (int32 Y = FirstRow; Y < EndRow; ++Y)
+			{
+				ConvertRow(Y, Rows[Current].GetData());
+				uint8* Dst = Out.GetData() + static_cast<int64>(Y - FirstRow) * (RowBytes + 1);
+				if (Settings.PngFilter == ECameraArrayPngFilter::Adaptive)
+				{
+					FilterRowAdaptive(Rows[Current].GetData(), Rows[Current ^ 1].GetData(), RowBytes, Bpp, Dst, Scratch);
+				}
+				else
+				{
+					FilterRow(Settings.PngFilter, Rows[Current].GetData(), Rows[Current ^ 1].GetData(), RowBytes, Bpp, Dst);
+				}
+				Current ^= 1;
+			}
+		});
+
+		// 第二遍：各条带并行压缩，同时计算各自的Adler-32
+		TArray<FCameraArrayPooledBuffer> Compressed;
+		TArray<uLong> Adlers;
+		Compressed.SetNum(NumStripes);
+		Adlers.SetNumZeroed(NumStripes);
+		std::atomic<bool> bFailed(false);
+		ParallelFor(NumStripes, [&](int32 Stripe)
+		{
+			const TArray64<uint8>& Input = Filtered[Stripe].GetArray();
+			const TArray64<uint8>* Previous = Stripe > 0 ? &Filtered[Stripe - 1].GetArray() : nullptr;
+			const int32 DictionaryBytes = Previous ? static_cast<int32>(FMath::Min<int64>(Previous->Num(), DeflateWindowBytes)) : 0;
+			const uint8* Dictionary = Previous ? Previous->GetData() + Previous->Num() - DictionaryBytes : nullptr;
+			Compressed[Stripe] = FCameraArrayPooledBuffer(compressBound(static_cast<uLong>(Input.Num())) + 64);
+			if (!DeflateStripe(Input, Dictionary, DictionaryBytes, Level, Strategy, Stripe == NumStripes - 1, false, Compressed[Stripe].GetArray()))
+			{
+				bFailed = true;
+			}
+			Adlers[Stripe] = adler32(1L, Input.GetData(), static_cast<uInt>(Input.Num()));
+		});
+		if (bFailed)
+		{
+			return false;
+		}
+
+		uLong Adler = Adlers[0];
+		int64 CompressedBytes = Compressed[0].Num();
+		for (int32 Stripe = 1; Stripe < NumStripes; ++Stripe)
+		{
+			Adler = adler32_combine(Adler, Adlers[Stripe], static_cast<z_off_t>(Filtered[Stripe].Num()));
+			CompressedBytes += Compressed[Stripe].Num();
+		}
+
+		OutData.Reset(CompressedBytes + NumStripes * 12 + 64);
+		static const uint8 Signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		OutData.Append(Signature, 8);
+
+		uint8 Header[13];
+		WriteBigEndian32(Header, Width);
+		WriteBigEndian32(Header + 4, Height);
+		Header[8] = static_cast<uint8>(BitDepth);
+		Header[9] = 2;  // RGB
+		Header[10] = 0; // deflate
+		Header[11] = 0; // 自适应滤波
+		Header[12] = 0; // 不隔行
+		AppendPngChunk(OutData, "IHDR", Header, sizeof(Header));
+
+		// zlib头与尾的Adler-32分别并入第一个和最后一个IDAT块
+		const uint8 CompressionMethod = 0x78;
+		const uint8 LevelFlag = Level < 2 ? 0 : Level < 6 ? 1 : Level == 6 ? 2 : 3;
+		uint8 Flags = static_cast<uint8>(LevelFlag << 6);
+		Flags += static_cast<uint8>(31 - (CompressionMethod * 256 + Flags) % 31);
+		Compressed[0].GetArray().Insert({ CompressionMethod, Flags }, 0);
+		uint8 AdlerBytes[4];
+		WriteBigEndian32(AdlerBytes, static_cast<uint32>(Adler));
+		Compressed.Last().GetArray().Append(AdlerBytes, 4);
+
+		for (const FCameraArrayPooledBuffer& Chunk : Compressed)
+		{
+			AppendPngChunk(OutData, "IDAT", Chunk.GetData(), Chunk.Num());
+		}
+		AppendPngChunk(OutData, "IEND", nullptr, 0);
+		return true;
+	}
+
+	static bool EncodePng8(const FCameraArrayEncodeSettings& Settings, const FColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData)
+	{
+		return EncodePng(Settings, Width, Height, 8, [Pixels, Width](int32 Y, uint8* Out)
+		{
+			const FColor* Src = Pixels + static_cast<int64>(Y) * Width;
+			for (int32 X = 0; X < Width; ++X, Out += 3)
+			{
+				Out[0] = Src[X].R;
+				Out[1] = Src[X].G;
+				Out[2] = Src[X].B;
+			}
+		}, OutData);
+	}
+
+	// ---- 16位整数 ----
+	// 线性浮点按[0, 1]截断后量化到0..65535，不做gamma；一个SIMD寄存器处理一个像素的四个通道
+
+	template <bool bBigEndian>
+	static void QuantizeRowToUint16(const FLinearColor* Src, int32 Width, uint8* Out)
+	{
+		const VectorRegister4Float Scale = VectorSetFloat1(65535.0f);
+		const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+		alignas(16) int32 Quantized[4];
+		for (int32 X = 0; X < Width; ++X, Out += 6)
+		{
+			const VectorRegister4Float Clamped = VectorMin(VectorMax(VectorLoad(&Src[X].R), VectorZeroFloat()), VectorOneFloat());
+			VectorIntStoreAligned(VectorFloatToInt(VectorMultiplyAdd(Clamped, Scale, Half)), Quantized);
+			for (int32 Channel = 0; Channel < 3; ++Channel)
+			{
+				const uint16 Value = static_cast<uint16>(Quantized[Channel]);
+				Out[Channel * 2 + (bBigEndian ? 0 : 1)] = static_cast<uint8>(Value >> 8);
+				Out[Channel * 2 + (bBigEndian ? 1 : 0)] = static_cast<uint8>(Value);
+			}
+		}
+	}
+
+	static bool EncodePng16(const FCameraArrayEncodeSettings& Settings, const FLinearColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData)
+	{
+		return EncodePng(Settings, Width, Height, 16, [Pixels, Width](int32 Y, uint8* Out)
+		{
+			QuantizeRowToUint16<true>(Pixels + static_cast<int64>(Y) * Width, Width, Out);
+		}, OutData);
+	}
+
+	static void WriteLittleEndian16(TArray64<uint8>& Out, uint16 Value)
+	{
+		Out.Add(static_cast<uint8>(Value));
+		Out.Add(static_cast<uint8>(Value >> 8));
+	}
+
+	static void WriteLittleEndian32(TArray64<uint8>& Out, uint32 Value)
+	{
+		WriteLittleEndian16(Out, static_cast<uint16>(Value));
+		WriteLittleEndian16(Out, static_cast<uint16>(Value >> 16));
+	}
+
+	// 小端序基线TIFF，RGB各16位，每个条带独立量化、水平差分并压缩（Adobe Deflate），条带本身就是TIFF的存储单位，
+	// 所以条带数据一次写完，最后追加IFD；压缩级别为0时不压缩也不差分
+	static bool EncodeTiff16(const FCameraArrayEncodeSettings& Settings, const FLinearColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData)
+	{
+		constexpr int32 Bpp = 6;
+		const int32 RowBytes = Width * Bpp;
+		const int32 Level = FMath::Clamp(Settings.PngCompressionLevel, 0, 9);
+		const bool bCompressed = Level > 0;
+		const int32 RowsPerStrip = FMath::Max<int32>(1, static_cast<int32>(PngStripeBytes / RowBytes));
+		const int32 NumStrips = FMath::DivideAndRoundUp(Height, RowsPerStrip);
+
+		TArray<FCameraArrayPooledBuffer> Strips;
+		Strips.SetNum(NumStrips);
+		std::atomic<bool> bFailed(false);
+		ParallelFor(NumStrips, [&](int32 Strip)
+		{
+			const int32 FirstRow = Strip * RowsPerStrip;
+			const int32 EndRow = FMath::Min(FirstRow + RowsPerStrip, Height);
+			FCameraArrayPooledBuffer Raw(static_cast<int64>(EndRow - FirstRow) * RowBytes);
+			for (int32 Y = FirstRow; Y < EndRow; ++Y)
+			{
+				uint8* Row = Raw.GetData() + static_cast<int64>(Y - FirstRow) * RowBytes;
+				QuantizeRowToUint16<false>(Pixels + static_cast<int64>(Y) * Width, Width, Row);
+				if (bCompressed)
+				{
+					// 预测器2：每个样本减去左边像素的同一通道，从右往左原地计算
+					uint16* Samples = reinterpret_cast<uint16*>(Row);
+					for (int32 i = Width * 3 - 1; i >= 3; --i)
+					{
+						Samples[i] = static_cast<uint16>(Samples[i] - Samples[i - 3]);
+					}
+				}
+			}
+
+			if (!bCompressed)
+			{
+				Strips[Strip] = MoveTemp(Raw);
+			}
+			else
+			{
+				Strips[Strip] = FCameraArrayPooledBuffer(compressBound(static_cast<uLong>(Raw.Num())) + 64);
+				if (!DeflateStripe(Raw.GetArray(), nullptr, 0, Level, Z_DEFAULT_STRATEGY, true, true, Strips[Strip].GetArray()))
+				{
+					bFailed = true;
+				}
+			}
+		});
+		if (bFailed)
+		{
+			return false;
+		}
+
+		int64 StripBytes = 0;
+		for (const FCameraArrayPooledBuffer& Strip : Strips)
+		{
+			StripBytes += Strip.Num();
+		}
+		if (StripBytes + NumStrips * 8 + 512 > MAX_uint32)
+		{
+			UE_LOG(LogTemp, Error, TEXT("TIFF超过4GB，请改用EXR。"));
+			return false;
+		}
+
+		OutData.Reset(StripBytes + NumStrips * 8 + 512);
+		OutData.Append({ 'I', 'I', 42, 0 });
+		WriteLittleEndian32(OutData, 0); // IFD偏移，写完条带后回填
+
+		TArray<uint32> StripOffsets;
+		TArray<uint32> StripByteCounts;
+		for (const FCameraArrayPooledBuffer& Strip : Strips)
+		{
+			StripOffsets.Add(static_cast<uint32>(OutData.Num()));
+			StripByteCounts.Add(static_cast<uint32>(Strip.Num()));
+			OutData.Append(Strip.GetData(), Strip.Num());
+		}
+
+		// 超过4字节的标签值放在IFD之后，先算好它们的位置
+		if (OutData.Num() % 2 != 0)
+		{
+			OutData.Add(0);
+		}
+		const uint32 IfdOffset = static_cast<uint32>(OutData.Num());
+		const uint16 NumEntries = bCompressed ? 12 : 11;
+		uint32 ExtraOffset = IfdOffset + 2 + NumEntries * 12 + 4;
+		const uint32 BitsPerSampleOffset = ExtraOffset;
+		ExtraOffset += 3 * 2;
+		const uint32 SampleFormatOffset = ExtraOffset;
+		ExtraOffset += 3 * 2;
+		const uint32 StripOffsetsOffset = ExtraOffset;
+		ExtraOffset += NumStrips * 4;
+		const uint32 StripByteCountsOffset = ExtraOffset;
+
+		OutData[4] = static_cast<uint8>(IfdOffset);
+		OutData[5] = static_cast<uint8>(IfdOffset >> 8);
+		OutData[6] = static_cast<uint8>(IfdOffset >> 16);
+		OutData[7] = static_cast<uint8>(IfdOffset >> 24);
+
+		// 标签按编号升序；只有一个条带时偏移与字节数直接放在标签里
+		auto WriteEntry = [&OutData](uint16 Tag, uint16 Type, uint32 Count, uint32 Value)
+		{
+			WriteLittleEndian16(OutData, Tag);
+			WriteLittleEndian16(OutData, Type);
+			WriteLittleEndian32(OutData, Count);
+			if (Type == 3 && Count == 1)
+			{
+				WriteLittleEndian16(OutData, static_cast<uint16>(Value));
+				WriteLittleEndian16(OutData, 0);
+			}
+			else
+			{
+				WriteLittleEndian32(OutData, Value);
+			}
+		};
+		constexpr uint16 Short = 3;
+		constexpr uint16 Long = 4;
+		WriteLittleEndian16(OutData, NumEntries);
+		WriteEntry(256, Long, 1, Width);                                  // ImageWidth
+		WriteEntry(257, Long, 1, Height);                                 // ImageLength
+		WriteEntry(258, Short, 3, BitsPerSampleOffset);                   // BitsPerSample
+		WriteEntry(259, Short, 1, bCompressed ? 8 : 1);                   // Compression
+		WriteEntry(262, Short, 1, 2);                                     // PhotometricInterpretation: RGB
+		WriteEntry(273, Long, NumStrips, NumStrips == 1 ? StripOffsets[0] : StripOffsetsOffset);
+		WriteEntry(277, Short, 1, 3);                                     // SamplesPerPixel
+		WriteEntry(278, Long, 1, RowsPerStrip);                           // RowsPerStrip
+		WriteEntry(279, Long, NumStrips, NumStrips == 1 ? StripByteCounts[0] : StripByteCountsOffset);
+		WriteEntry(284, Short, 1, 1);                                     // PlanarConfiguration: 交错
+		if (bCompressed)
+		{
+			WriteEntry(317, Short, 1, 2);                                 // Predictor: 水平差分
+		}
+		WriteEntry(339, Short, 3, SampleFormatOffset);                    // SampleFormat: 无符号整数
+		WriteLittleEndian32(OutData, 0);                                  // 没有下一个IFD
+
+		for (int32 Channel = 0; Channel < 3; ++Channel)
+		{
+			WriteLittleEndian16(OutData, 16);
+		}
+		for (int32 Channel = 0; Channel < 3; ++Channel)
+		{
+			WriteLittleEndian16(OutData, 1);
+		}
+		for (const uint32 Offset : StripOffsets)
+		{
+			WriteLittleEndian32(OutData, Offset);
+		}
+		for (const uint32 Count : StripByteCounts)
+		{
+			WriteLittleEndian32(OutData, Count);
+		}
+		return true;
+	}
+
+	// ---- QOI ----
+	// https://qoiformat.org/qoi-specification.pdf，单遍编码，速度接近内存拷贝
+
+	static bool EncodeQoi(const FColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData)
+	{
+		const int64 NumPixels = static_cast<int64>(Width) * Height;
+		OutData.SetNumUninitialized(14 + NumPixels * 4 + 8);
+		uint8* Out = OutData.GetData();
+
+		FMemory::Memcpy(Out, "qoif", 4);
+		WriteBigEndian32(Out + 4, Width);
+		WriteBigEndian32(Out + 8, Height);
+		Out[12] = 3; // RGB，alpha恒为不透明
+		Out[13] = 0; // sRGB
+		Out += 14;
+
+		struct FRgba { uint8 R, G, B, A; };
+		FRgba Index[64];
+		FMemory::Memzero(Index);
+		FRgba Prev = { 0, 0, 0, 255 };
+		int32 Run = 0;
+
+		for (int64 i = 0; i < NumPixels; ++i)
+		{
+			const FRgba Pixel = { Pixels[i].R, Pixels[i].G, Pixels[i].B, 255 };
+			if (Pixel.R == Prev.R && Pixel.G == Prev.G && Pixel.B == Prev.B)
+			{
+				++Run;
+				if (Run == 62 || i == NumPixels - 1)
+				{
+					*Out++ = static_cast<uint8>(0xC0 | (Run - 1));
+					Run = 0;
+				}
+				continue;
+			}
+			if (Run > 0)
+			{
+				*Out++ = static_cast<uint8>(0xC0 | (Run - 1));
+				Run = 0;
+			}
+
+			const int32 Hash = (Pixel.R * 3 + Pixel.G * 5 + Pixel.B * 7 + Pixel.A * 11) % 64;
+			if (Index[Hash].R == Pixel.R && Index[Hash].G == Pixel.G && Index[Hash].B == Pixel.B && Index[Hash].A == Pixel.A)
+			{
+				*Out++ = static_cast<uint8>(Hash);
+			}
+			else
+			{
+				Index[Hash] = Pixel;
+				const int32 DR = static_cast<int8>(Pixel.R - Prev.R);
+				const int32 DG = static_cast<int8>(Pixel.G - Prev.G);
+				const int32 DB = static_cast<int8>(Pixel.B - Prev.B);
+				const int32 DRG = DR - DG;
+				const int32 DBG = DB - DG;
+				if (DR > -3 && DR < 2 && DG > -3 && DG < 2 && DB > -3 && DB < 2)
+				{
+					*Out++ = static_cast<uint8>(0x40 | (DR + 2) << 4 | (DG + 2) << 2 | (DB + 2));
+				}
+				else if (DRG > -9 && DRG < 8 && DG > -33 && DG < 32 && DBG > -9 && DBG < 8)
+				{
+					*Out++ = static_cast<uint8>(0x80 | (DG + 32));
+					*Out++ = static_cast<uint8>((DRG + 8) << 4 | (DBG + 8));
+				}
+				else
+				{
+					*Out++ = 0xFE;
+					*Out++ = Pixel.R;
+					*Out++ = Pixel.G;
+					*Out++ = Pixel.B;
+				}
+			}
+			Prev = Pixel;
+		}
+
+		static const uint8 EndMarker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+		FMemory::Memcpy(Out, EndMarker, 8);
+		Out += 8;
+		OutData.SetNum(Out - OutData.GetData(), false);
+		return true;
+	}
+
+	// ---- EXR ----
+	// OpenEXR需要启用异常，编码放在单独的CameraArrayToolsExr模块中；这里只转换为半精度
+
+	static CameraArrayExr::ECompression ToExrCompression(ECameraArrayExrCodec Codec)
+	{
+		switch (Codec)
+		{
+		case ECameraArrayExrCodec::None: return CameraArrayExr::ECompression::None;
+		case ECameraArrayExrCodec::PIZ:  return CameraArrayExr::ECompression::Piz;
+		case ECameraArrayExrCodec::DWAA: return CameraArrayExr::ECompression::Dwaa;
+		case ECameraArrayExrCodec::ZIP:
+		default:                         return CameraArrayExr::ECompression::Zip;
+		}
+	}
+
+	static bool EncodeExr(const FCameraArrayEncodeSettings& Settings, const FLinearColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData)
+	{
+		const int64 NumPixels = static_cast<int64>(Width) * Height;
+		FCameraArrayPooledBuffer HalfBuffer(NumPixels * sizeof(FFloat16Color));
+		FFloat16Color* HalfPixels = HalfBuffer.GetData<FFloat16Color>();
+		ParallelFor(Height, [&](int32 Y)
+		{
+			const int64 RowStart = static_cast<int64>(Y) * Width;
+			for (int64 i = RowStart; i < RowStart + Width; ++i)
+			{
+				HalfPixels[i] = FFloat16Color(Pixels[i]);
+			}
+		});
+		return CameraArrayExr::EncodeRgbaHalf(HalfPixels, Width, Height, ToExrCompression(Settings.ExrCodec), OutData);
+	}
+
+	// ---- ImageWrapper ----
+
+	static bool EncodeWithImageWrapper(EImageFormat ImageFormat, int32 Quality, const FColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData)
+	{
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(ImageFormat);
+		if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(Pixels, static_cast<int64>(Width) * Height * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
+		{
+			return false;
+		}
+		OutData = ImageWrapper->GetCompressed(Quality);
+		return OutData.Num() > 0;
+	}
+
+	int64 EstimateMaxEncodedBytes(const FCameraArrayEncodeSettings& Settings, int32 Width, int32 Height)
+	{
+		int64 BytesPerPixel = 4;
+		switch (Settings.Format)
+		{
+		case ECameraArrayImageFormat::PNG:   BytesPerPixel = 3; break;
+		case ECameraArrayImageFormat::PNG16:
+		case ECameraArrayImageFormat::TIFF:  BytesPerPixel = 6; break;
+		case ECameraArrayImageFormat::EXR:   BytesPerPixel = sizeof(FFloat16Color); break;
+		default: break;
+		}
+		// 未压缩的样本、每行的滤波字节，加上deflate最坏情况的少量膨胀与文件头
+		const int64 RawBytes = static_cast<int64>(Width) * Height * BytesPerPixel + Height;
+		return RawBytes + RawBytes / 256 + 4096;
+	}
+
+	bool EncodeLdr(const FCameraArrayEncodeSettings& Settings, const FColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData)
+	{
+		switch (Settings.Format)
+		{
+		case ECameraArrayImageFormat::PNG:  return EncodePng8(Settings, Pixels, Width, Height, OutData);
+		case ECameraArrayImageFormat::QOI:  return EncodeQoi(Pixels, Width, Height, OutData);
+		case ECameraArrayImageFormat::JPEG: return EncodeWithImageWrapper(EImageFormat::JPEG, FMath::Clamp(Settings.JpegQuality, 1, 100), Pixels, Width, Height, OutData);
+		case ECameraArrayImageFormat::BMP:  return EncodeWithImageWrapper(EImageFormat::BMP, 0, Pixels, Width, Height, OutData);
+		case ECameraArrayImageFormat::TGA:  return EncodeWithImageWrapper(EImageFormat::TGA, 0, Pixels, Width, Height, OutData);
+		default:
+			UE_LOG(LogTemp, Error, TEXT("%s 不是8位格式。"), *Settings.Describe());
+			return false;
+		}
+	}
+
+	bool EncodeHdr(const FCameraArrayEncodeSettings& Settings, const FLinearColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData)
+	{
+		switch (Settings.Format)
+		{
+		case ECameraArrayImageFormat::EXR:   return EncodeExr(Settings, Pixels, Width, Height, OutData);
+		case ECameraArrayImageFormat::PNG16: return EncodePng16(Settings, Pixels, Width, Height, OutData);
+		case ECameraArrayImageFormat::TIFF:  return EncodeTiff16(Settings, Pixels, Width, Height, OutData);
+		default:
+			UE_LOG(LogTemp, Error, TEXT("%s 不是高位深格式。"), *Settings.Describe());
+			return false;
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraArrayManager.h"
+
+// 一帧图像的编码设置，从管理器的“编码”参数复制，在后台线程上使用
+struct FCameraArrayEncodeSettings
+{
+	ECameraArrayImageFormat Format = ECameraArrayImageFormat::PNG;
+	int32 PngCompressionLevel = 3;
+	ECameraArrayPngFilter PngFilter = ECameraArrayPngFilter::Up;
+	int32 JpegQuality = 85;
+	ECameraArrayExrCodec ExrCodec = ECameraArrayExrCodec::ZIP;
+
+	// 用于日志与性能测试报告，例如 "PNG L3 Up"
+	FString Describe() const;
+};
+
+// PNG、QOI与EXR由插件自己编码，可以控制压缩参数并在一帧之内并行；JPEG、BMP、TGA仍使用ImageWrapper
+namespace CameraArrayImageEncoder
+{
+	// 8位BGRA像素，alpha视为不透明
+	bool EncodeLdr(const FCameraArrayEncodeSettings& Settings, const FColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData);
+
+	// 线性浮点像素，以半精度写出
+	bool EncodeHdr(const FCameraArrayEncodeSettings& Settings, const FLinearColor* Pixels, int32 Width, int32 Height, TArray64<uint8>& OutData);
+
+	// 编码输出大小的上限（接近未压缩），用于预先取好输出缓冲
+	int64 EstimateMaxEncodedBytes(const FCameraArrayEncodeSettings& Settings, int32 Width, int32 Height);
+}
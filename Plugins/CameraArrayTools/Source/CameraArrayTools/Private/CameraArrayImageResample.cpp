@@ -0,0 +1,214 @@
+#include "CameraArrayImageResample.h"
+#include "Async/ParallelFor.h"
+
+namespace CameraArrayImageResample
+{
+	template <typename PixelType>
+	static void BoxDownsampleImpl(const PixelType* Src, int32 SrcWidth, int32 SrcHeight, PixelType* Dst, int32 DstWidth, int32 DstHeight)
+	{
+		// 先把目标行覆盖的源行纵向累加到行缓冲，再在行缓冲上横向求平均
+		TArray<VectorRegister4Float> RowSum;
+		RowSum.SetNumUninitialized(SrcWidth);
+
+		for (int32 DstY = 0; DstY < DstHeight; ++DstY)
+		{
+			const int32 SrcY0 = static_cast<int32>(static_cast<int64>(DstY) * SrcHeight / DstHeight);
+			const int32 SrcY1 = FMath::Max(SrcY0 + 1, static_cast<int32>(static_cast<int64>(DstY + 1) * SrcHeight / DstHeight));
+
+			for (int32 X = 0; X < SrcWidth; ++X)
+			{
+				RowSum[X] = VectorZeroFloat();
+			}
+			for (int32 Y = SrcY0; Y < SrcY1; ++Y)
+			{
+				const PixelType* Row = Src + static_cast<int64>(Y) * SrcWidth;
+				for (int32 X = 0; X < SrcWidth; ++X)
+				{
+					RowSum[X] = VectorAdd(RowSum[X], LoadPixel(Row[X]));
+				}
+			}
+
+			for (int32 DstX = 0; DstX < DstWidth; ++DstX)
+			{
+				const int32 SrcX0 = static_cast<int32>(static_cast<int64>(DstX) * SrcWidth / DstWidth);
+				const int32 SrcX1 = FMath::Max(SrcX0 + 1, static_cast<int32>(static_cast<int64>(DstX + 1) * SrcWidth / DstWidth));
+
+				VectorRegister4Float Sum = VectorZeroFloat();
+				for (int32 X = SrcX0; X < SrcX1; ++X)
+				{
+					Sum = VectorAdd(Sum, RowSum[X]);
+				}
+
+				const float InvCount = 1.0f / static_cast<float>((SrcY1 - SrcY0) * (SrcX1 - SrcX0));
+				StorePixel(VectorMultiply(Sum, VectorSetFloat1(InvCount)), Dst[static_cast<int64>(DstY) * DstWidth + DstX]);
+			}
+		}
+	}
+
+	template <typename PixelType>
+	static void LanczosResampleImpl(const FLanczosKernel& Kernel, const PixelType* Src, PixelType* Dst)
+	{
+		const FLanczosAxis& H = Kernel.Horizontal;
+		const FLanczosAxis& V = Kernel.Vertical;
+
+		// 横向：所有源行缩放到目标宽度
+		TArray<VectorRegister4Float> Intermediate;
+		Intermediate.SetNumUninitialized(H.DstSize * V.SrcSize);
+		for (int32 Y = 0; Y < V.SrcSize; ++Y)
+		{
+			const PixelType* Row = Src + static_cast<int64>(Y) * H.SrcSize;
+			for (int32 DstX = 0; DstX < H.DstSize; ++DstX)
+			{
+				const int32 First = H.FirstSource[DstX];
+				const float* Weights = &H.Weights[DstX * H.MaxTaps];
+				VectorRegister4Float Sum = VectorZeroFloat();
+				for (int32 Tap = 0; Tap < H.MaxTaps && First + Tap < H.SrcSize; ++Tap)
+				{
+					Sum = VectorMultiplyAdd(LoadPixel(Row[First + Tap]), VectorSetFloat1(Weights[Tap]), Sum);
+				}
+				Intermediate[Y * H.DstSize + DstX] = Sum;
+			}
+		}
+
+		// 纵向：逐目标行累加，内层循环沿行连续访问
+		TArray<VectorRegister4Float> RowSum;
+		RowSum.SetNumUninitialized(H.DstSize);
+		for (int32 DstY = 0; DstY < V.DstSize; ++DstY)
+		{
+			for (int32 X = 0; X < H.DstSize; ++X)
+			{
+				RowSum[X] = VectorZeroFloat();
+			}
+
+			const int32 First = V.FirstSource[DstY];
+			const float* Weights = &V.Weights[DstY * V.MaxTaps];
+			for (int32 Tap = 0; Tap < V.MaxTaps && First + Tap < V.SrcSize; ++Tap)
+			{
+				const VectorRegister4Float Weight = VectorSetFloat1(Weights[Tap]);
+				const VectorRegister4Float* SrcRow = &Intermediate[(First + Tap) * H.DstSize];
+				for (int32 X = 0; X < H.DstSize; ++X)
+				{
+					RowSum[X] = VectorMultiplyAdd(SrcRow[X], Weight, RowSum[X]);
+				}
+			}
+
+			PixelType* DstRow = Dst + static_cast<int64>(DstY) * H.DstSize;
+			for (int32 X = 0; X < H.DstSize; ++X)
+			{
+				StorePixel(RowSum[X], DstRow[X]);
+			}
+		}
+	}
+
+	static float LanczosWeight(float X)
+	{
+		constexpr float Radius = 3.0f;
+		X = FMath::Abs(X);
+		if (X < UE_SMALL_NUMBER)
+		{
+			return 1.0f;
+		}
+		if (X >= Radius)
+		{
+			return 0.0f;
+		}
+		const float PiX = UE_PI * X;
+		return Radius * FMath::Sin(PiX) * FMath::Sin(PiX / Radius) / (PiX * PiX);
+	}
+
+	void FLanczosAxis::Build(int32 InSrcSize, int32 InDstSize)
+	{
+		SrcSize = FMath::Max(InSrcSize, 1);
+		DstSize = FMath::Max(InDstSize, 1);
+
+		// 缩小时按比例放宽滤波支撑，起到抗锯齿作用
+		const float Scale = static_cast<float>(SrcSize) / static_cast<float>(DstSize);
+		const float FilterScale = FMath::Max(Scale, 1.0f);
+		const float Support = 3.0f * FilterScale;
+		MaxTaps = FMath::CeilToInt(Support * 2.0f) + 1;
+
+		FirstSource.SetNumUninitialized(DstSize);
+		Weights.SetNumZeroed(DstSize * MaxTaps);
+
+		for (int32 DstIndex = 0; DstIndex < DstSize; ++DstIndex)
+		{
+			const float Center = (DstIndex + 0.5f) * Scale - 0.5f;
+			const int32 First = FMath::Max(0, FMath::FloorToInt(Center - Support) + 1);
+			const int32 Last = FMath::Min(SrcSize - 1, FMath::Min(First + MaxTaps - 1, FMath::FloorToInt(Center + Support)));
+			FirstSource[DstIndex] = First;
+
+			float* DstWeights = &Weights[DstIndex * MaxTaps];
+			float Total = 0.0f;
+			for (int32 SrcIndex = First; SrcIndex <= Last; ++SrcIndex)
+			{
+				const float Weight = LanczosWeight((SrcIndex - Center) / FilterScale);
+				DstWeights[SrcIndex - First] = Weight;
+				Total += Weight;
+			}
+			if (Total > UE_SMALL_NUMBER)
+			{
+				for (int32 Tap = 0; Tap < MaxTaps; ++Tap)
+				{
+					DstWeights[Tap] /= Total;
+				}
+			}
+		}
+	}
+
+	void BoxDownsample(const FColor* Src, int32 SrcWidth, int32 SrcHeight, FColor* Dst, int32 DstWidth, int32 DstHeight)
+	{
+		BoxDownsampleImpl(Src, SrcWidth, SrcHeight, Dst, DstWidth, DstHeight);
+	}
+
+	void BoxDownsample(const FLinearColor* Src, int32 SrcWidth, int32 SrcHeight, FLinearColor* Dst, int32 DstWidth, int32 DstHeight)
+	{
+		BoxDownsampleImpl(Src, SrcWidth, SrcHeight, Dst, DstWidth, DstHeight);
+	}
+
+	void LanczosResample(const FLanczosKernel& Kernel, const FColor* Src, FColor* Dst)
+	{
+		LanczosResampleImpl(Kernel, Src, Dst);
+	}
+
+	void LanczosResample(const FLanczosKernel& Kernel, const FLinearColor* Src, FLinearColor* Dst)
+	{
+		LanczosResampleImpl(Kernel, Src, Dst);
+	}
+
+	template <typename PixelType>
+	static void RemapBilinearImpl(const FBilinearTap* Taps, int32 DstWidth, int32 DstHeight, const PixelType* Src, int32 SrcRowStride, PixelType* Dst)
+	{
+		const VectorRegister4Float WeightScale = VectorSetFloat1(1.0f / 65535.0f);
+
+		// 每个像素的4个通道在一个SIMD寄存器中做双线性插值
+		ParallelFor(DstHeight, [&](int32 Y)
+		{
+			const int64 RowStart = static_cast<int64>(Y) * DstWidth;
+			for (int32 X = 0; X < DstWidth; ++X)
+			{
+				const FBilinearTap& Tap = Taps[RowStart + X];
+				const PixelType* Top = Src + Tap.Offset;
+				const PixelType* Bottom = Top + SrcRowStride;
+
+				const VectorRegister4Float WX = VectorMultiply(VectorSetFloat1(static_cast<float>(Tap.WeightX)), WeightScale);
+				const VectorRegister4Float WY = VectorMultiply(VectorSetFloat1(static_cast<float>(Tap.WeightY)), WeightScale);
+
+				const VectorRegister4Float Top0 = LoadPixel(Top[0]);
+				const VectorRegister4Float Bottom0 = LoadPixel(Bottom[0]);
+				const VectorRegister4Float TopRow = VectorMultiplyAdd(VectorSubtract(LoadPixel(Top[1]), Top0), WX, Top0);
+				const VectorRegister4Float BottomRow = VectorMultiplyAdd(VectorSubtract(LoadPixel(Bottom[1]), Bottom0), WX, Bottom0);
+				StorePixel(VectorMultiplyAdd(VectorSubtract(BottomRow, TopRow), WY, TopRow), Dst[RowStart + X]);
+			}
+		});
+	}
+
+	void RemapBilinear(const FBilinearTap* Taps, int32 DstWidth, int32 DstHeight, const FColor* Src, int32 SrcRowStride, FColor* Dst)
+	{
+		RemapBilinearImpl(Taps, DstWidth, DstHeight, Src, SrcRowStride, Dst);
+	}
+
+	void RemapBilinear(const FBilinearTap* Taps, int32 DstWidth, int32 DstHeight, const FLinearColor* Src, int32 SrcRowStride, FLinearColor* Dst)
+	{
+		RemapBilinearImpl(Taps, DstWidth, DstHeight, Src, SrcRowStride, Dst);
+	}
+}
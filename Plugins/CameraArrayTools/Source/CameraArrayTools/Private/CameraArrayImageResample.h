@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+
+// 图像缩放：每个像素的4个通道放在一个SIMD寄存器里计算，行缓冲连续访问
+// 盒式滤波用于面积平均缩小；Lanczos-3为可分离滤波，权重表只与尺寸有关，可以在多帧之间复用
+namespace CameraArrayImageResample
+{
+	// 单个像素与SIMD寄存器之间的转换，8位像素按0..255的浮点数计算
+	FORCEINLINE VectorRegister4Float LoadPixel(const FColor& Pixel)
+	{
+		return VectorLoadByte4(&Pixel);
+	}
+
+	FORCEINLINE VectorRegister4Float LoadPixel(const FLinearColor& Pixel)
+	{
+		return VectorLoad(&Pixel.R);
+	}
+
+	FORCEINLINE void StorePixel(const VectorRegister4Float& Value, FColor& OutPixel)
+	{
+		// VectorStoreByte4会截断，先加0.5做四舍五入
+		const VectorRegister4Float Clamped = VectorMin(VectorMax(VectorAdd(Value, VectorSetFloat1(0.5f)), VectorZeroFloat()), VectorSetFloat1(255.0f));
+		VectorStoreByte4(Clamped, &OutPixel);
+	}
+
+	FORCEINLINE void StorePixel(const VectorRegister4Float& Value, FLinearColor& OutPixel)
+	{
+		VectorStore(Value, &OutPixel.R);
+	}
+
+	// 一维Lanczos权重表：每个目标像素对应一段连续的源像素及其归一化权重
+	struct FLanczosAxis
+	{
+		int32 SrcSize = 0;
+		int32 DstSize = 0;
+		int32 MaxTaps = 0;
+		TArray<int32> FirstSource;
+		TArray<float> Weights; // DstSize * MaxTaps，不足MaxTaps的部分补0
+
+		void Build(int32 InSrcSize, int32 InDstSize);
+	};
+
+	struct FLanczosKernel
+	{
+		FLanczosAxis Horizontal;
+		FLanczosAxis Vertical;
+
+		void Build(int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight)
+		{
+			Horizontal.Build(SrcWidth, DstWidth);
+			Vertical.Build(SrcHeight, DstHeight);
+		}
+
+		bool Matches(int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight) const
+		{
+			return Horizontal.SrcSize == SrcWidth && Horizontal.DstSize == DstWidth &&
+				Vertical.SrcSize == SrcHeight && Vertical.DstSize == DstHeight;
+		}
+	};
+
+	// 双线性重映射的一个采样块：源图中2x2像素的左上角及右侧、下方像素的权重
+	// 由调用方保证左上角不在最后一行或最后一列，四个采样点都在源图内
+	struct FBilinearTap
+	{
+		uint32 Offset = 0;   // 左上角像素在源缓冲中的下标
+		uint16 WeightX = 0;  // 0..65535
+		uint16 WeightY = 0;  // 0..65535
+
+		static uint16 QuantizeWeight(double Weight)
+		{
+			return static_cast<uint16>(FMath::RoundToInt32(FMath::Clamp(Weight, 0.0, 1.0) * 65535.0));
+		}
+	};
+
+	// 按查找表逐像素双线性采样，SrcRowStride为源图一行的像素数，按行分给工作线程
+	void RemapBilinear(const FBilinearTap* Taps, int32 DstWidth, int32 DstHeight, const FColor* Src, int32 SrcRowStride, FColor* Dst);
+	void RemapBilinear(const FBilinearTap* Taps, int32 DstWidth, int32 DstHeight, const FLinearColor* Src, int32 SrcRowStride, FLinearColor* Dst);
+
+	void BoxDownsample(const FColor* Src, int32 SrcWidth, int32 SrcHeight, FColor* Dst, int32 DstWidth, int32 DstHeight);
+	void BoxDownsample(const FLinearColor* Src, int32 SrcWidth, int32 SrcHeight, FLinearColor* Dst, int32 DstWidth, int32 DstHeight);
+
+	void LanczosResample(const FLanczosKernel& Kernel, const FColor* Src, FColor* Dst);
+	void LanczosResample(const FLanczosKernel& Kernel, const FLinearColor* Src, FLinearColor* Dst);
+}
@@ -0,0 +1,265 @@
+#include "CameraArrayImageWriter.h"
+#include "CameraArrayContactSheet.h"
+#include "CameraArrayStereoPacker.h"
+#include "CameraArrayLensDistortion.h"
+#include "CameraArrayMemoryBudget.h"
+#include "CameraArrayDenoiser.h"
+#include "CameraArrayProgressive.h"
+#include "CameraArrayRegion.h"
+#include "CameraArrayRenderJournal.h"
+#include "IImageWrapper.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "HAL/PlatformFileManager.h"
+
+namespace CameraArrayImageWriter
+{
+	static bool EncodeAndSave(const FCameraArrayFrameWriteRequest& Request, const void* Pixels, ERGBFormat RGBFormat)
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Request.FilePath));
+
+		// 按最坏情况的大小从池中取输出缓冲，每帧落在同一等级
+		FCameraArrayPooledBuffer CompressedData(CameraArrayImageEncoder::EstimateMaxEncodedBytes(Request.Encode, Request.Width, Request.Height));
+		const bool bEncoded = RGBFormat == ERGBFormat::RGBAF
+			? CameraArrayImageEncoder::EncodeHdr(Request.Encode, static_cast<const FLinearColor*>(Pixels), Request.Width, Request.Height, CompressedData.GetArray())
+			: CameraArrayImageEncoder::EncodeLdr(Request.Encode, static_cast<const FColor*>(Pixels), Request.Width, Request.Height, CompressedData.GetArray());
+		if (!bEncoded)
+		{
+			UE_LOG(LogTemp, Error, TEXT("为 %s 编码图像数据失败（%s）。"), *Request.FilePath, *Request.Encode.Describe());
+			return false;
+		}
+
+		// 渐进渲染的后续各遍覆盖已有文件，中断时不能留下写了一半的图像
+		const bool bSaved = Request.Progressive.IsValid()
+			? CameraArrayProgressive::SaveFileAtomically(CompressedData.GetArray(), Request.FilePath)
+			: FFileHelper::SaveArrayToFile(CompressedData.GetArray(), *Request.FilePath);
+		if (!bSaved)
+		{
+			UE_LOG(LogTemp, Error, TEXT("保存图像文件失败: %s"), *Request.FilePath);
+			return false;
+		}
+
+		if (Request.RegionFullSize.X <= 0)
+		{
+			CameraArrayRegion::DeleteMetadata(Request.FilePath);
+		}
+		else if (!CameraArrayRegion::SaveMetadata(Request.FilePath, Request.Region, Request.RegionFullSize))
+		{
+			UE_LOG(LogTemp, Error, TEXT("保存区域信息失败: %s"), *CameraArrayRegion::GetMetadataPath(Request.FilePath));
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("成功异步保存图像到: %s"), *Request.FilePath);
+		return true;
+	}
+
+	template <typename PixelType>
+	static void ApplyDistortion(const FCameraArrayFrameWriteRequest& Request, FCameraArrayPooledBuffer& Pixels)
+	{
+		const FCameraArrayDistortionMap* Map = Request.DistortionMap.Get();
+		if (!Map || Map->Width != Request.Width || Map->Height != Request.Height || Pixels.Num<PixelType>() != static_cast<int64>(Map->Width) * Map->Height)
+		{
+			return;
+		}
+		FCameraArrayPooledBuffer Distorted(Pixels.Num());
+		Map->Apply(Pixels.GetData<PixelType>(), Distorted.GetData<PixelType>());
+		Pixels = MoveTemp(Distorted);
+	}
+
+	static FCameraArrayPooledBuffer ConvertHalfToLinear(const FCameraArrayPooledBuffer& HalfPixels)
+	{
+		const int64 NumPixels = HalfPixels.Num<FFloat16Color>();
+		FCameraArrayPooledBuffer LinearPixels(NumPixels * sizeof(FLinearColor));
+		const FFloat16Color* Src = HalfPixels.GetData<FFloat16Color>();
+		FLinearColor* Dst = LinearPixels.GetData<FLinearColor>();
+		// 每个像素的四个半精度通道一次转换
+		static_assert(sizeof(FFloat16Color) == 4 * sizeof(uint16), "FFloat16Color must be four packed halves");
+		for (int64 i = 0; i < NumPixels; ++i)
+		{
+			FPlatformMath::VectorLoadHalf(&Dst[i].R, reinterpret_cast<const uint16*>(&Src[i]));
+		}
+		return LinearPixels;
+	}
+
+	// 合并在降噪之前进行，状态文件里保存的是未降噪的均值
+	static void ApplyProgressive(const FCameraArrayFrameWriteRequest& Request, FLinearColor* Pixels)
+	{
+		Request.Progressive->MergeAndStore(Pixels, Request.Width, Request.Height);
+	}
+
+	// 降噪在畸变、联系表与打包之前进行，此时辅助通道与像素逐一对齐；用完立即归还辅助通道的缓冲
+	// 像素总是线性HDR，8位输出在降噪之后才编码为sRGB并量化
+	static void ApplyDenoise(const FCameraArrayFrameWriteRequest& Request, FLinearColor* Pixels)
+	{
+		FCameraArrayDenoiseAovs& Aovs = *Request.Denoise;
+		const int64 NumPixels = static_cast<int64>(Request.Width) * Request.Height;
+		const FFloat16Color* Albedo = Aovs.Albedo.Num<FFloat16Color>() == NumPixels ? Aovs.Albedo.GetData<FFloat16Color>() : nullptr;
+		const FFloat16Color* Normal = Aovs.Normal.Num<FFloat16Color>() == NumPixels ? Aovs.Normal.GetData<FFloat16Color>() : nullptr;
+
+		const double StartTime = FPlatformTime::Seconds();
+		const bool bDenoised = CameraArrayDenoiser::Denoise(Pixels, Albedo, Normal, Request.Width, Request.Height, true);
+		if (!bDenoised)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("为 %s 降噪失败，保存未降噪的图像。"), *Request.FilePath);
+		}
+		if (Aovs.Stats.IsValid())
+		{
+			Aovs.Stats->Record(FPlatformTime::Seconds() - StartTime, bDenoised);
+		}
+		Aovs.Albedo.Reset();
+		Aovs.Normal.Reset();
+	}
+
+	// 打包输出时只有最后到达的一目负责编码整张图像
+	static void PackAndSave(const FCameraArrayFrameWriteRequest& Request, const void* Pixels, int32 BytesPerPixel, ERGBFormat RGBFormat)
+	{
+		FCameraArrayFrameWriteRequest PackedRequest = Request;
+		FCameraArrayPooledBuffer Packed;
+		if (Request.StereoPacker->AddEye(Request.PositionIndex, Request.EyeIndex, Pixels, Request.Width, Request.Height, BytesPerPixel,
+			Packed, PackedRequest.Width, PackedRequest.Height))
+		{
+			if (!EncodeAndSave(PackedRequest, Packed.GetData(), RGBFormat))
+			{
+				UE_LOG(LogTemp, Error, TEXT("CameraArrayImageWriter: 位置 %d 的打包图像写出失败"), Request.PositionIndex);
+			}
+		}
+	}
+
+	void AbandonRequest(const FCameraArrayFrameWriteRequest& Request)
+	{
+		if (Request.StereoPacker.IsValid())
+		{
+			Request.StereoPacker->FailEye(Request.PositionIndex, Request.EyeIndex);
+		}
+		FinishRequest(Request);
+	}
+
+	void FinishRequest(const FCameraArrayFrameWriteRequest& Request)
+	{
+		if (Request.RenderCosts.IsValid())
+		{
+			Request.RenderCosts->Add(Request.JournalKey, FPlatformTime::Seconds() - Request.CaptureStartTime);
+		}
+
+		// 先归还内存再递减计数，收尾时看到计数归零就不会再有预留
+		if (Request.MemoryBudget.IsValid() && Request.ReservedBytes > 0)
+		{
+			Request.MemoryBudget->Release(Request.ReservedBytes);
+		}
+		if (Request.PendingWrites.IsValid())
+		{
+			Request.PendingWrites->Decrement();
+		}
+	}
+
+	void WriteLdrFrame(const FCameraArrayFrameWriteRequest& Request, FCameraArrayPooledBuffer&& Pixels)
+	{
+		ON_SCOPE_EXIT
+		{
+			FinishRequest(Request);
+		};
+
+		FCameraArrayPooledBuffer Local = MoveTemp(Pixels);
+		FColor* LocalPixels = Local.GetData<FColor>();
+		for (int64 i = 0; i < Local.Num<FColor>(); ++i)
+		{
+			LocalPixels[i].A = 255;
+		}
+		ApplyDistortion<FColor>(Request, Local);
+
+		if (Request.ContactSheet.IsValid())
+		{
+			Request.ContactSheet->AddFrame(Request.CameraIndex, Local.GetData<FColor>(), Request.Width, Request.Height);
+		}
+
+		if (Request.StereoPacker.IsValid())
+		{
+			PackAndSave(Request, Local.GetData(), sizeof(FColor), ERGBFormat::BGRA);
+			return;
+		}
+		EncodeAndSave(Request, Local.GetData(), ERGBFormat::BGRA);
+	}
+
+	void WriteHalfFrame(const FCameraArrayFrameWriteRequest& Request, FCameraArrayPooledBuffer&& Pixels)
+	{
+		FCameraArrayPooledBuffer HalfPixels = MoveTemp(Pixels);
+		FCameraArrayPooledBuffer LinearPixels = ConvertHalfToLinear(HalfPixels);
+		HalfPixels.Reset();
+		WriteHdrFrame(Request, MoveTemp(LinearPixels));
+	}
+
+	void WriteHalfFrameAsLdr(const FCameraArrayFrameWriteRequest& Request, FCameraArrayPooledBuffer&& Pixels)
+	{
+		FCameraArrayPooledBuffer HalfPixels = MoveTemp(Pixels);
+		const int64 NumPixels = HalfPixels.Num<FFloat16Color>();
+		FCameraArrayPooledBuffer LdrPixels(NumPixels * sizeof(FColor));
+		FColor* Dst = LdrPixels.GetData<FColor>();
+		if (Request.Progressive.IsValid() || Request.Denoise.IsValid())
+		{
+			// 渐进渲染的合并与降噪都在线性空间进行，之后再编码为sRGB，避免对量化后的值降噪
+			FCameraArrayPooledBuffer LinearPixels = ConvertHalfToLinear(HalfPixels);
+			HalfPixels.Reset();
+			FLinearColor* Src = LinearPixels.GetData<FLinearColor>();
+			if (Request.Progressive.IsValid())
+			{
+				ApplyProgressive(Request, Src);
+			}
+			if (Request.Denoise.IsValid())
+			{
+				ApplyDenoise(Request, Src);
+			}
+			for (int64 i = 0; i < NumPixels; ++i)
+			{
+				Dst[i] = Src[i].ToFColor(true);
+			}
+		}
+		else
+		{
+			const FFloat16Color* Src = HalfPixels.GetData<FFloat16Color>();
+			for (int64 i = 0; i < NumPixels; ++i)
+			{
+				Dst[i] = FLinearColor(Src[i]).ToFColor(true);
+			}
+			HalfPixels.Reset();
+		}
+		WriteLdrFrame(Request, MoveTemp(LdrPixels));
+	}
+
+	void WriteHdrFrame(const FCameraArrayFrameWriteRequest& Request, FCameraArrayPooledBuffer&& Pixels)
+	{
+		ON_SCOPE_EXIT
+		{
+			FinishRequest(Request);
+		};
+
+		// 强制 alpha = 1
+		FCameraArrayPooledBuffer LinearPixels = MoveTemp(Pixels);
+		FLinearColor* LocalPixels = LinearPixels.GetData<FLinearColor>();
+		for (int64 i = 0; i < LinearPixels.Num<FLinearColor>(); ++i)
+		{
+			LocalPixels[i].A = 1.0f;
+		}
+		if (Request.Progressive.IsValid())
+		{
+			ApplyProgressive(Request, LocalPixels);
+		}
+		if (Request.Denoise.IsValid())
+		{
+			ApplyDenoise(Request, LocalPixels);
+		}
+		ApplyDistortion<FLinearColor>(Request, LinearPixels);
+
+		if (Request.ContactSheet.IsValid())
+		{
+			Request.ContactSheet->AddFrame(Request.CameraIndex, LinearPixels.GetData<FLinearColor>(), Request.Width, Request.Height);
+		}
+
+		if (Request.StereoPacker.IsValid())
+		{
+			PackAndSave(Request, LinearPixels.GetData(), sizeof(FLinearColor), ERGBFormat::RGBAF);
+			return;
+		}
+		EncodeAndSave(Request, LinearPixels.GetData(), ERGBFormat::RGBAF);
+	}
+}
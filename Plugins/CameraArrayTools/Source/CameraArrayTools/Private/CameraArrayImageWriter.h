@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "CameraArrayManager.h"
+#include "CameraArrayImageEncoder.h"
+#include "CameraArrayBufferPool.h"
+
+class FCameraArrayContactSheet;
+class FCameraArrayStereoPacker;
+class FCameraArrayMemoryBudget;
+class FCameraArrayRenderCosts;
+struct FCameraArrayDenoiseAovs;
+struct FCameraArrayProgressiveMerge;
+struct FCameraArrayDistortionMap;
+
+// 一帧图像的写出请求：渲染线程回读完成后交给后台线程编码并保存
+struct FCameraArrayFrameWriteRequest
+{
+	FString FilePath;
+	FCameraArrayEncodeSettings Encode;
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 CameraIndex = INDEX_NONE;
+
+	// 可选：区域捕获时图像在整幅画面中的位置，保存图像后写入旁边的区域信息文件；RegionFullSize为0时删除已有的区域信息文件
+	FIntRect Region;
+	FIntPoint RegionFullSize = FIntPoint::ZeroValue;
+
+	// 可选：渐进渲染时先与之前各遍的累积均值合并，输出文件整体替换
+	TSharedPtr<const FCameraArrayProgressiveMerge, ESPMode::ThreadSafe> Progressive;
+
+	// 可选：路径追踪降噪的辅助通道，最先降噪，之后的处理都使用降噪后的图像
+	TSharedPtr<FCameraArrayDenoiseAovs, ESPMode::ThreadSafe> Denoise;
+
+	// 可选：先按镜头畸变重映射，之后的联系表与编码都使用畸变后的图像
+	TSharedPtr<const FCameraArrayDistortionMap, ESPMode::ThreadSafe> DistortionMap;
+
+	// 可选：把这一帧缩小后写入联系表
+	TSharedPtr<FCameraArrayContactSheet, ESPMode::ThreadSafe> ContactSheet;
+
+	// 可选：这一帧是某个阵列位置的一目，各目到齐后由打包器拼接，FilePath为拼好的图像路径
+	TSharedPtr<FCameraArrayStereoPacker, ESPMode::ThreadSafe> StereoPacker;
+	int32 PositionIndex = INDEX_NONE;
+	int32 EyeIndex = 0;
+
+	// 可选：写出结束时把从开始捕获到此刻的耗时记到JournalKey下
+	TSharedPtr<FCameraArrayRenderCosts, ESPMode::ThreadSafe> RenderCosts;
+	FString JournalKey;
+	double CaptureStartTime = 0.0;
+
+	// 尚未写完的帧数，无论成功与否，写出结束时都会递减
+	TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> PendingWrites;
+
+	// 捕获前为这一帧预留的内存，写出结束时与待写计数一起归还
+	TSharedPtr<FCameraArrayMemoryBudget, ESPMode::ThreadSafe> MemoryBudget;
+	int64 ReservedBytes = 0;
+};
+
+namespace CameraArrayImageWriter
+{
+	// 递减待写计数并归还预留的内存；未交给下面的写出函数就放弃的帧也要调用
+	void FinishRequest(const FCameraArrayFrameWriteRequest& Request);
+
+	// 回读失败等原因放弃这一帧：打包输出时通知打包器该位置不完整，再结束请求
+	void AbandonRequest(const FCameraArrayFrameWriteRequest& Request);
+
+	// 以下函数都在后台线程上调用；像素缓冲分别为 FColor、FFloat16Color、FLinearColor，写完后归还缓冲池
+	void WriteLdrFrame(const FCameraArrayFrameWriteRequest& Request, FCameraArrayPooledBuffer&& Pixels);
+	void WriteHalfFrame(const FCameraArrayFrameWriteRequest& Request, FCameraArrayPooledBuffer&& Pixels);
+
+	// 半精度线性像素（色调曲线之后）编码为sRGB的FColor，再按8位格式写出；渐进合并与降噪在编码之前进行
+	void WriteHalfFrameAsLdr(const FCameraArrayFrameWriteRequest& Request, FCameraArrayPooledBuffer&& Pixels);
+	void WriteHdrFrame(const FCameraArrayFrameWriteRequest& Request, FCameraArrayPooledBuffer&& Pixels);
+}
@@ -0,0 +1,238 @@
+#include "CameraArrayJobSubsystem.h"
+#include "CameraArrayManager.h"
+#include "CameraArrayMemoryBudget.h"
+#include "CameraArrayBufferPool.h"
+#include "CameraArrayReadiness.h"
+#include "CameraArrayDenoiser.h"
+#include "CameraArrayWarmUp.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "TimerManager.h"
+
+bool UCameraArrayJobSubsystem::RenderCameraArrays(const TArray<ACameraArrayManager*>& Managers)
+{
+	if (IsJobRunning())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RenderCameraArrays: 已有相机阵列任务在运行。"));
+		return false;
+	}
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return false;
+	}
+
+	TArray<ACameraArrayManager*> Candidates = Managers;
+	if (Candidates.Num() == 0)
+	{
+		for (TActorIterator<ACameraArrayManager> It(World); It; ++It)
+		{
+			Candidates.Add(*It);
+		}
+	}
+
+	JobManagers.Reset();
+	for (ACameraArrayManager* Manager : Candidates)
+	{
+		if (IsValid(Manager) && !Manager->bIsTaskRunning && Manager->ManagedCameras.Num() > 0)
+		{
+			JobManagers.AddUnique(Manager);
+		}
+		else if (IsValid(Manager))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("RenderCameraArrays: 跳过 %s（正在渲染或没有相机）。"), *Manager->GetActorNameOrLabel());
+		}
+	}
+
+	if (JobManagers.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("RenderCameraArrays: 没有可渲染的相机阵列。"));
+		return false;
+	}
+
+	JobStartTime = FPlatformTime::Seconds();
+	PendingWrites = MakeShared<FThreadSafeCounter, ESPMode::ThreadSafe>();
+
+	// 只要有一个阵列使用视口截图，就在任务开始时保存一次视口状态；后台渲染的阵列不接管视口
+	ACameraArrayManager* Owner = GetResourceOwner();
+	MemoryBudget = Owner->CreateFrameMemoryBudget();
+	bSavedViewportState = false;
+	for (ACameraArrayManager* Manager : JobManagers)
+	{
+		if (!Manager->UsesSceneCapture(false))
+		{
+			Owner->SaveOriginalViewportState();
+			bSavedViewportState = true;
+			break;
+		}
+	}
+
+	for (ACameraArrayManager* Manager : JobManagers)
+	{
+		Manager->LockEditorProperties();
+		Manager->RenderStatus = TEXT("排队中...");
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("RenderCameraArrays: 开始渲染 %d 个相机阵列。"), JobManagers.Num());
+	CurrentManagerIndex = -1;
+	StartNextManager();
+	return true;
+}
+
+ACameraArrayManager* UCameraArrayJobSubsystem::GetResourceOwner() const
+{
+	return JobManagers.Num() > 0 ? JobManagers[0].Get() : nullptr;
+}
+
+void UCameraArrayJobSubsystem::StartNextManager()
+{
+	while (++CurrentManagerIndex < JobManagers.Num())
+	{
+		ACameraArrayManager* Manager = JobManagers[CurrentManagerIndex];
+		if (!IsValid(Manager))
+		{
+			continue;
+		}
+
+		Manager->ActiveJob = this;
+		Manager->PendingFrameWrites = PendingWrites;
+		Manager->ActiveMemoryBudget = MemoryBudget;
+		Manager->BorrowCaptureResources(GetResourceOwner());
+		Manager->StartBatchCapture(false);
+		if (Manager->bIsTaskRunning)
+		{
+			return;
+		}
+
+		// 启动失败：归还借用的资源，继续下一个阵列
+		Manager->ActiveJob = nullptr;
+		Manager->ReleaseBorrowedCaptureResources();
+	}
+
+	FinishJob();
+}
+
+void UCameraArrayJobSubsystem::NotifyManagerFinished(ACameraArrayManager* Manager)
+{
+	if (!IsJobRunning() || !JobManagers.IsValidIndex(CurrentManagerIndex) || JobManagers[CurrentManagerIndex] != Manager)
+	{
+		return;
+	}
+
+	Manager->RenderStatus = TEXT("等待写出...");
+	StartNextManager();
+}
+
+void UCameraArrayJobSubsystem::FinishJob()
+{
+	UWorld* World = GetWorld();
+
+	// 所有阵列共用一个待写计数，只在最后等待一次
+	if (World && PendingWrites.IsValid() && PendingWrites->GetValue() > 0)
+	{
+		World->GetTimerManager().SetTimer(FinishTimerHandle, this, &UCameraArrayJobSubsystem::FinishJob, 0.1f, false);
+		return;
+	}
+
+	// 视口截图由引擎在帧末写文件，整个任务只等待这一次
+	ACameraArrayManager* Owner = GetResourceOwner();
+	for (ACameraArrayManager* Manager : JobManagers)
+	{
+		if (IsValid(Manager) && Manager->ActiveJob == this)
+		{
+			if (Manager->ActiveWarmUpStats.IsValid())
+			{
+				UE_LOG(LogTemp, Log, TEXT("RenderCameraArrays: %s %s"), *Manager->GetActorNameOrLabel(), *Manager->ActiveWarmUpStats->Describe());
+			}
+			if (Manager->ActiveReadinessStats.IsValid())
+			{
+				UE_LOG(LogTemp, Log, TEXT("RenderCameraArrays: %s %s"), *Manager->GetActorNameOrLabel(), *Manager->ActiveReadinessStats->Describe());
+			}
+			if (Manager->ActiveDenoiseStats.IsValid())
+			{
+				UE_LOG(LogTemp, Log, TEXT("RenderCameraArrays: %s %s"), *Manager->GetActorNameOrLabel(), *Manager->ActiveDenoiseStats->Describe());
+			}
+			Manager->FinalizeBatchOutputs();
+			Manager->RenderProgress = 100;
+			Manager->RenderStatus = TEXT("完成");
+			Manager->EndCaptureTask();
+		}
+	}
+
+	if (IsValid(Owner))
+	{
+		if (bSavedViewportState)
+		{
+			Owner->RestoreOriginalViewportState();
+		}
+		Owner->OpenOutputFolder();
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("RenderCameraArrays: %d 个相机阵列全部完成，总耗时 %.2f 秒。"),
+		JobManagers.Num(), FPlatformTime::Seconds() - JobStartTime);
+	if (MemoryBudget.IsValid())
+	{
+		UE_LOG(LogTemp, Log, TEXT("RenderCameraArrays: %s"), *MemoryBudget->Describe());
+	}
+	UE_LOG(LogTemp, Log, TEXT("RenderCameraArrays: %s"), *FCameraArrayBufferPool::Get().Describe());
+	FCameraArrayBufferPool::Get().Trim();
+	ResetJob();
+}
+
+void UCameraArrayJobSubsystem::CancelJob()
+{
+	if (!IsJobRunning())
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("RenderCameraArrays: 正在终止相机阵列任务..."));
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(FinishTimerHandle);
+	}
+
+	ACameraArrayManager* Owner = GetResourceOwner();
+	for (ACameraArrayManager* Manager : JobManagers)
+	{
+		if (!IsValid(Manager))
+		{
+			continue;
+		}
+
+		if (Manager->ActiveJob == this)
+		{
+			Manager->ClearAllTimers();
+			Manager->SaveRenderJournal();
+			Manager->EndCaptureTask();
+			Manager->RenderStatus = TEXT("已强行终止");
+		}
+		else
+		{
+			Manager->UnlockEditorProperties();
+			Manager->RenderStatus = TEXT("未开始");
+		}
+	}
+
+	if (IsValid(Owner) && bSavedViewportState)
+	{
+		Owner->RestoreOriginalViewportState();
+	}
+	ResetJob();
+}
+
+void UCameraArrayJobSubsystem::ResetJob()
+{
+	JobManagers.Reset();
+	CurrentManagerIndex = INDEX_NONE;
+	bSavedViewportState = false;
+	PendingWrites.Reset();
+	MemoryBudget.Reset();
+}
+
+void UCameraArrayJobSubsystem::Deinitialize()
+{
+	CancelJob();
+	Super::Deinitialize();
+}
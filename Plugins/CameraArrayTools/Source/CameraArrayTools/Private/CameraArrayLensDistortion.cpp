@@ -0,0 +1,96 @@
+#include "CameraArrayLensDistortion.h"
+#include "Async/ParallelFor.h"
+#include "Hash/xxhash.h"
+
+TSharedRef<const FCameraArrayDistortionMap, ESPMode::ThreadSafe> FCameraArrayDistortionMap::Build(const FCameraArrayIntrinsics& Intrinsics, int32 Width, int32 Height)
+{
+	check(Width >= 2 && Height >= 2);
+	TSharedRef<FCameraArrayDistortionMap, ESPMode::ThreadSafe> Map = MakeShared<FCameraArrayDistortionMap, ESPMode::ThreadSafe>();
+	Map->Width = Width;
+	Map->Height = Height;
+
+	const FCameraArrayIntrinsics K = Intrinsics.ScaledTo(Width, Height);
+	const int64 NumPixels = static_cast<int64>(Width) * Height;
+
+	// 第一遍：每个输出像素反解畸变得到归一化光线坐标（与OpenCV undistortPoints相同的不动点迭代）
+	TArray<FVector2f> Rays;
+	Rays.SetNumUninitialized(NumPixels);
+	ParallelFor(Height, [&](int32 Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const double DistortedX = (X - K.Cx) / K.Fx;
+			const double DistortedY = (Y - K.Cy) / K.Fy;
+			double RayX = DistortedX;
+			double RayY = DistortedY;
+			for (int32 Iteration = 0; Iteration < 20; ++Iteration)
+			{
+				const double R2 = RayX * RayX + RayY * RayY;
+				const double Radial = 1.0 + R2 * (K.K1 + R2 * (K.K2 + R2 * K.K3));
+				const double DeltaX = 2.0 * K.P1 * RayX * RayY + K.P2 * (R2 + 2.0 * RayX * RayX);
+				const double DeltaY = K.P1 * (R2 + 2.0 * RayY * RayY) + 2.0 * K.P2 * RayX * RayY;
+				if (Radial <= UE_KINDA_SMALL_NUMBER)
+				{
+					break; // 超出畸变模型的有效范围
+				}
+				RayX = (DistortedX - DeltaX) / Radial;
+				RayY = (DistortedY - DeltaY) / Radial;
+			}
+			Rays[static_cast<int64>(Y) * Width + X] = FVector2f(static_cast<float>(RayX), static_cast<float>(RayY));
+		}
+	});
+
+	// 理想图像的焦距取能容纳所有光线的最大值，渲染视角因此只比标定视角略大
+	double MaxRayX = UE_KINDA_SMALL_NUMBER;
+	double MaxRayY = UE_KINDA_SMALL_NUMBER;
+	for (const FVector2f& Ray : Rays)
+	{
+		MaxRayX = FMath::Max(MaxRayX, static_cast<double>(FMath::Abs(Ray.X)));
+		MaxRayY = FMath::Max(MaxRayY, static_cast<double>(FMath::Abs(Ray.Y)));
+	}
+	const double RenderFocal = FMath::Min(Width * 0.5 / MaxRayX, Height * 0.5 / MaxRayY);
+	Map->RenderFOV = static_cast<float>(FMath::RadiansToDegrees(2.0 * FMath::Atan(Width / (2.0 * RenderFocal))));
+
+	// 第二遍：光线投影到理想图像，生成双线性采样块
+	Map->Taps.SetNumUninitialized(NumPixels);
+	ParallelFor(Height, [&](int32 Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const int64 Index = static_cast<int64>(Y) * Width + X;
+			const double SrcX = RenderFocal * Rays[Index].X + Width * 0.5 - 0.5;
+			const double SrcY = RenderFocal * Rays[Index].Y + Height * 0.5 - 0.5;
+			const int32 X0 = FMath::Clamp(FMath::FloorToInt32(SrcX), 0, Width - 2);
+			const int32 Y0 = FMath::Clamp(FMath::FloorToInt32(SrcY), 0, Height - 2);
+
+			CameraArrayImageResample::FBilinearTap& Tap = Map->Taps[Index];
+			Tap.Offset = static_cast<uint32>(static_cast<int64>(Y0) * Width + X0);
+			Tap.WeightX = CameraArrayImageResample::FBilinearTap::QuantizeWeight(SrcX - X0);
+			Tap.WeightY = CameraArrayImageResample::FBilinearTap::QuantizeWeight(SrcY - Y0);
+		}
+	});
+
+	return Map;
+}
+
+uint64 FCameraArrayDistortionMap::MakeCacheKey(const FCameraArrayIntrinsics& Intrinsics, int32 Width, int32 Height)
+{
+	const FCameraArrayIntrinsics K = Intrinsics.ScaledTo(Width, Height);
+	const double Values[] = { K.Fx, K.Fy, K.Cx, K.Cy, K.K1, K.K2, K.K3, K.P1, K.P2 };
+	const int32 Size[] = { Width, Height };
+
+	FXxHash64Builder Builder;
+	Builder.Update(Values, sizeof(Values));
+	Builder.Update(Size, sizeof(Size));
+	return Builder.Finalize().Hash;
+}
+
+void FCameraArrayDistortionMap::Apply(const FColor* Src, FColor* Dst) const
+{
+	CameraArrayImageResample::RemapBilinear(Taps.GetData(), Width, Height, Src, Width, Dst);
+}
+
+void FCameraArrayDistortionMap::Apply(const FLinearColor* Src, FLinearColor* Dst) const
+{
+	CameraArrayImageResample::RemapBilinear(Taps.GetData(), Width, Height, Src, Width, Dst);
+}
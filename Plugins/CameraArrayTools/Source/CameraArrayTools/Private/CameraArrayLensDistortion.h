@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraArrayIntrinsics.h"
+#include "CameraArrayImageResample.h"
+
+// 镜头畸变重映射表：先按覆盖所有畸变光线的视角渲染一张居中的理想针孔图像，
+// 再对输出的每个像素按标定内参反解畸变得到光线方向，在理想图像中双线性采样
+// 只与内参和分辨率有关，内参相同的相机共用一张表
+struct FCameraArrayDistortionMap
+{
+	int32 Width = 0;
+	int32 Height = 0;
+
+	// 渲染理想针孔图像时使用的水平视角（度）
+	float RenderFOV = 90.0f;
+
+	TArray<CameraArrayImageResample::FBilinearTap> Taps;
+
+	static TSharedRef<const FCameraArrayDistortionMap, ESPMode::ThreadSafe> Build(const FCameraArrayIntrinsics& Intrinsics, int32 Width, int32 Height);
+	static uint64 MakeCacheKey(const FCameraArrayIntrinsics& Intrinsics, int32 Width, int32 Height);
+
+	// Src为按RenderFOV渲染的Width*Height图像，Dst为同尺寸的畸变后图像
+	void Apply(const FColor* Src, FColor* Dst) const;
+	void Apply(const FLinearColor* Src, FLinearColor* Dst) const;
+};
@@ -8,6 +8,7 @@
 #include "Misc/FileHelper.h"
 #include "HAL/PlatformProcess.h"
 #include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
 #include "Async/Async.h"
 #include "IImageWrapperModule.h"
 #include "IImageWrapper.h"
@@ -19,6 +20,36 @@
 #include "RHIResources.h"
 #include "RenderCore.h"
 #include "RenderingThread.h"
+#include "CameraArrayViewHash.h"
+#include "CameraArrayImageWriter.h"
+#include "CameraArrayContactSheet.h"
+#include "CameraArrayJobSubsystem.h"
+#include "CameraArrayStereoPacker.h"
+#include "CameraArrayPanorama.h"
+#include "CameraArrayLensDistortion.h"
+#include "CameraArrayCalibration.h"
+#include "CameraArrayRigImport.h"
+#include "CameraArrayImageEncoder.h"
+#include "CameraArrayEncodeBenchmark.h"
+#include "CameraArrayMemoryBudget.h"
+#include "CameraArrayBufferPool.h"
+#include "CameraArrayReadback.h"
+#include "CameraArrayReadiness.h"
+#include "CameraArrayWarmUp.h"
+#include "CameraArrayAccumulation.h"
+#include "CameraArrayDenoiser.h"
+#include "CameraArrayProgressive.h"
+#include "CameraArrayRegion.h"
+#include "CameraArraySpatialIndex.h"
+#include "CameraArrayDisplay.h"
+#include "CameraArrayCoverage.h"
+#include "Components/LineBatchComponent.h"
+#include "EngineUtils.h"
+#include "ImageUtils.h"
+#include "ImageCore.h"
+#include "Misc/ScopeExit.h"
+#include "LevelSequenceActor.h"
+#include "LevelSequencePlayer.h"
 #if WITH_EDITOR
 #include "Editor.h"
 #include "Selection.h"
@@ -33,6 +64,28 @@
 ACameraArrayManager::ACameraArrayManager()
 {
 	PrimaryActorTick.bCanEverTick = true;
+
+	// 线段在世界空间中，组件不需要挂到根组件上；只在编辑器视口中显示
+	CameraDisplayComponent = CreateDefaultSubobject<ULineBatchComponent>(TEXT("CameraDisplay"));
+	CameraDisplayComponent->SetHiddenInGame(true);
+#if WITH_EDITOR
+	CameraDisplayComponent->SetIsVisualizationComponent(true);
+#endif
+	CameraDisplayComponent->bCalculateAccurateBounds = false;
+}
+
+void ACameraArrayManager::PostRegisterAllComponents()
+{
+	Super::PostRegisterAllComponents();
+
+#if WITH_EDITOR
+	// 加载关卡时相机可能还没有注册，下一帧再重建线框并隐藏相机自带的模型
+	UWorld* World = GetWorld();
+	if (World && World->WorldType == EWorldType::Editor && !IsTemplate())
+	{
+		World->GetTimerManager().SetTimerForNextTick(this, &ACameraArrayManager::RebuildCameraDisplay);
+	}
+#endif
 }
 
 void ACameraArrayManager::BeginPlay()
@@ -43,33 +96,64 @@ void ACameraArrayManager::BeginPlay()
 
 void ACameraArrayManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	// 分帧生成中离开关卡时保留已生成的相机并结束事务，不把事务留给下一个操作
+	if (bIsSpawningCameras)
+	{
+		FinishCameraSpawn(true);
+	}
+
 	// 清理所有定时器以防止内存泄漏
 #if WITH_EDITOR
 	ClearAllTimers();
 #endif
 	
+	DiscardIncompleteStereoPairs();
+	ReleaseBorrowedCaptureResources();
 	if (ReusableCaptureComponent)
 	{
 		ReusableCaptureComponent->DestroyComponent();
 		ReusableCaptureComponent = nullptr;
 	}
-	if (ReusableHdrRenderTarget)
+	if (ReusableHdrRenderTarget && ReusableHdrRenderTarget->GetOuter() == this)
 	{
 		ReusableHdrRenderTarget->MarkAsGarbage();
-		ReusableHdrRenderTarget = nullptr;
 	}
-	if (ReusableLdrRenderTarget)
+	ReusableHdrRenderTarget = nullptr;
+	if (ReusableLdrRenderTarget && ReusableLdrRenderTarget->GetOuter() == this)
 	{
 		ReusableLdrRenderTarget->MarkAsGarbage();
-		ReusableLdrRenderTarget = nullptr;
 	}
+	ReusableLdrRenderTarget = nullptr;
 	Super::EndPlay(EndPlayReason);
 }
 
+void ACameraArrayManager::Destroyed()
+{
+	// 编辑器中删除管理器不会调用EndPlay，生成中的事务在这里结束
+	if (bIsSpawningCameras)
+	{
+		FinishCameraSpawn(true);
+	}
+#if WITH_EDITOR
+	if (GEngine && ActorMovedHandle.IsValid())
+	{
+		GEngine->OnActorMoved().Remove(ActorMovedHandle);
+		ActorMovedHandle.Reset();
+	}
+#endif
+	Super::Destroyed();
+}
+
 #if WITH_EDITOR
 // 添加清理所有定时器的函数
 void ACameraArrayManager::ClearAllTimers()
 {
+	// 生成相机的定时器与编辑器事务一起结束
+	if (bIsSpawningCameras)
+	{
+		FinishCameraSpawn(true);
+	}
+
 	if (GetWorld())
 	{
 		FTimerManager& TimerManager = GetWorld()->GetTimerManager();
@@ -88,12 +172,17 @@ void ACameraArrayManager::ClearAllTimers()
 		{
 			TimerManager.ClearTimer(RenderTimerHandle);
 		}
+
+		TimerManager.ClearTimer(ContactSheetTimerHandle);
+		TimerManager.ClearTimer(SpawnTimerHandle);
 	}
 	
 	// 重置所有定时器句柄
 	ScreenshotTimerHandle.Invalidate();
 	PathTracingLogTimerHandle.Invalidate();
 	RenderTimerHandle.Invalidate();
+	ContactSheetTimerHandle.Invalidate();
+	SpawnTimerHandle.Invalidate();
 }
 
 void ACameraArrayManager::SaveOriginalViewportState()
@@ -196,14 +285,33 @@ void ACameraArrayManager::PostEditChangeProperty(FPropertyChangedEvent& Property
 		return;
 	}
 
-	// 只有相机数量改变时，才执行完全重建
-	if (MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, NumCameras))
+	// 相机位姿、FOV与查询距离都可能随属性变化，重建代价很小，不逐个区分
+	bSpatialIndexDirty = true;
+
+	// 只有相机数量或相机组合改变时，才执行完全重建
+	if (MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, NumCameras) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, RigPreset) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, NumEyes))
 	{
 		CreateOrUpdateCameras();
 	}
+	// 导入的相机阵列没有参数化布局，不随位置/旋转参数变化
+	else if (!ImportedCameraNames.IsEmpty() &&
+		(MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, TotalYDistance) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, StartLocation) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, InteraxialDistance) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, ConvergenceDistance) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, SharedRotation) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, bUseLookAtTarget) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, LookAtTarget)))
+	{
+		UE_LOG(LogTemp, Log, TEXT("相机来自导入的阵列文件，布局参数不生效；重新生成相机可恢复参数化布局。"));
+	}
 	// 只更新位置，保留手动调整过的旋转
 	else if (MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, TotalYDistance) ||
-		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, StartLocation))
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, StartLocation) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, InteraxialDistance) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, ConvergenceDistance))
 	{
 		for (int32 i = 0; i < ManagedCameras.Num(); ++i)
 		{
@@ -244,22 +352,23 @@ void ACameraArrayManager::PostEditChangeProperty(FPropertyChangedEvent& Property
 		{
 			if (AActor* Camera = ManagedCameras[i])
 			{
-				const FString NewLabel = FString::Printf(TEXT("%s_%03d"), *CameraNamePrefix, i);
+				const FString NewLabel = GetCameraBaseName(i);
 				Camera->SetActorLabel(NewLabel); // 更新Actor在编辑器中的名字
 				Camera->SetFolderPath(FolderName); // 更新文件夹
 			}
 		}
 	}
 	// 只更新FOV
-	else if (MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, CameraFOV))
+	else if (MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, CameraFOV) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ACameraArrayManager, CameraIntrinsics))
 	{
-		for (AActor* Camera : ManagedCameras)
+		for (int32 i = 0; i < ManagedCameras.Num(); ++i)
 		{
-			if (Camera)
+			if (AActor* Camera = ManagedCameras[i])
 			{
 				if (UCineCameraComponent* CineCamComponent = Camera->FindComponentByClass<UCineCameraComponent>())
 				{
-					CineCamComponent->SetFieldOfView(CameraFOV);
+					CineCamComponent->SetFieldOfView(GetCameraFOV(i));
 				}
 			}
 		}
@@ -282,6 +391,17 @@ void ACameraArrayManager::PostEditChangeProperty(FPropertyChangedEvent& Property
 			}
 		}
 	}
+
+	RebuildCameraDisplay();
+}
+
+void ACameraArrayManager::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	// 撤销可能恢复或删除了相机
+	bSpatialIndexDirty = true;
+	RebuildCameraDisplay();
 }
 
 void ACameraArrayManager::SyncShowFlagsWithEditorViewport()
@@ -337,39 +457,102 @@ void ACameraArrayManager::InitializeCaptureComponents()
 		ReusableCaptureComponent->RegisterComponentWithWorld(GetWorld());
 	}
 
+	const FIntPoint Resolution = GetCaptureResolution();
+
+	// 借来的RenderTarget属于其他阵列，尺寸不符时换成自己的，不能标记为垃圾
 	// --- LDR Render Target (for PNG, JPG, BMP, TGA) ---
-	if (!IsValid(ReusableLdrRenderTarget) || ReusableLdrRenderTarget->SizeX != RenderTargetX || ReusableLdrRenderTarget
-		->SizeY != RenderTargetY)
+	if (!IsValid(ReusableLdrRenderTarget) || ReusableLdrRenderTarget->SizeX != Resolution.X || ReusableLdrRenderTarget
+		->SizeY != Resolution.Y)
 	{
-		if (ReusableLdrRenderTarget)
+		if (ReusableLdrRenderTarget && ReusableLdrRenderTarget->GetOuter() == this)
 		{
 			ReusableLdrRenderTarget->MarkAsGarbage();
 		}
 		ReusableLdrRenderTarget = NewObject<UTextureRenderTarget2D>(this, TEXT("ReusableLdrRenderTarget"));
 		ReusableLdrRenderTarget->RenderTargetFormat = RTF_RGBA8;
-		ReusableLdrRenderTarget->SizeX = RenderTargetX;
-		ReusableLdrRenderTarget->SizeY = RenderTargetY;
+		ReusableLdrRenderTarget->SizeX = Resolution.X;
+		ReusableLdrRenderTarget->SizeY = Resolution.Y;
 		ReusableLdrRenderTarget->bAutoGenerateMips = false;
 		ReusableLdrRenderTarget->UpdateResource();
 	}
 
 	// --- HDR Render Target (for EXR, TIFF, HDR) ---
-	if (!IsValid(ReusableHdrRenderTarget) || ReusableHdrRenderTarget->SizeX != RenderTargetX || ReusableHdrRenderTarget
-		->SizeY != RenderTargetY)
+	if (!IsValid(ReusableHdrRenderTarget) || ReusableHdrRenderTarget->SizeX != Resolution.X || ReusableHdrRenderTarget
+		->SizeY != Resolution.Y)
 	{
-		if (ReusableHdrRenderTarget)
+		if (ReusableHdrRenderTarget && ReusableHdrRenderTarget->GetOuter() == this)
 		{
 			ReusableHdrRenderTarget->MarkAsGarbage();
 		}
 		ReusableHdrRenderTarget = NewObject<UTextureRenderTarget2D>(this, TEXT("ReusableHdrRenderTarget"));
 		ReusableHdrRenderTarget->RenderTargetFormat = RTF_RGBA16f;
-		ReusableHdrRenderTarget->SizeX = RenderTargetX;
-		ReusableHdrRenderTarget->SizeY = RenderTargetY;
+		ReusableHdrRenderTarget->SizeX = Resolution.X;
+		ReusableHdrRenderTarget->SizeY = Resolution.Y;
 		ReusableHdrRenderTarget->bAutoGenerateMips = false;
 		ReusableHdrRenderTarget->UpdateResource();
 	}
 }
 
+FIntPoint ACameraArrayManager::GetCaptureResolution() const
+{
+	if (bIsPreviewPass)
+	{
+		return FIntPoint(
+			FMath::Max(1, FMath::RoundToInt(RenderTargetX * PreviewResolutionScale)),
+			FMath::Max(1, FMath::RoundToInt(RenderTargetY * PreviewResolutionScale)));
+	}
+	return FIntPoint(FMath::Max(1, RenderTargetX), FMath::Max(1, RenderTargetY));
+}
+
+void ACameraArrayManager::BorrowCaptureResources(ACameraArrayManager* Owner)
+{
+	if (!IsValid(Owner) || Owner == this || IsValid(ReusableCaptureComponent))
+	{
+		return;
+	}
+
+	// 借用方会在PrepareSceneCapture中重新同步自己的ShowFlags与后处理设置
+	Owner->InitializeCaptureComponents();
+	ReusableCaptureComponent = Owner->ReusableCaptureComponent;
+
+	// RenderTarget只在分辨率与格式完全一致时共用，否则借用方在InitializeCaptureComponents中创建自己的
+	// 合并任务不做快速预览，按完整分辨率比较
+	const FIntPoint Resolution(FMath::Max(1, RenderTargetX), FMath::Max(1, RenderTargetY));
+	auto Matches = [&Resolution](const UTextureRenderTarget2D* Target, ETextureRenderTargetFormat Format)
+	{
+		return IsValid(Target) && Target->SizeX == Resolution.X && Target->SizeY == Resolution.Y && Target->RenderTargetFormat == Format;
+	};
+	if (!Matches(ReusableLdrRenderTarget, RTF_RGBA8) && Matches(Owner->ReusableLdrRenderTarget, RTF_RGBA8))
+	{
+		ReusableLdrRenderTarget = Owner->ReusableLdrRenderTarget;
+	}
+	if (!Matches(ReusableHdrRenderTarget, RTF_RGBA16f) && Matches(Owner->ReusableHdrRenderTarget, RTF_RGBA16f))
+	{
+		ReusableHdrRenderTarget = Owner->ReusableHdrRenderTarget;
+	}
+	bBorrowedCaptureResources = true;
+}
+
+void ACameraArrayManager::ReleaseBorrowedCaptureResources()
+{
+	if (!bBorrowedCaptureResources)
+	{
+		return;
+	}
+
+	// 只归还借来的RenderTarget，分辨率不同时自己创建的留到下次复用
+	ReusableCaptureComponent = nullptr;
+	if (ReusableLdrRenderTarget && ReusableLdrRenderTarget->GetOuter() != this)
+	{
+		ReusableLdrRenderTarget = nullptr;
+	}
+	if (ReusableHdrRenderTarget && ReusableHdrRenderTarget->GetOuter() != this)
+	{
+		ReusableHdrRenderTarget = nullptr;
+	}
+	bBorrowedCaptureResources = false;
+}
+
 void ACameraArrayManager::CreateOrUpdateCameras()
 {
 	if (bIsTaskRunning)
@@ -377,65 +560,194 @@ void ACameraArrayManager::CreateOrUpdateCameras()
 		UE_LOG(LogTemp, Warning, TEXT("CreateOrUpdateCameras: 无法在渲染任务进行中刷新相机。"));
 		return;
 	}
+	UWorld* const World = GetWorld();
+	if (!World)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("CreateOrUpdateCameras: 获取UWorld失败。"));
+		return;
+	}
+
 	// 在创建新相机前清理现有定时器
 #if WITH_EDITOR
 	ClearAllTimers();
 #endif
-	
-	ClearAllCameras();
 
-	UWorld* const World = GetWorld();
-	if (!World)
+	BeginCameraSpawn(TEXT("CreateOrUpdateCameras"));
+	ImportedCameraNames.Reset();
+
+	// 导入阵列带来的内参按导入的相机排列，与参数化布局的相机不对应
+	if (bIntrinsicsFromRigImport)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("CreateOrUpdateCameras: 获取UWorld失败。"));
-		return;
+		UE_LOG(LogTemp, Log, TEXT("CreateOrUpdateCameras: 恢复参数化布局，清除随相机阵列导入的 %d 组内参。"), CameraIntrinsics.Num());
+		CameraIntrinsics.Reset();
+		bIntrinsicsFromRigImport = false;
 	}
 
 	if (NumCameras <= 0)
 	{
 		UE_LOG(LogTemp, Log, TEXT("CreateOrUpdateCameras: NumCameras为0，不创建相机。"));
+		FinishCameraSpawn(false);
 		return;
 	}
 
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.Owner = this;
-
-	for (int32 i = 0; i < NumCameras; ++i)
+	// 位姿在开始时一次算好，生成期间属性已锁定
+	const int32 NumCamerasToSpawn = NumCameras * GetEyesPerPosition();
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(NumCamerasToSpawn);
+	for (int32 i = 0; i < NumCamerasToSpawn; ++i)
 	{
-		const FTransform CameraTransform = GetCameraTransform(i);
-		ACineCameraActor* NewCamera = World->SpawnActor<ACineCameraActor>(
-			ACineCameraActor::StaticClass(), CameraTransform, SpawnParams);
-
-		if (NewCamera)
-		{
-			UCineCameraComponent* CineCamComponent = NewCamera->GetCineCameraComponent();
-			if (CineCamComponent)
-			{
-				CineCamComponent->SetFieldOfView(CameraFOV);
+		Transforms.Add(GetCameraTransform(i));
+	}
+	StartTimeSlicedSpawn(MoveTemp(Transforms));
+}
 
-				if (RenderTargetY > 0 && RenderTargetX > 0)
-				{
-					const float DesiredAspectRatio = static_cast<float>(RenderTargetX) / static_cast<float>(
-						RenderTargetY);
-					CineCamComponent->Filmback.SensorHeight = CineCamComponent->Filmback.SensorWidth /
-						DesiredAspectRatio;
-				}
-			}
+void ACameraArrayManager::BeginCameraSpawn(const TCHAR* Context)
+{
+	SpawnContext = Context;
+	SpawnStartTime = FPlatformTime::Seconds();
+	bIsSpawningCameras = true;
+	bIsTaskRunning = true;
+	LockEditorProperties();
+	RenderProgress = 0;
+	RenderStatus = TEXT("生成相机中...");
 
-			FString CameraLabel = FString::Printf(TEXT("%s_%03d"), *CameraNamePrefix, i);
 #if WITH_EDITOR
-			NewCamera->SetActorLabel(CameraLabel);
+	// 事务跨越多帧，期间编辑器拒绝撤销，结束后整个阵列的删除与生成一次撤销
+	if (GEditor && !GIsTransacting)
+	{
+		GEditor->BeginTransaction(TEXT("CameraArrayTools"), FText::FromString(TEXT("生成相机阵列")), this);
+		bSpawnTransactionOpen = true;
+	}
+	Modify();
 #endif
+	DestroyManagedCameras();
+}
+
+void ACameraArrayManager::StartTimeSlicedSpawn(TArray<FTransform>&& Transforms)
+{
+	PendingSpawnTransforms = MoveTemp(Transforms);
+	NextSpawnIndex = 0;
+	ManagedCameras.Reserve(PendingSpawnTransforms.Num());
+	if (PendingSpawnTransforms.IsEmpty())
+	{
+		FinishCameraSpawn(false);
+		return;
+	}
+
+	// 第一片同步执行，相机少时与之前一样在本次调用内完成
+	SpawnNextCameraSlice();
+}
+
+void ACameraArrayManager::SpawnNextCameraSlice()
+{
+	SpawnTimerHandle.Invalidate();
+	if (!bIsSpawningCameras)
+	{
+		return;
+	}
+	if (!GetWorld())
+	{
+		FinishCameraSpawn(true);
+		return;
+	}
+
+	// 每片至少生成一个相机
+	const double Deadline = FPlatformTime::Seconds() + FMath::Max(SpawnFrameBudgetMs, 1.0f) / 1000.0;
+	do
+	{
+		const int32 CameraIndex = NextSpawnIndex++;
+		if (ACineCameraActor* NewCamera = SpawnManagedCamera(CameraIndex, PendingSpawnTransforms[CameraIndex]))
+		{
 			ManagedCameras.Add(NewCamera);
+			bSpatialIndexDirty = true;
 		}
 		else
 		{
-			UE_LOG(LogTemp, Warning, TEXT("CreateOrUpdateCameras: 生成相机 %d 失败。"), i);
+			UE_LOG(LogTemp, Warning, TEXT("%s: 生成相机 %s 失败。"), SpawnContext, *GetCameraBaseName(CameraIndex));
+		}
+	}
+	while (NextSpawnIndex < PendingSpawnTransforms.Num() && FPlatformTime::Seconds() < Deadline);
+
+	if (NextSpawnIndex >= PendingSpawnTransforms.Num())
+	{
+		FinishCameraSpawn(false);
+		return;
+	}
+
+	RenderProgress = FMath::RoundToInt(static_cast<float>(NextSpawnIndex) / PendingSpawnTransforms.Num() * 100.0f);
+	RenderStatus = FString::Printf(TEXT("生成相机中... (%d/%d)"), NextSpawnIndex, PendingSpawnTransforms.Num());
+	SpawnTimerHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ACameraArrayManager::SpawnNextCameraSlice);
+}
+
+void ACameraArrayManager::FinishCameraSpawn(bool bCancelled)
+{
+	if (!bIsSpawningCameras)
+	{
+		return;
+	}
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(SpawnTimerHandle);
+	}
+
+#if WITH_EDITOR
+	if (bSpawnTransactionOpen)
+	{
+		if (GEditor)
+		{
+			GEditor->EndTransaction();
+		}
+		bSpawnTransactionOpen = false;
+	}
+#endif
+
+	RebuildCameraDisplay();
+
+	const int32 NumRequested = PendingSpawnTransforms.Num();
+	PendingSpawnTransforms.Empty();
+	NextSpawnIndex = 0;
+	bIsSpawningCameras = false;
+	bIsTaskRunning = false;
+	UnlockEditorProperties();
+	RenderProgress = bCancelled ? 0 : 100;
+	RenderStatus = bCancelled ? TEXT("已终止生成相机") : TEXT("未开始");
+
+	UE_LOG(LogTemp, Log, TEXT("%s: %s %d/%d 个相机，耗时 %.2f 秒。"), SpawnContext, bCancelled ? TEXT("终止，已生成") : TEXT("成功创建或更新了"),
+		ManagedCameras.Num(), NumRequested, FPlatformTime::Seconds() - SpawnStartTime);
+}
+
+ACineCameraActor* ACameraArrayManager::SpawnManagedCamera(int32 CameraIndex, const FTransform& CameraTransform)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = this;
+
+	ACineCameraActor* NewCamera = GetWorld()->SpawnActor<ACineCameraActor>(
+		ACineCameraActor::StaticClass(), CameraTransform, SpawnParams);
+	if (!NewCamera)
+	{
+		return nullptr;
+	}
+
+	UCineCameraComponent* CineCamComponent = NewCamera->GetCineCameraComponent();
+	if (CineCamComponent)
+	{
+		CineCamComponent->SetFieldOfView(GetCameraFOV(CameraIndex));
+
+		if (RenderTargetY > 0 && RenderTargetX > 0)
+		{
+			const float DesiredAspectRatio = static_cast<float>(RenderTargetX) / static_cast<float>(
+				RenderTargetY);
+			CineCamComponent->Filmback.SensorHeight = CineCamComponent->Filmback.SensorWidth /
+				DesiredAspectRatio;
 		}
 	}
 
-	OrganizeCamerasInFolder();
-	UE_LOG(LogTemp, Log, TEXT("CreateOrUpdateCameras: 成功创建或更新了 %d 个相机。"), NumCameras);
+#if WITH_EDITOR
+	NewCamera->SetActorLabel(GetCameraBaseName(CameraIndex));
+	NewCamera->SetFolderPath(FName(TEXT("CameraArray")));
+	CameraArrayDisplay::SetCameraVisualizationVisible(NewCamera, !bBatchedCameraDisplay);
+#endif
+	return NewCamera;
 }
 
 void ACameraArrayManager::ClearAllCameras()
@@ -446,13 +758,17 @@ void ACameraArrayManager::ClearAllCameras()
 		return;
 	}
 
-	UWorld* const World = GetWorld();
-	if (!World)
+	if (!GetWorld())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("ClearAllCameras: 获取UWorld失败。"));
 		return;
 	}
+	DestroyManagedCameras();
+}
 
+void ACameraArrayManager::DestroyManagedCameras()
+{
+	UWorld* const World = GetWorld();
 	int32 DestroyedCount = 0;
 	for (AActor* Camera : ManagedCameras)
 	{
@@ -467,7 +783,9 @@ void ACameraArrayManager::ClearAllCameras()
 	}
 
 	ManagedCameras.Empty();
-	UE_LOG(LogTemp, Log, TEXT("ClearAllCameras: 成功销毁了 %d 个相机。"), DestroyedCount);
+	bSpatialIndexDirty = true;
+	RebuildCameraDisplay();
+	UE_LOG(LogTemp, Log, TEXT("成功销毁了 %d 个相机。"), DestroyedCount);
 }
 
 /*void ACameraArrayManager::RenderAllViews()
@@ -755,13 +1073,70 @@ void ACameraArrayManager::SaveRenderTargetToFileAsync(const FString& FullOutputP
     ); // ENQUEUE_RENDER_COMMAND
 }*/
 
+// 视口截图由引擎按扩展名写文件（HDR时只能写EXR），其他格式只能走场景捕获
+bool ACameraArrayManager::IsEngineScreenshotFormat() const
+{
+	return FileFormat != ECameraArrayImageFormat::QOI &&
+		FileFormat != ECameraArrayImageFormat::PNG16 &&
+		FileFormat != ECameraArrayImageFormat::TIFF;
+}
+
 bool ACameraArrayManager::IsHdrFormat() const
 {
-	return FileFormat == ECameraArrayImageFormat::EXR/* || 
-           FileFormat == ECameraArrayImageFormat::TIFF || 
+	return FileFormat == ECameraArrayImageFormat::EXR ||
+           FileFormat == ECameraArrayImageFormat::PNG16 ||
+           FileFormat == ECameraArrayImageFormat::TIFF/* ||
            FileFormat == ECameraArrayImageFormat::HDR*/;
 }
 
+FString ACameraArrayManager::GetCameraFileName(int32 CameraIndex) const
+{
+	return FString::Printf(TEXT("%s.%s"), *GetCameraBaseName(CameraIndex), *GetFileExtension());
+}
+
+// 单目为 前缀_位置，立体为 前缀_位置_L/R，多目为 前缀_位置_E目索引
+FString ACameraArrayManager::GetCameraBaseName(int32 CameraIndex) const
+{
+	if (ImportedCameraNames.IsValidIndex(CameraIndex))
+	{
+		return ImportedCameraNames[CameraIndex];
+	}
+
+	const int32 NumEyesPerPosition = GetEyesPerPosition();
+	const int32 PositionIndex = CameraIndex / NumEyesPerPosition;
+	const int32 EyeIndex = CameraIndex % NumEyesPerPosition;
+	switch (RigPreset)
+	{
+	case ECameraArrayRigPreset::Stereo:
+		return FString::Printf(TEXT("%s_%03d_%s"), *CameraNamePrefix, PositionIndex, EyeIndex == 0 ? TEXT("L") : TEXT("R"));
+	case ECameraArrayRigPreset::MultiEye:
+		return FString::Printf(TEXT("%s_%03d_E%d"), *CameraNamePrefix, PositionIndex, EyeIndex);
+	case ECameraArrayRigPreset::Mono:
+	default:
+		return FString::Printf(TEXT("%s_%03d"), *CameraNamePrefix, CameraIndex);
+	}
+}
+
+FString ACameraArrayManager::GetTimeSampleDirectoryName() const
+{
+	return IsTimeSampling() ? FString::Printf(TEXT("Frame_%04d"), TimeSampleFrames[CurrentTimeSampleIndex]) : FString();
+}
+
+FString ACameraArrayManager::GetJournalKey(int32 CameraIndex) const
+{
+	return IsTimeSampling() ? GetTimeSampleDirectoryName() / GetCameraFileName(CameraIndex) : GetCameraFileName(CameraIndex);
+}
+
+FString ACameraArrayManager::GetFullOutputDirectory() const
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / OutputPath);
+}
+
+FString ACameraArrayManager::GetPreviewDirectory() const
+{
+	return GetFullOutputDirectory() / TEXT("Preview");
+}
+
 FString ACameraArrayManager::GetFileExtension() const
 {
 	switch (FileFormat)
@@ -770,16 +1145,29 @@ FString ACameraArrayManager::GetFileExtension() const
 	case ECameraArrayImageFormat::JPEG: return TEXT("jpg");
 	case ECameraArrayImageFormat::BMP: return TEXT("bmp");
 	case ECameraArrayImageFormat::TGA: return TEXT("tga");
+	case ECameraArrayImageFormat::QOI: return TEXT("qoi");
 	case ECameraArrayImageFormat::EXR: return TEXT("exr");
-	//case ECameraArrayImageFormat::TIFF: return TEXT("tiff");
+	case ECameraArrayImageFormat::PNG16: return TEXT("png");
+	case ECameraArrayImageFormat::TIFF: return TEXT("tif");
 	//case ECameraArrayImageFormat::HDR: return TEXT("hdr");
 	default: return TEXT("png");
 	}
 }
 
+FCameraArrayEncodeSettings ACameraArrayManager::MakeEncodeSettings(ECameraArrayImageFormat Format) const
+{
+	FCameraArrayEncodeSettings Settings;
+	Settings.Format = Format;
+	Settings.PngCompressionLevel = PngCompressionLevel;
+	Settings.PngFilter = PngFilter;
+	Settings.JpegQuality = JpegQuality;
+	Settings.ExrCodec = ExrCodec;
+	return Settings;
+}
+
 void ACameraArrayManager::OpenOutputFolder()
 {
-	const FString FullOutputPath = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / OutputPath);
+	const FString FullOutputPath = GetFullOutputDirectory();
 
 	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
 	if (!PlatformFile.DirectoryExists(*FullOutputPath))
@@ -793,12 +1181,16 @@ void ACameraArrayManager::OpenOutputFolder()
 
 FTransform ACameraArrayManager::GetCameraTransform(int32 CameraIndex) const
 {
+	const int32 NumEyesPerPosition = GetEyesPerPosition();
+	const int32 PositionIndex = CameraIndex / NumEyesPerPosition;
+	const int32 EyeIndex = CameraIndex % NumEyesPerPosition;
+
 	FVector Location = StartLocation;
 	if (NumCameras > 1)
 	{
 		// 如果只有一个相机，间距为0，避免除以0
 		const float Spacing = (NumCameras > 1) ? (TotalYDistance * 100.0f / (NumCameras - 1)) : 0.0f;
-		Location.Y += CameraIndex * Spacing;
+		Location.Y += PositionIndex * Spacing;
 	}
 
 	FRotator Rotation = SharedRotation;
@@ -809,6 +1201,20 @@ FTransform ACameraArrayManager::GetCameraTransform(int32 CameraIndex) const
 		Rotation = Direction.ToOrientationRotator();
 	}
 
+	if (NumEyesPerPosition > 1)
+	{
+		// 各目以阵列位置为中心沿相机右方向对称排列，相邻两目相距瞳距
+		const FVector Right = Rotation.RotateVector(FVector::RightVector);
+		const FVector EyeLocation = Location + Right * ((EyeIndex - (NumEyesPerPosition - 1) * 0.5f) * InteraxialDistance);
+		if (ConvergenceDistance > 0.0f)
+		{
+			// 内转汇聚：各目对准中心正前方汇聚距离处的同一点
+			const FVector ConvergencePoint = Location + Rotation.Vector() * (ConvergenceDistance * 100.0f);
+			Rotation = FRotationMatrix::MakeFromXZ(ConvergencePoint - EyeLocation, Rotation.RotateVector(FVector::UpVector)).Rotator();
+		}
+		Location = EyeLocation;
+	}
+
 	return FTransform(Rotation, Location);
 }
 
@@ -856,43 +1262,559 @@ void ACameraArrayManager::SelectLastCamera()
 	}
 }
 
-void ACameraArrayManager::OrganizeCamerasInFolder()
+void ACameraArrayManager::SelectCamerasSeeingTarget()
 {
-#if WITH_EDITOR
-	for (AActor* Camera : ManagedCameras)
+	if (!IsValid(LookAtTarget))
 	{
-		if (IsValid(Camera))
+		UE_LOG(LogTemp, Warning, TEXT("SelectCamerasSeeingTarget: 没有设置场景目标点。"));
+		return;
+	}
+	const TArray<int32> CameraIndices = FindCamerasSeeingActor(LookAtTarget, false);
+	SelectCameras(CameraIndices);
+	UE_LOG(LogTemp, Log, TEXT("SelectCamerasSeeingTarget: %d/%d 个相机能看到 %s。"), CameraIndices.Num(), ManagedCameras.Num(), *LookAtTarget->GetActorNameOrLabel());
+}
+
+void ACameraArrayManager::AnalyzeCoverage()
+{
+	if (bIsTaskRunning)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AnalyzeCoverage: 有任务正在运行。"));
+		return;
+	}
+	AActor* Target = IsValid(CoverageTarget) ? CoverageTarget.Get() : LookAtTarget.Get();
+	if (!IsValid(Target))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AnalyzeCoverage: 没有设置分析目标或场景目标点。"));
+		return;
+	}
+	if (ManagedCameras.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AnalyzeCoverage: 没有可用的相机。"));
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<CameraArrayCoverage::FSurfaceSample> Samples;
+	TArray<CameraArrayCoverage::FSurface> Surfaces;
+	if (!CameraArrayCoverage::SampleSurface(Target, CoverageSampleCount, Samples, Surfaces))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AnalyzeCoverage: %s 没有可采样的静态网格。"), *Target->GetActorNameOrLabel());
+		return;
+	}
+	const double SampleTime = FPlatformTime::Seconds();
+
+	// 相机位置与名字按相机索引排列，无效相机不在空间索引中，不会出现在可见列表里
+	const FCameraArraySpatialIndex& Index = GetSpatialIndex();
+	TArray<FVector> CameraLocations;
+	TArray<FString> CameraNames;
+	TArray<int32> Neighbors;
+	CameraLocations.SetNum(ManagedCameras.Num());
+	CameraNames.SetNum(ManagedCameras.Num());
+	Neighbors.Init(INDEX_NONE, ManagedCameras.Num());
+	for (int32 i = 0; i < ManagedCameras.Num(); ++i)
+	{
+		CameraNames[i] = GetCameraBaseName(i);
+		if (IsValid(ManagedCameras[i]))
 		{
-			Camera->SetFolderPath(FName(TEXT("CameraArray")));
+			CameraLocations[i] = ManagedCameras[i]->GetActorLocation();
+			Neighbors[i] = Index.FindNearest(CameraLocations[i], i);
 		}
 	}
-#endif
+
+	TArray<TArray<int32>> VisibleCameras;
+	const int64 NumTraces = CameraArrayCoverage::ComputeVisibility(GetWorld(), Index, CameraLocations, Samples, CoverageMaxViewAngle, VisibleCameras);
+	const double TraceTime = FPlatformTime::Seconds();
+
+	CameraArrayCoverage::FReport Report;
+	CameraArrayCoverage::BuildReport(Samples, Surfaces, VisibleCameras, CameraLocations, Neighbors, CoverageMinViews, Report);
+	UE_LOG(LogTemp, Log, TEXT("AnalyzeCoverage: %s\n%s"), *Target->GetActorNameOrLabel(), *Report.Describe(Surfaces));
+	UE_LOG(LogTemp, Log, TEXT("AnalyzeCoverage: 采样 %.1f 毫秒，%lld 次射线检测 %.1f 毫秒。"),
+		(SampleTime - StartTime) * 1000.0, NumTraces, (TraceTime - SampleTime) * 1000.0);
+
+	const FString OutputDirectory = GetFullOutputDirectory();
+	IFileManager::Get().MakeDirectory(*OutputDirectory, true);
+	const FString CameraCsvPath = OutputDirectory / TEXT("Coverage_Cameras.csv");
+	const FString SampleCsvPath = OutputDirectory / TEXT("Coverage_Samples.csv");
+	if (CameraArrayCoverage::SaveCameraCsv(Report, CameraNames, CameraCsvPath) &&
+		CameraArrayCoverage::SaveSampleCsv(Samples, Surfaces, VisibleCameras, SampleCsvPath))
+	{
+		UE_LOG(LogTemp, Log, TEXT("AnalyzeCoverage: 结果已保存到 %s"), *OutputDirectory);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("AnalyzeCoverage: 无法写入 %s"), *OutputDirectory);
+	}
 }
 
-/*void ACameraArrayManager::RenderFirstCamera()
+FCameraArraySpatialEntry ACameraArrayManager::MakeSpatialEntry(int32 CameraIndex) const
 {
-    if (bIsTaskRunning) return;
-    if (ManagedCameras.Num() <= 0) return;
-#if WITH_EDITOR
-    SyncShowFlagsWithEditorViewport();
-    SyncPostProcessSettings();
-#endif
-    bIsTaskRunning = true;
-    InitializeCaptureComponents();
-
-    PerformSingleCaptureForSpecificIndex(0);
-    OpenOutputFolder();
+	const float AspectRatio = RenderTargetX > 0 && RenderTargetY > 0 ? static_cast<float>(RenderTargetX) / RenderTargetY : 1.0f;
+	return FCameraArraySpatialEntry::Make(CameraIndex, ManagedCameras[CameraIndex]->GetActorTransform(), GetCameraFOV(CameraIndex),
+		AspectRatio, SpatialQueryDistance * 100.0);
 }
 
-void ACameraArrayManager::RenderLastCamera()
+FCameraArraySpatialIndex& ACameraArrayManager::GetSpatialIndex()
 {
-    if (bIsTaskRunning) return;
-    if (ManagedCameras.Num() <= 0) return;
-#if WITH_EDITOR
-    SyncShowFlagsWithEditorViewport();
-    SyncPostProcessSettings();
-#endif
-    bIsTaskRunning = true;
+	if (!SpatialIndex.IsValid())
+	{
+		SpatialIndex = MakeShared<FCameraArraySpatialIndex>();
+	}
+	if (!bSpatialIndexDirty && !SpatialIndex->NeedsRebuild())
+	{
+		return *SpatialIndex;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<FCameraArraySpatialEntry> Entries;
+	Entries.Reserve(ManagedCameras.Num());
+	for (int32 i = 0; i < ManagedCameras.Num(); ++i)
+	{
+		if (IsValid(ManagedCameras[i]))
+		{
+			Entries.Add(MakeSpatialEntry(i));
+		}
+	}
+	SpatialIndex->Build(MoveTemp(Entries));
+	bSpatialIndexDirty = false;
+	BindActorMoved();
+	UE_LOG(LogTemp, Verbose, TEXT("空间索引：%d 个相机，构建耗时 %.3f 毫秒。"), SpatialIndex->Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return *SpatialIndex;
+}
+
+void ACameraArrayManager::BindActorMoved()
+{
+#if WITH_EDITOR
+	if (GEngine && !ActorMovedHandle.IsValid())
+	{
+		ActorMovedHandle = GEngine->OnActorMoved().AddUObject(this, &ACameraArrayManager::OnActorMoved);
+	}
+#endif
+}
+
+void ACameraArrayManager::OnActorMoved(AActor* Actor)
+{
+	// 拖动时每帧都会调用，只做指针比较
+	const int32 CameraIndex = Actor ? ManagedCameras.IndexOfByKey(Actor) : INDEX_NONE;
+	if (CameraIndex == INDEX_NONE)
+	{
+		return;
+	}
+	if (!bSpatialIndexDirty && SpatialIndex.IsValid())
+	{
+		SpatialIndex->Update(MakeSpatialEntry(CameraIndex));
+	}
+	UpdateCameraDisplay(CameraIndex);
+}
+
+void ACameraArrayManager::WriteCameraDisplayLines(int32 CameraIndex, FBatchedLine* OutLines) const
+{
+	if (!IsValid(ManagedCameras[CameraIndex]))
+	{
+		CameraArrayDisplay::WriteEmptyLines(OutLines);
+		return;
+	}
+	const float AspectRatio = RenderTargetX > 0 && RenderTargetY > 0 ? static_cast<float>(RenderTargetX) / RenderTargetY : 1.0f;
+	CameraArrayDisplay::WriteCameraLines(OutLines, ManagedCameras[CameraIndex]->GetActorTransform(), GetCameraFOV(CameraIndex), AspectRatio,
+		CameraDisplayLength * 100.0f, CameraDisplayColor, 0.0f);
+}
+
+void ACameraArrayManager::RebuildCameraDisplay()
+{
+	if (!IsValid(CameraDisplayComponent))
+	{
+		return;
+	}
+
+	for (AActor* Camera : ManagedCameras)
+	{
+		CameraArrayDisplay::SetCameraVisualizationVisible(Camera, !bBatchedCameraDisplay);
+	}
+
+	// 每个相机的线段数固定，第i个相机的线段位于 i * LinesPerCamera
+	TArray<FBatchedLine>& Lines = CameraDisplayComponent->BatchedLines;
+	Lines.Reset();
+	if (bBatchedCameraDisplay)
+	{
+		Lines.SetNumUninitialized(ManagedCameras.Num() * CameraArrayDisplay::LinesPerCamera);
+		for (int32 i = 0; i < ManagedCameras.Num(); ++i)
+		{
+			WriteCameraDisplayLines(i, Lines.GetData() + i * CameraArrayDisplay::LinesPerCamera);
+		}
+		BindActorMoved();
+	}
+	CameraDisplayComponent->MarkRenderStateDirty();
+}
+
+void ACameraArrayManager::UpdateCameraDisplay(int32 CameraIndex)
+{
+	if (!bBatchedCameraDisplay || !IsValid(CameraDisplayComponent))
+	{
+		return;
+	}
+	TArray<FBatchedLine>& Lines = CameraDisplayComponent->BatchedLines;
+	if (Lines.Num() != ManagedCameras.Num() * CameraArrayDisplay::LinesPerCamera)
+	{
+		RebuildCameraDisplay();
+		return;
+	}
+	WriteCameraDisplayLines(CameraIndex, Lines.GetData() + CameraIndex * CameraArrayDisplay::LinesPerCamera);
+	CameraDisplayComponent->MarkRenderStateDirty();
+}
+
+int32 ACameraArrayManager::FindNearestCamera(const FVector& Location)
+{
+	return GetSpatialIndex().FindNearest(Location);
+}
+
+TArray<int32> ACameraArrayManager::FindCamerasInRadius(const FVector& Location, float Radius)
+{
+	TArray<int32> CameraIndices;
+	GetSpatialIndex().FindInRadius(Location, Radius, CameraIndices);
+	return CameraIndices;
+}
+
+TArray<int32> ACameraArrayManager::FindCamerasSeeingPoint(const FVector& Location)
+{
+	TArray<int32> CameraIndices;
+	GetSpatialIndex().FindContainingPoint(Location, CameraIndices);
+	return CameraIndices;
+}
+
+TArray<int32> ACameraArrayManager::FindCamerasSeeingActor(AActor* Actor, bool bRequireFullyVisible)
+{
+	TArray<int32> CameraIndices;
+	if (IsValid(Actor))
+	{
+		GetSpatialIndex().FindSeeingBox(Actor->GetComponentsBoundingBox(true), bRequireFullyVisible, CameraIndices);
+	}
+	return CameraIndices;
+}
+
+void ACameraArrayManager::SelectCameras(const TArray<int32>& CameraIndices)
+{
+#if WITH_EDITOR
+	if (!GEditor)
+	{
+		return;
+	}
+	GEditor->SelectNone(false, true);
+	for (const int32 CameraIndex : CameraIndices)
+	{
+		if (ManagedCameras.IsValidIndex(CameraIndex) && IsValid(ManagedCameras[CameraIndex]))
+		{
+			GEditor->SelectActor(ManagedCameras[CameraIndex], true, false);
+		}
+	}
+	GEditor->NoteSelectionChange();
+#endif
+}
+
+TArray<int32> ACameraArrayManager::BuildCaptureOrder() const
+{
+	// 排序以阵列位置为单位，立体/多目时同一位置的各目在最后展开
+	const int32 NumEyes = GetEyesPerPosition();
+	const int32 NumToCapture = FMath::DivideAndRoundUp(ManagedCameras.Num(), NumEyes);
+	TArray<int32> Order;
+	Order.Reserve(NumToCapture);
+
+	switch (CaptureOrderMode)
+	{
+	case ECameraArrayCaptureOrder::CoarseToFine:
+	{
+		// 步长从不超过8的最大2的幂开始逐级减半，每级只加入尚未访问的索引
+		TBitArray<> Visited(false, NumToCapture);
+		auto Visit = [&Order, &Visited](int32 Index)
+		{
+			if (!Visited[Index])
+			{
+				Visited[Index] = true;
+				Order.Add(Index);
+			}
+		};
+
+		int32 Stride = 1;
+		while (Stride * 2 <= 8 && Stride * 2 < NumToCapture)
+		{
+			Stride *= 2;
+		}
+		for (; Stride >= 1; Stride /= 2)
+		{
+			for (int32 Index = 0; Index < NumToCapture; Index += Stride)
+			{
+				Visit(Index);
+			}
+			if (NumToCapture > 0)
+			{
+				Visit(NumToCapture - 1); // 首轮就包含阵列末端
+			}
+		}
+		break;
+	}
+	case ECameraArrayCaptureOrder::LongestCostFirst:
+	{
+		// 耗时是上次从开始捕获到文件写完的时间；没有历史耗时的相机按已知耗时的平均值估计
+		TArray<double> Costs;
+		Costs.Init(-1.0, NumToCapture);
+		double KnownTotal = 0.0;
+		int32 KnownCount = 0;
+		for (int32 Index = 0; Index < NumToCapture; ++Index)
+		{
+			for (int32 Eye = 0; Eye < NumEyes; ++Eye)
+			{
+				const FCameraArrayRenderJournal::FEntry* Entry = RenderJournal.Find(GetJournalKey(Index * NumEyes + Eye));
+				if (Entry && Entry->RenderSeconds > 0.0)
+				{
+					Costs[Index] = FMath::Max(Costs[Index], 0.0) + Entry->RenderSeconds;
+				}
+			}
+			if (Costs[Index] >= 0.0)
+			{
+				KnownTotal += Costs[Index];
+				++KnownCount;
+			}
+		}
+		const double DefaultCost = KnownCount > 0 ? KnownTotal / KnownCount : 0.0;
+		for (int32 Index = 0; Index < NumToCapture; ++Index)
+		{
+			if (Costs[Index] < 0.0)
+			{
+				Costs[Index] = DefaultCost;
+			}
+			Order.Add(Index);
+		}
+		Order.StableSort([&Costs](int32 A, int32 B) { return Costs[A] > Costs[B]; });
+		break;
+	}
+	case ECameraArrayCaptureOrder::Index:
+	default:
+		for (int32 Index = 0; Index < NumToCapture; ++Index)
+		{
+			Order.Add(Index);
+		}
+		break;
+	}
+
+	if (NumEyes > 1)
+	{
+		// 同一位置的各目紧接着渲染，复用同一份渲染状态，打包输出也能尽早写出
+		TArray<int32> CameraOrder;
+		CameraOrder.Reserve(ManagedCameras.Num());
+		for (const int32 PositionIndex : Order)
+		{
+			for (int32 Eye = 0; Eye < NumEyes; ++Eye)
+			{
+				const int32 CameraIndex = PositionIndex * NumEyes + Eye;
+				if (CameraIndex < ManagedCameras.Num())
+				{
+					CameraOrder.Add(CameraIndex);
+				}
+			}
+		}
+		return CameraOrder;
+	}
+	return Order;
+}
+
+const FCameraArrayIntrinsics* ACameraArrayManager::FindIntrinsics(int32 CameraIndex) const
+{
+	const FCameraArrayIntrinsics* Intrinsics = CameraIntrinsics.Num() == 1 ? &CameraIntrinsics[0] :
+		CameraIntrinsics.IsValidIndex(CameraIndex) ? &CameraIntrinsics[CameraIndex] : nullptr;
+	return Intrinsics && Intrinsics->IsValid() ? Intrinsics : nullptr;
+}
+
+float ACameraArrayManager::GetCameraFOV(int32 CameraIndex) const
+{
+	if (const FCameraArrayIntrinsics* Intrinsics = FindIntrinsics(CameraIndex))
+	{
+		return Intrinsics->GetHorizontalFOV(FMath::Max(RenderTargetX, 1));
+	}
+	return CameraFOV;
+}
+
+void ACameraArrayManager::ImportCalibration()
+{
+	if (bIsTaskRunning)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ImportCalibration: 无法在渲染任务进行中导入标定。"));
+		return;
+	}
+
+	FString Error;
+	TArray<FCameraArrayIntrinsics> Imported;
+	if (!CameraArrayCalibration::LoadIntrinsicsFromJson(CalibrationFile.FilePath, Imported, Error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ImportCalibration: %s"), *Error);
+		return;
+	}
+	if (Imported.Num() != 1 && Imported.Num() != ManagedCameras.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ImportCalibration: 标定文件中有 %d 个相机，阵列中有 %d 个相机，多出的相机使用统一FOV。"),
+			Imported.Num(), ManagedCameras.Num());
+	}
+
+#if WITH_EDITOR
+	Modify();
+#endif
+	CameraIntrinsics = MoveTemp(Imported);
+	bIntrinsicsFromRigImport = false;
+	bSpatialIndexDirty = true;
+	RebuildCameraDisplay();
+	for (int32 i = 0; i < ManagedCameras.Num(); ++i)
+	{
+		UCineCameraComponent* CineCamComponent = IsValid(ManagedCameras[i]) ? ManagedCameras[i]->FindComponentByClass<UCineCameraComponent>() : nullptr;
+		if (CineCamComponent)
+		{
+			CineCamComponent->SetFieldOfView(GetCameraFOV(i));
+		}
+	}
+	UE_LOG(LogTemp, Log, TEXT("ImportCalibration: 从 %s 导入了 %d 组相机内参。"), *CalibrationFile.FilePath, CameraIntrinsics.Num());
+}
+
+void ACameraArrayManager::BenchmarkImageEncoders()
+{
+	// 优先使用第一个相机已渲染的图像，使结果反映实际场景的可压缩性
+	FImage Source;
+	const FString FirstFramePath = FPaths::ConvertRelativePathToFull(GetFullOutputDirectory() / GetCameraFileName(0));
+	TArray64<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *FirstFramePath, FILEREAD_Silent) || !FImageUtils::DecompressImage(FileData.GetData(), FileData.Num(), Source))
+	{
+		UE_LOG(LogTemp, Log, TEXT("BenchmarkImageEncoders: 未找到 %s，使用 %dx%d 的测试图。"), *FirstFramePath, RenderTargetX, RenderTargetY);
+		CameraArrayEncodeBenchmark::MakeTestImage(FMath::Max(RenderTargetX, 1), FMath::Max(RenderTargetY, 1), Source);
+	}
+
+	const FString CsvPath = FPaths::ConvertRelativePathToFull(GetFullOutputDirectory() / TEXT("EncodeBenchmark.csv"));
+	UE_LOG(LogTemp, Log, TEXT("BenchmarkImageEncoders: 在后台开始测试，完成后结果输出到日志与 %s。"), *CsvPath);
+	Async(EAsyncExecution::ThreadPool, [Source = MoveTemp(Source), CsvPath]()
+	{
+		CameraArrayEncodeBenchmark::Run(Source, CsvPath);
+	});
+}
+
+void ACameraArrayManager::ImportCameraRig()
+{
+	if (bIsTaskRunning)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ImportCameraRig: 无法在渲染任务进行中导入相机。"));
+		return;
+	}
+	if (!GetWorld())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ImportCameraRig: 获取UWorld失败。"));
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	FString Error;
+	TArray<CameraArrayRigImport::FImportedCamera> Imported;
+	if (!CameraArrayRigImport::Load(RigImportFile.FilePath, Imported, Error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ImportCameraRig: %s"), *Error);
+		return;
+	}
+	if (Imported.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ImportCameraRig: %s 中没有相机。"), *RigImportFile.FilePath);
+		return;
+	}
+	const double ParseTime = FPlatformTime::Seconds() - StartTime;
+
+	// COLMAP中图像顺序与ID无关，按文件名排序使相机索引稳定
+	Imported.Sort([](const CameraArrayRigImport::FImportedCamera& A, const CameraArrayRigImport::FImportedCamera& B)
+	{
+		return A.Name < B.Name;
+	});
+
+#if WITH_EDITOR
+	ClearAllTimers();
+#endif
+	BeginCameraSpawn(TEXT("ImportCameraRig"));
+
+	RigPreset = ECameraArrayRigPreset::Mono;
+	NumCameras = Imported.Num();
+	CameraIntrinsics.Reset(Imported.Num());
+	bIntrinsicsFromRigImport = true;
+	ImportedCameraNames.Reset(Imported.Num());
+	for (const CameraArrayRigImport::FImportedCamera& Camera : Imported)
+	{
+		CameraIntrinsics.Add(Camera.Intrinsics);
+
+		// 子目录也并入名字，避免不同目录下的同名图像输出到同一个文件
+		FString Name = FPaths::Combine(FPaths::GetPath(Camera.Name), FPaths::GetBaseFilename(Camera.Name));
+		Name.ReplaceCharInline(TEXT('/'), TEXT('_'));
+		Name.ReplaceCharInline(TEXT('\\'), TEXT('_'));
+		ImportedCameraNames.Add(Name.IsEmpty() ? FString::Printf(TEXT("%s_%05d"), *CameraNamePrefix, ImportedCameraNames.Num()) : Name);
+	}
+
+	const FTransform RigTransform = GetActorTransform();
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(Imported.Num());
+	for (const CameraArrayRigImport::FImportedCamera& Camera : Imported)
+	{
+		Transforms.Add(CameraArrayRigImport::ToUnrealTransform(Camera, ImportAxes, ImportScale) * RigTransform);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ImportCameraRig: 从 %s 读取了 %d 个相机（解析 %.2f 秒），开始生成。"),
+		*RigImportFile.FilePath, Imported.Num(), ParseTime);
+	StartTimeSlicedSpawn(MoveTemp(Transforms));
+}
+
+int32 ACameraArrayManager::GetEyesPerPosition() const
+{
+	switch (RigPreset)
+	{
+	case ECameraArrayRigPreset::Stereo:   return 2;
+	case ECameraArrayRigPreset::MultiEye: return FMath::Max(NumEyes, 2);
+	case ECameraArrayRigPreset::Mono:
+	default:                              return 1;
+	}
+}
+
+void ACameraArrayManager::ClearRenderJournal()
+{
+	RenderJournal.Empty();
+	CurrentViewHashes.Empty();
+	CurrentSceneViewHashes.Empty();
+
+	// 渐进渲染的累积状态随日志一起清除，下次从第一遍重新累积
+	const FString ProgressiveDirectory = CameraArrayProgressive::GetStateDirectory(GetFullOutputDirectory());
+	if (IFileManager::Get().DirectoryExists(*ProgressiveDirectory))
+	{
+		IFileManager::Get().DeleteDirectory(*ProgressiveDirectory, false, true);
+	}
+
+	const FString JournalPath = FCameraArrayRenderJournal::GetJournalFilePath(GetFullOutputDirectory());
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (PlatformFile.FileExists(*JournalPath))
+	{
+		PlatformFile.DeleteFile(*JournalPath);
+	}
+	UE_LOG(LogTemp, Log, TEXT("ClearRenderJournal: 已清除渲染日志 %s"), *JournalPath);
+}
+
+/*void ACameraArrayManager::RenderFirstCamera()
+{
+    if (bIsTaskRunning) return;
+    if (ManagedCameras.Num() <= 0) return;
+#if WITH_EDITOR
+    SyncShowFlagsWithEditorViewport();
+    SyncPostProcessSettings();
+#endif
+    bIsTaskRunning = true;
+    InitializeCaptureComponents();
+
+    PerformSingleCaptureForSpecificIndex(0);
+    OpenOutputFolder();
+}
+
+void ACameraArrayManager::RenderLastCamera()
+{
+    if (bIsTaskRunning) return;
+    if (ManagedCameras.Num() <= 0) return;
+#if WITH_EDITOR
+    SyncShowFlagsWithEditorViewport();
+    SyncPostProcessSettings();
+#endif
+    bIsTaskRunning = true;
     InitializeCaptureComponents();
 
     PerformSingleCaptureForSpecificIndex(ManagedCameras.Num() - 1);
@@ -994,6 +1916,17 @@ void ACameraArrayManager::PerformSingleCaptureForSpecificIndex(int32 IndexToCapt
 
 // 入口函数：开始批量截图任务
 void ACameraArrayManager::TakeHighResScreenshots()
+{
+	StartBatchCapture(false);
+}
+
+// 入口函数：快速预览，沿用同一套相机遍历，只是分辨率和采样数降低
+void ACameraArrayManager::RenderPreviewPass()
+{
+	StartBatchCapture(true);
+}
+
+void ACameraArrayManager::StartBatchCapture(bool bPreview)
 {
 	if (bIsTaskRunning)
 	{
@@ -1012,227 +1945,2016 @@ void ACameraArrayManager::TakeHighResScreenshots()
 	}
 
 	ClearAllTimers();
-	SaveOriginalViewportState();
-	LockEditorProperties();
-	
-	bIsTaskRunning = true;
-	CurrentScreenshotIndex = 0;
-	RenderProgress = 0;
-	RenderStatus = TEXT("开始高清截图...");
-	UE_LOG(LogTemp, Log, TEXT("Starting high-resolution screenshot capture for %d cameras."), ManagedCameras.Num());
 
-	// 启动递归循环
-	TakeNextHighResScreenshot_Recursive();
+	// 合并任务中视口状态与待写计数由任务统一管理
+	const bool bInJob = ActiveJob.IsValid();
+
+	const FViewport* ActiveViewport = GEditor->GetActiveViewport();
+	const FEditorViewportClient* ViewportClient = ActiveViewport ? static_cast<FEditorViewportClient*>(ActiveViewport->GetClient()) : nullptr;
+	const bool bIsPathTracing = ViewportClient && ViewportClient->EngineShowFlags.PathTracing;
+
+	// 预览和全景总是走场景捕获路径，不接管视口；预览只渲染普通视角
+	bIsPreviewPass = bPreview;
+	bBatchUsesPanorama = !bPreview && bCapturePanorama;
+	bBatchUsesLensDistortion = !bPreview && !bBatchUsesPanorama && bApplyLensDistortion && CameraIntrinsics.Num() > 0;
+	bBatchUsesAccumulation = !bPreview && !bBatchUsesPanorama && bJitteredAccumulation;
+	bBatchUsesDenoiser = !bPreview && !bBatchUsesPanorama && bDenoisePathTracing;
+	bBatchUsesProgressive = !bPreview && !bBatchUsesPanorama && bProgressiveRefinement;
+	bBatchUsesRegion = !bPreview && !bBatchUsesPanorama && !bBatchUsesLensDistortion && bCaptureRegionOfInterest;
+	CurrentProgressivePass = 0;
+	bBatchUsesSceneCapture = UsesSceneCapture(bPreview);
+	if (!bInJob)
+	{
+		PendingFrameWrites = MakeShared<FThreadSafeCounter, ESPMode::ThreadSafe>();
+		ActiveMemoryBudget = CreateFrameMemoryBudget();
+	}
+	ActiveContactSheet.Reset();
+	ActiveStereoPacker.Reset();
+	ActiveRenderCosts = bPreview ? nullptr : MakeShared<FCameraArrayRenderCosts, ESPMode::ThreadSafe>();
+	ActiveReadinessStats = ShouldWaitForViewReady() ? MakeShared<FCameraArrayReadinessStats>() : nullptr;
+
+	// 立体/多目打包在后台线程拼接回读的像素，只有场景捕获路径能做到；预览总是分别输出缩略图
+	if (!bIsPreviewPass && GetEyesPerPosition() > 1 && StereoPacking != ECameraArrayStereoPacking::Separate)
+	{
+		if (bBatchUsesSceneCapture)
+		{
+			ActiveStereoPacker = MakeShared<FCameraArrayStereoPacker, ESPMode::ThreadSafe>(GetEyesPerPosition(), StereoPacking);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TakeHighResScreenshots: 打包输出需要场景捕获方式，本次各目分别输出。"));
+		}
+	}
+
+	if (bBatchUsesSceneCapture)
+	{
+		PrepareSceneCapture();
+		if (ActiveMemoryBudget.IsValid())
+		{
+			ActiveMemoryBudget->SetResidentBytes(EstimateResidentBytes());
+		}
+	}
+	else if (!bInJob)
+	{
+		SaveOriginalViewportState();
+	}
+	LockEditorProperties();
+
+	if (bIsPreviewPass || bBuildContactSheet)
+	{
+		CreateContactSheet();
+	}
+	// 按帧范围渲染：先跳转到第一帧再计算视角哈希，预览只渲染当前时刻
+	TimeSampleFrames.Reset();
+	CurrentTimeSampleIndex = INDEX_NONE;
+	if (!bIsPreviewPass && bRenderTimeRange)
+	{
+		for (int32 Frame = TimeRangeStartFrame; Frame <= TimeRangeEndFrame; Frame += FMath::Max(1, TimeRangeFrameStep))
+		{
+			TimeSampleFrames.Add(Frame);
+		}
+		if (TimeSampleFrames.Num() > 0)
+		{
+			CurrentTimeSampleIndex = 0;
+			ApplyTimeSample(CurrentTimeSampleIndex);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TakeHighResScreenshots: 帧范围为空（起始帧 %d > 结束帧 %d），只渲染当前时刻。"), TimeRangeStartFrame, TimeRangeEndFrame);
+		}
+	}
+
+	if (!bIsPreviewPass)
+	{
+		PrepareRenderJournal(bIsPathTracing);
+	}
+	else
+	{
+		RenderJournal.Load(GetFullOutputDirectory()); // 预览只读取日志中的耗时来排序，不写回
+	}
+	CaptureOrder = BuildCaptureOrder();
+
+	bIsTaskRunning = true;
+	CurrentScreenshotIndex = 0;
+	RenderProgress = 0;
+	RenderStatus = bIsPreviewPass ? TEXT("开始快速预览...") : TEXT("开始高清截图...");
+	ActiveWarmUpStats.Reset();
+
+	auto StartCaptureLoop = [this]()
+	{
+		UE_LOG(LogTemp, Log, TEXT("Starting %s capture for %d cameras."), bIsPreviewPass ? TEXT("preview") : TEXT("high-resolution screenshot"), ManagedCameras.Num());
+
+		// 启动递归循环；跳转过序列时留一帧让场景状态同步到渲染线程
+		if (IsTimeSampling())
+		{
+			UE_LOG(LogTemp, Log, TEXT("Time range capture: %d frames x %d cameras."), TimeSampleFrames.Num(), CaptureOrder.Num());
+			GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, this, &ACameraArrayManager::TakeNextHighResScreenshot_Recursive, 0.1f, false);
+		}
+		else
+		{
+			TakeNextHighResScreenshot_Recursive();
+		}
+	};
+
+	// 预热在相机遍历之前完成，正式捕获的耗时不再包含着色器编译
+	if (!bIsPreviewPass && bWarmUpShaders)
+	{
+		StartWarmUpPass(MoveTemp(StartCaptureLoop));
+	}
+	else
+	{
+		StartCaptureLoop();
+	}
+}
+
+// 循环控制器：递归调用，负责驱动整个流程
+void ACameraArrayManager::TakeNextHighResScreenshot_Recursive()
+{
+	// 检查是否所有相机都已处理完毕
+	if (CurrentScreenshotIndex >= CaptureOrder.Num())
+	{
+		// 按帧范围渲染：当前时刻的相机都已提交，世界前进到下一帧后重新遍历相机
+		if (IsTimeSampling() && CurrentTimeSampleIndex + 1 < TimeSampleFrames.Num())
+		{
+			RetireContactSheet();
+			ApplyTimeSample(++CurrentTimeSampleIndex);
+			ComputeViewHashes();
+			CurrentScreenshotIndex = 0;
+			GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, this, &ACameraArrayManager::TakeNextHighResScreenshot_Recursive, 0.1f, false);
+			return;
+		}
+
+		// 渐进渲染：所有相机都完成这一遍后开始下一遍
+		if (bBatchUsesProgressive && CurrentProgressivePass + 1 < FMath::Max(ProgressivePasses, 1))
+		{
+			StartNextProgressivePass();
+			return;
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("All screenshot requests submitted. Finalizing..."));
+
+		// 合并任务中直接开始下一个阵列，收尾在整个任务结束时统一进行
+		if (UCameraArrayJobSubsystem* Job = ActiveJob.Get())
+		{
+			Job->NotifyManagerFinished(this);
+			return;
+		}
+
+		// 视口截图由引擎在帧末写文件，留一个短暂的延时；场景捕获路径则等待后台写出完成
+		FTimerDelegate FinalizeDelegate;
+		FinalizeDelegate.BindUObject(this, &ACameraArrayManager::FinishBatchCapture);
+		GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, FinalizeDelegate, bBatchUsesSceneCapture ? 0.1f : 1.0f, false);
+		return;
+	}
+
+	// 为当前索引的相机执行截图，并设置回调函数
+	// 回调函数的内容是：在当前截图完成后，继续处理下一个
+	ExecuteScreenshotForCamera(CaptureOrder[CurrentScreenshotIndex], [this]()
+	{
+		const int32 NumTimeSamples = IsTimeSampling() ? TimeSampleFrames.Num() : 1;
+		const int32 NumPasses = bBatchUsesProgressive ? FMath::Max(ProgressivePasses, 1) : 1;
+		const int32 ImagesPerPass = CaptureOrder.Num() * NumTimeSamples;
+		const int32 DoneImages = CurrentProgressivePass * ImagesPerPass + FMath::Max(CurrentTimeSampleIndex, 0) * CaptureOrder.Num() + CurrentScreenshotIndex;
+		RenderProgress = FMath::RoundToInt((static_cast<float>(DoneImages) / (ImagesPerPass * NumPasses)) * 100.0f);
+		
+		// 使用 SetTimerForNextTick 来调用下一次递归，避免堆栈溢出
+		FTimerHandle NextTickTimer;
+		GetWorld()->GetTimerManager().SetTimer(NextTickTimer, this, &ACameraArrayManager::TakeNextHighResScreenshot_Recursive, 0.1f, false);
+		CurrentScreenshotIndex++;
+	});
+}
+
+void ACameraArrayManager::FinishBatchCapture()
+{
+	// 场景捕获路径的帧仍在后台编码时继续等待
+	if (PendingFrameWrites.IsValid() && PendingFrameWrites->GetValue() > 0)
+	{
+		RenderStatus = FString::Printf(TEXT("等待写出... (剩余 %d)"), PendingFrameWrites->GetValue());
+		GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, this, &ACameraArrayManager::FinishBatchCapture, 0.1f, false);
+		return;
+	}
+
+	FinalizeBatchOutputs();
+	if (bBatchUsesSceneCapture && ActiveMemoryBudget.IsValid())
+	{
+		UE_LOG(LogTemp, Log, TEXT("FinishBatchCapture: %s"), *ActiveMemoryBudget->Describe());
+		UE_LOG(LogTemp, Log, TEXT("FinishBatchCapture: %s"), *FCameraArrayBufferPool::Get().Describe());
+	}
+	if (ActiveWarmUpStats.IsValid())
+	{
+		UE_LOG(LogTemp, Log, TEXT("FinishBatchCapture: %s"), *ActiveWarmUpStats->Describe());
+	}
+	if (ActiveReadinessStats.IsValid())
+	{
+		UE_LOG(LogTemp, Log, TEXT("FinishBatchCapture: %s"), *ActiveReadinessStats->Describe());
+	}
+	if (ActiveDenoiseStats.IsValid())
+	{
+		UE_LOG(LogTemp, Log, TEXT("FinishBatchCapture: %s"), *ActiveDenoiseStats->Describe());
+	}
+	FCameraArrayBufferPool::Get().Trim();
+
+	RenderProgress = 100;
+	RenderStatus = TEXT("完成");
+	UE_LOG(LogTemp, Log, TEXT("Screenshot process finished."));
+
+	const bool bWasPreview = bIsPreviewPass;
+	EndCaptureTask();
+	if (bWasPreview)
+	{
+		FPlatformProcess::ExploreFolder(*GetPreviewDirectory());
+	}
+	else
+	{
+		OpenOutputFolder();
+	}
+}
+
+void ACameraArrayManager::CreateContactSheet()
+{
+	const FIntPoint Resolution = bBatchUsesPanorama && PanoramaLut.IsValid() ? FIntPoint(PanoramaLut->Width, PanoramaLut->Height) : GetCaptureResolution();
+	const int32 TileWidth = FMath::Min(ContactSheetTileWidth, Resolution.X);
+	const int32 TileHeight = FMath::Max(1, FMath::RoundToInt(static_cast<float>(TileWidth) * Resolution.Y / Resolution.X));
+	ActiveContactSheet = MakeShared<FCameraArrayContactSheet, ESPMode::ThreadSafe>(
+		ManagedCameras.Num(), TileWidth, TileHeight, Resolution, ContactSheetFilter);
+}
+
+// 按帧范围渲染时每个时间步一张联系表，文件名带上与图像目录相同的帧号
+FString ACameraArrayManager::GetContactSheetPath() const
+{
+	const FString Directory = bIsPreviewPass ? GetPreviewDirectory() : GetFullOutputDirectory();
+	return IsTimeSampling() ? Directory / FString::Printf(TEXT("ContactSheet_%s.jpg"), *GetTimeSampleDirectoryName()) : Directory / TEXT("ContactSheet.jpg");
+}
+
+// 切换时间步时换一张新的联系表；这个时间步的帧仍在后台写出，旧表等它们写完再保存
+void ACameraArrayManager::RetireContactSheet()
+{
+	if (!ActiveContactSheet.IsValid())
+	{
+		return;
+	}
+
+	if (PendingFrameWrites.IsValid())
+	{
+		PendingFrameWrites->Increment();
+	}
+	RetiredContactSheets.Add({ MoveTemp(ActiveContactSheet), PendingFrameWrites, GetContactSheetPath() });
+	CreateContactSheet();
+	if (!GetWorld()->GetTimerManager().IsTimerActive(ContactSheetTimerHandle))
+	{
+		GetWorld()->GetTimerManager().SetTimer(ContactSheetTimerHandle, this, &ACameraArrayManager::SaveRetiredContactSheets, 0.1f, true);
+	}
+}
+
+void ACameraArrayManager::SaveRetiredContactSheets()
+{
+	// 写出请求与读回任务都持有联系表的引用，只剩这里一个引用时该时间步的格子都已填好
+	for (int32 i = RetiredContactSheets.Num() - 1; i >= 0; --i)
+	{
+		FRetiredContactSheet& Retired = RetiredContactSheets[i];
+		if (Retired.Sheet.GetSharedReferenceCount() > 1)
+		{
+			continue;
+		}
+
+		if (Retired.Sheet->SaveToFile(Retired.FilePath))
+		{
+			UE_LOG(LogTemp, Log, TEXT("联系表已保存: %s (%dx%d)"), *Retired.FilePath, Retired.Sheet->GetWidth(), Retired.Sheet->GetHeight());
+		}
+		if (Retired.PendingWrites.IsValid())
+		{
+			Retired.PendingWrites->Decrement();
+		}
+		RetiredContactSheets.RemoveAt(i);
+	}
+
+	if (RetiredContactSheets.IsEmpty())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(ContactSheetTimerHandle);
+	}
+}
+
+void ACameraArrayManager::FinalizeBatchOutputs()
+{
+	// 每帧写出时已经把缩略图放进联系表，这里只剩一次编码
+	if (ActiveContactSheet.IsValid())
+	{
+		const FString ContactSheetPath = GetContactSheetPath();
+		if (ActiveContactSheet->SaveToFile(ContactSheetPath))
+		{
+			UE_LOG(LogTemp, Log, TEXT("联系表已保存: %s (%dx%d)"), *ContactSheetPath, ActiveContactSheet->GetWidth(), ActiveContactSheet->GetHeight());
+		}
+	}
+	if (!bIsPreviewPass)
+	{
+		SaveRenderJournal();
+	}
+}
+
+void ACameraArrayManager::EndCaptureTask()
+{
+	UnlockEditorProperties();
+	if (!bBatchUsesSceneCapture && !ActiveJob.IsValid())
+	{
+		RestoreOriginalViewportState();
+	}
+	ReleaseBorrowedCaptureResources();
+	RestoreSequencePosition();
+	ActiveJob = nullptr;
+	bIsTaskRunning = false;
+	bIsPreviewPass = false;
+	bBatchUsesPanorama = false;
+	bBatchUsesLensDistortion = false;
+	bBatchUsesAccumulation = false;
+	bBatchUsesDenoiser = false;
+	bBatchUsesProgressive = false;
+	CurrentProgressivePass = 0;
+	ProgressivePassSamples = 0;
+	bBatchUsesRegion = false;
+	CameraDistortionMaps.Reset();
+	ActiveContactSheet.Reset();
+	RetiredContactSheets.Reset();
+	DiscardIncompleteStereoPairs();
+	ActiveStereoPacker.Reset();
+	ReleaseFrameReservation();
+	ActiveMemoryBudget.Reset();
+	ActiveReadinessStats.Reset();
+	ActiveWarmUpStats.Reset();
+	ActiveDenoiseStats.Reset();
+	WarmUpPoses.Empty();
+	CurrentViewHashes.Empty();
+	CurrentSceneViewHashes.Empty();
+}
+
+// 打包输出时某一目没有产生图像，该位置的其余各目不再等待
+void ACameraArrayManager::FailStereoEye(int32 CameraIndex)
+{
+	if (ActiveStereoPacker.IsValid())
+	{
+		ActiveStereoPacker->FailEye(CameraIndex / GetEyesPerPosition(), CameraIndex % GetEyesPerPosition());
+	}
+}
+
+// 任务结束、中止或管理器销毁时，仍未到齐的位置不会再输出，逐个记录后丢弃
+void ACameraArrayManager::DiscardIncompleteStereoPairs()
+{
+	if (!ActiveStereoPacker.IsValid())
+	{
+		return;
+	}
+	const int32 NumDiscarded = ActiveStereoPacker->DiscardIncomplete();
+	if (NumDiscarded > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("DiscardIncompleteStereoPairs: %d 个位置的各目未到齐，没有输出打包图像"), NumDiscarded);
+	}
+}
+
+FString ACameraArrayManager::GetCameraOutputFilePath(int32 CameraIndex) const
+{
+	if (bIsPreviewPass)
+	{
+		// 预览缩略图统一用JPEG，写入输出目录下的Preview子目录
+		return GetPreviewDirectory() / (GetCameraBaseName(CameraIndex) + TEXT(".jpg"));
+	}
+	if (ActiveStereoPacker.IsValid())
+	{
+		// 打包输出：同一位置的各目共用一个文件 前缀_位置.格式
+		const FString PackedFileName = FString::Printf(TEXT("%s_%03d.%s"), *CameraNamePrefix, CameraIndex / GetEyesPerPosition(), *GetFileExtension());
+		return FPaths::Combine(FPaths::ProjectSavedDir(), OutputPath, GetTimeSampleDirectoryName(), PackedFileName);
+	}
+	if (IsTimeSampling())
+	{
+		return FPaths::Combine(FPaths::ProjectSavedDir(), OutputPath, GetTimeSampleDirectoryName(), GetCameraFileName(CameraIndex));
+	}
+	return FPaths::Combine(FPaths::ProjectSavedDir(), OutputPath, GetCameraFileName(CameraIndex));
+}
+
+// 核心函数：为单个相机执行截图，并在完成后调用OnComplete回调
+void ACameraArrayManager::ExecuteScreenshotForCamera(int32 CameraIndex, TFunction<void()> OnComplete)
+{
+	if (!ManagedCameras.IsValidIndex(CameraIndex) || !IsValid(ManagedCameras[CameraIndex]))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ExecuteScreenshotForCamera: Invalid camera at index %d."), CameraIndex);
+		FailStereoEye(CameraIndex);
+		OnComplete(); // 即使失败也要调用回调，以继续循环
+		return;
+	}
+
+	const FString FullFilePath = GetCameraOutputFilePath(CameraIndex);
+
+	// 跳过的相机用已有文件填入联系表，否则留下黑色的格子
+	auto SkipWithExistingFile = [this, CameraIndex, &FullFilePath, &OnComplete]()
+	{
+		if (FPlatformFileManager::Get().GetPlatformFile().FileExists(*FullFilePath))
+		{
+			QueueContactSheetFromFile(CameraIndex, FullFilePath, false, FDateTime::MinValue());
+		}
+		OnComplete();
+	};
+
+	// 预览总是覆盖上一次的缩略图
+	if (bBatchUsesProgressive)
+	{
+		// 渐进渲染由累积状态决定是否跳过，代替增量渲染的判断
+		if (!PrepareProgressiveCamera(CameraIndex, FullFilePath))
+		{
+			// 之后的遍跳过时，联系表中已经是这次写出的图像；按帧范围渲染时每个时间步换新表，需要重新读取
+			if (CurrentProgressivePass == 0 || IsTimeSampling())
+			{
+				SkipWithExistingFile();
+			}
+			else
+			{
+				OnComplete();
+			}
+			return;
+		}
+	}
+	else if (!bIsPreviewPass)
+	{
+		// 增量渲染：视角哈希与上次日志一致且文件仍在，直接跳过
+		if (ShouldSkipUnchangedView(CameraIndex, FullFilePath))
+		{
+			UE_LOG(LogTemp, Log, TEXT("视角未变化，跳过相机 %d: %s"), CameraIndex, *FullFilePath);
+			SkipWithExistingFile();
+			return;
+		}
+
+		// 检查文件是否存在且不覆盖的情况
+		if (!bOverwriteExisting && FPlatformFileManager::Get().GetPlatformFile().FileExists(*FullFilePath))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("文件已存在，跳过保存: %s"), *FullFilePath);
+			SkipWithExistingFile();
+			return;
+		}
+	}
+
+	if (bBatchUsesSceneCapture)
+	{
+		AdmitAndCaptureForCamera(CameraIndex, FullFilePath, MoveTemp(OnComplete), FPlatformTime::Seconds());
+	}
+	else
+	{
+		ExecuteViewportScreenshotForCamera(CameraIndex, FullFilePath, OnComplete);
+	}
+}
+
+// 场景捕获路径的准入：在途帧的内存加上这一帧超出预算时，隔一小段时间再试，后台每写完一帧都会腾出空间
+void ACameraArrayManager::AdmitAndCaptureForCamera(int32 CameraIndex, const FString& FullFilePath, TFunction<void()> OnComplete, double WaitStartTime)
+{
+	const int64 FrameBytes = EstimateInFlightFrameBytes();
+	if (ActiveMemoryBudget.IsValid())
+	{
+		if (!ActiveMemoryBudget->TryReserve(FrameBytes))
+		{
+			RenderStatus = FString::Printf(TEXT("等待内存... (%d/%d)"), CameraIndex + 1, ManagedCameras.Num());
+			FTimerDelegate RetryDelegate;
+			RetryDelegate.BindLambda([this, CameraIndex, FullFilePath, OnComplete = MoveTemp(OnComplete), WaitStartTime]() mutable
+			{
+				if (bIsTaskRunning)
+				{
+					AdmitAndCaptureForCamera(CameraIndex, FullFilePath, MoveTemp(OnComplete), WaitStartTime);
+				}
+			});
+			GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, RetryDelegate, 0.05f, false);
+			return;
+		}
+
+		const double WaitSeconds = FPlatformTime::Seconds() - WaitStartTime;
+		if (WaitSeconds > 0.01)
+		{
+			ActiveMemoryBudget->RecordStall(WaitSeconds);
+		}
+		AdmittedFrameBytes = FrameBytes;
+	}
+
+	if (bBatchUsesPanorama)
+	{
+		// 全景的6个面朝向各不相同，每个面的时域历史仍按截图前采样数累积，这里只等待流送
+		if (ShouldWaitForViewReady())
+		{
+			WaitForViewReady(ManagedCameras[CameraIndex]->GetActorLocation(), 90.0f, FMath::Max(PanoramaWidth / 4, 2), false, nullptr,
+				[this, CameraIndex, FullFilePath, OnComplete]()
+				{
+					ExecutePanoramaCaptureForCamera(CameraIndex, FullFilePath, OnComplete);
+				});
+		}
+		else
+		{
+			ExecutePanoramaCaptureForCamera(CameraIndex, FullFilePath, OnComplete);
+		}
+	}
+	else
+	{
+		ExecuteSceneCaptureForCamera(CameraIndex, FullFilePath, OnComplete);
+	}
+}
+
+void ACameraArrayManager::AttachFrameReservation(FCameraArrayFrameWriteRequest& Request)
+{
+	Request.MemoryBudget = ActiveMemoryBudget;
+	Request.ReservedBytes = AdmittedFrameBytes;
+	AdmittedFrameBytes = 0;
+}
+
+void ACameraArrayManager::AttachRenderCost(FCameraArrayFrameWriteRequest& Request, int32 CameraIndex, double CaptureStartTime) const
+{
+	if (ActiveRenderCosts.IsValid() && !bIsPreviewPass)
+	{
+		Request.RenderCosts = ActiveRenderCosts;
+		Request.JournalKey = GetJournalKey(CameraIndex);
+		Request.CaptureStartTime = CaptureStartTime;
+	}
+}
+
+// 捕获失败、没有生成写出请求时立即归还
+void ACameraArrayManager::ReleaseFrameReservation()
+{
+	if (AdmittedFrameBytes > 0 && ActiveMemoryBudget.IsValid())
+	{
+		ActiveMemoryBudget->Release(AdmittedFrameBytes);
+	}
+	AdmittedFrameBytes = 0;
+}
+
+// 预览、全景、镜头畸变、引擎截图不支持的格式、后台渲染、抖动累积、降噪、渐进渲染以及区域捕获都只能走场景捕获路径
+bool ACameraArrayManager::UsesSceneCapture(bool bPreview) const
+{
+	const bool bLensDistortion = !bCapturePanorama && bApplyLensDistortion && CameraIntrinsics.Num() > 0;
+	return bPreview || bCapturePanorama || bLensDistortion || bRenderInBackground || bJitteredAccumulation || bDenoisePathTracing ||
+		bProgressiveRefinement || bCaptureRegionOfInterest || !IsEngineScreenshotFormat() || CaptureBackend == ECameraArrayCaptureBackend::SceneCapture;
+}
+
+void ACameraArrayManager::RunCaptureSteps(int32 FirstStep, int32 NumSteps, TFunction<void(int32)> Step, TFunction<void()> OnDone)
+{
+	const int32 EndStep = bRenderInBackground ? FMath::Min(FirstStep + FMath::Max(BackgroundCapturesPerTick, 1), NumSteps) : NumSteps;
+	for (int32 Index = FirstStep; Index < EndStep; ++Index)
+	{
+		Step(Index);
+	}
+
+	if (EndStep >= NumSteps)
+	{
+		OnDone();
+		return;
+	}
+
+	// 剩下的步骤留到下一个编辑器帧，中间视口照常绘制；终止任务时清除该定时器
+	FTimerDelegate NextStepsDelegate;
+	NextStepsDelegate.BindLambda([this, EndStep, NumSteps, Step = MoveTemp(Step), OnDone = MoveTemp(OnDone)]() mutable
+	{
+		if (bIsTaskRunning)
+		{
+			RunCaptureSteps(EndStep, NumSteps, MoveTemp(Step), MoveTemp(OnDone));
+		}
+	});
+	GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, NextStepsDelegate, 0.001f, false);
+}
+
+void ACameraArrayManager::WaitForViewReady(const FVector& ViewOrigin, float FOVDegrees, int32 ViewWidth, bool bNeedsHistory, TFunction<void()> OnWaitFrame, TFunction<void()> OnReady)
+{
+	FCameraArrayReadinessSettings Settings;
+	Settings.TimeoutSeconds = FMath::Max(ReadyTimeoutSeconds, 0.1f);
+	if (bNeedsHistory && FCameraArrayReadinessGate::UsesTemporalHistory(IsValid(PostProcessVolumeRef) ? &PostProcessVolumeRef->Settings : nullptr))
+	{
+		Settings.MinFrames = FMath::Max(Settings.MinFrames, ReadyHistoryFrames);
+	}
+
+	TSharedRef<FCameraArrayReadinessGate> Gate = MakeShared<FCameraArrayReadinessGate>();
+	Gate->Begin(Settings, ViewOrigin, FOVDegrees, ViewWidth);
+	PollViewReady(Gate, MoveTemp(OnWaitFrame), MoveTemp(OnReady));
+}
+
+void ACameraArrayManager::PollViewReady(TSharedRef<FCameraArrayReadinessGate> Gate, TFunction<void()> OnWaitFrame, TFunction<void()> OnReady)
+{
+	const FCameraArrayReadinessGate::EResult Result = Gate->Poll();
+	if (Result != FCameraArrayReadinessGate::EResult::Waiting)
+	{
+		const bool bTimedOut = Result == FCameraArrayReadinessGate::EResult::TimedOut;
+		if (bTimedOut)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("就绪检测超时：等待 %d 帧 / %.2f 秒后仍有 %d 个流送请求，继续截图。"),
+				Gate->GetFramesWaited(), Gate->GetSecondsWaited(), Gate->GetPendingRequests());
+		}
+		if (ActiveReadinessStats.IsValid())
+		{
+			ActiveReadinessStats->Record(*Gate, bTimedOut);
+		}
+		OnReady();
+		return;
+	}
+
+	if (OnWaitFrame)
+	{
+		OnWaitFrame();
+	}
+
+	// 下一个编辑器帧再检查，中间流送系统更新、视口照常绘制；终止任务时清除该定时器
+	FTimerDelegate NextPollDelegate;
+	NextPollDelegate.BindLambda([this, Gate, OnWaitFrame = MoveTemp(OnWaitFrame), OnReady = MoveTemp(OnReady)]() mutable
+	{
+		if (bIsTaskRunning)
+		{
+			PollViewReady(Gate, MoveTemp(OnWaitFrame), MoveTemp(OnReady));
+		}
+	});
+	GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, NextPollDelegate, 0.001f, false);
+}
+
+void ACameraArrayManager::StartWarmUpPass(TFunction<void()> OnDone)
+{
+	// 视口截图路径没有准备场景捕获组件，预热只需要与视口一致的ShowFlags和后处理
+	if (!bBatchUsesSceneCapture)
+	{
+		InitializeCaptureComponents();
+		SyncShowFlagsWithEditorViewport();
+		SyncPostProcessSettings();
+	}
+
+	// 输出格式相同才会用到相同的PSO，分辨率只取很小的一份
+	const ETextureRenderTargetFormat Format = IsHdrFormat() || bBatchUsesAccumulation ? RTF_RGBA16f : RTF_RGBA8;
+	const FIntPoint Resolution = GetCaptureResolution();
+	const int32 Width = CameraArrayWarmUp::TargetWidth;
+	const int32 Height = bBatchUsesPanorama ? Width : FMath::Max(1, FMath::RoundToInt(static_cast<float>(Width) * Resolution.Y / FMath::Max(Resolution.X, 1)));
+	if (!IsValid(WarmUpRenderTarget) || WarmUpRenderTarget->SizeY != Height || WarmUpRenderTarget->RenderTargetFormat != Format)
+	{
+		if (WarmUpRenderTarget)
+		{
+			WarmUpRenderTarget->MarkAsGarbage();
+		}
+		WarmUpRenderTarget = NewObject<UTextureRenderTarget2D>(this, TEXT("WarmUpRenderTarget"));
+		WarmUpRenderTarget->RenderTargetFormat = Format;
+		WarmUpRenderTarget->SizeX = Width;
+		WarmUpRenderTarget->SizeY = Height;
+		WarmUpRenderTarget->bAutoGenerateMips = false;
+		WarmUpRenderTarget->UpdateResource();
+	}
+
+	WarmUpPoses.Reset();
+	for (const int32 Selected : CameraArrayWarmUp::SelectPoses(CaptureOrder.Num(), WarmUpMaxPoses))
+	{
+		const int32 CameraIndex = CaptureOrder[Selected];
+		if (ManagedCameras.IsValidIndex(CameraIndex) && IsValid(ManagedCameras[CameraIndex]))
+		{
+			WarmUpPoses.Add(CameraIndex);
+		}
+	}
+
+	ActiveWarmUpStats = MakeShared<FCameraArrayWarmUpStats>();
+	ActiveWarmUpStats->NumPoses = WarmUpPoses.Num();
+	UE_LOG(LogTemp, Log, TEXT("StartWarmUpPass: 预热 %d 个位姿（%dx%d）。"), WarmUpPoses.Num(), Width, Height);
+	RunWarmUpRound(0, MoveTemp(OnDone));
+}
+
+void ACameraArrayManager::RunWarmUpRound(int32 Round, TFunction<void()> OnDone)
+{
+	// 全景的6个面朝向不同，每个位姿都捕获全部面
+	const int32 StepsPerPose = bBatchUsesPanorama ? CameraArrayPanorama::NumFaces : 1;
+	const ESceneCaptureSource CaptureSource = WarmUpRenderTarget->RenderTargetFormat == RTF_RGBA16f ? ESceneCaptureSource::SCS_FinalToneCurveHDR : ESceneCaptureSource::SCS_FinalColorLDR;
+	ReusableCaptureComponent->TextureTarget = WarmUpRenderTarget;
+	ReusableCaptureComponent->CaptureSource = CaptureSource;
+
+	const double RoundStartTime = FPlatformTime::Seconds();
+	const int32 NumSteps = WarmUpPoses.Num() * StepsPerPose;
+	RunCaptureSteps(0, NumSteps, [this, Round, StepsPerPose, NumSteps](int32 Step)
+	{
+		const int32 CameraIndex = WarmUpPoses[Step / StepsPerPose];
+		const FTransform CameraTransform = ManagedCameras[CameraIndex]->GetActorTransform();
+		if (bBatchUsesPanorama)
+		{
+			ReusableCaptureComponent->SetWorldLocationAndRotation(CameraTransform.GetLocation(),
+				CameraTransform.GetRotation() * CameraArrayPanorama::GetFaceRotation(Step % StepsPerPose));
+			ReusableCaptureComponent->FOVAngle = 90.0f;
+		}
+		else
+		{
+			ReusableCaptureComponent->SetWorldTransform(CameraTransform);
+			ReusableCaptureComponent->FOVAngle = GetCaptureFOV(CameraIndex);
+		}
+		ReusableCaptureComponent->CaptureScene();
+		RenderStatus = FString::Printf(TEXT("预热着色器... 第 %d 轮 (%d/%d)"), Round + 1, Step + 1, NumSteps);
+	},
+	[this, Round, NumSteps, RoundStartTime, OnDone = MoveTemp(OnDone)]() mutable
+	{
+		ActiveWarmUpStats->NumCaptures += NumSteps;
+		ActiveWarmUpStats->CaptureSeconds += FPlatformTime::Seconds() - RoundStartTime;
+		WaitForWarmUpCompilation(Round, false, GFrameCounter, FPlatformTime::Seconds(), MoveTemp(OnDone));
+	});
+}
+
+void ACameraArrayManager::WaitForWarmUpCompilation(int32 Round, bool bCompiledThisRound, uint64 WaitStartFrame, double WaitStartTime, TFunction<void()> OnDone)
+{
+	// 缺失的PSO在渲染线程绘制时才提交编译，捕获后至少隔两帧再判断
+	const int32 NumPending = CameraArrayWarmUp::GetNumPendingCompilations();
+	bCompiledThisRound |= NumPending > 0;
+	ActiveWarmUpStats->MaxPendingCompilations = FMath::Max(ActiveWarmUpStats->MaxPendingCompilations, NumPending);
+	if (NumPending > 0 || GFrameCounter < WaitStartFrame + 2)
+	{
+		if (NumPending > 0)
+		{
+			RenderStatus = FString::Printf(TEXT("预热着色器... 等待编译 (剩余 %d)"), NumPending);
+		}
+		FTimerDelegate NextPollDelegate;
+		NextPollDelegate.BindLambda([this, Round, bCompiledThisRound, WaitStartFrame, WaitStartTime, OnDone = MoveTemp(OnDone)]() mutable
+		{
+			if (bIsTaskRunning)
+			{
+				WaitForWarmUpCompilation(Round, bCompiledThisRound, WaitStartFrame, WaitStartTime, MoveTemp(OnDone));
+			}
+		});
+		GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, NextPollDelegate, 0.05f, false);
+		return;
+	}
+
+	ActiveWarmUpStats->CompileWaitSeconds += FPlatformTime::Seconds() - WaitStartTime;
+	ActiveWarmUpStats->NumRounds = Round + 1;
+
+	// 编译完成的材质第一次以真实着色器绘制时可能需要新的PSO，再走一轮确认
+	if (bCompiledThisRound && Round + 1 < CameraArrayWarmUp::MaxRounds)
+	{
+		RunWarmUpRound(Round + 1, MoveTemp(OnDone));
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("StartWarmUpPass: %s"), *ActiveWarmUpStats->Describe());
+	OnDone();
+}
+
+// 视口截图路径：移动当前编辑器视口到相机位置，等待画面就绪或按帧数延迟后截图
+void ACameraArrayManager::ExecuteViewportScreenshotForCamera(int32 CameraIndex, const FString& FullFilePath, TFunction<void()> OnComplete)
+{
+	AActor* CameraActor = ManagedCameras[CameraIndex];
+	FEditorViewportClient* ViewportClient = static_cast<FEditorViewportClient*>(GEditor->GetActiveViewport()->GetClient());
+	
+	if (!ViewportClient)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ExecuteScreenshotForCamera: Could not get active editor viewport client."));
+		OnComplete();
+		return;
+	}
+
+	// 1. 定位视口
+	const FTransform CameraTransform = CameraActor->GetActorTransform();
+	ViewportClient->SetViewLocation(CameraTransform.GetLocation());
+	ViewportClient->SetViewRotation(CameraTransform.GetRotation().Rotator());
+	ViewportClient->ViewFOV = GetCameraFOV(CameraIndex);
+	ViewportClient->SetGameView(true);
+	ViewportClient->SetRealtime(true);
+	ViewportClient->ViewportType = LVT_Perspective;
+	ViewportClient->Invalidate();
+
+	RenderStatus = FString::Printf(TEXT("处理中... (%d/%d)"), CameraIndex + 1, ManagedCameras.Num());
+	UE_LOG(LogTemp, Log, TEXT("Processing screenshot for camera index %d."), CameraIndex);
+
+	// 2. 配置并请求截图
+	const bool bIsPathTracing = ViewportClient->EngineShowFlags.PathTracing;
+	const bool bWaitForReady = ShouldWaitForViewReady();
+	const FDateTime StartTimeUtc = FDateTime::UtcNow();
+
+	int32 FramesDelay = 1;
+	if (bIsPathTracing)
+	{
+		int32 SamplesPerPixel = 1;
+		if (PostProcessVolumeRef)
+		{
+			SamplesPerPixel = PostProcessVolumeRef->Settings.PathTracingSamplesPerPixel;
+		}
+		FramesDelay = FMath::Max(SamplesPerPixel, 1);
+		UE_LOG(LogTemp, Log, TEXT("Path Tracing: Requesting screenshot now; delaying capture by %d frames."), FramesDelay);
+	}
+	else
+	{
+		// 就绪检测已经等到时域历史稳定，截图只需再延迟一帧
+		FramesDelay = bWaitForReady ? 1 : FMath::Max(SPPLit, 1);
+		UE_LOG(LogTemp, Log, TEXT("Rasterization: Requesting screenshot now; delaying capture by %d frames."), FramesDelay);
+	}
+
+	auto RequestScreenshot = [this, OnComplete, CameraIndex, FullFilePath, FramesDelay, StartTimeUtc]()
+	{
+		IConsoleManager::Get().FindConsoleVariable(TEXT("r.HighResScreenshotDelay"))->Set(FramesDelay);
+
+		// 覆盖时旧文件仍在，联系表要等到时间戳变化后再读
+		const FDateTime PreviousTimeStamp = IFileManager::Get().GetTimeStamp(*FullFilePath);
+
+		// 立即配置并请求截图；没有请求成功时不会写出文件，之后的日志、耗时与联系表都跳过
+		FViewport* ActiveViewport = GEditor ? GEditor->GetActiveViewport() : nullptr;
+		const bool bScreenshotRequested = ActiveViewport != nullptr;
+		if (bScreenshotRequested)
+		{
+			FHighResScreenshotConfig& HRConfig = GetHighResScreenshotConfig();
+			HRConfig.bCaptureHDR = IsHdrFormat();
+			HRConfig.FilenameOverride = FullFilePath;
+			HRConfig.SetResolution(RenderTargetX, RenderTargetY, 1.0f);
+			HRConfig.bDumpBufferVisualizationTargets = false;
+			ActiveViewport->TakeHighResScreenShot();
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("ExecuteScreenshotForCamera: 没有活动视口，相机 %d 未截图。"), CameraIndex);
+		}
+
+		// 仅延迟推进到下一个相机：按帧数估算时间（假设60fps），保持与截图延迟对齐
+		const float AdvanceDelaySeconds = (static_cast<float>(FramesDelay) / 60.0f) + 0.05f;
+		FTimerDelegate AdvanceDelegate;
+		AdvanceDelegate.BindLambda([this, OnComplete, CameraIndex, FullFilePath, StartTimeUtc, PreviousTimeStamp, bScreenshotRequested]()
+		{
+			// 若已强制停止，则不再推进
+			if (!bIsTaskRunning)
+			{
+				return;
+			}
+			if (!bScreenshotRequested)
+			{
+				OnComplete();
+				return;
+			}
+			RecordRenderedView(CameraIndex);
+			if (ActiveRenderCosts.IsValid() && !bIsPreviewPass)
+			{
+				// 推进时引擎可能还没写完，耗时在保存日志时按文件的修改时间计算
+				ActiveRenderCosts->AddEngineWrittenFile(GetJournalKey(CameraIndex), FPaths::ConvertRelativePathToFull(FullFilePath), StartTimeUtc);
+			}
+			QueueContactSheetFromFile(CameraIndex, FullFilePath, true, PreviousTimeStamp);
+			OnComplete();
+		});
+		// 复用 PathTracingLogTimerHandle 作为推进句柄
+		FTimerManager& TM = GetWorld()->GetTimerManager();
+		if (TM.IsTimerActive(PathTracingLogTimerHandle))
+		{
+			TM.ClearTimer(PathTracingLogTimerHandle);
+		}
+		TM.SetTimer(PathTracingLogTimerHandle, AdvanceDelegate, AdvanceDelaySeconds, false);
+	};
+
+	// 视口每帧都在绘制，等待期间不需要额外的预热；路径追踪的累积在移动后重新开始，只等待流送
+	if (bWaitForReady)
+	{
+		WaitForViewReady(CameraTransform.GetLocation(), ViewportClient->ViewFOV, RenderTargetX, !bIsPathTracing, nullptr, MoveTemp(RequestScreenshot));
+	}
+	else
+	{
+		RequestScreenshot();
+	}
+}
+
+void ACameraArrayManager::PrepareSceneCapture()
+{
+	InitializeCaptureComponents();
+	if (!ReadbackStaging.IsValid())
+	{
+		ReadbackStaging = MakeShared<FCameraArrayReadbackStaging, ESPMode::ThreadSafe>();
+	}
+	SyncShowFlagsWithEditorViewport();
+	SyncPostProcessSettings();
+
+	// 路径追踪时让场景捕获按指定采样数累积
+	if (ReusableCaptureComponent->ShowFlags.PathTracing)
+	{
+		FPostProcessSettings& Settings = ReusableCaptureComponent->PostProcessSettings;
+		Settings.bOverride_PathTracingSamplesPerPixel = true;
+		Settings.PathTracingSamplesPerPixel = GetSceneCaptureSampleCount();
+		ReusableCaptureComponent->PostProcessBlendWeight = 1.0f;
+	}
+
+	// 截图中隐藏所有受管理的相机
+	ReusableCaptureComponent->HiddenActors.Empty();
+	for (AActor* Cam : ManagedCameras)
+	{
+		if (IsValid(Cam))
+		{
+			ReusableCaptureComponent->HiddenActors.Add(Cam);
+		}
+	}
+
+	// 各阵列合批绘制的相机线框也不进入截图
+	for (TActorIterator<ACameraArrayManager> It(GetWorld()); It; ++It)
+	{
+		ReusableCaptureComponent->HiddenActors.Add(*It);
+	}
+
+	if (bBatchUsesPanorama)
+	{
+		PrepareSceneCapturePanorama();
+	}
+	if (bBatchUsesLensDistortion)
+	{
+		PrepareLensDistortion();
+	}
+
+	// 路径追踪本身就在像素内抖动累积；取消的批量可能留下抖动投影
+	ReusableCaptureComponent->bUseCustomProjectionMatrix = false;
+	if (bBatchUsesAccumulation && ReusableCaptureComponent->ShowFlags.PathTracing)
+	{
+		UE_LOG(LogTemp, Log, TEXT("PrepareSceneCapture: 路径追踪按采样数累积，不使用抖动累积。"));
+		bBatchUsesAccumulation = false;
+	}
+	if (bBatchUsesAccumulation)
+	{
+		PrepareAccumulation();
+	}
+
+	if (bBatchUsesDenoiser && !ReusableCaptureComponent->ShowFlags.PathTracing)
+	{
+		UE_LOG(LogTemp, Log, TEXT("PrepareSceneCapture: 降噪只用于路径追踪，本次光栅化不降噪。"));
+		bBatchUsesDenoiser = false;
+	}
+	if (bBatchUsesDenoiser && !CameraArrayDenoiser::IsAvailable())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("PrepareSceneCapture: 当前平台没有可用的降噪器，本次输出不降噪。"));
+		bBatchUsesDenoiser = false;
+	}
+	if (bBatchUsesDenoiser)
+	{
+		PrepareDenoiser();
+	}
+
+	if (bBatchUsesProgressive && !ReusableCaptureComponent->ShowFlags.PathTracing)
+	{
+		UE_LOG(LogTemp, Log, TEXT("PrepareSceneCapture: 渐进渲染只用于路径追踪，本次光栅化一次渲染完成。"));
+		bBatchUsesProgressive = false;
+	}
+	if (bBatchUsesProgressive)
+	{
+		PrepareProgressive();
+	}
+
+	// 多目打包要求各目尺寸相同
+	if (bBatchUsesRegion && (!IsValid(LookAtTarget) || ActiveStereoPacker.IsValid()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("PrepareSceneCapture: 区域捕获需要设置场景目标点，且不能与多目打包同时使用，本次渲染整幅画面。"));
+		bBatchUsesRegion = false;
+	}
+}
+
+void ACameraArrayManager::PrepareAccumulation()
+{
+	// 累积时关闭时域抗锯齿与基于速度的运动模糊，抖动采样本身就是抗锯齿，运动模糊来自快门内的时间采样
+	ReusableCaptureComponent->ShowFlags.SetTemporalAA(false);
+	ReusableCaptureComponent->ShowFlags.SetAntiAliasing(false);
+	ReusableCaptureComponent->ShowFlags.SetMotionBlur(false);
+
+	const FIntPoint Resolution = GetCaptureResolution();
+	if (!IsValid(AccumulationTarget) || AccumulationTarget->SizeX != Resolution.X || AccumulationTarget->SizeY != Resolution.Y)
+	{
+		if (AccumulationTarget)
+		{
+			AccumulationTarget->MarkAsGarbage();
+		}
+		AccumulationTarget = NewObject<UTextureRenderTarget2D>(this, TEXT("AccumulationTarget"));
+		AccumulationTarget->RenderTargetFormat = RTF_RGBA32f;
+		AccumulationTarget->bForceLinearGamma = true;
+		AccumulationTarget->TargetGamma = 1.0f;
+		AccumulationTarget->SizeX = Resolution.X;
+		AccumulationTarget->SizeY = Resolution.Y;
+		AccumulationTarget->bAutoGenerateMips = false;
+		AccumulationTarget->UpdateResource();
+	}
+
+	if (AccumulationShutter > 0.0f && (!bRenderTimeRange || !IsValid(LevelSequenceActorRef)))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("PrepareAccumulation: 运动模糊需要按帧范围渲染并指定关卡序列，本次只做空间抖动。"));
+	}
+	UE_LOG(LogTemp, Log, TEXT("PrepareAccumulation: 每个相机 %d 个抖动采样，快门 %.2f 帧。"), FMath::Max(AccumulationSamples, 1), AccumulationShutter);
+}
+
+void ACameraArrayManager::CaptureAccumulationSample(int32 SampleIndex, int32 NumSamples)
+{
+	UTextureRenderTarget2D* SampleTarget = ReusableCaptureComponent->TextureTarget;
+	const FVector2D Jitter = CameraArrayAccumulation::GetJitter(SampleIndex);
+	ReusableCaptureComponent->bUseCustomProjectionMatrix = true;
+	if (bBatchUsesRegion)
+	{
+		// 区域捕获时在离轴投影上加抖动，抖动按区域RenderTarget的像素计算
+		const FIntPoint Resolution = GetCaptureResolution();
+		FMatrix Projection = CameraArrayRegion::MakeCropProjection(ReusableCaptureComponent->FOVAngle, Resolution.X, Resolution.Y, CurrentCaptureRect);
+		CameraArrayAccumulation::ApplyJitter(Projection, SampleTarget->SizeX, SampleTarget->SizeY, Jitter);
+		ReusableCaptureComponent->CustomProjectionMatrix = Projection;
+	}
+	else
+	{
+		ReusableCaptureComponent->CustomProjectionMatrix = CameraArrayAccumulation::MakeJitteredProjection(
+			ReusableCaptureComponent->FOVAngle, SampleTarget->SizeX, SampleTarget->SizeY, Jitter);
+	}
+
+	if (AccumulationShutter > 0.0f)
+	{
+		SetSequenceFrameOffset(CameraArrayAccumulation::GetShutterOffset(SampleIndex, NumSamples, AccumulationShutter));
+	}
+
+	// 捕获与画布绘制按提交顺序在渲染线程执行，累加读到的总是这一次的捕获结果
+	ReusableCaptureComponent->CaptureScene();
+	CameraArrayAccumulation::Composite(GetWorld(), SampleTarget, AccumulationTarget, 1.0f / NumSamples, SampleIndex == 0);
+}
+
+// 只在按帧范围渲染且序列可用时生效；偏移为0时回到当前时间步的整帧
+void ACameraArrayManager::SetSequenceFrameOffset(double FrameOffset)
+{
+	if (!IsTimeSampling() || !IsValid(LevelSequenceActorRef))
+	{
+		return;
+	}
+	ULevelSequencePlayer* Player = LevelSequenceActorRef->GetSequencePlayer();
+	if (Player && Player->GetSequence())
+	{
+		const FFrameTime Time = FFrameTime::FromDecimal(TimeSampleFrames[CurrentTimeSampleIndex] + FrameOffset);
+		Player->SetPlaybackPosition(FMovieSceneSequencePlaybackParams(Time, EUpdatePositionMethod::Jump));
+	}
+}
+
+void ACameraArrayManager::PrepareDenoiser()
+{
+	// 由本插件在后台线程降噪，引擎自带的降噪会在渲染线程上同步执行，且只能拿到降噪后的图像
+	FPostProcessSettings& Settings = ReusableCaptureComponent->PostProcessSettings;
+	Settings.bOverride_PathTracingEnableDenoiser = true;
+	Settings.PathTracingEnableDenoiser = false;
+
+	const FIntPoint Resolution = GetCaptureResolution();
+	auto EnsureTarget = [this, Resolution](TObjectPtr<UTextureRenderTarget2D>& Target, const TCHAR* Name)
+	{
+		if (IsValid(Target) && Target->SizeX == Resolution.X && Target->SizeY == Resolution.Y)
+		{
+			return;
+		}
+		if (Target)
+		{
+			Target->MarkAsGarbage();
+		}
+		Target = NewObject<UTextureRenderTarget2D>(this, Name);
+		Target->RenderTargetFormat = RTF_RGBA16f;
+		Target->bForceLinearGamma = true;
+		Target->TargetGamma = 1.0f;
+		Target->SizeX = Resolution.X;
+		Target->SizeY = Resolution.Y;
+		Target->bAutoGenerateMips = false;
+		Target->UpdateResource();
+	};
+	EnsureTarget(DenoiseAlbedoTarget, TEXT("DenoiseAlbedoTarget"));
+	EnsureTarget(DenoiseNormalTarget, TEXT("DenoiseNormalTarget"));
+
+	ActiveDenoiseStats = MakeShared<FCameraArrayDenoiseStats, ESPMode::ThreadSafe>();
+	UE_LOG(LogTemp, Log, TEXT("PrepareDenoiser: 每个相机 %d spp，渲染后在后台线程降噪。"), GetSceneCaptureSampleCount());
+}
+
+// 辅助通道取光栅化GBuffer的首次命中：与路径追踪的主光线看到同一表面，且本身没有噪点
+// 渲染图像已在RenderTarget中，这两次捕获写入各自的RenderTarget，不影响它；下一个相机移动后路径追踪重新累积
+void ACameraArrayManager::CaptureDenoiseAovs()
+{
+	UTextureRenderTarget2D* BeautyTarget = ReusableCaptureComponent->TextureTarget;
+	const ESceneCaptureSource BeautySource = ReusableCaptureComponent->CaptureSource;
+	ReusableCaptureComponent->ShowFlags.SetPathTracing(false);
+
+	ReusableCaptureComponent->TextureTarget = DenoiseAlbedoTarget;
+	ReusableCaptureComponent->CaptureSource = ESceneCaptureSource::SCS_BaseColor;
+	ReusableCaptureComponent->CaptureScene();
+
+	ReusableCaptureComponent->TextureTarget = DenoiseNormalTarget;
+	ReusableCaptureComponent->CaptureSource = ESceneCaptureSource::SCS_Normal;
+	ReusableCaptureComponent->CaptureScene();
+
+	ReusableCaptureComponent->ShowFlags.SetPathTracing(true);
+	ReusableCaptureComponent->TextureTarget = BeautyTarget;
+	ReusableCaptureComponent->CaptureSource = BeautySource;
+}
+
+void ACameraArrayManager::PrepareProgressive()
+{
+	// 状态键只包含影响累积采样的设置（分辨率、FOV、区域、后处理体积）；累积状态是编码与降噪之前的半精度均值，
+	// 输出格式、压缩与降噪不影响它；每像素采样数也不在其中，提高采样数后从已有的状态继续追加
+	ProgressiveSettingsHash = ComputeRenderSettingsHash(true, TEXT("AffectsAccumulation"));
+	if (IsValid(PostProcessVolumeRef))
+	{
+		// 后处理体积中的路径追踪设置（反弹次数等）改变采样本身，按值计入；每像素采样数清零后再计入
+		FPostProcessSettings Settings = PostProcessVolumeRef->Settings;
+		Settings.PathTracingSamplesPerPixel = 0;
+		FString SettingsText;
+		FPostProcessSettings::StaticStruct()->ExportText(SettingsText, &Settings, nullptr, nullptr, PPF_None, nullptr);
+		FXxHash64Builder Builder;
+		CameraArrayViewHash::HashBytes(Builder, &ProgressiveSettingsHash, sizeof(ProgressiveSettingsHash));
+		CameraArrayViewHash::HashString(Builder, SettingsText);
+		ProgressiveSettingsHash = Builder.Finalize().Hash;
+	}
+	ProgressivePassSamples = 0;
+
+	// 各遍的采样必须使用不同的随机序列，合并后噪点才会下降
+	const IConsoleVariable* SeedCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.PathTracing.FrameIndependentTemporalSeed"));
+	if (SeedCVar && SeedCVar->GetInt() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("PrepareProgressive: r.PathTracing.FrameIndependentTemporalSeed 为0时各遍的采样序列相同，追加的采样不会降低噪点。"));
+	}
+
+	const int32 NumPasses = FMath::Max(ProgressivePasses, 1);
+	const int32 TotalSamples = IsValid(PostProcessVolumeRef) ? FMath::Max(PostProcessVolumeRef->Settings.PathTracingSamplesPerPixel, 1) : 1;
+	UE_LOG(LogTemp, Log, TEXT("PrepareProgressive: %d 遍，第一遍 %d spp，最终 %d spp。"),
+		NumPasses, CameraArrayProgressive::GetCumulativeSamples(0, NumPasses, TotalSamples), TotalSamples);
+}
+
+// 读取该视角的累积状态，算出这一遍要追加的采样数；已有足够采样时返回false跳过
+bool ACameraArrayManager::PrepareProgressiveCamera(int32 CameraIndex, const FString& FullFilePath)
+{
+	const FIntPoint Resolution = GetCaptureRect(CameraIndex).Size();
+	const int32 TotalSamples = IsValid(PostProcessVolumeRef) ? FMath::Max(PostProcessVolumeRef->Settings.PathTracingSamplesPerPixel, 1) : 1;
+	const int32 TargetSamples = CameraArrayProgressive::GetCumulativeSamples(CurrentProgressivePass, ProgressivePasses, TotalSamples);
+	ProgressivePriorSamples = CameraArrayProgressive::ReadStoredSamples(GetProgressiveStatePath(CameraIndex), GetProgressiveStateKey(CameraIndex), Resolution.X, Resolution.Y);
+	ProgressivePassSamples = FMath::Max(TargetSamples - ProgressivePriorSamples, 0);
+
+	if (ProgressivePassSamples == 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("相机 %d 已有 %d 个采样，第 %d 遍跳过: %s"), CameraIndex, ProgressivePriorSamples, CurrentProgressivePass + 1, *FullFilePath);
+		return false;
+	}
+
+	// 没有累积状态的已有文件不是渐进渲染的结果，按覆盖设置处理
+	if (ProgressivePriorSamples == 0 && !bOverwriteExisting && FPlatformFileManager::Get().GetPlatformFile().FileExists(*FullFilePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("文件已存在，跳过保存: %s"), *FullFilePath);
+		ProgressivePassSamples = 0;
+		return false;
+	}
+	return true;
+}
+
+void ACameraArrayManager::StartNextProgressivePass()
+{
+	if (!bIsTaskRunning)
+	{
+		return;
+	}
+	if (PendingFrameWrites.IsValid() && PendingFrameWrites->GetValue() > 0)
+	{
+		RenderStatus = FString::Printf(TEXT("等待第 %d 遍写出... (剩余 %d)"), CurrentProgressivePass + 1, PendingFrameWrites->GetValue());
+		GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, this, &ACameraArrayManager::StartNextProgressivePass, 0.1f, false);
+		return;
+	}
+
+	++CurrentProgressivePass;
+	CurrentScreenshotIndex = 0;
+	UE_LOG(LogTemp, Log, TEXT("StartNextProgressivePass: 开始第 %d/%d 遍。"), CurrentProgressivePass + 1, FMath::Max(ProgressivePasses, 1));
+
+	// 按帧范围渲染时每一遍都从第一帧开始，跳转后留一帧让场景状态同步
+	if (IsTimeSampling())
+	{
+		RetireContactSheet();
+		CurrentTimeSampleIndex = 0;
+		ApplyTimeSample(CurrentTimeSampleIndex);
+		ComputeViewHashes();
+		GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, this, &ACameraArrayManager::TakeNextHighResScreenshot_Recursive, 0.1f, false);
+		return;
+	}
+	TakeNextHighResScreenshot_Recursive();
+}
+
+FString ACameraArrayManager::GetProgressiveStatePath(int32 CameraIndex) const
+{
+	return CameraArrayProgressive::GetStateDirectory(GetFullOutputDirectory()) / (GetJournalKey(CameraIndex) + TEXT(".state"));
+}
+
+// 设置、相机位姿与FOV决定状态是否可以继续累积；启用增量渲染时还包含视锥内的场景状态
+uint64 ACameraArrayManager::GetProgressiveStateKey(int32 CameraIndex) const
+{
+	FXxHash64Builder Builder;
+	CameraArrayViewHash::HashBytes(Builder, &ProgressiveSettingsHash, sizeof(ProgressiveSettingsHash));
+	if (ManagedCameras.IsValidIndex(CameraIndex) && IsValid(ManagedCameras[CameraIndex]))
+	{
+		const FTransform Transform = ManagedCameras[CameraIndex]->GetActorTransform();
+		const FVector Location = Transform.GetLocation();
+		const FQuat Rotation = Transform.GetRotation();
+		CameraArrayViewHash::HashBytes(Builder, &Location, sizeof(Location));
+		CameraArrayViewHash::HashBytes(Builder, &Rotation, sizeof(Rotation));
+	}
+	const float FOV = GetCaptureFOV(CameraIndex);
+	CameraArrayViewHash::HashBytes(Builder, &FOV, sizeof(FOV));
+	if (const uint64* ViewHash = CurrentSceneViewHashes.Find(CameraIndex))
+	{
+		CameraArrayViewHash::HashBytes(Builder, ViewHash, sizeof(*ViewHash));
+	}
+	return Builder.Finalize().Hash;
+}
+
+FIntRect ACameraArrayManager::GetCaptureRect(int32 CameraIndex) const
+{
+	const FIntPoint Resolution = GetCaptureResolution();
+	const FIntRect FullRect(FIntPoint::ZeroValue, Resolution);
+	if (!bBatchUsesRegion || !IsValid(LookAtTarget) || !ManagedCameras.IsValidIndex(CameraIndex) || !IsValid(ManagedCameras[CameraIndex]))
+	{
+		return FullRect;
+	}
+
+	FIntRect Rect;
+	const FBox Bounds = LookAtTarget->GetComponentsBoundingBox(true);
+	if (!CameraArrayRegion::ProjectBounds(Bounds, ManagedCameras[CameraIndex]->GetActorTransform(), GetCaptureFOV(CameraIndex),
+		Resolution.X, Resolution.Y, RegionPadding, Rect))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("相机 %d 看不到完整的目标包围盒，渲染整幅画面。"), CameraIndex);
+		return FullRect;
+	}
+	return Rect;
+}
+
+// 尺寸不变时不做任何事；之前提交的回读在渲染线程上先于重建执行，不受影响
+void ACameraArrayManager::ResizeSceneCaptureTargets(const FIntPoint& Size)
+{
+	UTextureRenderTarget2D* Targets[] = {
+		ReusableCaptureComponent->TextureTarget.Get(),
+		bBatchUsesAccumulation ? AccumulationTarget.Get() : nullptr,
+		bBatchUsesDenoiser ? DenoiseAlbedoTarget.Get() : nullptr,
+		bBatchUsesDenoiser ? DenoiseNormalTarget.Get() : nullptr,
+	};
+	for (UTextureRenderTarget2D* Target : Targets)
+	{
+		if (IsValid(Target) && (Target->SizeX != Size.X || Target->SizeY != Size.Y))
+		{
+			Target->ResizeTarget(Size.X, Size.Y);
+		}
+	}
+}
+
+void ACameraArrayManager::PrepareLensDistortion()
+{
+	const FIntPoint Resolution = GetCaptureResolution();
+	const double StartTime = FPlatformTime::Seconds();
+	int32 NumBuilt = 0;
+
+	CameraDistortionMaps.Reset();
+	CameraDistortionMaps.SetNum(ManagedCameras.Num());
+	for (int32 i = 0; i < ManagedCameras.Num(); ++i)
+	{
+		const FCameraArrayIntrinsics* Intrinsics = FindIntrinsics(i);
+		if (!Intrinsics)
+		{
+			continue; // 没有内参的相机按统一FOV直接输出
+		}
+
+		const uint64 Key = FCameraArrayDistortionMap::MakeCacheKey(*Intrinsics, Resolution.X, Resolution.Y);
+		TSharedPtr<const FCameraArrayDistortionMap, ESPMode::ThreadSafe>& Cached = DistortionMapCache.FindOrAdd(Key);
+		if (!Cached.IsValid())
+		{
+			Cached = FCameraArrayDistortionMap::Build(*Intrinsics, Resolution.X, Resolution.Y);
+			++NumBuilt;
+		}
+		CameraDistortionMaps[i] = Cached;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("PrepareLensDistortion: %d 个相机使用 %d 张畸变重映射表（新生成 %d 张），耗时 %.3f 秒。"),
+		CameraDistortionMaps.Num(), DistortionMapCache.Num(), NumBuilt, FPlatformTime::Seconds() - StartTime);
+}
+
+float ACameraArrayManager::GetCaptureFOV(int32 CameraIndex) const
+{
+	// 畸变输出需要先渲染覆盖所有畸变光线的更大视角
+	if (bBatchUsesLensDistortion && CameraDistortionMaps.IsValidIndex(CameraIndex) && CameraDistortionMaps[CameraIndex].IsValid())
+	{
+		return CameraDistortionMaps[CameraIndex]->RenderFOV;
+	}
+	return GetCameraFOV(CameraIndex);
+}
+
+void ACameraArrayManager::PrepareSceneCapturePanorama()
+{
+	const int32 FaceSize = FMath::Max(PanoramaWidth / 4, 2);
+	const int32 Width = FaceSize * 4;
+	const int32 Height = FaceSize * 2;
+	const ETextureRenderTargetFormat FaceFormat = IsHdrFormat() ? RTF_RGBA16f : RTF_RGBA8;
+
+	if (!IsValid(ReusablePanoramaFaceTarget) || ReusablePanoramaFaceTarget->SizeX != FaceSize ||
+		ReusablePanoramaFaceTarget->RenderTargetFormat != FaceFormat)
+	{
+		if (ReusablePanoramaFaceTarget)
+		{
+			ReusablePanoramaFaceTarget->MarkAsGarbage();
+		}
+		ReusablePanoramaFaceTarget = NewObject<UTextureRenderTarget2D>(this, TEXT("ReusablePanoramaFaceTarget"));
+		ReusablePanoramaFaceTarget->RenderTargetFormat = FaceFormat;
+		ReusablePanoramaFaceTarget->SizeX = FaceSize;
+		ReusablePanoramaFaceTarget->SizeY = FaceSize;
+		ReusablePanoramaFaceTarget->bAutoGenerateMips = false;
+		ReusablePanoramaFaceTarget->UpdateResource();
+	}
+
+	// 查找表只与尺寸有关，尺寸不变时跨批量复用
+	if (!PanoramaLut.IsValid() || !PanoramaLut->Matches(FaceSize, Width, Height))
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		TSharedRef<CameraArrayPanorama::FEquirectLut, ESPMode::ThreadSafe> NewLut = MakeShared<CameraArrayPanorama::FEquirectLut, ESPMode::ThreadSafe>();
+		NewLut->Build(FaceSize, Width, Height);
+		PanoramaLut = NewLut;
+		UE_LOG(LogTemp, Log, TEXT("PrepareSceneCapturePanorama: 生成 %dx%d 全景查找表（面 %d），耗时 %.3f 秒。"),
+			Width, Height, FaceSize, FPlatformTime::Seconds() - StartTime);
+	}
+}
+
+int32 ACameraArrayManager::GetSceneCaptureSampleCount() const
+{
+	if (IsValid(ReusableCaptureComponent) && ReusableCaptureComponent->ShowFlags.PathTracing)
+	{
+		if (bIsPreviewPass)
+		{
+			return FMath::Max(PreviewSamplesPerPixel, 1);
+		}
+		// 渐进渲染：当前相机在这一遍追加的采样数
+		if (bBatchUsesProgressive && ProgressivePassSamples > 0)
+		{
+			return ProgressivePassSamples;
+		}
+		return IsValid(PostProcessVolumeRef) ? FMath::Max(PostProcessVolumeRef->Settings.PathTracingSamplesPerPixel, 1) : 1;
+	}
+
+	// 光栅化：预览只渲染一次，正式渲染让时域累积按截图前采样数运行
+	return bIsPreviewPass ? 1 : FMath::Max(SPPLit, 1);
+}
+
+// 缓冲池空闲缓冲的上限与预算一致：稳定时缓冲在“在途”和“空闲”之间轮转，两者都不超过预算
+TSharedRef<FCameraArrayMemoryBudget, ESPMode::ThreadSafe> ACameraArrayManager::CreateFrameMemoryBudget() const
+{
+	const int64 BudgetBytes = static_cast<int64>(InFlightMemoryBudgetMB) * 1024 * 1024;
+	FCameraArrayBufferPool& Pool = FCameraArrayBufferPool::Get();
+	Pool.SetMaxPooledBytes(BudgetBytes > 0 ? BudgetBytes : 4096ll * 1024 * 1024);
+	Pool.ResetStats();
+	return MakeShared<FCameraArrayMemoryBudget, ESPMode::ThreadSafe>(BudgetBytes);
+}
+
+// 整个批量期间常驻的内存：RenderTarget与同尺寸的回读暂存纹理、全景查找表与畸变重映射表，以及降噪器的工作内存
+int64 ACameraArrayManager::EstimateResidentBytes() const
+{
+	int64 Bytes = 0;
+	int64 LargestTargetBytes = 0;
+	const UTextureRenderTarget2D* Accumulation = bBatchUsesAccumulation ? AccumulationTarget.Get() : nullptr;
+	const UTextureRenderTarget2D* DenoiseAlbedo = bBatchUsesDenoiser ? DenoiseAlbedoTarget.Get() : nullptr;
+	const UTextureRenderTarget2D* DenoiseNormal = bBatchUsesDenoiser ? DenoiseNormalTarget.Get() : nullptr;
+	for (const UTextureRenderTarget2D* Target : { ReusableLdrRenderTarget.Get(), ReusableHdrRenderTarget.Get(), ReusablePanoramaFaceTarget.Get(), Accumulation, DenoiseAlbedo, DenoiseNormal })
+	{
+		if (IsValid(Target))
+		{
+			const int64 BytesPerPixel = Target->RenderTargetFormat == RTF_RGBA32f ? sizeof(FLinearColor)
+				: Target->RenderTargetFormat == RTF_RGBA16f ? sizeof(FFloat16Color) : sizeof(FColor);
+			const int64 TargetBytes = static_cast<int64>(Target->SizeX) * Target->SizeY * BytesPerPixel;
+			Bytes += TargetBytes;
+			LargestTargetBytes = FMath::Max(LargestTargetBytes, TargetBytes);
+		}
+	}
+	Bytes += LargestTargetBytes;
+	if (bBatchUsesDenoiser && IsValid(DenoiseAlbedoTarget))
+	{
+		// 辅助通道单独的暂存纹理；降噪器同一时间只处理一帧，工作内存不随在途帧数增长
+		Bytes += static_cast<int64>(DenoiseAlbedoTarget->SizeX) * DenoiseAlbedoTarget->SizeY * sizeof(FFloat16Color);
+		Bytes += CameraArrayDenoiser::MaxScratchBytes;
+	}
+	if (bBatchUsesPanorama && PanoramaLut.IsValid())
+	{
+		Bytes += PanoramaLut->Taps.GetAllocatedSize();
+	}
+
+	TSet<const FCameraArrayDistortionMap*> CountedMaps;
+	for (const TSharedPtr<const FCameraArrayDistortionMap, ESPMode::ThreadSafe>& Map : CameraDistortionMaps)
+	{
+		if (Map.IsValid() && !CountedMaps.Contains(Map.Get()))
+		{
+			CountedMaps.Add(Map.Get());
+			Bytes += Map->Taps.GetAllocatedSize();
+		}
+	}
+	return Bytes;
+}
+
+// 一帧从回读到写完的内存：回读像素、处理用的像素（畸变、打包各一份），以及编码缓冲与压缩输出
+// 编码按最坏情况（接近未压缩）估算，宁可少并发几帧也不超出预算
+int64 ACameraArrayManager::EstimateInFlightFrameBytes() const
+{
+	const bool bHdr = !bIsPreviewPass && IsHdrFormat();
+	const bool bHalfToLdr = (bBatchUsesAccumulation || bBatchUsesProgressive || bBatchUsesDenoiser) && !bHdr;
+	const int64 ReadbackBytesPerPixel = bHdr || bHalfToLdr ? sizeof(FFloat16Color) : sizeof(FColor);
+	const int64 PixelBytesPerPixel = bHdr ? sizeof(FLinearColor) : sizeof(FColor);
+	const int64 EncodeBytesPerPixel = bHdr ? 2 * sizeof(FFloat16Color) : sizeof(FColor) + 1;
+
+	if (bBatchUsesPanorama && PanoramaLut.IsValid())
+	{
+		// 6个面的像素加上逐面回读的半精度面，重投影后的全景图再编码
+		const int64 FacePixels = static_cast<int64>(PanoramaLut->FaceSize) * PanoramaLut->FaceSize;
+		const int64 PanoramaPixels = static_cast<int64>(PanoramaLut->Width) * PanoramaLut->Height;
+		return FacePixels * (CameraArrayPanorama::NumFaces * PixelBytesPerPixel + ReadbackBytesPerPixel)
+			+ PanoramaPixels * (PixelBytesPerPixel + EncodeBytesPerPixel);
+	}
+
+	const FIntPoint Resolution = GetCaptureResolution();
+	int64 BytesPerPixel = ReadbackBytesPerPixel + EncodeBytesPerPixel;
+	if (bHdr || bHalfToLdr)
+	{
+		BytesPerPixel += PixelBytesPerPixel; // 半精度转换为浮点或sRGB
+	}
+	if (bBatchUsesLensDistortion)
+	{
+		BytesPerPixel += PixelBytesPerPixel;
+	}
+	if (bBatchUsesProgressive)
+	{
+		// 读入的累积状态；8位输出还要先转换为浮点再合并
+		BytesPerPixel += sizeof(FFloat16Color);
+		if (!bHdr)
+		{
+			BytesPerPixel += sizeof(FLinearColor);
+		}
+	}
+	if (bBatchUsesDenoiser)
+	{
+		// 反照率与法线的半精度回读；8位输出还要先转换为浮点再降噪，渐进渲染已经计入这一份
+		BytesPerPixel += 2 * sizeof(FFloat16Color);
+		if (!bHdr && !bBatchUsesProgressive)
+		{
+			BytesPerPixel += sizeof(FLinearColor);
+		}
+	}
+	if (ActiveStereoPacker.IsValid())
+	{
+		// 打包器保留每一目的副本，最后一目到达时拼成整张；按目均摊
+		BytesPerPixel += 2 * PixelBytesPerPixel;
+	}
+	return static_cast<int64>(Resolution.X) * Resolution.Y * BytesPerPixel;
+}
+
+// 场景捕获路径：连续捕获若干次以累积采样，回读与编码在渲染线程和后台线程进行，不阻塞下一个相机
+void ACameraArrayManager::ExecuteSceneCaptureForCamera(int32 CameraIndex, const FString& FullFilePath, TFunction<void()> OnComplete)
+{
+	AActor* CameraActor = ManagedCameras[CameraIndex];
+	if (!IsValid(ReusableCaptureComponent) || !IsValid(ReusableLdrRenderTarget) || !IsValid(ReusableHdrRenderTarget))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ExecuteSceneCaptureForCamera: 渲染组件无效!"));
+		FailStereoEye(CameraIndex);
+		ReleaseFrameReservation();
+		OnComplete();
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// 累积在线性空间进行，8位输出也先捕获到半精度RenderTarget，写出时再编码为sRGB；渐进渲染的合并与降噪同样如此
+	const bool bSaveAsHdr = (!bIsPreviewPass && IsHdrFormat()) || bBatchUsesAccumulation || bBatchUsesProgressive || bBatchUsesDenoiser;
+	UTextureRenderTarget2D* RenderTarget = bSaveAsHdr ? ReusableHdrRenderTarget : ReusableLdrRenderTarget;
+
+	ReusableCaptureComponent->TextureTarget = RenderTarget;
+	ReusableCaptureComponent->CaptureSource = bSaveAsHdr ? ESceneCaptureSource::SCS_FinalToneCurveHDR : ESceneCaptureSource::SCS_FinalColorLDR;
+	ReusableCaptureComponent->SetWorldTransform(CameraActor->GetActorTransform());
+	ReusableCaptureComponent->FOVAngle = GetCaptureFOV(CameraIndex);
+
+	// 区域捕获：RenderTarget调整到区域大小，离轴投影只渲染这一块；区域为整幅画面时用默认投影
+	if (bBatchUsesRegion)
+	{
+		const FIntPoint Resolution = GetCaptureResolution();
+		CurrentCaptureRect = GetCaptureRect(CameraIndex);
+		ResizeSceneCaptureTargets(CurrentCaptureRect.Size());
+		ReusableCaptureComponent->bUseCustomProjectionMatrix = CurrentCaptureRect != FIntRect(FIntPoint::ZeroValue, Resolution);
+		if (ReusableCaptureComponent->bUseCustomProjectionMatrix)
+		{
+			ReusableCaptureComponent->CustomProjectionMatrix = CameraArrayRegion::MakeCropProjection(
+				ReusableCaptureComponent->FOVAngle, Resolution.X, Resolution.Y, CurrentCaptureRect);
+		}
+	}
+
+	RenderStatus = FString::Printf(TEXT("%s... (%d/%d)"), bIsPreviewPass ? TEXT("预览中") : TEXT("处理中"), CameraIndex + 1, ManagedCameras.Num());
+
+	const int32 NumAccumulationSamples = FMath::Max(AccumulationSamples, 1);
+	auto CaptureStep = [this, NumAccumulationSamples](int32 Step)
+	{
+		if (bBatchUsesAccumulation)
+		{
+			CaptureAccumulationSample(Step, NumAccumulationSamples);
+			return;
+		}
+		ReusableCaptureComponent->CaptureScene();
+	};
+	auto ReadbackAndContinue = [this, RenderTarget, NumAccumulationSamples, CameraIndex, FullFilePath, OnComplete = MoveTemp(OnComplete), StartTime]()
+	{
+		if (bBatchUsesAccumulation)
+		{
+			// 平均值写回半精度RenderTarget，之后的回读与写出不变
+			CameraArrayAccumulation::Composite(GetWorld(), AccumulationTarget, RenderTarget, 1.0f, true);
+			if (AccumulationShutter > 0.0f)
+			{
+				SetSequenceFrameOffset(0.0);
+			}
+		}
+
+		if (bBatchUsesDenoiser)
+		{
+			CaptureDenoiseAovs();
+		}
+
+		// 下一个相机的预热捕获不带抖动或离轴投影
+		ReusableCaptureComponent->bUseCustomProjectionMatrix = false;
+
+		const ECameraArrayImageFormat Format = bIsPreviewPass ? ECameraArrayImageFormat::JPEG : FileFormat;
+		ReadbackAndSaveAsync(RenderTarget, CameraIndex, FullFilePath, Format, StartTime);
+
+		if (!bIsPreviewPass)
+		{
+			RecordRenderedView(CameraIndex);
+		}
+		OnComplete();
+	};
+
+	if (!ShouldWaitForViewReady())
+	{
+		const int32 NumSteps = bBatchUsesAccumulation ? NumAccumulationSamples : GetSceneCaptureSampleCount();
+		RunCaptureSteps(0, NumSteps, MoveTemp(CaptureStep), MoveTemp(ReadbackAndContinue));
+		return;
+	}
+
+	// 光栅化：等待期间每帧捕获一次，时域历史在捕获组件的视图状态中累积，同时产生Nanite与虚拟纹理反馈，就绪后只需再捕获一次
+	// 抖动累积：等待期间同样预热，就绪后按累积采样数捕获
+	// 路径追踪：移动后累积重新开始，等待期间不捕获，就绪后按采样数累积
+	const bool bWarmUp = !ReusableCaptureComponent->ShowFlags.PathTracing;
+	const int32 NumSamples = bBatchUsesAccumulation ? NumAccumulationSamples : (bWarmUp ? 1 : GetSceneCaptureSampleCount());
+	TFunction<void()> WarmUpCapture;
+	if (bWarmUp)
+	{
+		WarmUpCapture = [this]()
+		{
+			ReusableCaptureComponent->CaptureScene();
+		};
+	}
+	// 流送按整幅画面的像素密度请求mip，区域捕获时也是如此
+	WaitForViewReady(CameraActor->GetActorLocation(), ReusableCaptureComponent->FOVAngle, GetCaptureResolution().X, bWarmUp, MoveTemp(WarmUpCapture),
+		[this, NumSamples, CaptureStep = MoveTemp(CaptureStep), ReadbackAndContinue = MoveTemp(ReadbackAndContinue)]() mutable
+		{
+			RunCaptureSteps(0, NumSamples, MoveTemp(CaptureStep), MoveTemp(ReadbackAndContinue));
+		});
+}
+
+// 全景：同一个位置依次朝6个方向捕获到同一张面RenderTarget，渲染线程按提交顺序逐面回读到连续的面缓冲，
+// 最后一面回读后交给后台线程按查找表重投影并编码
+void ACameraArrayManager::ExecutePanoramaCaptureForCamera(int32 CameraIndex, const FString& FullFilePath, TFunction<void()> OnComplete)
+{
+	AActor* CameraActor = ManagedCameras[CameraIndex];
+	FTextureRenderTargetResource* RTResource = IsValid(ReusablePanoramaFaceTarget) ? ReusablePanoramaFaceTarget->GameThread_GetRenderTargetResource() : nullptr;
+	if (!IsValid(ReusableCaptureComponent) || !RTResource || !PanoramaLut.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("ExecutePanoramaCaptureForCamera: 全景渲染资源无效!"));
+		FailStereoEye(CameraIndex);
+		ReleaseFrameReservation();
+		OnComplete();
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const bool bSaveAsHdr = ReusablePanoramaFaceTarget->RenderTargetFormat == RTF_RGBA16f;
+	const int32 FaceSize = PanoramaLut->FaceSize;
+	const int64 FacePixels = static_cast<int64>(FaceSize) * FaceSize;
+
+	ReusableCaptureComponent->TextureTarget = ReusablePanoramaFaceTarget;
+	ReusableCaptureComponent->CaptureSource = bSaveAsHdr ? ESceneCaptureSource::SCS_FinalToneCurveHDR : ESceneCaptureSource::SCS_FinalColorLDR;
+	ReusableCaptureComponent->FOVAngle = 90.0f;
+
+	RenderStatus = FString::Printf(TEXT("全景处理中... (%d/%d)"), CameraIndex + 1, ManagedCameras.Num());
+
+	// 6个面的像素在渲染线程上写入，后台线程读取；两者通过渲染命令的先后顺序同步
+	// HDR面读回为半精度后转换为浮点，LDR面直接回读到各自的位置
+	struct FPanoramaFaces
+	{
+		FCameraArrayPooledBuffer Pixels;
+	};
+	const int64 FaceBytesPerPixel = bSaveAsHdr ? sizeof(FLinearColor) : sizeof(FColor);
+	TSharedRef<FPanoramaFaces, ESPMode::ThreadSafe> Faces = MakeShared<FPanoramaFaces, ESPMode::ThreadSafe>();
+	Faces->Pixels = FCameraArrayPooledBuffer(FacePixels * CameraArrayPanorama::NumFaces * FaceBytesPerPixel);
+	FMemory::Memzero(Faces->Pixels.GetData(), Faces->Pixels.Num());
+
+	// 每一步捕获一个面的一次采样，面的最后一次采样之后回读该面
+	const FTransform CameraTransform = CameraActor->GetActorTransform();
+	const int32 NumSamples = GetSceneCaptureSampleCount();
+	FTextureRHIRef FaceTexture = RTResource->GetRenderTargetTexture();
+	auto CaptureFaceSample = [this, CameraTransform, NumSamples, FaceTexture, Faces, FaceSize, FacePixels, bSaveAsHdr](int32 Step)
+	{
+		const int32 Face = Step / NumSamples;
+		const int32 Sample = Step % NumSamples;
+		if (Sample == 0)
+		{
+			ReusableCaptureComponent->SetWorldLocationAndRotation(CameraTransform.GetLocation(),
+				CameraTransform.GetRotation() * CameraArrayPanorama::GetFaceRotation(Face));
+		}
+		ReusableCaptureComponent->CaptureScene();
+		if (Sample < NumSamples - 1)
+		{
+			return;
+		}
+
+		ENQUEUE_RENDER_COMMAND(FCameraArrayPanoramaFaceReadback)(
+			[FaceTexture, Staging = ReadbackStaging, Faces, Face, FaceSize, FacePixels, bSaveAsHdr](FRHICommandListImmediate& RHICmdList)
+			{
+				if (!FaceTexture || !Staging.IsValid())
+				{
+					return;
+				}
+				const FIntRect Rect(0, 0, FaceSize, FaceSize);
+				if (bSaveAsHdr)
+				{
+					// 半精度像素在回读完成后才转换为线性浮点
+					FCameraArrayPooledBuffer HalfPixels(FacePixels * sizeof(FFloat16Color));
+					uint8* HalfData = HalfPixels.GetData();
+					Staging->ReadAsync(RHICmdList, FaceTexture, Rect, true, HalfData,
+						[Faces, Face, FacePixels, HalfPixels = MoveTemp(HalfPixels)](bool bSucceeded)
+						{
+							if (!bSucceeded)
+							{
+								return;
+							}
+							const FFloat16Color* Src = HalfPixels.GetData<FFloat16Color>();
+							FLinearColor* Dst = Faces->Pixels.GetData<FLinearColor>() + Face * FacePixels;
+							for (int64 i = 0; i < FacePixels; ++i)
+							{
+								Dst[i] = FLinearColor(Src[i]);
+							}
+						});
+				}
+				else
+				{
+					Staging->ReadAsync(RHICmdList, FaceTexture, Rect, false, reinterpret_cast<uint8*>(Faces->Pixels.GetData<FColor>() + Face * FacePixels),
+						[Faces](bool) {}); // 回读完成前保持面缓冲有效
+				}
+			});
+	};
+
+	RunCaptureSteps(0, CameraArrayPanorama::NumFaces * NumSamples, CaptureFaceSample,
+		[this, CameraIndex, FullFilePath, Faces, bSaveAsHdr, OnComplete = MoveTemp(OnComplete), StartTime]()
+	{
+		FCameraArrayFrameWriteRequest Request;
+		Request.FilePath = FPaths::ConvertRelativePathToFull(FullFilePath);
+		Request.Encode = MakeEncodeSettings(FileFormat);
+		Request.Width = PanoramaLut->Width;
+		Request.Height = PanoramaLut->Height;
+		Request.CameraIndex = CameraIndex;
+		Request.ContactSheet = ActiveContactSheet;
+		Request.StereoPacker = ActiveStereoPacker;
+		Request.PositionIndex = CameraIndex / GetEyesPerPosition();
+		Request.EyeIndex = CameraIndex % GetEyesPerPosition();
+		Request.PendingWrites = PendingFrameWrites;
+		AttachFrameReservation(Request);
+		AttachRenderCost(Request, CameraIndex, StartTime);
+		if (Request.PendingWrites.IsValid())
+		{
+			Request.PendingWrites->Increment();
+		}
+
+		// 各面的回读完成后才重投影
+		ENQUEUE_RENDER_COMMAND(FCameraArrayPanoramaProject)(
+			[Faces, Lut = PanoramaLut, Staging = ReadbackStaging, Request = MoveTemp(Request), bSaveAsHdr](FRHICommandListImmediate&) mutable
+			{
+				if (!Staging.IsValid())
+				{
+					CameraArrayImageWriter::AbandonRequest(Request);
+					return;
+				}
+				Staging->Then([Faces, Lut, Request = MoveTemp(Request), bSaveAsHdr]() mutable
+				{
+					AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Faces, Lut, Request = MoveTemp(Request), bSaveAsHdr]() mutable
+					{
+						const int64 NumPixels = static_cast<int64>(Lut->Width) * Lut->Height;
+						if (bSaveAsHdr)
+						{
+							FCameraArrayPooledBuffer Panorama(NumPixels * sizeof(FLinearColor));
+							CameraArrayPanorama::ProjectToEquirect(*Lut, Faces->Pixels.GetData<FLinearColor>(), Panorama.GetData<FLinearColor>());
+							Faces->Pixels.Reset();
+							CameraArrayImageWriter::WriteHdrFrame(Request, MoveTemp(Panorama));
+						}
+						else
+						{
+							FCameraArrayPooledBuffer Panorama(NumPixels * sizeof(FColor));
+							CameraArrayPanorama::ProjectToEquirect(*Lut, Faces->Pixels.GetData<FColor>(), Panorama.GetData<FColor>());
+							Faces->Pixels.Reset();
+							CameraArrayImageWriter::WriteLdrFrame(Request, MoveTemp(Panorama));
+						}
+					});
+				});
+			});
+
+		RecordRenderedView(CameraIndex);
+		OnComplete();
+	});
+}
+
+// 视口截图的文件由引擎写出，写完后在后台线程读回并解码放入联系表；跳过的相机直接读取已有文件
+void ACameraArrayManager::QueueContactSheetFromFile(int32 CameraIndex, const FString& FullFilePath, bool bWaitForNewFile, const FDateTime& PreviousTimeStamp)
+{
+	if (!ActiveContactSheet.IsValid() || !PendingFrameWrites.IsValid())
+	{
+		return;
+	}
+
+	PendingFrameWrites->Increment();
+	const FString FilePath = FPaths::ConvertRelativePathToFull(FullFilePath);
+	if (bWaitForNewFile)
+	{
+		PollContactSheetFile(ActiveContactSheet, PendingFrameWrites, CameraIndex, FilePath, PreviousTimeStamp, INDEX_NONE, FPlatformTime::Seconds() + 10.0);
+	}
+	else
+	{
+		LoadContactSheetFrameAsync(ActiveContactSheet, PendingFrameWrites, CameraIndex, FilePath);
+	}
+}
+
+// 引擎在延迟帧之后才写文件。在游戏线程上定时检查，时间戳与请求截图前不同、且两次检查之间大小不变才算写完，
+// 既不会读到上一次渲染留下的文件，也不会读到写了一半的文件
+void ACameraArrayManager::PollContactSheetFile(TSharedPtr<FCameraArrayContactSheet, ESPMode::ThreadSafe> ContactSheet, TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> PendingWrites,
+	int32 CameraIndex, const FString& FilePath, const FDateTime& PreviousTimeStamp, int64 LastSize, double Deadline)
+{
+	IFileManager& FileManager = IFileManager::Get();
+	const int64 Size = FileManager.FileSize(*FilePath);
+	const bool bIsNewFile = Size > 0 && FileManager.GetTimeStamp(*FilePath) != PreviousTimeStamp;
+	if (bIsNewFile && Size == LastSize)
+	{
+		LoadContactSheetFrameAsync(MoveTemp(ContactSheet), MoveTemp(PendingWrites), CameraIndex, FilePath);
+		return;
+	}
+
+	if (!bIsTaskRunning || FPlatformTime::Seconds() > Deadline)
+	{
+		if (bIsTaskRunning)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("联系表: 等待 %s 写出超时，跳过该格子。"), *FilePath);
+		}
+		PendingWrites->Decrement();
+		return;
+	}
+
+	FTimerHandle PollTimerHandle;
+	GetWorld()->GetTimerManager().SetTimer(PollTimerHandle, FTimerDelegate::CreateWeakLambda(this,
+		[this, ContactSheet, PendingWrites, CameraIndex, FilePath, PreviousTimeStamp, Size = bIsNewFile ? Size : INDEX_NONE, Deadline]()
+		{
+			PollContactSheetFile(ContactSheet, PendingWrites, CameraIndex, FilePath, PreviousTimeStamp, Size, Deadline);
+		}), 0.05f, false);
+}
+
+void ACameraArrayManager::LoadContactSheetFrameAsync(TSharedPtr<FCameraArrayContactSheet, ESPMode::ThreadSafe> ContactSheet, TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> PendingWrites,
+	int32 CameraIndex, const FString& FilePath)
+{
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+		[ContactSheet = MoveTemp(ContactSheet), PendingWrites = MoveTemp(PendingWrites), CameraIndex, FilePath]()
+		{
+			ON_SCOPE_EXIT
+			{
+				PendingWrites->Decrement();
+			};
+
+			TArray64<uint8> FileData;
+			FImage Image;
+			if (!FFileHelper::LoadFileToArray(FileData, *FilePath) || !FImageUtils::DecompressImage(FileData.GetData(), FileData.Num(), Image))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("联系表: 无法读取 %s，跳过该格子。"), *FilePath);
+				return;
+			}
+
+			Image.ChangeFormat(ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+			ContactSheet->AddFrame(CameraIndex, Image.AsBGRA8().GetData(), Image.SizeX, Image.SizeY);
+		});
 }
 
-// 循环控制器：递归调用，负责驱动整个流程
-void ACameraArrayManager::TakeNextHighResScreenshot_Recursive()
+void ACameraArrayManager::ReadbackAndSaveAsync(UTextureRenderTarget2D* RenderTarget, int32 CameraIndex, const FString& FullFilePath, ECameraArrayImageFormat Format, double CaptureStartTime)
 {
-	// 检查是否所有相机都已处理完毕
-	if (CurrentScreenshotIndex >= ManagedCameras.Num())
+	FTextureRenderTargetResource* RTResource = RenderTarget->GameThread_GetRenderTargetResource();
+	if (!RTResource)
 	{
-		UE_LOG(LogTemp, Log, TEXT("All screenshot requests submitted. Finalizing..."));
-		
-		// 设置一个短暂的最终延时，以确保最后一张截图的文件已成功写入
-		FTimerHandle FinalizeTimerHandle;
-		FTimerDelegate FinalizeDelegate;
-		FinalizeDelegate.BindLambda([this]()
-		{
-			RenderProgress = 100;
-			RenderStatus = TEXT("完成");
-			UE_LOG(LogTemp, Log, TEXT("Screenshot process finished."));
-			
-			UnlockEditorProperties();
-			RestoreOriginalViewportState();
-			bIsTaskRunning = false;
-			OpenOutputFolder();
-		});
-		GetWorld()->GetTimerManager().SetTimer(FinalizeTimerHandle, FinalizeDelegate, 1.0f, false);
+		UE_LOG(LogTemp, Error, TEXT("ReadbackAndSaveAsync: 无法获取 RenderTarget 资源"));
+		FailStereoEye(CameraIndex);
+		ReleaseFrameReservation();
 		return;
 	}
 
-	// 为当前索引的相机执行截图，并设置回调函数
-	// 回调函数的内容是：在当前截图完成后，继续处理下一个
-	ExecuteScreenshotForCamera(CurrentScreenshotIndex, [this]()
+	FCameraArrayFrameWriteRequest Request;
+	Request.FilePath = FPaths::ConvertRelativePathToFull(FullFilePath);
+	Request.Encode = MakeEncodeSettings(Format);
+	Request.Width = RenderTarget->SizeX;
+	Request.Height = RenderTarget->SizeY;
+	Request.CameraIndex = CameraIndex;
+	Request.ContactSheet = ActiveContactSheet;
+	Request.StereoPacker = ActiveStereoPacker;
+	Request.PositionIndex = CameraIndex / GetEyesPerPosition();
+	Request.EyeIndex = CameraIndex % GetEyesPerPosition();
+	Request.PendingWrites = PendingFrameWrites;
+	if (bBatchUsesLensDistortion && CameraDistortionMaps.IsValidIndex(CameraIndex))
 	{
-		RenderProgress = FMath::RoundToInt((static_cast<float>(CurrentScreenshotIndex) / ManagedCameras.Num()) * 100.0f);
-		
-		// 使用 SetTimerForNextTick 来调用下一次递归，避免堆栈溢出
-		FTimerHandle NextTickTimer;
-		GetWorld()->GetTimerManager().SetTimer(NextTickTimer, this, &ACameraArrayManager::TakeNextHighResScreenshot_Recursive, 0.1f, false);
-		CurrentScreenshotIndex++;
-	});
-}
-
-// 核心函数：为单个相机执行截图，并在完成后调用OnComplete回调
-void ACameraArrayManager::ExecuteScreenshotForCamera(int32 CameraIndex, TFunction<void()> OnComplete)
-{
-	if (!ManagedCameras.IsValidIndex(CameraIndex) || !IsValid(ManagedCameras[CameraIndex]))
+		Request.DistortionMap = CameraDistortionMaps[CameraIndex];
+	}
+	AttachFrameReservation(Request);
+	AttachRenderCost(Request, CameraIndex, CaptureStartTime);
+	if (Request.PendingWrites.IsValid())
 	{
-		UE_LOG(LogTemp, Error, TEXT("ExecuteScreenshotForCamera: Invalid camera at index %d."), CameraIndex);
-		OnComplete(); // 即使失败也要调用回调，以继续循环
-		return;
+		Request.PendingWrites->Increment();
 	}
 
-	AActor* CameraActor = ManagedCameras[CameraIndex];
-	FEditorViewportClient* ViewportClient = static_cast<FEditorViewportClient*>(GEditor->GetActiveViewport()->GetClient());
-	
-	if (!ViewportClient)
+	// 抖动累积的8位输出也从半精度RenderTarget回读，在后台线程编码为sRGB
+	const bool bSaveAsHdr = RenderTarget->RenderTargetFormat == RTF_RGBA16f;
+	const bool bEncodeAsLdr = bSaveAsHdr && !IsHdrFormat();
+
+	// 降噪辅助通道与渲染图像在同一个渲染命令中回读，用单独的暂存纹理，不与渲染图像的格式来回切换
+	FTextureRenderTargetResource* AlbedoResource = nullptr;
+	FTextureRenderTargetResource* NormalResource = nullptr;
+	// 退回整幅画面的相机不写区域信息，写出时会删掉之前留下的
+	if (bBatchUsesRegion && CurrentCaptureRect != FIntRect(FIntPoint::ZeroValue, GetCaptureResolution()))
 	{
-		UE_LOG(LogTemp, Error, TEXT("ExecuteScreenshotForCamera: Could not get active editor viewport client."));
-		OnComplete();
-		return;
+		Request.Region = CurrentCaptureRect;
+		Request.RegionFullSize = GetCaptureResolution();
 	}
 
-	// 1. 定位视口
-	const FTransform CameraTransform = CameraActor->GetActorTransform();
-	ViewportClient->SetViewLocation(CameraTransform.GetLocation());
-	ViewportClient->SetViewRotation(CameraTransform.GetRotation().Rotator());
-	ViewportClient->ViewFOV = CameraFOV;
-	ViewportClient->SetGameView(true);
-	ViewportClient->SetRealtime(true);
-	ViewportClient->ViewportType = LVT_Perspective;
-	ViewportClient->Invalidate();
+	if (bBatchUsesProgressive && ProgressivePassSamples > 0)
+	{
+		TSharedRef<FCameraArrayProgressiveMerge, ESPMode::ThreadSafe> Merge = MakeShared<FCameraArrayProgressiveMerge, ESPMode::ThreadSafe>();
+		Merge->StatePath = GetProgressiveStatePath(CameraIndex);
+		Merge->StateKey = GetProgressiveStateKey(CameraIndex);
+		Merge->PriorSamples = ProgressivePriorSamples;
+		Merge->PassSamples = ProgressivePassSamples;
+		Request.Progressive = Merge;
+	}
 
-	RenderStatus = FString::Printf(TEXT("处理中... (%d/%d)"), CameraIndex + 1, ManagedCameras.Num());
-	UE_LOG(LogTemp, Log, TEXT("Processing screenshot for camera index %d."), CameraIndex);
+	if (bBatchUsesDenoiser && IsValid(DenoiseAlbedoTarget) && IsValid(DenoiseNormalTarget) &&
+		DenoiseAlbedoTarget->SizeX == Request.Width && DenoiseAlbedoTarget->SizeY == Request.Height)
+	{
+		AlbedoResource = DenoiseAlbedoTarget->GameThread_GetRenderTargetResource();
+		NormalResource = DenoiseNormalTarget->GameThread_GetRenderTargetResource();
+		Request.Denoise = MakeShared<FCameraArrayDenoiseAovs, ESPMode::ThreadSafe>();
+		Request.Denoise->Stats = ActiveDenoiseStats;
+	}
 
-	// 2. 配置并请求截图
-	const bool bIsPathTracing = ViewportClient->EngineShowFlags.PathTracing;
-	
+	// 回读中的一帧：渲染图像与降噪辅助通道在同一个暂存对象上按顺序完成，全部完成后交给后台线程
+	struct FFrameReadback
 	{
-		int32 FramesDelay = 1;
-		if (bIsPathTracing)
+		FCameraArrayFrameWriteRequest Request;
+		FCameraArrayPooledBuffer Pixels;
+		bool bPixelsRead = false;
+		bool bAovsRead = true;
+	};
+
+	// 将读取操作放到渲染线程执行（不会阻塞 Game Thread），拷贝完成前不等待GPU，编码与写文件交给后台线程
+	// 像素缓冲取自缓冲池，暂存纹理跨帧复用
+	ENQUEUE_RENDER_COMMAND(FCameraArrayReadbackCommand)(
+		[RTTexture = RTResource->GetRenderTargetTexture(), Staging = ReadbackStaging, Request = MoveTemp(Request), bSaveAsHdr, bEncodeAsLdr,
+		AlbedoTexture = AlbedoResource ? AlbedoResource->GetRenderTargetTexture() : nullptr,
+		NormalTexture = NormalResource ? NormalResource->GetRenderTargetTexture() : nullptr](FRHICommandListImmediate& RHICmdList) mutable
 		{
-			int32 SamplesPerPixel = 1;
-			if (PostProcessVolumeRef)
+			if (!RTTexture || !Staging.IsValid())
 			{
-				SamplesPerPixel = PostProcessVolumeRef->Settings.PathTracingSamplesPerPixel;
+				UE_LOG(LogTemp, Error, TEXT("FCameraArrayReadbackCommand: 回读 %s 失败"), *Request.FilePath);
+				CameraArrayImageWriter::AbandonRequest(Request);
+				return;
 			}
-			FramesDelay = FMath::Max(SamplesPerPixel, 1);
-			UE_LOG(LogTemp, Log, TEXT("Path Tracing: Requesting screenshot now; delaying capture by %d frames."), FramesDelay);
-			IConsoleManager::Get().FindConsoleVariable(TEXT("r.HighResScreenshotDelay"))->Set(FramesDelay);
-		}
-		else
-		{
-			FramesDelay = FMath::Max(SPPLit, 1);
-			UE_LOG(LogTemp, Log, TEXT("Rasterization: Requesting screenshot now; delaying capture by %d frames."), FramesDelay);
-			IConsoleManager::Get().FindConsoleVariable(TEXT("r.HighResScreenshotDelay"))->Set(FramesDelay);
-		}
 
-		// 立即配置并请求截图
-		{
-			const FString SaveFilename = FString::Printf(TEXT("%s_%03d"), *CameraNamePrefix, CameraIndex);
-			const FString FullFilePath = FPaths::Combine(FPaths::ProjectSavedDir(), OutputPath, SaveFilename + TEXT(".") + GetFileExtension());
-			FHighResScreenshotConfig& HRConfig = GetHighResScreenshotConfig();
-			if (IsHdrFormat())
-			{
-				HRConfig.bCaptureHDR = true;
-				HRConfig.FilenameOverride = FullFilePath;
-			}
-			else
+			const FIntRect Rect(0, 0, Request.Width, Request.Height);
+			const int64 BytesPerPixel = bSaveAsHdr ? sizeof(FFloat16Color) : sizeof(FColor);
+			TSharedRef<FFrameReadback, ESPMode::ThreadSafe> Frame = MakeShared<FFrameReadback, ESPMode::ThreadSafe>();
+			Frame->Request = MoveTemp(Request);
+			Frame->Pixels = FCameraArrayPooledBuffer(static_cast<int64>(Frame->Request.Width) * Frame->Request.Height * BytesPerPixel);
+			Staging->ReadAsync(RHICmdList, RTTexture, Rect, bSaveAsHdr, Frame->Pixels.GetData(), [Frame](bool bSucceeded)
 			{
-				HRConfig.bCaptureHDR = false;
-				HRConfig.FilenameOverride = FullFilePath;
-			}
+				Frame->bPixelsRead = bSucceeded;
+			});
 
-			// 检查文件是否存在且不覆盖的情况
-			if (!bOverwriteExisting && FPlatformFileManager::Get().GetPlatformFile().FileExists(*FullFilePath))
+			if (Frame->Request.Denoise.IsValid())
 			{
-				UE_LOG(LogTemp, Warning, TEXT("文件已存在，跳过保存: %s"), *FullFilePath);
-				
-				// 如果是单个相机截图，直接调用OnComplete
-				if (CameraIndex >= 0)
+				FCameraArrayDenoiseAovs& Aovs = *Frame->Request.Denoise;
+				const int64 AovBytes = static_cast<int64>(Frame->Request.Width) * Frame->Request.Height * sizeof(FFloat16Color);
+				Aovs.Albedo = FCameraArrayPooledBuffer(AovBytes);
+				Aovs.Normal = FCameraArrayPooledBuffer(AovBytes);
+				if (AlbedoTexture && NormalTexture)
 				{
-					if (OnComplete)
+					// 辅助通道的缓冲要等两次回读都结束才能释放
+					auto OnAovRead = [Frame](bool bSucceeded)
 					{
-						OnComplete();
-					}
-					return;
+						Frame->bAovsRead &= bSucceeded;
+					};
+					Staging->ReadAsync(RHICmdList, AlbedoTexture, Rect, true, Aovs.Albedo.GetData(), OnAovRead);
+					Staging->ReadAsync(RHICmdList, NormalTexture, Rect, true, Aovs.Normal.GetData(), OnAovRead);
 				}
-				// 如果是批量截图，继续处理下一个相机
 				else
 				{
-					TakeNextHighResScreenshot_Recursive();
-					return;
+					Frame->bAovsRead = false;
 				}
 			}
 
-			HRConfig.SetResolution(RenderTargetX, RenderTargetY, 1.0f);
-			HRConfig.bDumpBufferVisualizationTargets = false;
-			//GEditor->GetActiveViewport()->TakeHighResScreenShot();
-		}
-
-		// 仅延迟推进到下一个相机：按帧数估算时间（假设60fps），保持与截图延迟对齐
-		const float AdvanceDelaySeconds = (static_cast<float>(FramesDelay) / 60.0f) + 0.05f;
-		FTimerDelegate AdvanceDelegate;
-		AdvanceDelegate.BindLambda([this, OnComplete]()
-		{
-			// 若已强制停止，则不再推进
-			if (!bIsTaskRunning)
+			Staging->Then([Frame, bSaveAsHdr, bEncodeAsLdr]()
 			{
-				return;
-			}
-			OnComplete();
+				if (!Frame->bPixelsRead)
+				{
+					UE_LOG(LogTemp, Error, TEXT("FCameraArrayReadbackCommand: 回读 %s 失败"), *Frame->Request.FilePath);
+					CameraArrayImageWriter::AbandonRequest(Frame->Request);
+					return;
+				}
+				if (Frame->Request.Denoise.IsValid() && !Frame->bAovsRead)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("FCameraArrayReadbackCommand: 回读 %s 的降噪辅助通道失败，只按渲染图像降噪"), *Frame->Request.FilePath);
+					Frame->Request.Denoise->Albedo.Reset();
+					Frame->Request.Denoise->Normal.Reset();
+				}
+
+				AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Frame, bSaveAsHdr, bEncodeAsLdr]()
+				{
+					if (bEncodeAsLdr)
+					{
+						CameraArrayImageWriter::WriteHalfFrameAsLdr(Frame->Request, MoveTemp(Frame->Pixels));
+					}
+					else if (bSaveAsHdr)
+					{
+						CameraArrayImageWriter::WriteHalfFrame(Frame->Request, MoveTemp(Frame->Pixels));
+					}
+					else
+					{
+						CameraArrayImageWriter::WriteLdrFrame(Frame->Request, MoveTemp(Frame->Pixels));
+					}
+				});
+			});
 		});
-		// 复用 PathTracingLogTimerHandle 作为推进句柄
-		FTimerManager& TM = GetWorld()->GetTimerManager();
-		if (TM.IsTimerActive(PathTracingLogTimerHandle))
+}
+
+void ACameraArrayManager::TakeSingleHighResScreenshot(int32 CameraIndex)
+{
+	if (bIsTaskRunning || !ManagedCameras.IsValidIndex(CameraIndex) || !GEditor)
+	{
+		return;
+	}
+
+	bIsPreviewPass = false;
+	bBatchUsesPanorama = bCapturePanorama;
+	bBatchUsesLensDistortion = !bBatchUsesPanorama && bApplyLensDistortion && CameraIntrinsics.Num() > 0;
+	bBatchUsesAccumulation = !bBatchUsesPanorama && bJitteredAccumulation;
+	bBatchUsesDenoiser = !bBatchUsesPanorama && bDenoisePathTracing;
+	bBatchUsesRegion = !bBatchUsesPanorama && !bBatchUsesLensDistortion && bCaptureRegionOfInterest;
+	bBatchUsesSceneCapture = UsesSceneCapture(false);
+	PendingFrameWrites = MakeShared<FThreadSafeCounter, ESPMode::ThreadSafe>();
+	ActiveMemoryBudget = CreateFrameMemoryBudget();
+	ActiveRenderCosts.Reset();
+	if (bBatchUsesSceneCapture)
+	{
+		PrepareSceneCapture();
+		ActiveMemoryBudget->SetResidentBytes(EstimateResidentBytes());
+	}
+	else
+	{
+		SaveOriginalViewportState();
+	}
+
+	bIsTaskRunning = true;
+	LockEditorProperties();
+
+	ExecuteScreenshotForCamera(CameraIndex, [this]()
+	{
+		if (bBatchUsesSceneCapture)
 		{
-			TM.ClearTimer(PathTracingLogTimerHandle);
+			FinishSingleScreenshot();
+			return;
 		}
-		TM.SetTimer(PathTracingLogTimerHandle, AdvanceDelegate, AdvanceDelaySeconds, false);
+
+		// 视口截图的文件由引擎写出，不经过写出计数，等待片刻以确保文件写入
+		GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, this, &ACameraArrayManager::FinishSingleScreenshot, 1.0f, false);
+	});
+}
+
+void ACameraArrayManager::FinishSingleScreenshot()
+{
+	// 与批量渲染相同，场景捕获路径的帧仍在后台编码时继续等待
+	if (PendingFrameWrites.IsValid() && PendingFrameWrites->GetValue() > 0)
+	{
+		RenderStatus = FString::Printf(TEXT("等待写出... (剩余 %d)"), PendingFrameWrites->GetValue());
+		GetWorld()->GetTimerManager().SetTimer(ScreenshotTimerHandle, this, &ACameraArrayManager::FinishSingleScreenshot, 0.1f, false);
+		return;
 	}
+
+	EndCaptureTask();
+	OpenOutputFolder();
 }
 
-// 公共接口：为第一个相机截图
-void ACameraArrayManager::TakeFirstCameraScreenshot()
+void ACameraArrayManager::RenderCameraArraysAsOneJob()
 {
-	if (bIsTaskRunning) return;
-	if (ManagedCameras.Num() > 0)
+	UWorld* World = GetWorld();
+	UCameraArrayJobSubsystem* Job = World ? World->GetSubsystem<UCameraArrayJobSubsystem>() : nullptr;
+	if (!Job || Job->IsJobRunning())
 	{
-		bIsTaskRunning = true;
-		LockEditorProperties();
-		SaveOriginalViewportState();
-		
-		ExecuteScreenshotForCamera(0, [this]()
+		return; // 多选时每个选中的阵列都会调用一次，第一次调用之后任务已经在运行
+	}
+
+	TArray<ACameraArrayManager*> SelectedManagers;
+	if (GEditor)
+	{
+		for (FSelectionIterator It(GEditor->GetSelectedActorIterator()); It; ++It)
 		{
-			FTimerHandle FinalizeTimerHandle;
-			// 等待片刻以确保文件写入
-			GetWorld()->GetTimerManager().SetTimer(FinalizeTimerHandle, FTimerDelegate::CreateLambda([this]()
+			if (ACameraArrayManager* Manager = Cast<ACameraArrayManager>(*It))
 			{
-				UnlockEditorProperties();
-				RestoreOriginalViewportState();
-				bIsTaskRunning = false;
-				OpenOutputFolder();
-			}), 1.0f, false);
-		});
+				SelectedManagers.Add(Manager);
+			}
+		}
+	}
+
+	// 只选中了当前阵列时渲染场景中的全部阵列
+	if (SelectedManagers.Num() <= 1)
+	{
+		SelectedManagers.Reset();
 	}
+	Job->RenderCameraArrays(SelectedManagers);
+}
+
+// 公共接口：为第一个相机截图
+void ACameraArrayManager::TakeFirstCameraScreenshot()
+{
+	TakeSingleHighResScreenshot(0);
 }
 
 // 公共接口：为最后一个相机截图
 void ACameraArrayManager::TakeLastCameraScreenshot()
 {
-	if (bIsTaskRunning) return;
-	if (ManagedCameras.Num() > 0)
-	{
-		bIsTaskRunning = true;
-		LockEditorProperties();
-		SaveOriginalViewportState();
-		
-		ExecuteScreenshotForCamera(ManagedCameras.Num() - 1, [this]()
-		{
-			FTimerHandle FinalizeTimerHandle;
-			// 等待片刻以确保文件写入
-			GetWorld()->GetTimerManager().SetTimer(FinalizeTimerHandle, FTimerDelegate::CreateLambda([this]()
-			{
-				UnlockEditorProperties();
-				RestoreOriginalViewportState();
-				bIsTaskRunning = false;
-				OpenOutputFolder();
-			}), 1.0f, false);
-		});
-	}
+	TakeSingleHighResScreenshot(ManagedCameras.Num() - 1);
 }
 
 void ACameraArrayManager::ForceStopAllTasks()
@@ -1242,29 +3964,232 @@ void ACameraArrayManager::ForceStopAllTasks()
 		UE_LOG(LogTemp, Warning, TEXT("ForceStopAllTasks: 没有正在运行的截图任务。"));
 		return;
 	}
+
+	// 终止生成时保留已生成的相机，撤销一次即可恢复到生成前
+	if (bIsSpawningCameras)
+	{
+		FinishCameraSpawn(true);
+		return;
+	}
 	
 	UE_LOG(LogTemp, Warning, TEXT("ForceStopAllTasks: 正在强行终止所有截图任务..."));
+
+	// 合并任务中终止整个任务
+	if (UCameraArrayJobSubsystem* Job = ActiveJob.Get())
+	{
+		Job->CancelJob();
+		return;
+	}
 	
 	// 清理所有定时器
 #if WITH_EDITOR
 	ClearAllTimers();
 #endif
 	
-	// 重置任务状态
-	bIsTaskRunning = false;
+	// 保留已完成相机的日志，下次增量渲染可以从中断处继续
+	if (!bIsPreviewPass)
+	{
+		SaveRenderJournal();
+	}
+
+	// 重置任务状态，恢复编辑器属性编辑权限和原始视口状态
+	EndCaptureTask();
 	CurrentScreenshotIndex = 0;
 	RenderProgress = 0;
 	RenderStatus = TEXT("已强行终止");
 	
-	// 恢复编辑器属性编辑权限
-	UnlockEditorProperties();
-	
-	// 恢复原始视口状态
-	RestoreOriginalViewportState();
-	
 	UE_LOG(LogTemp, Log, TEXT("ForceStopAllTasks: 所有任务已成功终止。"));
 }
 
+void ACameraArrayManager::PrepareRenderJournal(bool bIsPathTracing)
+{
+	RenderJournal.Load(GetFullOutputDirectory());
+	bBatchIsPathTracing = bIsPathTracing;
+	ComputeViewHashes();
+}
+
+// 按当前场景状态计算每个相机的视角哈希，按帧范围渲染时每个时间步重新计算一次
+void ACameraArrayManager::ComputeViewHashes()
+{
+	CurrentViewHashes.Empty();
+	CurrentSceneViewHashes.Empty();
+	if (!bSkipUnchangedViews)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// 路径追踪和Lumen会让视锥外的物体通过间接光照影响画面，此时按整个场景计算哈希
+	bool bWholeScene = bBatchIsPathTracing || bCapturePanorama; // 全景能看到所有方向
+	if (const IConsoleVariable* GIMethodCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.DynamicGlobalIlluminationMethod")))
+	{
+		bWholeScene |= GIMethodCVar->GetInt() == 1;
+	}
+	if (const IConsoleVariable* ReflectionMethodCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.ReflectionMethod")))
+	{
+		bWholeScene |= ReflectionMethodCVar->GetInt() == 1;
+	}
+	if (IsValid(PostProcessVolumeRef))
+	{
+		const FPostProcessSettings& Settings = PostProcessVolumeRef->Settings;
+		bWholeScene |= Settings.bOverride_DynamicGlobalIlluminationMethod &&
+			Settings.DynamicGlobalIlluminationMethod == EDynamicGlobalIlluminationMethod::Lumen;
+		bWholeScene |= Settings.bOverride_ReflectionMethod && Settings.ReflectionMethod == EReflectionMethod::Lumen;
+	}
+
+	TSet<const AActor*> IgnoredActors;
+	IgnoredActors.Add(this);
+	for (const AActor* Camera : ManagedCameras)
+	{
+		IgnoredActors.Add(Camera);
+	}
+
+	FCameraArraySceneSnapshot Snapshot;
+	Snapshot.Capture(GetWorld(), IgnoredActors, bWholeScene);
+	const uint64 SettingsHash = ComputeRenderSettingsHash(bBatchIsPathTracing, TEXT("AffectsRender"));
+
+	for (int32 i = 0; i < ManagedCameras.Num(); ++i)
+	{
+		const AActor* Camera = ManagedCameras[i];
+		UCineCameraComponent* CineCamComponent = IsValid(Camera) ? Camera->FindComponentByClass<UCineCameraComponent>() : nullptr;
+		if (!CineCamComponent)
+		{
+			continue; // 没有哈希的相机总是会被渲染
+		}
+
+		FMinimalViewInfo ViewInfo;
+		CineCamComponent->GetCameraView(0.0f, ViewInfo);
+		ViewInfo.FOV = GetCaptureFOV(i); // 与截图时使用的FOV保持一致
+		if (RenderTargetX > 0 && RenderTargetY > 0)
+		{
+			ViewInfo.AspectRatio = static_cast<float>(RenderTargetX) / static_cast<float>(RenderTargetY);
+		}
+		CurrentViewHashes.Add(i, Snapshot.HashView(ViewInfo, SettingsHash));
+		CurrentSceneViewHashes.Add(i, Snapshot.HashView(ViewInfo, 0));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ComputeViewHashes: 计算了 %d 个视角哈希（%s），耗时 %.3f 秒。"),
+		CurrentViewHashes.Num(), bWholeScene ? TEXT("整个场景") : TEXT("按视锥"), FPlatformTime::Seconds() - StartTime);
+}
+
+uint64 ACameraArrayManager::ComputeRenderSettingsHash(bool bIsPathTracing, const TCHAR* MetaTag) const
+{
+	FXxHash64Builder Builder;
+	FString ValueText;
+	for (TFieldIterator<FProperty> It(ACameraArrayManager::StaticClass(), EFieldIteratorFlags::ExcludeSuper); It; ++It)
+	{
+		const FProperty* Property = *It;
+
+		// 只计入带有MetaTag标记的设置：输出路径、顺序、显示、预览、联系表等不改变像素的设置修改后不需要重新渲染
+		// 相机的位置与FOV已经在视角哈希中；新增影响画面的属性时要加上AffectsRender，影响渐进累积状态的还要加上AffectsAccumulation
+		if (!Property->HasMetaData(MetaTag))
+		{
+			continue;
+		}
+
+		ValueText.Reset();
+		Property->ExportTextItem_InContainer(ValueText, this, nullptr, nullptr, PPF_None);
+		CameraArrayViewHash::HashString(Builder, Property->GetName());
+		CameraArrayViewHash::HashString(Builder, ValueText);
+	}
+
+	const uint8 PathTracingFlag = bIsPathTracing ? 1 : 0;
+	CameraArrayViewHash::HashBytes(Builder, &PathTracingFlag, sizeof(PathTracingFlag));
+	return Builder.Finalize().Hash;
+}
+
+bool ACameraArrayManager::ShouldSkipUnchangedView(int32 CameraIndex, const FString& FullFilePath) const
+{
+	auto IsViewUnchanged = [this](int32 Index)
+	{
+		const uint64* ViewHash = CurrentViewHashes.Find(Index);
+		const FCameraArrayRenderJournal::FEntry* Entry = ViewHash ? RenderJournal.Find(GetJournalKey(Index)) : nullptr;
+		return Entry && Entry->ViewHash == *ViewHash;
+	};
+
+	// 打包输出时同一位置的各目要么一起跳过，要么一起渲染，否则拼不出完整的图像
+	const int32 NumEyesToCheck = ActiveStereoPacker.IsValid() ? GetEyesPerPosition() : 1;
+	const int32 FirstIndex = ActiveStereoPacker.IsValid() ? CameraIndex - CameraIndex % NumEyesToCheck : CameraIndex;
+	for (int32 Index = FirstIndex; Index < FirstIndex + NumEyesToCheck; ++Index)
+	{
+		if (!IsViewUnchanged(Index))
+		{
+			return false;
+		}
+	}
+	return FPlatformFileManager::Get().GetPlatformFile().FileExists(*FullFilePath);
+}
+
+void ACameraArrayManager::RecordRenderedView(int32 CameraIndex)
+{
+	// 未启用增量渲染时记录哈希0，保证下次不会误判为未变化
+	const uint64* ViewHash = CurrentViewHashes.Find(CameraIndex);
+	RenderJournal.Record(GetJournalKey(CameraIndex), ViewHash ? *ViewHash : 0);
+}
+
+void ACameraArrayManager::SaveRenderJournal()
+{
+	if (ActiveRenderCosts.IsValid())
+	{
+		ActiveRenderCosts->ApplyTo(RenderJournal);
+	}
+	if (!RenderJournal.Save(GetFullOutputDirectory()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SaveRenderJournal: 保存渲染日志失败。"));
+	}
+}
+
+void ACameraArrayManager::ApplyTimeSample(int32 SampleIndex)
+{
+	const int32 Frame = TimeSampleFrames[SampleIndex];
+	RenderStatus = FString::Printf(TEXT("时间步 %d/%d（第 %d 帧）"), SampleIndex + 1, TimeSampleFrames.Num(), Frame);
+
+	if (!IsValid(LevelSequenceActorRef))
+	{
+		if (SampleIndex == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ApplyTimeSample: 未指定关卡序列，每一帧都会渲染当前的静态场景。"));
+		}
+		return;
+	}
+
+	// 编辑器世界中序列播放器不会自动初始化
+	ULevelSequencePlayer* Player = LevelSequenceActorRef->GetSequencePlayer();
+	if (Player && !Player->GetSequence())
+	{
+		LevelSequenceActorRef->InitializePlayer();
+	}
+	if (!Player || !Player->GetSequence())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ApplyTimeSample: 关卡序列 %s 没有可用的播放器。"), *LevelSequenceActorRef->GetName());
+		return;
+	}
+
+	if (!bHasOriginalSequenceTime)
+	{
+		OriginalSequenceTime = Player->GetCurrentTime().Time;
+		bHasOriginalSequenceTime = true;
+	}
+
+	// 跳转只求值一次序列，之后该时刻的所有相机都直接捕获
+	Player->SetPlaybackPosition(FMovieSceneSequencePlaybackParams(FFrameTime(Frame), EUpdatePositionMethod::Jump));
+	UE_LOG(LogTemp, Log, TEXT("ApplyTimeSample: 序列跳转到第 %d 帧。"), Frame);
+}
+
+void ACameraArrayManager::RestoreSequencePosition()
+{
+	if (bHasOriginalSequenceTime && IsValid(LevelSequenceActorRef))
+	{
+		if (ULevelSequencePlayer* Player = LevelSequenceActorRef->GetSequencePlayer())
+		{
+			Player->SetPlaybackPosition(FMovieSceneSequencePlaybackParams(OriginalSequenceTime, EUpdatePositionMethod::Jump));
+		}
+	}
+	bHasOriginalSequenceTime = false;
+	TimeSampleFrames.Reset();
+	CurrentTimeSampleIndex = INDEX_NONE;
+}
 
 float ACameraArrayManager::GetPathTracingProgress(int32& CurrentSPP, int32& TotalSPP)
 {
@@ -1387,7 +4312,7 @@ void ACameraArrayManager::TakeScreenshotAndContinue(int32 CameraIndex, TFunction
 		return;
 	}
 
-	const FString SaveFilename = FString::Printf(TEXT("%s_%03d"), *CameraNamePrefix, CameraIndex);
+	const FString SaveFilename = GetCameraBaseName(CameraIndex);
 	FHighResScreenshotConfig& HRConfig = GetHighResScreenshotConfig();
 
 	if (IsHdrFormat())
@@ -1404,7 +4329,14 @@ void ACameraArrayManager::TakeScreenshotAndContinue(int32 CameraIndex, TFunction
 	HRConfig.bDumpBufferVisualizationTargets = false;
 	
 	// 提交截图请求。引擎将在帧末尾处理它
-	//GEditor->GetActiveViewport()->TakeHighResScreenShot();
+	if (FViewport* ActiveViewport = GEditor ? GEditor->GetActiveViewport() : nullptr)
+	{
+		ActiveViewport->TakeHighResScreenShot();
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("TakeScreenshotAndContinue: 没有活动视口，相机 %d 未截图。"), CameraIndex);
+	}
 	
 	// 调用回调函数，以触发循环的下一步
 	OnComplete();
@@ -0,0 +1,58 @@
+#include "CameraArrayMemoryBudget.h"
+#include "Misc/ScopeLock.h"
+
+FCameraArrayMemoryBudget::FCameraArrayMemoryBudget(int64 InBudgetBytes)
+	: BudgetBytes(FMath::Max<int64>(InBudgetBytes, 0))
+{
+}
+
+bool FCameraArrayMemoryBudget::TryReserve(int64 Bytes)
+{
+	FScopeLock Lock(&Mutex);
+	if (BudgetBytes > 0 && NumInFlightFrames > 0 && ResidentBytes + InFlightBytes + Bytes > BudgetBytes)
+	{
+		return false;
+	}
+
+	InFlightBytes += Bytes;
+	++NumInFlightFrames;
+	HighWaterBytes = FMath::Max(HighWaterBytes, ResidentBytes + InFlightBytes);
+	MaxInFlightFrames = FMath::Max(MaxInFlightFrames, NumInFlightFrames);
+	return true;
+}
+
+void FCameraArrayMemoryBudget::Release(int64 Bytes)
+{
+	FScopeLock Lock(&Mutex);
+	InFlightBytes = FMath::Max<int64>(InFlightBytes - Bytes, 0);
+	NumInFlightFrames = FMath::Max(NumInFlightFrames - 1, 0);
+}
+
+void FCameraArrayMemoryBudget::SetResidentBytes(int64 Bytes)
+{
+	FScopeLock Lock(&Mutex);
+	ResidentBytes = FMath::Max(ResidentBytes, Bytes);
+	HighWaterBytes = FMath::Max(HighWaterBytes, ResidentBytes + InFlightBytes);
+}
+
+void FCameraArrayMemoryBudget::RecordStall(double Seconds)
+{
+	FScopeLock Lock(&Mutex);
+	++NumStalls;
+	StallSeconds += Seconds;
+}
+
+int64 FCameraArrayMemoryBudget::GetHighWaterBytes() const
+{
+	FScopeLock Lock(&Mutex);
+	return HighWaterBytes;
+}
+
+FString FCameraArrayMemoryBudget::Describe() const
+{
+	FScopeLock Lock(&Mutex);
+	const double ToMB = 1.0 / (1024.0 * 1024.0);
+	const FString BudgetText = BudgetBytes > 0 ? FString::Printf(TEXT("%.0f MB"), BudgetBytes * ToMB) : FString(TEXT("不限"));
+	return FString::Printf(TEXT("内存峰值 %.0f MB / 预算 %s（常驻 %.0f MB，最多 %d 帧在途，等待 %d 次共 %.2f 秒）"),
+		HighWaterBytes * ToMB, *BudgetText, ResidentBytes * ToMB, MaxInFlightFrames, NumStalls, StallSeconds);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 在途帧的内存预算：每帧在捕获前按回读、像素处理与编码所需的内存预留，后台写完后归还
+// 常驻的RenderTarget单独登记，峰值（常驻 + 在途）在批量结束时报告
+class FCameraArrayMemoryBudget
+{
+public:
+	// BudgetBytes为0表示不限制，只统计峰值
+	explicit FCameraArrayMemoryBudget(int64 InBudgetBytes);
+
+	// 预算足够时预留并返回true；没有在途帧时总是放行，单帧超出预算也能继续渲染
+	bool TryReserve(int64 Bytes);
+	void Release(int64 Bytes);
+
+	// 批量期间一直占用的资源；合并任务中各阵列共用资源，取最大值
+	void SetResidentBytes(int64 Bytes);
+
+	// 记录一次因预算不足而推迟的捕获
+	void RecordStall(double Seconds);
+
+	int64 GetBudgetBytes() const { return BudgetBytes; }
+	int64 GetHighWaterBytes() const;
+	FString Describe() const;
+
+private:
+	const int64 BudgetBytes;
+
+	// Reserve在游戏线程，Release在后台线程
+	mutable FCriticalSection Mutex;
+	int64 ResidentBytes = 0;
+	int64 InFlightBytes = 0;
+	int32 NumInFlightFrames = 0;
+	int64 HighWaterBytes = 0;
+	int32 MaxInFlightFrames = 0;
+	int32 NumStalls = 0;
+	double StallSeconds = 0.0;
+};
@@ -0,0 +1,93 @@
+#include "CameraArrayPanorama.h"
+#include "Async/ParallelFor.h"
+
+namespace CameraArrayPanorama
+{
+	FQuat GetFaceRotation(int32 FaceIndex)
+	{
+		static const FRotator FaceRotations[NumFaces] =
+		{
+			FRotator(0.0f, 0.0f, 0.0f),    // 前
+			FRotator(0.0f, 180.0f, 0.0f),  // 后
+			FRotator(0.0f, 90.0f, 0.0f),   // 右
+			FRotator(0.0f, -90.0f, 0.0f),  // 左
+			FRotator(90.0f, 0.0f, 0.0f),   // 上
+			FRotator(-90.0f, 0.0f, 0.0f),  // 下
+		};
+		return FaceRotations[FaceIndex].Quaternion();
+	}
+
+	void FEquirectLut::Build(int32 InFaceSize, int32 InWidth, int32 InHeight)
+	{
+		check(InFaceSize >= 2);
+		FaceSize = InFaceSize;
+		Width = InWidth;
+		Height = InHeight;
+		Taps.SetNumUninitialized(static_cast<int64>(Width) * Height);
+
+		// 与捕获时使用同一组旋转求出各面的前、右、上方向，保证查找表与画面朝向一致
+		FVector Forward[NumFaces], Right[NumFaces], Up[NumFaces];
+		for (int32 Face = 0; Face < NumFaces; ++Face)
+		{
+			const FQuat Rotation = GetFaceRotation(Face);
+			Forward[Face] = Rotation.GetForwardVector();
+			Right[Face] = Rotation.GetRightVector();
+			Up[Face] = Rotation.GetUpVector();
+		}
+
+		const int64 FacePixels = static_cast<int64>(FaceSize) * FaceSize;
+		const double HalfFace = FaceSize * 0.5;
+
+		ParallelFor(Height, [&](int32 Y)
+		{
+			// 纬度从上到下 +90°..-90°，经度从左到右 -180°..180°，图像中心为相机正前方
+			const double Latitude = UE_DOUBLE_HALF_PI - (Y + 0.5) / Height * UE_DOUBLE_PI;
+			for (int32 X = 0; X < Width; ++X)
+			{
+				const double Longitude = (X + 0.5) / Width * UE_DOUBLE_TWO_PI - UE_DOUBLE_PI;
+				const FVector Direction(
+					FMath::Cos(Latitude) * FMath::Cos(Longitude),
+					FMath::Cos(Latitude) * FMath::Sin(Longitude),
+					FMath::Sin(Latitude));
+
+				int32 BestFace = 0;
+				double BestDot = -2.0;
+				for (int32 Face = 0; Face < NumFaces; ++Face)
+				{
+					const double Dot = Direction | Forward[Face];
+					if (Dot > BestDot)
+					{
+						BestDot = Dot;
+						BestFace = Face;
+					}
+				}
+
+				// 90°视角下面内坐标为 [-1, 1]，图像Y轴向下
+				const double U = (Direction | Right[BestFace]) / BestDot;
+				const double V = (Direction | Up[BestFace]) / BestDot;
+				const double SrcX = (U + 1.0) * HalfFace - 0.5;
+				const double SrcY = (1.0 - V) * HalfFace - 0.5;
+
+				// 左上角限制在 [0, FaceSize-2]，四个采样点总在同一个面内
+				const int32 X0 = FMath::Clamp(FMath::FloorToInt32(SrcX), 0, FaceSize - 2);
+				const int32 Y0 = FMath::Clamp(FMath::FloorToInt32(SrcY), 0, FaceSize - 2);
+
+				CameraArrayImageResample::FBilinearTap& Tap = Taps[static_cast<int64>(Y) * Width + X];
+				Tap.Offset = static_cast<uint32>(BestFace * FacePixels + static_cast<int64>(Y0) * FaceSize + X0);
+				Tap.WeightX = CameraArrayImageResample::FBilinearTap::QuantizeWeight(SrcX - X0);
+				Tap.WeightY = CameraArrayImageResample::FBilinearTap::QuantizeWeight(SrcY - Y0);
+			}
+		});
+	}
+
+	// 6个面连续存放，面内的下一行就是源缓冲的下一行
+	void ProjectToEquirect(const FEquirectLut& Lut, const FColor* Faces, FColor* Dst)
+	{
+		CameraArrayImageResample::RemapBilinear(Lut.Taps.GetData(), Lut.Width, Lut.Height, Faces, Lut.FaceSize, Dst);
+	}
+
+	void ProjectToEquirect(const FEquirectLut& Lut, const FLinearColor* Faces, FLinearColor* Dst)
+	{
+		CameraArrayImageResample::RemapBilinear(Lut.Taps.GetData(), Lut.Width, Lut.Height, Faces, Lut.FaceSize, Dst);
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraArrayImageResample.h"
+
+// 360°全景：每个阵列位置以90°视角捕获6个立方体面，在后台线程重投影为等距柱状（equirectangular）全景图
+namespace CameraArrayPanorama
+{
+	constexpr int32 NumFaces = 6;
+
+	// 立方体面相对相机的朝向：前、后、右、左、上、下
+	FQuat GetFaceRotation(int32 FaceIndex);
+
+	// 等距柱状查找表：每个输出像素对应6个面连续存放的缓冲中一个2x2采样块的左上角及双线性权重
+	// 只与面尺寸和输出尺寸有关，所有相机共用
+	struct FEquirectLut
+	{
+		int32 FaceSize = 0;
+		int32 Width = 0;
+		int32 Height = 0;
+
+		// Offset = Face * FaceSize * FaceSize + Y * FaceSize + X，X和Y不超过FaceSize-2
+		TArray<CameraArrayImageResample::FBilinearTap> Taps;
+
+		void Build(int32 InFaceSize, int32 InWidth, int32 InHeight);
+
+		bool Matches(int32 InFaceSize, int32 InWidth, int32 InHeight) const
+		{
+			return FaceSize == InFaceSize && Width == InWidth && Height == InHeight;
+		}
+	};
+
+	// Faces为6个面按GetFaceRotation的顺序连续存放，Dst为Width*Height
+	void ProjectToEquirect(const FEquirectLut& Lut, const FColor* Faces, FColor* Dst);
+	void ProjectToEquirect(const FEquirectLut& Lut, const FLinearColor* Faces, FLinearColor* Dst);
+}
@@ -0,0 +1,130 @@
+#include "CameraArrayProgressive.h"
+#include "CameraArrayBufferPool.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	constexpr uint32 StateMagic = 0x52504143; // "CAPR"
+	constexpr uint32 StateVersion = 1;
+
+	// 状态文件：文件头之后是按行紧密排列的FFloat16Color
+	struct FStateHeader
+	{
+		uint32 Magic = StateMagic;
+		uint32 Version = StateVersion;
+		uint64 Key = 0;
+		int32 Width = 0;
+		int32 Height = 0;
+		int32 Samples = 0;
+		int32 Reserved = 0;
+	};
+
+	bool IsHeaderValid(const FStateHeader& Header, uint64 Key, int32 Width, int32 Height)
+	{
+		return Header.Magic == StateMagic && Header.Version == StateVersion && Header.Key == Key &&
+			Header.Width == Width && Header.Height == Height && Header.Samples > 0;
+	}
+
+	int64 GetStateFileSize(int32 Width, int32 Height)
+	{
+		return sizeof(FStateHeader) + static_cast<int64>(Width) * Height * sizeof(FFloat16Color);
+	}
+}
+
+namespace CameraArrayProgressive
+{
+	int32 GetCumulativeSamples(int32 Pass, int32 NumPasses, int32 TotalSamples)
+	{
+		NumPasses = FMath::Max(NumPasses, 1);
+		Pass = FMath::Clamp(Pass, 0, NumPasses - 1);
+		const int32 Shift = FMath::Min(NumPasses - 1 - Pass, 30);
+		return FMath::Max(1, FMath::Max(TotalSamples, 1) >> Shift);
+	}
+
+	FString GetStateDirectory(const FString& OutputDirectory)
+	{
+		return OutputDirectory / TEXT(".progressive");
+	}
+
+	int32 ReadStoredSamples(const FString& StatePath, uint64 StateKey, int32 Width, int32 Height)
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		TUniquePtr<IFileHandle> File(PlatformFile.OpenRead(*StatePath));
+		FStateHeader Header;
+		if (!File || File->Size() != GetStateFileSize(Width, Height) || !File->Read(reinterpret_cast<uint8*>(&Header), sizeof(Header)))
+		{
+			return 0;
+		}
+		return IsHeaderValid(Header, StateKey, Width, Height) ? Header.Samples : 0;
+	}
+
+	bool SaveFileAtomically(const TArray64<uint8>& Data, const FString& Path)
+	{
+		const FString TempPath = Path + TEXT(".tmp");
+		if (!FFileHelper::SaveArrayToFile(Data, *TempPath))
+		{
+			return false;
+		}
+		if (!IFileManager::Get().Move(*Path, *TempPath, true))
+		{
+			IFileManager::Get().Delete(*TempPath);
+			return false;
+		}
+		return true;
+	}
+}
+
+bool FCameraArrayProgressiveMerge::MergeAndStore(FLinearColor* Pixels, int32 Width, int32 Height) const
+{
+	const int64 NumPixels = static_cast<int64>(Width) * Height;
+	FCameraArrayPooledBuffer State(GetStateFileSize(Width, Height));
+	FStateHeader& Header = *reinterpret_cast<FStateHeader*>(State.GetData());
+	FFloat16Color* StoredPixels = reinterpret_cast<FFloat16Color*>(State.GetData() + sizeof(FStateHeader));
+
+	// 读取整份状态；与本遍开始时读到的采样数不一致说明状态被替换过，按文件中的实际采样数合并
+	int32 StoredSamples = 0;
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		TUniquePtr<IFileHandle> File(PlatformFile.OpenRead(*StatePath));
+		if (File && File->Size() == State.Num() && File->Read(State.GetData(), State.Num()) && IsHeaderValid(Header, StateKey, Width, Height))
+		{
+			StoredSamples = Header.Samples;
+		}
+	}
+	if (StoredSamples != PriorSamples)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("渐进渲染：%s 中有 %d 个采样，这一遍开始时为 %d 个，按文件中的采样数合并。"), *StatePath, StoredSamples, PriorSamples);
+	}
+
+	const int32 TotalSamples = StoredSamples + FMath::Max(PassSamples, 1);
+	const float PassWeight = static_cast<float>(TotalSamples - StoredSamples) / TotalSamples;
+	for (int64 i = 0; i < NumPixels; ++i)
+	{
+		FLinearColor& Pixel = Pixels[i];
+		if (StoredSamples > 0)
+		{
+			const FLinearColor Stored(StoredPixels[i]);
+			Pixel.R = FMath::Lerp(Stored.R, Pixel.R, PassWeight);
+			Pixel.G = FMath::Lerp(Stored.G, Pixel.G, PassWeight);
+			Pixel.B = FMath::Lerp(Stored.B, Pixel.B, PassWeight);
+		}
+		StoredPixels[i] = FFloat16Color(FLinearColor(Pixel.R, Pixel.G, Pixel.B, 1.0f));
+	}
+
+	Header = FStateHeader();
+	Header.Key = StateKey;
+	Header.Width = Width;
+	Header.Height = Height;
+	Header.Samples = TotalSamples;
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(StatePath), true);
+	if (!CameraArrayProgressive::SaveFileAtomically(State.GetArray(), StatePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("渐进渲染：保存累积状态失败: %s"), *StatePath);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 渐进渲染：第一遍以少量采样渲染所有相机并写出，之后每一遍为每个视角追加采样，直到达到后处理体积中的采样数
+// 每个视角的累积均值（半精度）与采样数保存在输出目录的状态文件中，中断后重新开始时从已有的采样继续
+namespace CameraArrayProgressive
+{
+	// 第Pass遍（从0开始）结束时每个视角的累计采样数：每一遍翻倍，最后一遍等于TotalSamples
+	int32 GetCumulativeSamples(int32 Pass, int32 NumPasses, int32 TotalSamples);
+
+	FString GetStateDirectory(const FString& OutputDirectory);
+
+	// 状态文件中的采样数；文件不存在，或者尺寸、状态键与当前视角不一致时返回0
+	int32 ReadStoredSamples(const FString& StatePath, uint64 StateKey, int32 Width, int32 Height);
+
+	// 先写临时文件再替换，读取方不会看到写了一半的文件
+	bool SaveFileAtomically(const TArray64<uint8>& Data, const FString& Path);
+}
+
+// 一帧在这一遍中的合并信息，随写出请求交给后台线程
+struct FCameraArrayProgressiveMerge
+{
+	FString StatePath;
+	uint64 StateKey = 0;
+	int32 PriorSamples = 0;
+	int32 PassSamples = 0;
+
+	// 与状态文件中的均值按采样数加权合并，Pixels变为合并后的均值并写回状态文件；只处理RGB
+	bool MergeAndStore(FLinearColor* Pixels, int32 Width, int32 Height) const;
+};
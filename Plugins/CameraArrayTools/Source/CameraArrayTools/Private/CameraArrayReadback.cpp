@@ -0,0 +1,192 @@
+#include "CameraArrayReadback.h"
+#include "Containers/Ticker.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "RHIGPUReadback.h"
+#include "RHIResources.h"
+
+// 空闲的暂存纹理最多保留几块，超出的直接释放
+static constexpr int32 MaxFreeStagingTextures = 8;
+
+FCameraArrayReadbackStaging::FCameraArrayReadbackStaging() = default;
+FCameraArrayReadbackStaging::~FCameraArrayReadbackStaging() = default;
+
+void FCameraArrayReadbackStaging::ReadAsync(FRHICommandListImmediate& RHICmdList, FRHITexture* Texture, const FIntRect& Rect, bool bHdr, uint8* Dst,
+	TUniqueFunction<void(bool)> OnComplete)
+{
+	check(IsInRenderingThread());
+
+	FPendingRead Read;
+	Read.BytesPerPixel = bHdr ? sizeof(FFloat16Color) : sizeof(FColor);
+	Read.Dst = Dst;
+	Read.OnComplete = MoveTemp(OnComplete);
+	if (!Texture || !Dst)
+	{
+		Enqueue(MoveTemp(Read));
+		return;
+	}
+
+	const int32 Width = Rect.Width();
+	const int32 Height = Rect.Height();
+	const EPixelFormat Format = Texture->GetFormat();
+
+	// RTF_RGBA8与RTF_RGBA16f的内存布局正好是FColor与FFloat16Color，其它格式交给引擎转换（引擎会等待GPU）
+	const bool bDirectCopy = bHdr ? Format == PF_FloatRGBA : Format == PF_B8G8R8A8;
+	if (!bDirectCopy)
+	{
+		const int64 NumBytes = static_cast<int64>(Width) * Height * Read.BytesPerPixel;
+		FReadSurfaceDataFlags ReadFlags;
+		ReadFlags.SetLinearToGamma(!bHdr);
+		if (bHdr)
+		{
+			TArray<FFloat16Color> Pixels;
+			RHICmdList.ReadSurfaceFloatData(Texture, Rect, Pixels, ReadFlags);
+			FMemory::Memcpy(Dst, Pixels.GetData(), FMath::Min<int64>(Pixels.Num() * Read.BytesPerPixel, NumBytes));
+		}
+		else
+		{
+			TArray<FColor> Pixels;
+			RHICmdList.ReadSurfaceData(Texture, Rect, Pixels, ReadFlags);
+			FMemory::Memcpy(Dst, Pixels.GetData(), FMath::Min<int64>(Pixels.Num() * Read.BytesPerPixel, NumBytes));
+		}
+		Read.bSucceeded = true;
+		Enqueue(MoveTemp(Read));
+		return;
+	}
+
+	Read.Staging = AcquireStaging(Rect.Size(), Format);
+	Read.Staging.Readback->EnqueueCopy(RHICmdList, Texture, FIntVector(Rect.Min.X, Rect.Min.Y, 0), 0, FIntVector(Width, Height, 1));
+	Enqueue(MoveTemp(Read));
+}
+
+void FCameraArrayReadbackStaging::Then(TUniqueFunction<void()> OnComplete)
+{
+	check(IsInRenderingThread());
+
+	FPendingRead Read;
+	Read.bSucceeded = true;
+	Read.OnComplete = [OnComplete = MoveTemp(OnComplete)](bool) { OnComplete(); };
+	Enqueue(MoveTemp(Read));
+}
+
+FCameraArrayReadbackStaging::FStagingTexture FCameraArrayReadbackStaging::AcquireStaging(const FIntPoint& Size, EPixelFormat Format)
+{
+	for (int32 i = FreeStaging.Num() - 1; i >= 0; --i)
+	{
+		if (FreeStaging[i].Size == Size && FreeStaging[i].Format == Format)
+		{
+			FStagingTexture Staging = MoveTemp(FreeStaging[i]);
+			FreeStaging.RemoveAtSwap(i, 1, false);
+			return Staging;
+		}
+	}
+
+	FStagingTexture Staging;
+	Staging.Readback = MakeUnique<FRHIGPUTextureReadback>(TEXT("CameraArrayReadback"));
+	Staging.Size = Size;
+	Staging.Format = Format;
+	return Staging;
+}
+
+bool FCameraArrayReadbackStaging::CopyFromStaging(FPendingRead& Read) const
+{
+	const int32 Width = Read.Staging.Size.X;
+	const int32 Height = Read.Staging.Size.Y;
+	int32 RowPitchInPixels = 0;
+	const uint8* Src = static_cast<const uint8*>(Read.Staging.Readback->Lock(RowPitchInPixels));
+	if (!Src)
+	{
+		return false;
+	}
+	const int64 RowBytes = Width * Read.BytesPerPixel;
+	const int64 SrcPitch = static_cast<int64>(FMath::Max(RowPitchInPixels, Width)) * Read.BytesPerPixel;
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		FMemory::Memcpy(Read.Dst + Y * RowBytes, Src + Y * SrcPitch, RowBytes);
+	}
+	Read.Staging.Readback->Unlock();
+	return true;
+}
+
+void FCameraArrayReadbackStaging::Enqueue(FPendingRead&& Read)
+{
+	// 前面没有未完成的回读时直接回调，保持入队顺序
+	if (PendingReads.IsEmpty() && !Read.Staging.Readback.IsValid())
+	{
+		Read.OnComplete(Read.bSucceeded);
+		return;
+	}
+	PendingReads.Add(MoveTemp(Read));
+	SchedulePoll();
+}
+
+void FCameraArrayReadbackStaging::SchedulePoll()
+{
+	if (bPollScheduled.exchange(true))
+	{
+		return;
+	}
+
+	// 定时器持有自身的引用，管理器先释放暂存对象时已入队的回读仍会完成
+	FTSTicker::GetCoreTicker().AddTicker(TEXT("CameraArrayReadback"), 0.0f,
+		[This = AsShared()](float)
+		{
+			if (!This->bPollScheduled)
+			{
+				return false;
+			}
+			ENQUEUE_RENDER_COMMAND(FCameraArrayReadbackPoll)([This](FRHICommandListImmediate&)
+			{
+				This->Poll();
+			});
+			return true;
+		});
+}
+
+void FCameraArrayReadbackStaging::Poll()
+{
+	check(IsInRenderingThread());
+
+	// GPU按提交顺序完成拷贝，遇到第一个未完成的回读就停下
+	int32 NumReady = 0;
+	for (; NumReady < PendingReads.Num(); ++NumReady)
+	{
+		FPendingRead& Read = PendingReads[NumReady];
+		if (!Read.Staging.Readback.IsValid())
+		{
+			continue;
+		}
+		if (!Read.Staging.Readback->IsReady())
+		{
+			break;
+		}
+		Read.bSucceeded = CopyFromStaging(Read);
+		if (FreeStaging.Num() < MaxFreeStagingTextures)
+		{
+			FreeStaging.Add(MoveTemp(Read.Staging));
+		}
+		Read.Staging = FStagingTexture();
+	}
+	if (NumReady == 0)
+	{
+		return;
+	}
+
+	// 回调中可能再次入队，先从队列中取出
+	TArray<FPendingRead> Completed;
+	Completed.Reserve(NumReady);
+	for (int32 i = 0; i < NumReady; ++i)
+	{
+		Completed.Add(MoveTemp(PendingReads[i]));
+	}
+	PendingReads.RemoveAt(0, NumReady, false);
+	for (FPendingRead& Read : Completed)
+	{
+		Read.OnComplete(Read.bSucceeded);
+	}
+
+	if (PendingReads.IsEmpty())
+	{
+		bPollScheduled = false;
+	}
+}
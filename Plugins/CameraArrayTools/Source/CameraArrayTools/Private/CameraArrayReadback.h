@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+#include "Templates/Function.h"
+
+#include <atomic>
+
+class FRHICommandListImmediate;
+class FRHITexture;
+class FRHIGPUTextureReadback;
+
+// 渲染线程上的异步回读：拷贝到暂存纹理后立即返回，之后的帧上检查拷贝是否完成，完成后才映射并拷出像素，
+// 不等待GPU空闲。暂存纹理按尺寸与格式跨帧复用，像素直接拷进调用方的缓冲，不像ReadSurfaceData那样每帧分配新的暂存与数组
+class FCameraArrayReadbackStaging : public TSharedFromThis<FCameraArrayReadbackStaging, ESPMode::ThreadSafe>
+{
+public:
+	FCameraArrayReadbackStaging();
+	~FCameraArrayReadbackStaging();
+
+	// 把Rect内的像素按行紧密排列写入Dst：bHdr时为FFloat16Color，否则为FColor。Dst在OnComplete调用前必须保持有效；
+	// OnComplete在渲染线程上按入队顺序调用，参数为是否成功。只能在渲染线程上调用
+	void ReadAsync(FRHICommandListImmediate& RHICmdList, FRHITexture* Texture, const FIntRect& Rect, bool bHdr, uint8* Dst, TUniqueFunction<void(bool)> OnComplete);
+
+	// 之前入队的回读全部完成后在渲染线程上调用OnComplete。只能在渲染线程上调用
+	void Then(TUniqueFunction<void()> OnComplete);
+
+private:
+	struct FStagingTexture
+	{
+		TUniquePtr<FRHIGPUTextureReadback> Readback;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		EPixelFormat Format = PF_Unknown;
+	};
+
+	// Staging.Readback为空的项已经有了结果，只是排在前面的回读之后调用
+	struct FPendingRead
+	{
+		FStagingTexture Staging;
+		int64 BytesPerPixel = 0;
+		uint8* Dst = nullptr;
+		bool bSucceeded = false;
+		TUniqueFunction<void(bool)> OnComplete;
+	};
+
+	FStagingTexture AcquireStaging(const FIntPoint& Size, EPixelFormat Format);
+	bool CopyFromStaging(FPendingRead& Read) const;
+	void Enqueue(FPendingRead&& Read);
+
+	// 游戏线程每帧发一次渲染命令检查完成的回读，队列为空时停止
+	void SchedulePoll();
+	void Poll();
+
+	// 以下只在渲染线程上访问
+	TArray<FPendingRead> PendingReads;
+	TArray<FStagingTexture> FreeStaging;
+
+	std::atomic<bool> bPollScheduled { false };
+};
@@ -0,0 +1,107 @@
+#include "CameraArrayReadiness.h"
+#include "CoreGlobals.h"
+#include "ContentStreaming.h"
+#include "Engine/Scene.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	int32 GetConsoleInt(const TCHAR* Name)
+	{
+		const IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name);
+		return CVar ? CVar->GetInt() : 0;
+	}
+}
+
+void FCameraArrayReadinessGate::Begin(const FCameraArrayReadinessSettings& InSettings, const FVector& InViewOrigin, float FOVDegrees, int32 ViewWidth)
+{
+	Settings = InSettings;
+	ViewOrigin = InViewOrigin;
+	ScreenSize = static_cast<float>(FMath::Max(ViewWidth, 1));
+	FOVScreenSize = ScreenSize / FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(FOVDegrees, 1.0f, 170.0f) * 0.5f));
+	StartFrame = GFrameCounter;
+	LastPollFrame = GFrameCounter;
+	StartTime = FPlatformTime::Seconds();
+	IdleFrames = 0;
+	LastPendingRequests = 0;
+}
+
+FCameraArrayReadinessGate::EResult FCameraArrayReadinessGate::Poll()
+{
+	// 不带持续时间的视角只参与下一次流送更新，等待期间每帧重新登记
+	IStreamingManager& Streaming = IStreamingManager::Get();
+	Streaming.AddViewInformation(ViewOrigin, ScreenSize, FOVScreenSize);
+
+	// 开始的那一帧流送还没有看到新视角，请求数不可信
+	if (GFrameCounter != LastPollFrame)
+	{
+		LastPollFrame = GFrameCounter;
+		LastPendingRequests = Streaming.GetNumWantingResources();
+		IdleFrames = LastPendingRequests == 0 ? IdleFrames + 1 : 0;
+	}
+
+	if (GetFramesWaited() >= Settings.MinFrames && IdleFrames >= Settings.SettleFrames)
+	{
+		return EResult::Ready;
+	}
+	if (GetSecondsWaited() >= Settings.TimeoutSeconds)
+	{
+		return EResult::TimedOut;
+	}
+	return EResult::Waiting;
+}
+
+int32 FCameraArrayReadinessGate::GetFramesWaited() const
+{
+	return static_cast<int32>(LastPollFrame - StartFrame);
+}
+
+double FCameraArrayReadinessGate::GetSecondsWaited() const
+{
+	return FPlatformTime::Seconds() - StartTime;
+}
+
+bool FCameraArrayReadinessGate::UsesTemporalHistory(const FPostProcessSettings* Overrides)
+{
+	// r.AntiAliasingMethod: 2 = TAA, 4 = TSR
+	const int32 AntiAliasingMethod = GetConsoleInt(TEXT("r.AntiAliasingMethod"));
+	if (AntiAliasingMethod == 2 || AntiAliasingMethod == 4)
+	{
+		return true;
+	}
+
+	int32 GlobalIlluminationMethod = GetConsoleInt(TEXT("r.DynamicGlobalIlluminationMethod"));
+	int32 ReflectionMethod = GetConsoleInt(TEXT("r.ReflectionMethod"));
+	if (Overrides)
+	{
+		if (Overrides->bOverride_DynamicGlobalIlluminationMethod)
+		{
+			GlobalIlluminationMethod = Overrides->DynamicGlobalIlluminationMethod;
+		}
+		if (Overrides->bOverride_ReflectionMethod)
+		{
+			ReflectionMethod = Overrides->ReflectionMethod;
+		}
+	}
+	return GlobalIlluminationMethod == EDynamicGlobalIlluminationMethod::Lumen || ReflectionMethod == EReflectionMethod::Lumen;
+}
+
+void FCameraArrayReadinessStats::Record(const FCameraArrayReadinessGate& Gate, bool bTimedOut)
+{
+	const double Seconds = Gate.GetSecondsWaited();
+	++NumViews;
+	TotalFrames += Gate.GetFramesWaited();
+	TotalSeconds += Seconds;
+	MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+	NumTimeouts += bTimedOut ? 1 : 0;
+}
+
+FString FCameraArrayReadinessStats::Describe() const
+{
+	if (NumViews == 0)
+	{
+		return TEXT("就绪检测：没有等待的视角");
+	}
+	return FString::Printf(TEXT("就绪检测：%d 个视角平均等待 %.1f 帧 / %.3f 秒（最长 %.2f 秒），超时 %d 次"),
+		NumViews, static_cast<double>(TotalFrames) / NumViews, TotalSeconds / NumViews, MaxSeconds, NumTimeouts);
+}
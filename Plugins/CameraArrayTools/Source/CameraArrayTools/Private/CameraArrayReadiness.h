@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FPostProcessSettings;
+
+// 就绪条件：至少等待MinFrames帧，且纹理/网格流送连续SettleFrames帧没有待处理请求；超过TimeoutSeconds不再等待
+// Nanite与虚拟纹理的页面请求来自GPU反馈，引擎没有游戏线程可查询的待处理数，用反馈往返所需的帧数作为最少帧数
+// TAA/TSR与Lumen的历史同样按帧数收敛，启用时最少帧数取时域历史帧数
+struct FCameraArrayReadinessSettings
+{
+	int32 MinFrames = 3;
+	int32 SettleFrames = 2;
+	double TimeoutSeconds = 5.0;
+};
+
+// 每次移动相机后的就绪检测，由游戏线程每帧轮询一次
+class FCameraArrayReadinessGate
+{
+public:
+	enum class EResult : uint8
+	{
+		Waiting,
+		Ready,
+		TimedOut,
+	};
+
+	// 从当前帧开始计数；ViewWidth与FOV决定流送系统为该视角请求的mip
+	void Begin(const FCameraArrayReadinessSettings& InSettings, const FVector& InViewOrigin, float FOVDegrees, int32 ViewWidth);
+
+	// 同一帧内重复调用只计一次
+	EResult Poll();
+
+	int32 GetFramesWaited() const;
+	double GetSecondsWaited() const;
+	int32 GetPendingRequests() const { return LastPendingRequests; }
+
+	// 项目设置或后期处理体积启用了TAA/TSR、Lumen全局光照或Lumen反射
+	static bool UsesTemporalHistory(const FPostProcessSettings* Overrides);
+
+private:
+	FCameraArrayReadinessSettings Settings;
+	FVector ViewOrigin = FVector::ZeroVector;
+	float ScreenSize = 0.0f;
+	float FOVScreenSize = 0.0f;
+	uint64 StartFrame = 0;
+	uint64 LastPollFrame = 0;
+	double StartTime = 0.0;
+	int32 IdleFrames = 0;
+	int32 LastPendingRequests = 0;
+};
+
+// 一次批量中所有视角的等待统计，批量结束时写入日志
+struct FCameraArrayReadinessStats
+{
+	int32 NumViews = 0;
+	int64 TotalFrames = 0;
+	double TotalSeconds = 0.0;
+	double MaxSeconds = 0.0;
+	int32 NumTimeouts = 0;
+
+	void Record(const FCameraArrayReadinessGate& Gate, bool bTimedOut);
+	FString Describe() const;
+};
@@ -0,0 +1,129 @@
+#include "CameraArrayRegion.h"
+#include "CameraArrayAccumulation.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace CameraArrayRegion
+{
+	bool ProjectBounds(const FBox& Bounds, const FTransform& CameraTransform, float FOVDegrees, int32 Width, int32 Height, float Padding, FIntRect& OutRect)
+	{
+		if (!Bounds.IsValid || Width <= 0 || Height <= 0)
+		{
+			return false;
+		}
+
+		// 相机空间X向前、Y向右、Z向上；FOV为水平视角，纵向按宽高比缩放，与场景捕获的投影一致
+		const double TanHalfFOV = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(FOVDegrees, 0.001f, 179.0f)) * 0.5);
+		const double AspectRatio = static_cast<double>(Width) / Height;
+		FVector2D Min(DBL_MAX, DBL_MAX);
+		FVector2D Max(-DBL_MAX, -DBL_MAX);
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			const FVector World(
+				(Corner & 1) ? Bounds.Max.X : Bounds.Min.X,
+				(Corner & 2) ? Bounds.Max.Y : Bounds.Min.Y,
+				(Corner & 4) ? Bounds.Max.Z : Bounds.Min.Z);
+			const FVector Local = CameraTransform.InverseTransformPositionNoScale(World);
+			if (Local.X <= GNearClippingPlane)
+			{
+				return false;
+			}
+			const double NdcX = Local.Y / (Local.X * TanHalfFOV);
+			const double NdcY = Local.Z / (Local.X * TanHalfFOV) * AspectRatio;
+			const FVector2D Pixel((NdcX + 1.0) * 0.5 * Width, (1.0 - NdcY) * 0.5 * Height);
+			Min = FVector2D::Min(Min, Pixel);
+			Max = FVector2D::Max(Max, Pixel);
+		}
+
+		const FVector2D Margin = (Max - Min) * FMath::Max(Padding, 0.0f);
+		FIntRect Rect(
+			FMath::Max(FMath::FloorToInt(Min.X - Margin.X), 0),
+			FMath::Max(FMath::FloorToInt(Min.Y - Margin.Y), 0),
+			FMath::Min(FMath::CeilToInt(Max.X + Margin.X), Width),
+			FMath::Min(FMath::CeilToInt(Max.Y + Margin.Y), Height));
+		if (Rect.Min.X >= Rect.Max.X || Rect.Min.Y >= Rect.Max.Y)
+		{
+			return false;
+		}
+
+		// 太小的区域向四周扩展到下限，靠近画面边缘时整体平移
+		const FIntPoint MinSize(FMath::Min(MinRegionSize, Width), FMath::Min(MinRegionSize, Height));
+		for (int32 Axis = 0; Axis < 2; ++Axis)
+		{
+			const int32 Extent = Axis == 0 ? Width : Height;
+			int32& Lo = Axis == 0 ? Rect.Min.X : Rect.Min.Y;
+			int32& Hi = Axis == 0 ? Rect.Max.X : Rect.Max.Y;
+			const int32 Missing = MinSize[Axis] - (Hi - Lo);
+			if (Missing > 0)
+			{
+				Lo = FMath::Clamp(Lo - Missing / 2, 0, Extent - MinSize[Axis]);
+				Hi = Lo + MinSize[Axis];
+			}
+		}
+		OutRect = Rect;
+		return true;
+	}
+
+	FMatrix MakeCropProjection(float FOVDegrees, int32 Width, int32 Height, const FIntRect& Rect)
+	{
+		FMatrix Projection = CameraArrayAccumulation::MakeJitteredProjection(FOVDegrees, Width, Height, FVector2D::ZeroVector);
+
+		// 裁剪空间中区域的范围，Y轴向上
+		const double Left = 2.0 * Rect.Min.X / Width - 1.0;
+		const double Right = 2.0 * Rect.Max.X / Width - 1.0;
+		const double Top = 1.0 - 2.0 * Rect.Min.Y / Height;
+		const double Bottom = 1.0 - 2.0 * Rect.Max.Y / Height;
+
+		// x' = (x - 中心) * 缩放，乘以w后作用在投影矩阵的对应列上
+		const double ScaleX = 2.0 / (Right - Left);
+		const double ScaleY = 2.0 / (Top - Bottom);
+		const double CenterX = (Left + Right) * 0.5;
+		const double CenterY = (Top + Bottom) * 0.5;
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			Projection.M[Row][0] = ScaleX * (Projection.M[Row][0] - CenterX * Projection.M[Row][3]);
+			Projection.M[Row][1] = ScaleY * (Projection.M[Row][1] - CenterY * Projection.M[Row][3]);
+		}
+		return Projection;
+	}
+
+	FString GetMetadataPath(const FString& ImagePath)
+	{
+		return FPaths::GetPath(ImagePath) / (FPaths::GetBaseFilename(ImagePath) + TEXT(".roi.json"));
+	}
+
+	bool SaveMetadata(const FString& ImagePath, const FIntRect& Rect, const FIntPoint& FullSize)
+	{
+		const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("image"), FPaths::GetCleanFilename(ImagePath));
+		Object->SetNumberField(TEXT("x"), Rect.Min.X);
+		Object->SetNumberField(TEXT("y"), Rect.Min.Y);
+		Object->SetNumberField(TEXT("width"), Rect.Width());
+		Object->SetNumberField(TEXT("height"), Rect.Height());
+		Object->SetNumberField(TEXT("fullWidth"), FullSize.X);
+		Object->SetNumberField(TEXT("fullHeight"), FullSize.Y);
+
+		FString Content;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Content);
+		if (!FJsonSerializer::Serialize(Object, Writer))
+		{
+			return false;
+		}
+		return FFileHelper::SaveStringToFile(Content, *GetMetadataPath(ImagePath), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	}
+
+	void DeleteMetadata(const FString& ImagePath)
+	{
+		const FString MetadataPath = GetMetadataPath(ImagePath);
+		IFileManager& FileManager = IFileManager::Get();
+		if (FileManager.FileExists(*MetadataPath) && !FileManager.Delete(*MetadataPath))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("删除过期的区域信息失败: %s"), *MetadataPath);
+		}
+	}
+}
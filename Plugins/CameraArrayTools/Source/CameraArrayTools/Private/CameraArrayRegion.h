@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 区域捕获：把目标的包围盒投影到相机画面，只渲染包含它的矩形区域
+// 离轴投影让这块区域的像素与整幅画面中的对应像素完全一致，GPU时间与文件大小只随区域增长
+namespace CameraArrayRegion
+{
+	// 区域边长的下限（像素），太小的区域没有意义，且每次改变尺寸都要重建RenderTarget
+	constexpr int32 MinRegionSize = 16;
+
+	// 包围盒在Width×Height画面中的像素矩形，四周各加上区域尺寸的Padding倍后裁到画面内
+	// 包围盒有角点在近裁剪面之后，或完全在画面外时返回false
+	bool ProjectBounds(const FBox& Bounds, const FTransform& CameraTransform, float FOVDegrees, int32 Width, int32 Height, float Padding, FIntRect& OutRect);
+
+	// 整幅Width×Height画面的投影只保留Rect部分，RenderTarget的尺寸应为Rect的大小
+	FMatrix MakeCropProjection(float FOVDegrees, int32 Width, int32 Height, const FIntRect& Rect);
+
+	// 图像旁的区域信息文件，例如 Cam_001.png -> Cam_001.roi.json
+	FString GetMetadataPath(const FString& ImagePath);
+
+	// 记录区域在整幅画面中的像素偏移与尺寸
+	bool SaveMetadata(const FString& ImagePath, const FIntRect& Rect, const FIntPoint& FullSize);
+
+	// 图像按整幅画面写出时删除之前区域捕获留下的区域信息文件，以免与新图像不符
+	void DeleteMetadata(const FString& ImagePath);
+}
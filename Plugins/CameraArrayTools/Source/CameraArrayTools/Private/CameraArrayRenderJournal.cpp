@@ -0,0 +1,101 @@
+#include "CameraArrayRenderJournal.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/ScopeLock.h"
+
+FString FCameraArrayRenderJournal::GetJournalFilePath(const FString& OutputDirectory)
+{
+	return OutputDirectory / TEXT("CameraArrayJournal.txt");
+}
+
+bool FCameraArrayRenderJournal::Load(const FString& OutputDirectory)
+{
+	Entries.Empty();
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *GetJournalFilePath(OutputDirectory)))
+	{
+		return false;
+	}
+
+	// 每行格式：文件名<TAB>视角哈希(16进制)<TAB>渲染耗时(秒)
+	for (const FString& Line : Lines)
+	{
+		TArray<FString> Fields;
+		if (Line.ParseIntoArray(Fields, TEXT("\t"), false) < 3)
+		{
+			continue;
+		}
+
+		FEntry& Entry = Entries.Add(Fields[0]);
+		Entry.ViewHash = FCString::Strtoui64(*Fields[1], nullptr, 16);
+		Entry.RenderSeconds = FCString::Atod(*Fields[2]);
+	}
+	return true;
+}
+
+bool FCameraArrayRenderJournal::Save(const FString& OutputDirectory) const
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.DirectoryExists(*OutputDirectory))
+	{
+		PlatformFile.CreateDirectoryTree(*OutputDirectory);
+	}
+
+	TArray<FString> SortedNames;
+	Entries.GetKeys(SortedNames);
+	SortedNames.Sort();
+
+	FString Content;
+	for (const FString& FileName : SortedNames)
+	{
+		const FEntry& Entry = Entries[FileName];
+		Content += FString::Printf(TEXT("%s\t%016llx\t%.4f\n"), *FileName, Entry.ViewHash, Entry.RenderSeconds);
+	}
+	return FFileHelper::SaveStringToFile(Content, *GetJournalFilePath(OutputDirectory));
+}
+
+void FCameraArrayRenderJournal::Record(const FString& FileName, uint64 ViewHash)
+{
+	Entries.FindOrAdd(FileName).ViewHash = ViewHash;
+}
+
+void FCameraArrayRenderJournal::SetRenderSeconds(const FString& FileName, double RenderSeconds)
+{
+	Entries.FindOrAdd(FileName).RenderSeconds = RenderSeconds;
+}
+
+void FCameraArrayRenderCosts::Add(const FString& FileName, double Seconds)
+{
+	FScopeLock Lock(&Mutex);
+	MeasuredSeconds.FindOrAdd(FileName) += Seconds;
+}
+
+void FCameraArrayRenderCosts::AddEngineWrittenFile(const FString& FileName, const FString& FilePath, const FDateTime& StartTimeUtc)
+{
+	FScopeLock Lock(&Mutex);
+	EngineWrittenFiles.Add({ FileName, FilePath, StartTimeUtc });
+}
+
+void FCameraArrayRenderCosts::ApplyTo(FCameraArrayRenderJournal& Journal)
+{
+	FScopeLock Lock(&Mutex);
+	IFileManager& FileManager = IFileManager::Get();
+	for (const FEngineWrittenFile& File : EngineWrittenFiles)
+	{
+		const FDateTime WriteTime = FileManager.GetTimeStamp(*File.FilePath);
+		if (WriteTime > File.StartTimeUtc)
+		{
+			MeasuredSeconds.FindOrAdd(File.FileName) += (WriteTime - File.StartTimeUtc).GetTotalSeconds();
+		}
+	}
+	EngineWrittenFiles.Reset();
+
+	for (const TPair<FString, double>& Pair : MeasuredSeconds)
+	{
+		Journal.SetRenderSeconds(Pair.Key, Pair.Value);
+	}
+	MeasuredSeconds.Reset();
+}
@@ -0,0 +1,389 @@
+#include "CameraArrayRigImport.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace CameraArrayRigImport
+{
+	// ---- COLMAP ----
+	// 相机模型编号与参数个数，见 colmap/src/colmap/sensor/models.h
+
+	static int32 GetColmapParamCount(int32 ModelId)
+	{
+		static const int32 Counts[] = { 3, 4, 4, 5, 8, 8, 12, 5, 4, 5, 12 };
+		return ModelId >= 0 && ModelId < UE_ARRAY_COUNT(Counts) ? Counts[ModelId] : INDEX_NONE;
+	}
+
+	static int32 GetColmapModelId(const FString& ModelName)
+	{
+		static const TCHAR* Names[] = {
+			TEXT("SIMPLE_PINHOLE"), TEXT("PINHOLE"), TEXT("SIMPLE_RADIAL"), TEXT("RADIAL"), TEXT("OPENCV"),
+			TEXT("OPENCV_FISHEYE"), TEXT("FULL_OPENCV"), TEXT("FOV"), TEXT("SIMPLE_RADIAL_FISHEYE"),
+			TEXT("RADIAL_FISHEYE"), TEXT("THIN_PRISM_FISHEYE") };
+		for (int32 i = 0; i < UE_ARRAY_COUNT(Names); ++i)
+		{
+			if (ModelName == Names[i])
+			{
+				return i;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	// 只保留Brown-Conrady能表达的部分，鱼眼与有理模型的高阶项被忽略
+	static FCameraArrayIntrinsics MakeColmapIntrinsics(int32 ModelId, int64 Width, int64 Height, const double* Params)
+	{
+		FCameraArrayIntrinsics Out;
+		Out.ImageWidth = static_cast<int32>(Width);
+		Out.ImageHeight = static_cast<int32>(Height);
+		switch (ModelId)
+		{
+		case 0: // SIMPLE_PINHOLE: f, cx, cy
+		case 2: // SIMPLE_RADIAL: f, cx, cy, k
+		case 3: // RADIAL: f, cx, cy, k1, k2
+		case 8: // SIMPLE_RADIAL_FISHEYE
+		case 9: // RADIAL_FISHEYE
+			Out.Fx = Out.Fy = Params[0];
+			Out.Cx = Params[1];
+			Out.Cy = Params[2];
+			if (ModelId == 2 || ModelId == 3) { Out.K1 = Params[3]; }
+			if (ModelId == 3) { Out.K2 = Params[4]; }
+			break;
+		case 1: // PINHOLE: fx, fy, cx, cy
+		case 7: // FOV
+			Out.Fx = Params[0]; Out.Fy = Params[1]; Out.Cx = Params[2]; Out.Cy = Params[3];
+			break;
+		case 4: // OPENCV: fx, fy, cx, cy, k1, k2, p1, p2
+		case 6: // FULL_OPENCV: ..., k3, k4, k5, k6
+			Out.Fx = Params[0]; Out.Fy = Params[1]; Out.Cx = Params[2]; Out.Cy = Params[3];
+			Out.K1 = Params[4]; Out.K2 = Params[5]; Out.P1 = Params[6]; Out.P2 = Params[7];
+			if (ModelId == 6) { Out.K3 = Params[8]; }
+			break;
+		default: // 其他鱼眼模型只取针孔部分
+			Out.Fx = Params[0]; Out.Fy = Params[1]; Out.Cx = Params[2]; Out.Cy = Params[3];
+			break;
+		}
+		return Out;
+	}
+
+	// COLMAP的图像位姿为世界到相机：X_cam = R * X_world + t，R的三行即相机三轴在世界中的方向
+	static void SetColmapPose(FImportedCamera& Camera, const double Q[4], const double T[3])
+	{
+		const FQuat Rotation(Q[1], Q[2], Q[3], Q[0]); // COLMAP为 w, x, y, z
+		const FMatrix R = FQuatRotationMatrix(Rotation.GetNormalized());
+		// FMatrix按行向量存储，M[列][行]对应列向量约定下的R[行][列]
+		Camera.Right = FVector(R.M[0][0], R.M[1][0], R.M[2][0]);
+		Camera.Down = FVector(R.M[0][1], R.M[1][1], R.M[2][1]);
+		Camera.Forward = FVector(R.M[0][2], R.M[1][2], R.M[2][2]);
+		const FVector Translation(T[0], T[1], T[2]);
+		Camera.Center = -(Camera.Right * Translation.X + Camera.Down * Translation.Y + Camera.Forward * Translation.Z);
+	}
+
+	static bool LoadColmapCamerasText(const FString& FilePath, TMap<int32, FCameraArrayIntrinsics>& OutCameras, FString& OutError)
+	{
+		TArray<FString> Tokens;
+		double Params[16];
+		const bool bRead = FFileHelper::LoadFileToStringWithLineVisitor(*FilePath, [&](FStringView Line)
+		{
+			if (Line.IsEmpty() || Line[0] == TEXT('#'))
+			{
+				return;
+			}
+			FString(Line).ParseIntoArrayWS(Tokens);
+			const int32 ModelId = Tokens.Num() >= 4 ? GetColmapModelId(Tokens[1]) : INDEX_NONE;
+			const int32 NumParams = GetColmapParamCount(ModelId);
+			if (NumParams == INDEX_NONE || Tokens.Num() < 4 + NumParams)
+			{
+				return;
+			}
+			for (int32 i = 0; i < NumParams; ++i)
+			{
+				Params[i] = FCString::Atod(*Tokens[4 + i]);
+			}
+			OutCameras.Add(FCString::Atoi(*Tokens[0]), MakeColmapIntrinsics(ModelId, FCString::Atoi64(*Tokens[2]), FCString::Atoi64(*Tokens[3]), Params));
+		});
+		if (!bRead)
+		{
+			OutError = FString::Printf(TEXT("无法读取 %s"), *FilePath);
+		}
+		return bRead;
+	}
+
+	static bool LoadColmapImagesText(const FString& FilePath, const TMap<int32, FCameraArrayIntrinsics>& Cameras, TArray<FImportedCamera>& OutCameras, FString& OutError)
+	{
+		// 每张图像占两行：位姿行和二维点行，二维点行可能为空，逐行读取时跳过
+		TArray<FString> Tokens;
+		bool bExpectPointsLine = false;
+		const bool bRead = FFileHelper::LoadFileToStringWithLineVisitor(*FilePath, [&](FStringView Line)
+		{
+			if (!Line.IsEmpty() && Line[0] == TEXT('#'))
+			{
+				return;
+			}
+			if (bExpectPointsLine)
+			{
+				bExpectPointsLine = false;
+				return;
+			}
+			FString(Line).ParseIntoArrayWS(Tokens);
+			if (Tokens.Num() < 10)
+			{
+				return;
+			}
+			bExpectPointsLine = true;
+
+			const double Q[4] = { FCString::Atod(*Tokens[1]), FCString::Atod(*Tokens[2]), FCString::Atod(*Tokens[3]), FCString::Atod(*Tokens[4]) };
+			const double T[3] = { FCString::Atod(*Tokens[5]), FCString::Atod(*Tokens[6]), FCString::Atod(*Tokens[7]) };
+			FImportedCamera& Camera = OutCameras.AddDefaulted_GetRef();
+			SetColmapPose(Camera, Q, T);
+			Camera.Name = Tokens[9];
+			if (const FCameraArrayIntrinsics* Intrinsics = Cameras.Find(FCString::Atoi(*Tokens[8])))
+			{
+				Camera.Intrinsics = *Intrinsics;
+			}
+		});
+		if (!bRead)
+		{
+			OutError = FString::Printf(TEXT("无法读取 %s"), *FilePath);
+		}
+		return bRead;
+	}
+
+	static bool LoadColmapCamerasBinary(const FString& FilePath, TMap<int32, FCameraArrayIntrinsics>& OutCameras, FString& OutError)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+		if (!Reader)
+		{
+			OutError = FString::Printf(TEXT("无法读取 %s"), *FilePath);
+			return false;
+		}
+
+		uint64 NumCameras = 0;
+		*Reader << NumCameras;
+		double Params[16];
+		for (uint64 i = 0; i < NumCameras && !Reader->IsError(); ++i)
+		{
+			int32 CameraId = 0;
+			int32 ModelId = 0;
+			uint64 Width = 0;
+			uint64 Height = 0;
+			*Reader << CameraId << ModelId << Width << Height;
+			const int32 NumParams = GetColmapParamCount(ModelId);
+			if (NumParams == INDEX_NONE)
+			{
+				OutError = FString::Printf(TEXT("%s: 未知的相机模型 %d"), *FilePath, ModelId);
+				return false;
+			}
+			Reader->Serialize(Params, NumParams * sizeof(double));
+			OutCameras.Add(CameraId, MakeColmapIntrinsics(ModelId, Width, Height, Params));
+		}
+		if (Reader->IsError())
+		{
+			OutError = FString::Printf(TEXT("%s: 文件不完整"), *FilePath);
+			return false;
+		}
+		return true;
+	}
+
+	static bool LoadColmapImagesBinary(const FString& FilePath, const TMap<int32, FCameraArrayIntrinsics>& Cameras, TArray<FImportedCamera>& OutCameras, FString& OutError)
+	{
+		// 顺序读取，二维点直接跳过，内存占用与图像数量成正比而不是文件大小
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+		if (!Reader)
+		{
+			OutError = FString::Printf(TEXT("无法读取 %s"), *FilePath);
+			return false;
+		}
+
+		uint64 NumImages = 0;
+		*Reader << NumImages;
+		OutCameras.Reserve(OutCameras.Num() + static_cast<int32>(FMath::Min<uint64>(NumImages, MAX_int32)));
+
+		TArray<ANSICHAR> NameBuffer;
+		for (uint64 i = 0; i < NumImages && !Reader->IsError(); ++i)
+		{
+			int32 ImageId = 0;
+			double Q[4];
+			double T[3];
+			int32 CameraId = 0;
+			*Reader << ImageId;
+			Reader->Serialize(Q, sizeof(Q));
+			Reader->Serialize(T, sizeof(T));
+			*Reader << CameraId;
+
+			NameBuffer.Reset();
+			ANSICHAR Char = 0;
+			do
+			{
+				Reader->Serialize(&Char, 1);
+				NameBuffer.Add(Char);
+			}
+			while (Char != 0 && !Reader->IsError());
+
+			uint64 NumPoints2D = 0;
+			*Reader << NumPoints2D;
+			Reader->Seek(Reader->Tell() + static_cast<int64>(NumPoints2D) * 24); // x, y, point3D_id
+
+			FImportedCamera& Camera = OutCameras.AddDefaulted_GetRef();
+			SetColmapPose(Camera, Q, T);
+			Camera.Name = UTF8_TO_TCHAR(NameBuffer.GetData());
+			if (const FCameraArrayIntrinsics* Intrinsics = Cameras.Find(CameraId))
+			{
+				Camera.Intrinsics = *Intrinsics;
+			}
+		}
+		if (Reader->IsError())
+		{
+			OutError = FString::Printf(TEXT("%s: 文件不完整"), *FilePath);
+			return false;
+		}
+		return true;
+	}
+
+	static bool LoadColmap(const FString& Directory, TArray<FImportedCamera>& OutCameras, FString& OutError)
+	{
+		IFileManager& FileManager = IFileManager::Get();
+		const bool bBinary = FileManager.FileExists(*(Directory / TEXT("images.bin")));
+		const FString Extension = bBinary ? TEXT(".bin") : TEXT(".txt");
+		const FString CamerasPath = Directory / (TEXT("cameras") + Extension);
+		const FString ImagesPath = Directory / (TEXT("images") + Extension);
+		if (!FileManager.FileExists(*ImagesPath))
+		{
+			OutError = FString::Printf(TEXT("%s 中没有 images.bin 或 images.txt"), *Directory);
+			return false;
+		}
+
+		TMap<int32, FCameraArrayIntrinsics> Cameras;
+		if (FileManager.FileExists(*CamerasPath) &&
+			!(bBinary ? LoadColmapCamerasBinary(CamerasPath, Cameras, OutError) : LoadColmapCamerasText(CamerasPath, Cameras, OutError)))
+		{
+			return false;
+		}
+		return bBinary ? LoadColmapImagesBinary(ImagesPath, Cameras, OutCameras, OutError) : LoadColmapImagesText(ImagesPath, Cameras, OutCameras, OutError);
+	}
+
+	// ---- JSON ----
+	// transforms.json风格：顶层或每帧的 fl_x, fl_y, cx, cy, w, h, k1, k2, k3, p1, p2，
+	// 每帧的 transform_matrix 为4x4相机到世界矩阵，相机为OpenGL约定（X右、Y上、Z后）
+
+	static void ReadJsonIntrinsics(const FJsonObject& Object, FCameraArrayIntrinsics& InOut)
+	{
+		Object.TryGetNumberField(TEXT("w"), InOut.ImageWidth);
+		Object.TryGetNumberField(TEXT("h"), InOut.ImageHeight);
+		Object.TryGetNumberField(TEXT("fl_x"), InOut.Fx);
+		if (!Object.TryGetNumberField(TEXT("fl_y"), InOut.Fy) && Object.HasField(TEXT("fl_x")))
+		{
+			InOut.Fy = InOut.Fx;
+		}
+		Object.TryGetNumberField(TEXT("cx"), InOut.Cx);
+		Object.TryGetNumberField(TEXT("cy"), InOut.Cy);
+		Object.TryGetNumberField(TEXT("k1"), InOut.K1);
+		Object.TryGetNumberField(TEXT("k2"), InOut.K2);
+		Object.TryGetNumberField(TEXT("k3"), InOut.K3);
+		Object.TryGetNumberField(TEXT("p1"), InOut.P1);
+		Object.TryGetNumberField(TEXT("p2"), InOut.P2);
+
+		// 只给出水平视角时按宽度换算焦距
+		double CameraAngleX = 0.0;
+		if (InOut.Fx <= 0.0 && InOut.ImageWidth > 0 && Object.TryGetNumberField(TEXT("camera_angle_x"), CameraAngleX) && CameraAngleX > 0.0)
+		{
+			InOut.Fx = InOut.Fy = 0.5 * InOut.ImageWidth / FMath::Tan(0.5 * CameraAngleX);
+		}
+	}
+
+	static bool LoadJson(const FString& FilePath, TArray<FImportedCamera>& OutCameras, FString& OutError)
+	{
+		FString Text;
+		if (!FFileHelper::LoadFileToString(Text, *FilePath))
+		{
+			OutError = FString::Printf(TEXT("无法读取 %s"), *FilePath);
+			return false;
+		}
+
+		TSharedPtr<FJsonObject> Root;
+		const TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(Text);
+		if (!FJsonSerializer::Deserialize(JsonReader, Root) || !Root.IsValid())
+		{
+			OutError = FString::Printf(TEXT("JSON解析失败: %s"), *JsonReader->GetErrorMessage());
+			return false;
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* Frames = nullptr;
+		if (!Root->TryGetArrayField(TEXT("frames"), Frames))
+		{
+			OutError = TEXT("缺少 frames 数组");
+			return false;
+		}
+
+		FCameraArrayIntrinsics SharedIntrinsics;
+		ReadJsonIntrinsics(*Root, SharedIntrinsics);
+
+		OutCameras.Reserve(OutCameras.Num() + Frames->Num());
+		for (int32 FrameIndex = 0; FrameIndex < Frames->Num(); ++FrameIndex)
+		{
+			const TSharedPtr<FJsonObject>* Frame = nullptr;
+			const TArray<TSharedPtr<FJsonValue>>* Rows = nullptr;
+			if (!(*Frames)[FrameIndex]->TryGetObject(Frame) || !(*Frame)->TryGetArrayField(TEXT("transform_matrix"), Rows) || Rows->Num() < 3)
+			{
+				OutError = FString::Printf(TEXT("第 %d 帧缺少 transform_matrix"), FrameIndex);
+				return false;
+			}
+
+			double M[3][4];
+			for (int32 Row = 0; Row < 3; ++Row)
+			{
+				const TArray<TSharedPtr<FJsonValue>>& Values = (*Rows)[Row]->AsArray();
+				for (int32 Col = 0; Col < 4; ++Col)
+				{
+					M[Row][Col] = Values.IsValidIndex(Col) ? Values[Col]->AsNumber() : 0.0;
+				}
+			}
+
+			// 矩阵的三列为相机X、Y、Z轴在世界中的方向，第四列为相机中心
+			FImportedCamera& Camera = OutCameras.AddDefaulted_GetRef();
+			Camera.Right = FVector(M[0][0], M[1][0], M[2][0]);
+			Camera.Down = -FVector(M[0][1], M[1][1], M[2][1]);
+			Camera.Forward = -FVector(M[0][2], M[1][2], M[2][2]);
+			Camera.Center = FVector(M[0][3], M[1][3], M[2][3]);
+			(*Frame)->TryGetStringField(TEXT("file_path"), Camera.Name);
+			Camera.Intrinsics = SharedIntrinsics;
+			ReadJsonIntrinsics(**Frame, Camera.Intrinsics);
+		}
+		return true;
+	}
+
+	bool Load(const FString& Path, TArray<FImportedCamera>& OutCameras, FString& OutError)
+	{
+		OutCameras.Reset();
+		const FString FullPath = FPaths::ConvertRelativePathToFull(Path);
+		if (FPaths::GetExtension(FullPath).Equals(TEXT("json"), ESearchCase::IgnoreCase))
+		{
+			return LoadJson(FullPath, OutCameras, OutError);
+		}
+		return LoadColmap(IFileManager::Get().DirectoryExists(*FullPath) ? FullPath : FPaths::GetPath(FullPath), OutCameras, OutError);
+	}
+
+	FTransform ToUnrealTransform(const FImportedCamera& Camera, ECameraArrayImportAxes SourceAxes, double Scale)
+	{
+		// 源坐标系都是右手系，换到UE的左手系时总有一个轴反向
+		auto Convert = [SourceAxes](const FVector& V)
+		{
+			switch (SourceAxes)
+			{
+			case ECameraArrayImportAxes::YUp:   return FVector(-V.Z, V.X, V.Y);  // OpenGL：X右、Y上、Z朝向观察者
+			case ECameraArrayImportAxes::ZUp:   return FVector(V.X, -V.Y, V.Z);  // X前、Y左、Z上
+			case ECameraArrayImportAxes::YDown:
+			default:                            return FVector(V.Z, V.X, -V.Y);  // OpenCV/COLMAP：X右、Y下、Z前
+			}
+		};
+
+		const FVector Location = Convert(Camera.Center) * Scale;
+		const FVector Forward = Convert(Camera.Forward);
+		const FVector Up = -Convert(Camera.Down);
+		return FTransform(FRotationMatrix::MakeFromXZ(Forward, Up).Rotator(), Location);
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraArrayManager.h"
+
+// 从重建/标定结果导入相机阵列：COLMAP的文本或二进制模型，以及transforms.json风格的JSON
+namespace CameraArrayRigImport
+{
+	// 一个导入的相机，位置与朝向都在源文件的世界坐标系中，朝向按OpenCV相机约定（X右、Y下、Z前）
+	struct FImportedCamera
+	{
+		FString Name;
+		FVector Center = FVector::ZeroVector;
+		FVector Right = FVector::YAxisVector;
+		FVector Down = -FVector::ZAxisVector;
+		FVector Forward = FVector::XAxisVector;
+		FCameraArrayIntrinsics Intrinsics;
+	};
+
+	// Path可以是COLMAP模型目录（含cameras/images的.bin或.txt）、其中任一文件，或一个.json文件
+	bool Load(const FString& Path, TArray<FImportedCamera>& OutCameras, FString& OutError);
+
+	// 把源坐标系中的相机转换为UE坐标系（X前、Y右、Z上，左手系，厘米）下的变换
+	FTransform ToUnrealTransform(const FImportedCamera& Camera, ECameraArrayImportAxes SourceAxes, double Scale);
+}
@@ -0,0 +1,375 @@
+#include "CameraArraySpatialIndex.h"
+#include "Algo/Sort.h"
+
+namespace
+{
+	// 叶子最多容纳的条目数
+	constexpr int32 MaxLeafItems = 4;
+
+	using FNodeStack = TArray<int32, TInlineAllocator<64>>;
+}
+
+FCameraArraySpatialEntry FCameraArraySpatialEntry::Make(int32 CameraIndex, const FTransform& Transform, float HorizontalFOVDegrees, float AspectRatio, double QueryDistance)
+{
+	FCameraArraySpatialEntry Entry;
+	Entry.CameraIndex = CameraIndex;
+	Entry.Location = Transform.GetLocation();
+	Entry.Forward = Transform.GetUnitAxis(EAxis::X);
+	Entry.Right = Transform.GetUnitAxis(EAxis::Y);
+	Entry.Up = Transform.GetUnitAxis(EAxis::Z);
+	Entry.TanHalfFOVX = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(HorizontalFOVDegrees, 1.0f, 170.0f) * 0.5f));
+	Entry.TanHalfFOVY = Entry.TanHalfFOVX / FMath::Max(AspectRatio, UE_KINDA_SMALL_NUMBER);
+	Entry.QueryDistance = FMath::Max(QueryDistance, 0.0);
+	return Entry;
+}
+
+FBox FCameraArraySpatialEntry::GetFrustumBounds() const
+{
+	FBox Bounds(Location, Location);
+	const FVector Center = Location + Forward * QueryDistance;
+	const FVector HalfX = Right * (TanHalfFOVX * QueryDistance);
+	const FVector HalfY = Up * (TanHalfFOVY * QueryDistance);
+	Bounds += Center + HalfX + HalfY;
+	Bounds += Center + HalfX - HalfY;
+	Bounds += Center - HalfX + HalfY;
+	Bounds += Center - HalfX - HalfY;
+	return Bounds;
+}
+
+bool FCameraArraySpatialEntry::ContainsPoint(const FVector& Point) const
+{
+	const FVector Offset = Point - Location;
+	const double X = FVector::DotProduct(Offset, Forward);
+	const double Y = FVector::DotProduct(Offset, Right);
+	const double Z = FVector::DotProduct(Offset, Up);
+	return X >= 0.0 && X <= QueryDistance && FMath::Abs(Y) <= X * TanHalfFOVX && FMath::Abs(Z) <= X * TanHalfFOVY;
+}
+
+bool FCameraArraySpatialEntry::TestBox(const FBox& Box, bool bFullyInside) const
+{
+	// 角点在相机空间中对六个平面的有符号距离，正值在平面外侧
+	constexpr int32 NumPlanes = 6;
+	int32 NumOutside[NumPlanes] = {};
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		const FVector Point((Corner & 1) ? Box.Max.X : Box.Min.X, (Corner & 2) ? Box.Max.Y : Box.Min.Y, (Corner & 4) ? Box.Max.Z : Box.Min.Z);
+		const FVector Offset = Point - Location;
+		const double X = FVector::DotProduct(Offset, Forward);
+		const double Y = FVector::DotProduct(Offset, Right);
+		const double Z = FVector::DotProduct(Offset, Up);
+		const double Distances[NumPlanes] = {
+			-X,
+			X - QueryDistance,
+			Y - X * TanHalfFOVX,
+			-Y - X * TanHalfFOVX,
+			Z - X * TanHalfFOVY,
+			-Z - X * TanHalfFOVY,
+		};
+		for (int32 Plane = 0; Plane < NumPlanes; ++Plane)
+		{
+			if (Distances[Plane] > 0.0)
+			{
+				if (bFullyInside)
+				{
+					return false;
+				}
+				++NumOutside[Plane];
+			}
+		}
+	}
+
+	for (int32 Plane = 0; Plane < NumPlanes; ++Plane)
+	{
+		if (NumOutside[Plane] == 8)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FCameraArraySpatialIndex::FTree::Build(const TArray<FBox>& Boxes)
+{
+	Nodes.Reset();
+	Items.Reset(Boxes.Num());
+	LeafOfEntry.Init(INDEX_NONE, Boxes.Num());
+	if (Boxes.IsEmpty())
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < Boxes.Num(); ++i)
+	{
+		Items.Add(i);
+	}
+	Nodes.Reserve(2 * FMath::DivideAndRoundUp(Boxes.Num(), MaxLeafItems));
+	BuildRecursive(Boxes, 0, Boxes.Num(), INDEX_NONE);
+}
+
+int32 FCameraArraySpatialIndex::FTree::BuildRecursive(const TArray<FBox>& Boxes, int32 First, int32 Count, int32 Parent)
+{
+	const int32 NodeIndex = Nodes.AddDefaulted();
+	FBox Bounds(ForceInit);
+	FBox CenterBounds(ForceInit);
+	for (int32 i = First; i < First + Count; ++i)
+	{
+		Bounds += Boxes[Items[i]];
+		CenterBounds += Boxes[Items[i]].GetCenter();
+	}
+	Nodes[NodeIndex].Bounds = Bounds;
+	Nodes[NodeIndex].Parent = Parent;
+
+	if (Count <= MaxLeafItems)
+	{
+		Nodes[NodeIndex].FirstItem = First;
+		Nodes[NodeIndex].NumItems = Count;
+		for (int32 i = First; i < First + Count; ++i)
+		{
+			LeafOfEntry[Items[i]] = NodeIndex;
+		}
+		return NodeIndex;
+	}
+
+	// 沿中心点分布最长的轴按中位数分成两半，阵列相机常排成一条线或一个平面，两半的数量总是平衡的
+	const FVector Extent = CenterBounds.GetExtent();
+	const int32 Axis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+	Algo::Sort(TArrayView<int32>(Items.GetData() + First, Count), [&Boxes, Axis](int32 A, int32 B)
+	{
+		return Boxes[A].GetCenter()[Axis] < Boxes[B].GetCenter()[Axis];
+	});
+
+	const int32 LeftCount = Count / 2;
+	BuildRecursive(Boxes, First, LeftCount, NodeIndex);
+	const int32 RightChild = BuildRecursive(Boxes, First + LeftCount, Count - LeftCount, NodeIndex);
+	Nodes[NodeIndex].RightChild = RightChild;
+	return NodeIndex;
+}
+
+void FCameraArraySpatialIndex::FTree::Refit(int32 EntryIndex, const TArray<FBox>& Boxes)
+{
+	int32 NodeIndex = LeafOfEntry[EntryIndex];
+	FNode& Leaf = Nodes[NodeIndex];
+	Leaf.Bounds = FBox(ForceInit);
+	for (int32 i = Leaf.FirstItem; i < Leaf.FirstItem + Leaf.NumItems; ++i)
+	{
+		Leaf.Bounds += Boxes[Items[i]];
+	}
+
+	for (NodeIndex = Leaf.Parent; NodeIndex != INDEX_NONE; NodeIndex = Nodes[NodeIndex].Parent)
+	{
+		FNode& Node = Nodes[NodeIndex];
+		Node.Bounds = Nodes[NodeIndex + 1].Bounds + Nodes[Node.RightChild].Bounds;
+	}
+}
+
+void FCameraArraySpatialIndex::Build(TArray<FCameraArraySpatialEntry>&& InEntries)
+{
+	Entries = MoveTemp(InEntries);
+	EntryOfCamera.Reset();
+	PointBoxes.Reset(Entries.Num());
+	FrustumBoxes.Reset(Entries.Num());
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const FCameraArraySpatialEntry& Entry = Entries[i];
+		EntryOfCamera.Add(Entry.CameraIndex, i);
+		PointBoxes.Add(FBox(Entry.Location, Entry.Location));
+		FrustumBoxes.Add(Entry.GetFrustumBounds());
+	}
+	PointTree.Build(PointBoxes);
+	FrustumTree.Build(FrustumBoxes);
+	NumRefits = 0;
+}
+
+void FCameraArraySpatialIndex::Reset()
+{
+	Build(TArray<FCameraArraySpatialEntry>());
+}
+
+bool FCameraArraySpatialIndex::Update(const FCameraArraySpatialEntry& Entry)
+{
+	const int32* EntryIndex = EntryOfCamera.Find(Entry.CameraIndex);
+	if (!EntryIndex)
+	{
+		return false;
+	}
+
+	Entries[*EntryIndex] = Entry;
+	PointBoxes[*EntryIndex] = FBox(Entry.Location, Entry.Location);
+	FrustumBoxes[*EntryIndex] = Entry.GetFrustumBounds();
+	PointTree.Refit(*EntryIndex, PointBoxes);
+	FrustumTree.Refit(*EntryIndex, FrustumBoxes);
+	++NumRefits;
+	return true;
+}
+
+int32 FCameraArraySpatialIndex::FindNearest(const FVector& Point, int32 ExcludeCameraIndex) const
+{
+	if (PointTree.Nodes.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+
+	int32 BestEntry = INDEX_NONE;
+	double BestDistanceSquared = TNumericLimits<double>::Max();
+	FNodeStack Stack;
+	Stack.Add(0);
+	while (!Stack.IsEmpty())
+	{
+		const int32 NodeIndex = Stack.Pop(false);
+		const FNode& Node = PointTree.Nodes[NodeIndex];
+		if (Node.Bounds.ComputeSquaredDistanceToPoint(Point) >= BestDistanceSquared)
+		{
+			continue;
+		}
+		if (Node.NumItems > 0)
+		{
+			for (int32 i = Node.FirstItem; i < Node.FirstItem + Node.NumItems; ++i)
+			{
+				const int32 EntryIndex = PointTree.Items[i];
+				if (Entries[EntryIndex].CameraIndex == ExcludeCameraIndex)
+				{
+					continue;
+				}
+				const double DistanceSquared = FVector::DistSquared(Entries[EntryIndex].Location, Point);
+				if (DistanceSquared < BestDistanceSquared)
+				{
+					BestDistanceSquared = DistanceSquared;
+					BestEntry = EntryIndex;
+				}
+			}
+			continue;
+		}
+
+		// 较近的子节点后入栈、先访问，尽早收紧剪枝距离
+		const int32 LeftChild = NodeIndex + 1;
+		const bool bLeftNearer = PointTree.Nodes[LeftChild].Bounds.ComputeSquaredDistanceToPoint(Point) <=
+			PointTree.Nodes[Node.RightChild].Bounds.ComputeSquaredDistanceToPoint(Point);
+		Stack.Add(bLeftNearer ? Node.RightChild : LeftChild);
+		Stack.Add(bLeftNearer ? LeftChild : Node.RightChild);
+	}
+	return BestEntry != INDEX_NONE ? Entries[BestEntry].CameraIndex : INDEX_NONE;
+}
+
+void FCameraArraySpatialIndex::FindInRadius(const FVector& Point, double Radius, TArray<int32>& OutCameraIndices) const
+{
+	OutCameraIndices.Reset();
+	if (PointTree.Nodes.IsEmpty() || Radius < 0.0)
+	{
+		return;
+	}
+
+	const double RadiusSquared = Radius * Radius;
+	TArray<TPair<double, int32>> Found;
+	FNodeStack Stack;
+	Stack.Add(0);
+	while (!Stack.IsEmpty())
+	{
+		const int32 NodeIndex = Stack.Pop(false);
+		const FNode& Node = PointTree.Nodes[NodeIndex];
+		if (Node.Bounds.ComputeSquaredDistanceToPoint(Point) > RadiusSquared)
+		{
+			continue;
+		}
+		if (Node.NumItems > 0)
+		{
+			for (int32 i = Node.FirstItem; i < Node.FirstItem + Node.NumItems; ++i)
+			{
+				const FCameraArraySpatialEntry& Entry = Entries[PointTree.Items[i]];
+				const double DistanceSquared = FVector::DistSquared(Entry.Location, Point);
+				if (DistanceSquared <= RadiusSquared)
+				{
+					Found.Emplace(DistanceSquared, Entry.CameraIndex);
+				}
+			}
+			continue;
+		}
+		Stack.Add(NodeIndex + 1);
+		Stack.Add(Node.RightChild);
+	}
+
+	Found.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B)
+	{
+		return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value);
+	});
+	OutCameraIndices.Reserve(Found.Num());
+	for (const TPair<double, int32>& Pair : Found)
+	{
+		OutCameraIndices.Add(Pair.Value);
+	}
+}
+
+void FCameraArraySpatialIndex::FindContainingPoint(const FVector& Point, TArray<int32>& OutCameraIndices) const
+{
+	TArray<int32> EntryIndices;
+	FNodeStack Stack;
+	if (!FrustumTree.Nodes.IsEmpty())
+	{
+		Stack.Add(0);
+	}
+	while (!Stack.IsEmpty())
+	{
+		const int32 NodeIndex = Stack.Pop(false);
+		const FNode& Node = FrustumTree.Nodes[NodeIndex];
+		if (!Node.Bounds.IsInsideOrOn(Point))
+		{
+			continue;
+		}
+		if (Node.NumItems > 0)
+		{
+			for (int32 i = Node.FirstItem; i < Node.FirstItem + Node.NumItems; ++i)
+			{
+				if (Entries[FrustumTree.Items[i]].ContainsPoint(Point))
+				{
+					EntryIndices.Add(FrustumTree.Items[i]);
+				}
+			}
+			continue;
+		}
+		Stack.Add(NodeIndex + 1);
+		Stack.Add(Node.RightChild);
+	}
+	ToSortedCameraIndices(EntryIndices, OutCameraIndices);
+}
+
+void FCameraArraySpatialIndex::FindSeeingBox(const FBox& Box, bool bFullyInside, TArray<int32>& OutCameraIndices) const
+{
+	TArray<int32> EntryIndices;
+	FNodeStack Stack;
+	if (!FrustumTree.Nodes.IsEmpty() && Box.IsValid)
+	{
+		Stack.Add(0);
+	}
+	while (!Stack.IsEmpty())
+	{
+		const int32 NodeIndex = Stack.Pop(false);
+		const FNode& Node = FrustumTree.Nodes[NodeIndex];
+		if (bFullyInside ? !Node.Bounds.IsInsideOrOn(Box.Min) || !Node.Bounds.IsInsideOrOn(Box.Max) : !Node.Bounds.Intersect(Box))
+		{
+			continue;
+		}
+		if (Node.NumItems > 0)
+		{
+			for (int32 i = Node.FirstItem; i < Node.FirstItem + Node.NumItems; ++i)
+			{
+				if (Entries[FrustumTree.Items[i]].TestBox(Box, bFullyInside))
+				{
+					EntryIndices.Add(FrustumTree.Items[i]);
+				}
+			}
+			continue;
+		}
+		Stack.Add(NodeIndex + 1);
+		Stack.Add(Node.RightChild);
+	}
+	ToSortedCameraIndices(EntryIndices, OutCameraIndices);
+}
+
+void FCameraArraySpatialIndex::ToSortedCameraIndices(const TArray<int32>& EntryIndices, TArray<int32>& OutCameraIndices) const
+{
+	OutCameraIndices.Reset(EntryIndices.Num());
+	for (const int32 EntryIndex : EntryIndices)
+	{
+		OutCameraIndices.Add(Entries[EntryIndex].CameraIndex);
+	}
+	OutCameraIndices.Sort();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 一个相机的查询数据：位置、朝向与截到QueryDistance的视锥，构建时从相机读取一次，查询时不再访问Actor或组件
+struct FCameraArraySpatialEntry
+{
+	int32 CameraIndex = INDEX_NONE;
+	FVector Location = FVector::ZeroVector;
+	FVector Forward = FVector::ForwardVector;
+	FVector Right = FVector::RightVector;
+	FVector Up = FVector::UpVector;
+	double TanHalfFOVX = 1.0;
+	double TanHalfFOVY = 1.0;
+	double QueryDistance = 0.0;
+
+	static FCameraArraySpatialEntry Make(int32 CameraIndex, const FTransform& Transform, float HorizontalFOVDegrees, float AspectRatio, double QueryDistance);
+
+	// 视锥（相机位置与远端四角）的包围盒
+	FBox GetFrustumBounds() const;
+
+	bool ContainsPoint(const FVector& Point) const;
+
+	// bFullyInside为false时是保守的相交测试：只排除完全在某个视锥平面外侧的包围盒
+	bool TestBox(const FBox& Box, bool bFullyInside) const;
+};
+
+// 相机位置与视锥上的两棵包围体层次树（BVH）
+// 最近相机与半径查询用位置树，按距离剪枝；可见性查询用视锥树，只对包围盒相交的相机做精确测试
+// 单个相机移动时只更新它所在的叶子与祖先的包围盒，更新次数超过相机数后下次查询前整体重建
+class FCameraArraySpatialIndex
+{
+public:
+	void Build(TArray<FCameraArraySpatialEntry>&& InEntries);
+	void Reset();
+
+	// 返回false表示该相机不在索引中
+	bool Update(const FCameraArraySpatialEntry& Entry);
+
+	bool NeedsRebuild() const { return NumRefits > FMath::Max(Entries.Num(), 64); }
+	int32 Num() const { return Entries.Num(); }
+
+	// 返回相机索引，没有相机时返回INDEX_NONE；ExcludeCameraIndex用于查找某个相机最近的邻居
+	int32 FindNearest(const FVector& Point, int32 ExcludeCameraIndex = INDEX_NONE) const;
+
+	// 按距离从近到远排列
+	void FindInRadius(const FVector& Point, double Radius, TArray<int32>& OutCameraIndices) const;
+
+	// 视锥包含该点的相机，按相机索引排列
+	void FindContainingPoint(const FVector& Point, TArray<int32>& OutCameraIndices) const;
+
+	// 视锥与包围盒相交（或完全包含包围盒）的相机，按相机索引排列
+	void FindSeeingBox(const FBox& Box, bool bFullyInside, TArray<int32>& OutCameraIndices) const;
+
+private:
+	// 节点的左子节点紧跟其后，RightChild只对内部节点有效；叶子的条目是Items[FirstItem, FirstItem + NumItems)
+	struct FNode
+	{
+		FBox Bounds = FBox(ForceInit);
+		int32 Parent = INDEX_NONE;
+		int32 RightChild = INDEX_NONE;
+		int32 FirstItem = 0;
+		int32 NumItems = 0;
+	};
+
+	struct FTree
+	{
+		TArray<FNode> Nodes;
+		TArray<int32> Items;
+		TArray<int32> LeafOfEntry;
+
+		void Build(const TArray<FBox>& Boxes);
+		void Refit(int32 EntryIndex, const TArray<FBox>& Boxes);
+		int32 BuildRecursive(const TArray<FBox>& Boxes, int32 First, int32 Count, int32 Parent);
+	};
+
+	void ToSortedCameraIndices(const TArray<int32>& EntryIndices, TArray<int32>& OutCameraIndices) const;
+
+	TArray<FCameraArraySpatialEntry> Entries;
+	TMap<int32, int32> EntryOfCamera;
+	TArray<FBox> PointBoxes;
+	TArray<FBox> FrustumBoxes;
+	FTree PointTree;
+	FTree FrustumTree;
+	int32 NumRefits = 0;
+};
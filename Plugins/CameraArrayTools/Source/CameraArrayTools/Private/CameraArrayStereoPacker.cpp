@@ -0,0 +1,128 @@
+#include "CameraArrayStereoPacker.h"
+#include "Misc/ScopeLock.h"
+
+FCameraArrayStereoPacker::FCameraArrayStereoPacker(int32 InNumEyes, ECameraArrayStereoPacking InPacking)
+	: NumEyes(FMath::Max(InNumEyes, 1))
+	, Packing(InPacking)
+{
+}
+
+bool FCameraArrayStereoPacker::AddEye(int32 PositionIndex, int32 EyeIndex, const void* Pixels, int32 Width, int32 Height, int32 BytesPerPixel,
+	FCameraArrayPooledBuffer& OutPacked, int32& OutWidth, int32& OutHeight)
+{
+	check(EyeIndex >= 0 && EyeIndex < NumEyes);
+	const int64 EyeBytes = static_cast<int64>(Width) * Height * BytesPerPixel;
+
+	// 只在锁内登记，拼接在锁外进行
+	FPendingPosition Completed;
+	{
+		FScopeLock Lock(&Mutex);
+		FPendingPosition& Pending = PendingPositions.FindOrAdd(PositionIndex);
+		if (Pending.Eyes.Num() == 0)
+		{
+			Pending.Eyes.SetNum(NumEyes);
+		}
+		if (Pending.bFailed)
+		{
+			// 另一目已失败，这一目不再保留
+			MarkReceived(PositionIndex, Pending, EyeIndex);
+			return false;
+		}
+		if (Pending.Eyes[EyeIndex].Num() == 0)
+		{
+			++Pending.NumReceived;
+		}
+		Pending.Eyes[EyeIndex] = FCameraArrayPooledBuffer(EyeBytes);
+		FMemory::Memcpy(Pending.Eyes[EyeIndex].GetData(), Pixels, EyeBytes);
+
+		if (Pending.NumReceived < NumEyes)
+		{
+			return false;
+		}
+		Completed = MoveTemp(Pending);
+		PendingPositions.Remove(PositionIndex);
+	}
+
+	OutPacked = FCameraArrayPooledBuffer(EyeBytes * NumEyes);
+	if (Packing == ECameraArrayStereoPacking::OverUnder)
+	{
+		// 上下排列：各目整幅连续存放，第0目在最上方
+		OutWidth = Width;
+		OutHeight = Height * NumEyes;
+		for (int32 Eye = 0; Eye < NumEyes; ++Eye)
+		{
+			FMemory::Memcpy(OutPacked.GetData() + Eye * EyeBytes, Completed.Eyes[Eye].GetData(), EyeBytes);
+		}
+	}
+	else
+	{
+		// 左右并排：逐行交错拷贝，第0目（最左侧）在左边
+		OutWidth = Width * NumEyes;
+		OutHeight = Height;
+		const int64 RowBytes = static_cast<int64>(Width) * BytesPerPixel;
+		for (int32 Y = 0; Y < Height; ++Y)
+		{
+			uint8* DstRow = OutPacked.GetData() + Y * RowBytes * NumEyes;
+			for (int32 Eye = 0; Eye < NumEyes; ++Eye)
+			{
+				FMemory::Memcpy(DstRow + Eye * RowBytes, Completed.Eyes[Eye].GetData() + Y * RowBytes, RowBytes);
+			}
+		}
+	}
+	return true;
+}
+
+void FCameraArrayStereoPacker::MarkReceived(int32 PositionIndex, FPendingPosition& Pending, int32 EyeIndex)
+{
+	if (Pending.Eyes[EyeIndex].Num() == 0)
+	{
+		++Pending.NumReceived;
+	}
+	Pending.Eyes[EyeIndex].Reset();
+	if (Pending.NumReceived >= NumEyes)
+	{
+		// 位置编号在各时间步、各遍之间重复使用，所有目都有了结果就移除，不影响下一次
+		PendingPositions.Remove(PositionIndex);
+	}
+}
+
+void FCameraArrayStereoPacker::FailEye(int32 PositionIndex, int32 EyeIndex)
+{
+	check(EyeIndex >= 0 && EyeIndex < NumEyes);
+
+	FScopeLock Lock(&Mutex);
+	FPendingPosition& Pending = PendingPositions.FindOrAdd(PositionIndex);
+	if (Pending.Eyes.Num() == 0)
+	{
+		Pending.Eyes.SetNum(NumEyes);
+	}
+	if (!Pending.bFailed)
+	{
+		UE_LOG(LogTemp, Error, TEXT("FCameraArrayStereoPacker: 位置 %d 的第 %d 目失败，该位置不会输出打包图像"), PositionIndex, EyeIndex);
+		Pending.bFailed = true;
+
+		// 已到达的各目仍然计数，只归还像素
+		for (FCameraArrayPooledBuffer& Eye : Pending.Eyes)
+		{
+			Eye.Reset();
+		}
+	}
+	MarkReceived(PositionIndex, Pending, EyeIndex);
+}
+
+int32 FCameraArrayStereoPacker::DiscardIncomplete()
+{
+	FScopeLock Lock(&Mutex);
+	int32 NumDiscarded = 0;
+	for (const TPair<int32, FPendingPosition>& Pair : PendingPositions)
+	{
+		// 失败的位置已经记录过
+		if (!Pair.Value.bFailed)
+		{
+			UE_LOG(LogTemp, Error, TEXT("FCameraArrayStereoPacker: 位置 %d 只收到 %d/%d 目，未输出打包图像"), Pair.Key, Pair.Value.NumReceived, NumEyes);
+			++NumDiscarded;
+		}
+	}
+	PendingPositions.Empty();
+	return NumDiscarded;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraArrayManager.h"
+#include "CameraArrayBufferPool.h"
+
+// 立体/多目打包：同一阵列位置的各目图像在后台线程陆续到达，全部到齐后拼成一张左右并排或上下排列的图像
+class FCameraArrayStereoPacker
+{
+public:
+	FCameraArrayStereoPacker(int32 InNumEyes, ECameraArrayStereoPacking InPacking);
+
+	// 放入一目的像素；该位置的所有目都到齐时返回true，并输出拼好的图像及其尺寸
+	bool AddEye(int32 PositionIndex, int32 EyeIndex, const void* Pixels, int32 Width, int32 Height, int32 BytesPerPixel,
+		FCameraArrayPooledBuffer& OutPacked, int32& OutWidth, int32& OutHeight);
+
+	// 某一目回读或处理失败：该位置不再输出打包图像，丢弃已到达的各目，其余各目到达时直接丢弃
+	void FailEye(int32 PositionIndex, int32 EyeIndex);
+
+	// 丢弃尚未到齐的位置并逐个记录日志，返回丢弃的位置数；任务结束或中止时调用
+	int32 DiscardIncomplete();
+
+	int32 GetNumEyes() const { return NumEyes; }
+
+private:
+	struct FPendingPosition
+	{
+		TArray<FCameraArrayPooledBuffer> Eyes;
+		int32 NumReceived = 0;
+		bool bFailed = false;
+	};
+
+	// 登记一目已到达（包括失败的目），所有目都有了结果时移除该位置；调用时需持有锁
+	void MarkReceived(int32 PositionIndex, FPendingPosition& Pending, int32 EyeIndex);
+
+	int32 NumEyes = 2;
+	ECameraArrayStereoPacking Packing = ECameraArrayStereoPacking::SideBySide;
+
+	// 各目在不同的后台线程上写入
+	FCriticalSection Mutex;
+	TMap<int32, FPendingPosition> PendingPositions;
+};
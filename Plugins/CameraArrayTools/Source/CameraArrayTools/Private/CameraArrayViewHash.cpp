@@ -0,0 +1,277 @@
+#include "CameraArrayViewHash.h"
+#include "Engine/World.h"
+#include "Engine/PostProcessVolume.h"
+#include "EngineUtils.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Components/LightComponent.h"
+#include "Components/LocalLightComponent.h"
+#include "Components/SkyAtmosphereComponent.h"
+#include "Components/ExponentialHeightFogComponent.h"
+#include "Components/VolumetricCloudComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstance.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+#include "Engine/SkinnedAsset.h"
+#include "UObject/UObjectIterator.h"
+#include "Camera/CameraTypes.h"
+#include "ConvexVolume.h"
+#include "SceneManagement.h"
+#include "Kismet/GameplayStatics.h"
+
+namespace CameraArrayViewHash
+{
+	void HashBytes(FXxHash64Builder& Builder, const void* Data, uint64 Size)
+	{
+		Builder.Update(Data, Size);
+	}
+
+	void HashString(FXxHash64Builder& Builder, const FString& Value)
+	{
+		Builder.Update(*Value, Value.Len() * sizeof(TCHAR));
+	}
+
+	void HashReflectedProperties(FXxHash64Builder& Builder, const UStruct* Struct, const void* Container)
+	{
+		FString ValueText;
+		for (TFieldIterator<FProperty> It(Struct); It; ++It)
+		{
+			const FProperty* Property = *It;
+			if (Property->HasAnyPropertyFlags(CPF_Transient))
+			{
+				continue;
+			}
+
+			for (int32 ArrayIndex = 0; ArrayIndex < Property->ArrayDim; ++ArrayIndex)
+			{
+				ValueText.Reset();
+				Property->ExportTextItem_Direct(ValueText, Property->ContainerPtrToValuePtr<void>(Container, ArrayIndex),
+					nullptr, nullptr, PPF_None);
+				HashString(Builder, Property->GetName());
+				HashString(Builder, ValueText);
+			}
+		}
+	}
+
+	static void HashTransform(FXxHash64Builder& Builder, const FTransform& Transform)
+	{
+		const FMatrix Matrix = Transform.ToMatrixWithScale();
+		HashBytes(Builder, &Matrix.M[0][0], sizeof(Matrix.M));
+	}
+
+	static void HashMaterial(FXxHash64Builder& Builder, const UMaterialInterface* Material)
+	{
+		if (!Material)
+		{
+			HashString(Builder, TEXT("None"));
+			return;
+		}
+
+		HashString(Builder, Material->GetPathName());
+
+		// 材质实例的参数可以在不改变路径的情况下被修改，需要一并计入
+		if (const UMaterialInstance* Instance = Cast<UMaterialInstance>(Material))
+		{
+			HashReflectedProperties(Builder, UMaterialInstance::StaticClass(), Instance);
+		}
+		if (const UMaterial* BaseMaterial = Material->GetMaterial())
+		{
+			HashBytes(Builder, &BaseMaterial->StateId, sizeof(FGuid));
+		}
+	}
+
+	static uint64 HashPrimitive(const UPrimitiveComponent* Primitive)
+	{
+		FXxHash64Builder Builder;
+		HashString(Builder, Primitive->GetPathName());
+		HashTransform(Builder, Primitive->GetComponentTransform());
+
+		const uint8 Flags[] = {
+			static_cast<uint8>(Primitive->IsVisible()),
+			static_cast<uint8>(Primitive->bHiddenInGame),
+			static_cast<uint8>(Primitive->CastShadow),
+		};
+		HashBytes(Builder, Flags, sizeof(Flags));
+
+		if (const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Primitive))
+		{
+			HashString(Builder, GetPathNameSafe(MeshComponent->GetStaticMesh()));
+		}
+		else if (const USkinnedMeshComponent* SkinnedComponent = Cast<USkinnedMeshComponent>(Primitive))
+		{
+			// 动画只改变骨骼姿势与变形目标权重，组件变换和资产都不变
+			HashString(Builder, GetPathNameSafe(SkinnedComponent->GetSkinnedAsset()));
+			const TArray<FTransform>& BoneTransforms = SkinnedComponent->GetComponentSpaceTransforms();
+			for (const FTransform& BoneTransform : BoneTransforms)
+			{
+				HashTransform(Builder, BoneTransform);
+			}
+			HashBytes(Builder, SkinnedComponent->MorphTargetWeights.GetData(), SkinnedComponent->MorphTargetWeights.Num() * sizeof(float));
+		}
+
+		for (int32 MaterialIndex = 0; MaterialIndex < Primitive->GetNumMaterials(); ++MaterialIndex)
+		{
+			HashMaterial(Builder, Primitive->GetMaterial(MaterialIndex));
+		}
+		return Builder.Finalize().Hash;
+	}
+
+	// 材质参数集合的值属于世界而不是材质，修改后引用它的材质路径与参数都不变
+	static uint64 HashParameterCollection(const UMaterialParameterCollectionInstance* Instance)
+	{
+		FXxHash64Builder Builder;
+		const UMaterialParameterCollection* Collection = Instance->GetCollection();
+		HashString(Builder, GetPathNameSafe(Collection));
+		if (!Collection)
+		{
+			return Builder.Finalize().Hash;
+		}
+
+		for (const FCollectionScalarParameter& Parameter : Collection->ScalarParameters)
+		{
+			float Value = Parameter.DefaultValue;
+			Instance->GetScalarParameterValue(Parameter.ParameterName, Value);
+			HashString(Builder, Parameter.ParameterName.ToString());
+			HashBytes(Builder, &Value, sizeof(Value));
+		}
+		for (const FCollectionVectorParameter& Parameter : Collection->VectorParameters)
+		{
+			FLinearColor Value = Parameter.DefaultValue;
+			Instance->GetVectorParameterValue(Parameter.ParameterName, Value);
+			HashString(Builder, Parameter.ParameterName.ToString());
+			HashBytes(Builder, &Value, sizeof(Value));
+		}
+		return Builder.Finalize().Hash;
+	}
+
+	static uint64 HashObject(const UObject* Object)
+	{
+		FXxHash64Builder Builder;
+		HashString(Builder, Object->GetPathName());
+		HashReflectedProperties(Builder, Object->GetClass(), Object);
+		if (const USceneComponent* SceneComponent = Cast<USceneComponent>(Object))
+		{
+			HashTransform(Builder, SceneComponent->GetComponentTransform());
+		}
+		return Builder.Finalize().Hash;
+	}
+}
+
+void FCameraArraySceneSnapshot::Capture(const UWorld* World, const TSet<const AActor*>& IgnoredActors, bool bWholeScene)
+{
+	using namespace CameraArrayViewHash;
+
+	LocalEntries.Reset();
+	GlobalStateHash = 0;
+	if (!World)
+	{
+		return;
+	}
+
+	// 先收集再排序，使哈希与Actor的遍历顺序无关，编辑器重启后仍能命中上次的日志
+	TArray<uint64> GlobalHashes;
+
+	for (TActorIterator<AActor> ActorIt(World); ActorIt; ++ActorIt)
+	{
+		const AActor* Actor = *ActorIt;
+		if (!IsValid(Actor) || IgnoredActors.Contains(Actor))
+		{
+			continue;
+		}
+
+		if (const APostProcessVolume* Volume = Cast<APostProcessVolume>(Actor))
+		{
+			GlobalHashes.Add(HashObject(Volume));
+		}
+
+		TInlineComponentArray<UActorComponent*> Components(Actor);
+		for (const UActorComponent* Component : Components)
+		{
+			if (!IsValid(Component) || !Component->IsRegistered())
+			{
+				continue;
+			}
+
+			if (const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component))
+			{
+				const uint64 PrimitiveHash = HashPrimitive(Primitive);
+
+				// 投射阴影的图元即使在视锥外也可能在画面内留下阴影，保守地计入全局状态
+				if (bWholeScene || Primitive->CastShadow)
+				{
+					GlobalHashes.Add(PrimitiveHash);
+				}
+				else
+				{
+					LocalEntries.Add({ Primitive->Bounds, PrimitiveHash });
+				}
+			}
+			else if (const ULocalLightComponent* LocalLight = Cast<ULocalLightComponent>(Component))
+			{
+				// 局部光源只照亮衰减半径以内的表面
+				const uint64 LightHash = HashObject(LocalLight);
+				if (bWholeScene)
+				{
+					GlobalHashes.Add(LightHash);
+				}
+				else
+				{
+					const FSphere Influence(LocalLight->GetComponentLocation(), LocalLight->AttenuationRadius);
+					LocalEntries.Add({ FBoxSphereBounds(Influence), LightHash });
+				}
+			}
+			else if (Component->IsA<ULightComponentBase>() ||
+				Component->IsA<USkyAtmosphereComponent>() ||
+				Component->IsA<UExponentialHeightFogComponent>() ||
+				Component->IsA<UVolumetricCloudComponent>())
+			{
+				GlobalHashes.Add(HashObject(Component));
+			}
+		}
+	}
+
+	for (TObjectIterator<UMaterialParameterCollectionInstance> It; It; ++It)
+	{
+		if (IsValid(*It) && It->IsIn(World))
+		{
+			GlobalHashes.Add(HashParameterCollection(*It));
+		}
+	}
+
+	GlobalHashes.Sort();
+	GlobalStateHash = FXxHash64::HashBuffer(GlobalHashes.GetData(), GlobalHashes.Num() * sizeof(uint64)).Hash;
+}
+
+uint64 FCameraArraySceneSnapshot::HashView(const FMinimalViewInfo& ViewInfo, uint64 RenderSettingsHash) const
+{
+	using namespace CameraArrayViewHash;
+
+	FXxHash64Builder Builder;
+	HashBytes(Builder, &GlobalStateHash, sizeof(GlobalStateHash));
+	HashBytes(Builder, &RenderSettingsHash, sizeof(RenderSettingsHash));
+	HashTransform(Builder, FTransform(ViewInfo.Rotation, ViewInfo.Location));
+
+	const float ViewParams[] = { ViewInfo.FOV, ViewInfo.AspectRatio, ViewInfo.OrthoWidth };
+	HashBytes(Builder, ViewParams, sizeof(ViewParams));
+
+	FMatrix ViewMatrix, ProjectionMatrix, ViewProjectionMatrix;
+	UGameplayStatics::GetViewProjectionMatrix(ViewInfo, ViewMatrix, ProjectionMatrix, ViewProjectionMatrix);
+
+	FConvexVolume ViewFrustum;
+	GetViewFrustumBounds(ViewFrustum, ViewProjectionMatrix, false);
+
+	TArray<uint64> VisibleHashes;
+	for (const FLocalEntry& Entry : LocalEntries)
+	{
+		if (ViewFrustum.IntersectBox(Entry.Bounds.Origin, Entry.Bounds.BoxExtent))
+		{
+			VisibleHashes.Add(Entry.StateHash);
+		}
+	}
+	VisibleHashes.Sort();
+	HashBytes(Builder, VisibleHashes.GetData(), VisibleHashes.Num() * sizeof(uint64));
+	return Builder.Finalize().Hash;
+}
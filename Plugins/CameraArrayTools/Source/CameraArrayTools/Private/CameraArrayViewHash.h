@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Hash/xxhash.h"
+#include "Math/BoxSphereBounds.h"
+
+class UWorld;
+class AActor;
+struct FMinimalViewInfo;
+
+// 场景状态快照：批量开始时采集一次，之后按每个相机的视锥组合出视角哈希
+// 快照不持有UObject引用，可以直接用合成数据构造来做测试
+struct FCameraArraySceneSnapshot
+{
+	struct FLocalEntry
+	{
+		FBoxSphereBounds Bounds;
+		uint64 StateHash = 0;
+	};
+
+	// 影响所有视角的状态（方向光、天空、雾、后处理体积、材质参数集合、投射阴影的图元等）
+	uint64 GlobalStateHash = 0;
+
+	// 只影响与其包围盒相交的视角的状态（不投射阴影的图元、局部光源的衰减范围）
+	// 图元的状态包括变换、可见性、网格与材质参数，骨骼网格还包括当前骨骼姿势与变形目标权重
+	TArray<FLocalEntry> LocalEntries;
+
+	// bWholeScene为true时（路径追踪、Lumen等全局光照），所有状态都计入全局哈希
+	void Capture(const UWorld* World, const TSet<const AActor*>& IgnoredActors, bool bWholeScene);
+
+	uint64 HashView(const FMinimalViewInfo& ViewInfo, uint64 RenderSettingsHash) const;
+};
+
+namespace CameraArrayViewHash
+{
+	void HashBytes(FXxHash64Builder& Builder, const void* Data, uint64 Size);
+	void HashString(FXxHash64Builder& Builder, const FString& Value);
+
+	// 通过反射导出所有非Transient属性的文本并计入哈希，用于保守地覆盖灯光、雾等组件的全部参数
+	void HashReflectedProperties(FXxHash64Builder& Builder, const UStruct* Struct, const void* Container);
+}
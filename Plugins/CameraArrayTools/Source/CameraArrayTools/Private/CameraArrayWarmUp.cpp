@@ -0,0 +1,33 @@
+#include "CameraArrayWarmUp.h"
+#include "AssetCompilingManager.h"
+#include "PipelineStateCache.h"
+#include "ShaderCompiler.h"
+
+int32 CameraArrayWarmUp::GetNumPendingCompilations()
+{
+	int32 NumPending = PipelineStateCache::NumActivePrecacheRequests();
+	NumPending += FAssetCompilingManager::Get().GetNumRemainingAssets();
+	if (GShaderCompilingManager)
+	{
+		NumPending += GShaderCompilingManager->GetNumRemainingJobs();
+	}
+	return NumPending;
+}
+
+TArray<int32> CameraArrayWarmUp::SelectPoses(int32 PoseCount, int32 MaxPoses)
+{
+	TArray<int32> Poses;
+	const int32 NumSelected = MaxPoses > 0 ? FMath::Min(PoseCount, MaxPoses) : PoseCount;
+	Poses.Reserve(NumSelected);
+	for (int32 i = 0; i < NumSelected; ++i)
+	{
+		Poses.Add(static_cast<int32>(static_cast<int64>(i) * PoseCount / NumSelected));
+	}
+	return Poses;
+}
+
+FString FCameraArrayWarmUpStats::Describe() const
+{
+	return FString::Printf(TEXT("着色器预热：%d 个位姿 %d 轮共 %d 次捕获，耗时 %.2f 秒（捕获 %.2f 秒，等待编译 %.2f 秒，最多 %d 项编译）"),
+		NumPoses, NumRounds, NumCaptures, CaptureSeconds + CompileWaitSeconds, CaptureSeconds, CompileWaitSeconds, MaxPendingCompilations);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 着色器预热：正式批量前在极小分辨率下把相机位姿捕获一遍，材质着色器与PSO在此期间编译，
+// 编译完成后再走一遍，直到某一轮不再触发新的编译
+namespace CameraArrayWarmUp
+{
+	// 最多预热的轮数，每一轮都把所有位姿捕获一次
+	constexpr int32 MaxRounds = 3;
+
+	// 预热捕获的宽度（像素），高度按输出比例
+	constexpr int32 TargetWidth = 64;
+
+	// 仍在编译的着色器任务、PSO预缓存请求与资产（材质、纹理等）的数量之和
+	int32 GetNumPendingCompilations();
+
+	// 在PoseCount个位姿中均匀选出不超过MaxPoses个的下标，MaxPoses不大于0时全部选中
+	TArray<int32> SelectPoses(int32 PoseCount, int32 MaxPoses);
+}
+
+// 一次批量的预热统计，与正式捕获的耗时分开报告
+struct FCameraArrayWarmUpStats
+{
+	int32 NumPoses = 0;
+	int32 NumRounds = 0;
+	int32 NumCaptures = 0;
+	int32 MaxPendingCompilations = 0;
+	double CaptureSeconds = 0.0;
+	double CompileWaitSeconds = 0.0;
+
+	FString Describe() const;
+};
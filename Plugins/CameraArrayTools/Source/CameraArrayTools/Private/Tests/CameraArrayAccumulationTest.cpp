@@ -0,0 +1,85 @@
+#include "CameraArrayAccumulation.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayJitterTest, "CameraArrayTools.Accumulation.Jitter",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayJitterTest::RunTest(const FString& Parameters)
+{
+	// 第一个采样跳过Halton序号0：x为1/2，y为1/3，减去0.5后居中
+	const FVector2D First = CameraArrayAccumulation::GetJitter(0);
+	TestTrue(TEXT("第一个采样的偏移"), First.Equals(FVector2D(0.0, 1.0 / 3.0 - 0.5), 1e-6));
+	TestTrue(TEXT("同一采样序号的偏移总是相同"), CameraArrayAccumulation::GetJitter(5).Equals(CameraArrayAccumulation::GetJitter(5), 0.0));
+
+	// 2的幂个采样在x方向上分层：每个1/N宽的区间正好一个采样
+	constexpr int32 NumStrata = 8;
+	TBitArray<> Occupied(false, NumStrata);
+	for (int32 Sample = 0; Sample < NumStrata; ++Sample)
+	{
+		const int32 Stratum = FMath::FloorToInt32((CameraArrayAccumulation::GetJitter(Sample).X + 0.5) * NumStrata);
+		if (Stratum >= 0 && Stratum < NumStrata)
+		{
+			Occupied[Stratum] = true;
+		}
+	}
+	TestEqual(TEXT("前8个采样覆盖x方向的8个区间"), Occupied.CountSetBits(), NumStrata);
+
+	FVector2D Sum = FVector2D::ZeroVector;
+	bool bInRange = true;
+	for (int32 Sample = 0; Sample < 64; ++Sample)
+	{
+		const FVector2D Jitter = CameraArrayAccumulation::GetJitter(Sample);
+		bInRange &= FMath::Abs(Jitter.X) <= 0.5 && FMath::Abs(Jitter.Y) <= 0.5;
+		Sum += Jitter;
+	}
+	TestTrue(TEXT("偏移在半个像素以内"), bInRange);
+	TestTrue(TEXT("64个采样的平均偏移接近像素中心"), (Sum / 64.0).GetAbsMax() < 0.02);
+
+	// 投影矩阵上的偏移：像素偏移 * 2 / 尺寸，像素Y向下对应裁剪空间Y向上
+	constexpr int32 Width = 640;
+	constexpr int32 Height = 360;
+	const FMatrix Unjittered = CameraArrayAccumulation::MakeJitteredProjection(90.0f, Width, Height, FVector2D::ZeroVector);
+	const FMatrix Jittered = CameraArrayAccumulation::MakeJitteredProjection(90.0f, Width, Height, FVector2D(0.25, -0.5));
+	const FVector4 ViewPoint(30.0, -20.0, 500.0, 1.0);
+	const FVector4 ClipA = Unjittered.TransformFVector4(ViewPoint);
+	const FVector4 ClipB = Jittered.TransformFVector4(ViewPoint);
+	TestTrue(TEXT("x方向的裁剪空间偏移"), FMath::IsNearlyEqual(ClipB.X / ClipB.W - ClipA.X / ClipA.W, 0.25 * 2.0 / Width, 1e-6));
+	TestTrue(TEXT("y方向的裁剪空间偏移"), FMath::IsNearlyEqual(ClipB.Y / ClipB.W - ClipA.Y / ClipA.W, 0.5 * 2.0 / Height, 1e-6));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayShutterOffsetTest, "CameraArrayTools.Accumulation.ShutterOffsets",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayShutterOffsetTest::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("单个采样不偏移"), CameraArrayAccumulation::GetShutterOffset(0, 1, 0.5f), 0.0);
+	TestEqual(TEXT("快门为0时不偏移"), CameraArrayAccumulation::GetShutterOffset(3, 8, 0.0f), 0.0);
+
+	// 分层均匀分布：每个采样位于快门区间内第i份的中点，整体以当前帧为中心
+	constexpr int32 NumSamples = 4;
+	constexpr float Shutter = 0.5f;
+	const double Expected[NumSamples] = { -0.1875, -0.0625, 0.0625, 0.1875 };
+	double Sum = 0.0;
+	for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+	{
+		const double Offset = CameraArrayAccumulation::GetShutterOffset(Sample, NumSamples, Shutter);
+		TestTrue(FString::Printf(TEXT("第 %d 个采样的时间偏移"), Sample), FMath::IsNearlyEqual(Offset, Expected[Sample], 1e-6));
+		Sum += Offset;
+	}
+	TestTrue(TEXT("时间偏移以当前帧为中心"), FMath::IsNearlyZero(Sum, 1e-6));
+
+	// 多个采样时首尾仍在快门区间以内
+	for (const int32 Count : { 2, 7, 32 })
+	{
+		const double FirstOffset = CameraArrayAccumulation::GetShutterOffset(0, Count, 1.0f);
+		const double LastOffset = CameraArrayAccumulation::GetShutterOffset(Count - 1, Count, 1.0f);
+		TestTrue(FString::Printf(TEXT("%d 个采样的偏移在快门以内"), Count), FirstOffset > -0.5 && LastOffset < 0.5);
+		TestTrue(FString::Printf(TEXT("%d 个采样的偏移对称"), Count), FMath::IsNearlyEqual(FirstOffset, -LastOffset, 1e-9));
+	}
+	return true;
+}
+
+#endif
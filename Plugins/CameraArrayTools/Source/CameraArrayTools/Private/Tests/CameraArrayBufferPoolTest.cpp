@@ -0,0 +1,48 @@
+#include "CameraArrayBufferPool.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayBufferPoolTest, "CameraArrayTools.BufferPool.Reuse",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayBufferPoolTest::RunTest(const FString& Parameters)
+{
+	// 缓冲池是全局的，先清空空闲缓冲，避免之前的批量留下的缓冲影响结果
+	FCameraArrayBufferPool& Pool = FCameraArrayBufferPool::Get();
+	Pool.Trim();
+
+	constexpr int64 FrameBytes = 1920 * 1080 * 4;
+	const uint8* FirstData = nullptr;
+	{
+		FCameraArrayPooledBuffer Buffer(FrameBytes);
+		TestEqual(TEXT("元素数为申请的大小"), Buffer.Num(), FrameBytes);
+		TestTrue(TEXT("按等级预留容量"), Buffer.GetArray().Max() >= FrameBytes);
+		FirstData = Buffer.GetData();
+	}
+
+	// 同一等级中稍小的申请复用刚归还的缓冲
+	{
+		FCameraArrayPooledBuffer Buffer(FrameBytes - 1000);
+		TestEqual(TEXT("复用时元素数为新的大小"), Buffer.Num(), FrameBytes - 1000);
+		TestTrue(TEXT("同一等级的申请复用归还的缓冲"), Buffer.GetData() == FirstData);
+
+		// 移动后原缓冲为空，只归还一次
+		FCameraArrayPooledBuffer Moved = MoveTemp(Buffer);
+		TestEqual(TEXT("移动后原缓冲为空"), Buffer.Num(), static_cast<int64>(0));
+		TestTrue(TEXT("移动后数据指针不变"), Moved.GetData() == FirstData);
+	}
+
+	// 两个同时使用的缓冲不能是同一块内存
+	{
+		FCameraArrayPooledBuffer A(FrameBytes);
+		FCameraArrayPooledBuffer B(FrameBytes);
+		TestTrue(TEXT("同时使用的缓冲互不重叠"), A.GetData() != B.GetData());
+		TestEqual(TEXT("按元素类型计数"), A.Num<FColor>(), FrameBytes / static_cast<int64>(sizeof(FColor)));
+	}
+
+	Pool.Trim();
+	return true;
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "CameraArrayManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/World.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	// 不加入引擎世界列表的临时场景，只放一个管理器
+	struct FManagerScene
+	{
+		UWorld* World = nullptr;
+		ACameraArrayManager* Manager = nullptr;
+
+		FManagerScene()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			Manager = World->SpawnActor<ACameraArrayManager>();
+		}
+
+		~FManagerScene()
+		{
+			if (World)
+			{
+				// 占位的空相机不交给管理器的清理逻辑
+				if (Manager)
+				{
+					SetNumCameras(0);
+				}
+				World->DestroyWorld(false);
+			}
+		}
+
+		// 排序只看相机数量，不访问相机本身；通过反射设置私有的相机列表，不必生成相机
+		void SetNumCameras(int32 NumCameras) const
+		{
+			FArrayProperty* Property = FindFProperty<FArrayProperty>(ACameraArrayManager::StaticClass(), TEXT("ManagedCameras"));
+			FScriptArrayHelper Helper(Property, Property->ContainerPtrToValuePtr<void>(Manager));
+			Helper.EmptyAndAddValues(NumCameras);
+		}
+	};
+
+	bool IsPermutation(const TArray<int32>& Order, int32 Num)
+	{
+		TBitArray<> Seen(false, Num);
+		for (const int32 Index : Order)
+		{
+			if (Index < 0 || Index >= Num || Seen[Index])
+			{
+				return false;
+			}
+			Seen[Index] = true;
+		}
+		return Order.Num() == Num;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayCaptureOrderTest, "CameraArrayTools.CaptureOrder.BuildCaptureOrder",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayCaptureOrderTest::RunTest(const FString& Parameters)
+{
+	FManagerScene Scene;
+	if (!TestNotNull(TEXT("相机阵列管理器"), Scene.Manager))
+	{
+		return false;
+	}
+	ACameraArrayManager& Manager = *Scene.Manager;
+	Scene.SetNumCameras(20);
+
+	Manager.CaptureOrderMode = ECameraArrayCaptureOrder::Index;
+	TArray<int32> Order = Manager.BuildCaptureOrder();
+	TestTrue(TEXT("按索引顺序"), Order == TArray<int32>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 }));
+
+	// 由粗到细：步长8（含阵列末端）、4、2、1，每级只加入尚未访问的相机
+	Manager.CaptureOrderMode = ECameraArrayCaptureOrder::CoarseToFine;
+	Order = Manager.BuildCaptureOrder();
+	TestTrue(TEXT("由粗到细的顺序"), Order == TArray<int32>({ 0, 8, 16, 19, 4, 12, 2, 6, 10, 14, 18, 1, 3, 5, 7, 9, 11, 13, 15, 17 }));
+
+	// 各种数量下都是排列：不重复、不遗漏
+	bool bAllPermutations = true;
+	for (int32 NumCameras = 1; NumCameras <= 40; ++NumCameras)
+	{
+		Scene.SetNumCameras(NumCameras);
+		bAllPermutations &= IsPermutation(Manager.BuildCaptureOrder(), NumCameras);
+	}
+	TestTrue(TEXT("由粗到细的顺序覆盖每个相机一次"), bAllPermutations);
+
+	// 没有历史耗时时所有相机按同一估计值排序，保持索引顺序
+	Scene.SetNumCameras(6);
+	Manager.CaptureOrderMode = ECameraArrayCaptureOrder::LongestCostFirst;
+	Order = Manager.BuildCaptureOrder();
+	TestTrue(TEXT("没有耗时记录时保持索引顺序"), Order == TArray<int32>({ 0, 1, 2, 3, 4, 5 }));
+
+	// 立体：按位置排序后展开为同一位置的左右两目；相机数为奇数时最后一个位置只有一目
+	Manager.RigPreset = ECameraArrayRigPreset::Stereo;
+	Manager.CaptureOrderMode = ECameraArrayCaptureOrder::CoarseToFine;
+	Scene.SetNumCameras(10);
+	Order = Manager.BuildCaptureOrder();
+	TestTrue(TEXT("立体时同一位置的两目相邻"), Order == TArray<int32>({ 0, 1, 8, 9, 4, 5, 2, 3, 6, 7 }));
+
+	Scene.SetNumCameras(9);
+	Order = Manager.BuildCaptureOrder();
+	TestTrue(TEXT("立体时不产生越界的相机索引"), IsPermutation(Order, 9));
+	return true;
+}
+
+#endif
@@ -0,0 +1,399 @@
+#include "CameraArrayImageEncoder.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Math/RandomStream.h"
+#include "Modules/ModuleManager.h"
+
+namespace
+{
+	// 300像素宽的RGB行约900字节，700行超过两个256KB的条带，覆盖条带之间的预设字典与Adler-32拼接
+	constexpr int32 TestWidth = 300;
+	constexpr int32 TestHeight = 700;
+
+	// 渐变、大块纯色与随机噪点混合，让每种滤波、QOI的每种块都出现
+	TArray<FColor> MakeLdrImage(int32 Width, int32 Height)
+	{
+		FRandomStream Random(1234);
+		TArray<FColor> Pixels;
+		Pixels.SetNumUninitialized(Width * Height);
+		for (int32 Y = 0; Y < Height; ++Y)
+		{
+			for (int32 X = 0; X < Width; ++X)
+			{
+				FColor& Pixel = Pixels[Y * Width + X];
+				if (Y < Height / 3)
+				{
+					Pixel = FColor(static_cast<uint8>(X), static_cast<uint8>(Y), static_cast<uint8>(X + Y), 255);
+				}
+				else if (Y < 2 * Height / 3)
+				{
+					Pixel = X < Width / 2 ? FColor(40, 80, 120, 255) : FColor(static_cast<uint8>(X / 8), 200, static_cast<uint8>(Y / 8), 255);
+				}
+				else
+				{
+					Pixel = FColor(static_cast<uint8>(Random.RandRange(0, 255)), static_cast<uint8>(Random.RandRange(0, 255)),
+						static_cast<uint8>(Random.RandRange(0, 255)), 255);
+				}
+			}
+		}
+		return Pixels;
+	}
+
+	bool DecodeWithImageWrapper(EImageFormat Format, const TArray64<uint8>& Encoded, ERGBFormat RGBFormat, int32 BitDepth,
+		int32& OutWidth, int32& OutHeight, TArray64<uint8>& OutRaw)
+	{
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(Format);
+		if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(Encoded.GetData(), Encoded.Num()) ||
+			!ImageWrapper->GetRaw(RGBFormat, BitDepth, OutRaw))
+		{
+			return false;
+		}
+		OutWidth = static_cast<int32>(ImageWrapper->GetWidth());
+		OutHeight = static_cast<int32>(ImageWrapper->GetHeight());
+		return true;
+	}
+
+	// 引擎没有QOI解码器，按规范解码RGB图像
+	bool DecodeQoi(const TArray64<uint8>& Encoded, int32& OutWidth, int32& OutHeight, TArray<FColor>& OutPixels)
+	{
+		if (Encoded.Num() < 22 || FMemory::Memcmp(Encoded.GetData(), "qoif", 4) != 0)
+		{
+			return false;
+		}
+		auto ReadBigEndian32 = [&Encoded](int64 Offset)
+		{
+			return static_cast<int32>(Encoded[Offset] << 24 | Encoded[Offset + 1] << 16 | Encoded[Offset + 2] << 8 | Encoded[Offset + 3]);
+		};
+		OutWidth = ReadBigEndian32(4);
+		OutHeight = ReadBigEndian32(8);
+		const int64 NumPixels = static_cast<int64>(OutWidth) * OutHeight;
+		OutPixels.Reset(NumPixels);
+
+		FColor Index[64];
+		FMemory::Memzero(Index);
+		FColor Prev(0, 0, 0, 255);
+		int64 Pos = 14;
+		const int64 End = Encoded.Num() - 8;
+		while (OutPixels.Num() < NumPixels && Pos < End)
+		{
+			const uint8 Tag = Encoded[Pos++];
+			if (Tag == 0xFE)
+			{
+				Prev.R = Encoded[Pos];
+				Prev.G = Encoded[Pos + 1];
+				Prev.B = Encoded[Pos + 2];
+				Pos += 3;
+			}
+			else if ((Tag & 0xC0) == 0x00)
+			{
+				Prev = Index[Tag];
+			}
+			else if ((Tag & 0xC0) == 0x40)
+			{
+				Prev.R = static_cast<uint8>(Prev.R + ((Tag >> 4) & 3) - 2);
+				Prev.G = static_cast<uint8>(Prev.G + ((Tag >> 2) & 3) - 2);
+				Prev.B = static_cast<uint8>(Prev.B + (Tag & 3) - 2);
+			}
+			else if ((Tag & 0xC0) == 0x80)
+			{
+				const int32 DG = (Tag & 0x3F) - 32;
+				const uint8 Next = Encoded[Pos++];
+				Prev.R = static_cast<uint8>(Prev.R + DG + ((Next >> 4) & 0x0F) - 8);
+				Prev.G = static_cast<uint8>(Prev.G + DG);
+				Prev.B = static_cast<uint8>(Prev.B + DG + (Next & 0x0F) - 8);
+			}
+			else
+			{
+				const int32 Run = (Tag & 0x3F) + 1;
+				for (int32 i = 0; i < Run; ++i)
+				{
+					OutPixels.Add(Prev);
+				}
+				continue;
+			}
+			Index[(Prev.R * 3 + Prev.G * 5 + Prev.B * 7 + Prev.A * 11) % 64] = Prev;
+			OutPixels.Add(Prev);
+		}
+		return OutPixels.Num() == NumPixels;
+	}
+
+	// 16位输出的测试图像：超出[0, 1]的值会被截断
+	TArray<FLinearColor> MakeLinearImage(int32 Width, int32 Height)
+	{
+		TArray<FLinearColor> Pixels;
+		Pixels.SetNumUninitialized(Width * Height);
+		for (int32 Y = 0; Y < Height; ++Y)
+		{
+			for (int32 X = 0; X < Width; ++X)
+			{
+				Pixels[Y * Width + X] = FLinearColor(X / static_cast<float>(Width - 1), Y / static_cast<float>(Height - 1),
+					(X * 7 + Y * 13) % 101 / 50.0f - 0.5f, 1.0f);
+			}
+		}
+		return Pixels;
+	}
+
+	// 解码后的RGBA 16位样本与按[0, 1]截断量化的原图比较，允许取整方式不同带来的1个单位误差
+	int32 CountMismatchedSamples16(const TArray<FLinearColor>& Expected, const uint16* RgbaSamples)
+	{
+		int32 Mismatched = 0;
+		for (int32 i = 0; i < Expected.Num(); ++i)
+		{
+			const float Channels[3] = { Expected[i].R, Expected[i].G, Expected[i].B };
+			for (int32 Channel = 0; Channel < 3; ++Channel)
+			{
+				const int32 Quantized = FMath::RoundToInt32(FMath::Clamp(Channels[Channel], 0.0f, 1.0f) * 65535.0f);
+				if (FMath::Abs(Quantized - static_cast<int32>(RgbaSamples[i * 4 + Channel])) > 1)
+				{
+					++Mismatched;
+					break;
+				}
+			}
+		}
+		return Mismatched;
+	}
+
+	int32 CountMismatchedPixels(const TArray<FColor>& Expected, const uint8* BgraPixels)
+	{
+		int32 Mismatched = 0;
+		for (int32 i = 0; i < Expected.Num(); ++i)
+		{
+			const uint8* Decoded = BgraPixels + i * 4;
+			if (Decoded[0] != Expected[i].B || Decoded[1] != Expected[i].G || Decoded[2] != Expected[i].R)
+			{
+				++Mismatched;
+			}
+		}
+		return Mismatched;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayPngEncoderTest, "CameraArrayTools.ImageEncoder.PngRoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayPngEncoderTest::RunTest(const FString& Parameters)
+{
+	const TArray<FColor> Pixels = MakeLdrImage(TestWidth, TestHeight);
+
+	const ECameraArrayPngFilter Filters[] = {
+		ECameraArrayPngFilter::None, ECameraArrayPngFilter::Sub, ECameraArrayPngFilter::Up,
+		ECameraArrayPngFilter::Paeth, ECameraArrayPngFilter::Adaptive,
+	};
+	const int32 Levels[] = { 0, 1, 6, 9 };
+	for (const ECameraArrayPngFilter Filter : Filters)
+	{
+		for (const int32 Level : Levels)
+		{
+			FCameraArrayEncodeSettings Settings;
+			Settings.Format = ECameraArrayImageFormat::PNG;
+			Settings.PngFilter = Filter;
+			Settings.PngCompressionLevel = Level;
+			const FString Name = Settings.Describe();
+
+			TArray64<uint8> Encoded;
+			if (!TestTrue(FString::Printf(TEXT("%s 编码成功"), *Name),
+				CameraArrayImageEncoder::EncodeLdr(Settings, Pixels.GetData(), TestWidth, TestHeight, Encoded)))
+			{
+				continue;
+			}
+
+			int32 Width = 0;
+			int32 Height = 0;
+			TArray64<uint8> Raw;
+			if (!TestTrue(FString::Printf(TEXT("%s 可以被引擎的PNG解码器读取"), *Name),
+				DecodeWithImageWrapper(EImageFormat::PNG, Encoded, ERGBFormat::BGRA, 8, Width, Height, Raw)))
+			{
+				continue;
+			}
+			TestEqual(FString::Printf(TEXT("%s 宽度"), *Name), Width, TestWidth);
+			TestEqual(FString::Printf(TEXT("%s 高度"), *Name), Height, TestHeight);
+			if (Raw.Num() == static_cast<int64>(Pixels.Num()) * 4)
+			{
+				TestEqual(FString::Printf(TEXT("%s 解码后像素与原图一致"), *Name), CountMismatchedPixels(Pixels, Raw.GetData()), 0);
+			}
+			else
+			{
+				AddError(FString::Printf(TEXT("%s 解码后的数据大小不符"), *Name));
+			}
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayQoiEncoderTest, "CameraArrayTools.ImageEncoder.QoiRoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayQoiEncoderTest::RunTest(const FString& Parameters)
+{
+	FCameraArrayEncodeSettings Settings;
+	Settings.Format = ECameraArrayImageFormat::QOI;
+
+	// 超过62个像素的纯色段要拆成多个游程块，最后一个像素结束游程
+	TArray<FColor> Pixels = MakeLdrImage(TestWidth, TestHeight);
+	for (int32 i = Pixels.Num() - 200; i < Pixels.Num(); ++i)
+	{
+		Pixels[i] = FColor(10, 20, 30, 255);
+	}
+
+	TArray64<uint8> Encoded;
+	if (!TestTrue(TEXT("QOI编码成功"), CameraArrayImageEncoder::EncodeLdr(Settings, Pixels.GetData(), TestWidth, TestHeight, Encoded)))
+	{
+		return false;
+	}
+	TestTrue(TEXT("编码结果不超过预估的上限"), Encoded.Num() <= CameraArrayImageEncoder::EstimateMaxEncodedBytes(Settings, TestWidth, TestHeight));
+
+	int32 Width = 0;
+	int32 Height = 0;
+	TArray<FColor> Decoded;
+	if (!TestTrue(TEXT("QOI可以按规范解码"), DecodeQoi(Encoded, Width, Height, Decoded)))
+	{
+		return false;
+	}
+	TestEqual(TEXT("宽度"), Width, TestWidth);
+	TestEqual(TEXT("高度"), Height, TestHeight);
+
+	int32 Mismatched = 0;
+	for (int32 i = 0; i < Pixels.Num(); ++i)
+	{
+		if (Decoded[i] != Pixels[i])
+		{
+			++Mismatched;
+		}
+	}
+	TestEqual(TEXT("解码后像素与原图一致"), Mismatched, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArray16BitEncoderTest, "CameraArrayTools.ImageEncoder.Uint16RoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArray16BitEncoderTest::RunTest(const FString& Parameters)
+{
+	const TArray<FLinearColor> Pixels = MakeLinearImage(TestWidth, TestHeight);
+
+	struct FCase
+	{
+		ECameraArrayImageFormat Format;
+		EImageFormat DecoderFormat;
+		int32 Level;
+	};
+	// TIFF压缩级别为0时不压缩也不做水平差分，两种都要检查
+	const FCase Cases[] = {
+		{ ECameraArrayImageFormat::PNG16, EImageFormat::PNG, 0 },
+		{ ECameraArrayImageFormat::PNG16, EImageFormat::PNG, 6 },
+		{ ECameraArrayImageFormat::TIFF, EImageFormat::TIFF, 0 },
+		{ ECameraArrayImageFormat::TIFF, EImageFormat::TIFF, 6 },
+	};
+
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	for (const FCase& Case : Cases)
+	{
+		FCameraArrayEncodeSettings Settings;
+		Settings.Format = Case.Format;
+		Settings.PngFilter = ECameraArrayPngFilter::Adaptive;
+		Settings.PngCompressionLevel = Case.Level;
+		const FString Name = Settings.Describe();
+
+		if (!ImageWrapperModule.CreateImageWrapper(Case.DecoderFormat).IsValid())
+		{
+			AddWarning(FString::Printf(TEXT("当前平台没有 %s 的解码器，跳过。"), *Name));
+			continue;
+		}
+
+		TArray64<uint8> Encoded;
+		if (!TestTrue(FString::Printf(TEXT("%s 编码成功"), *Name),
+			CameraArrayImageEncoder::EncodeHdr(Settings, Pixels.GetData(), TestWidth, TestHeight, Encoded)))
+		{
+			continue;
+		}
+
+		int32 Width = 0;
+		int32 Height = 0;
+		TArray64<uint8> Raw;
+		if (!TestTrue(FString::Printf(TEXT("%s 可以被引擎的解码器读取"), *Name),
+			DecodeWithImageWrapper(Case.DecoderFormat, Encoded, ERGBFormat::RGBA, 16, Width, Height, Raw)))
+		{
+			continue;
+		}
+		TestEqual(FString::Printf(TEXT("%s 宽度"), *Name), Width, TestWidth);
+		TestEqual(FString::Printf(TEXT("%s 高度"), *Name), Height, TestHeight);
+		if (Raw.Num() != static_cast<int64>(Pixels.Num()) * 4 * sizeof(uint16))
+		{
+			AddError(FString::Printf(TEXT("%s 解码后的数据大小不符"), *Name));
+			continue;
+		}
+		TestEqual(FString::Printf(TEXT("%s 解码后的16位样本与量化的原图一致"), *Name),
+			CountMismatchedSamples16(Pixels, reinterpret_cast<const uint16*>(Raw.GetData())), 0);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayExrEncoderTest, "CameraArrayTools.ImageEncoder.ExrRoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayExrEncoderTest::RunTest(const FString& Parameters)
+{
+	// 线性HDR像素，包含大于1的高光
+	TArray<FLinearColor> Pixels;
+	Pixels.SetNumUninitialized(TestWidth * TestHeight);
+	for (int32 Y = 0; Y < TestHeight; ++Y)
+	{
+		for (int32 X = 0; X < TestWidth; ++X)
+		{
+			Pixels[Y * TestWidth + X] = FLinearColor(X / 64.0f, Y / 256.0f, (X + Y) % 17 / 4.0f, 1.0f);
+		}
+	}
+
+	const ECameraArrayExrCodec LosslessCodecs[] = { ECameraArrayExrCodec::None, ECameraArrayExrCodec::ZIP, ECameraArrayExrCodec::PIZ };
+	for (const ECameraArrayExrCodec Codec : LosslessCodecs)
+	{
+		FCameraArrayEncodeSettings Settings;
+		Settings.Format = ECameraArrayImageFormat::EXR;
+		Settings.ExrCodec = Codec;
+		const FString Name = Settings.Describe();
+
+		TArray64<uint8> Encoded;
+		if (!TestTrue(FString::Printf(TEXT("%s 编码成功"), *Name),
+			CameraArrayImageEncoder::EncodeHdr(Settings, Pixels.GetData(), TestWidth, TestHeight, Encoded)))
+		{
+			continue;
+		}
+
+		int32 Width = 0;
+		int32 Height = 0;
+		TArray64<uint8> Raw;
+		if (!TestTrue(FString::Printf(TEXT("%s 可以被引擎的EXR解码器读取"), *Name),
+			DecodeWithImageWrapper(EImageFormat::EXR, Encoded, ERGBFormat::RGBAF, 16, Width, Height, Raw)))
+		{
+			continue;
+		}
+		TestEqual(FString::Printf(TEXT("%s 宽度"), *Name), Width, TestWidth);
+		TestEqual(FString::Printf(TEXT("%s 高度"), *Name), Height, TestHeight);
+		if (Raw.Num() != static_cast<int64>(Pixels.Num()) * sizeof(FFloat16Color))
+		{
+			AddError(FString::Printf(TEXT("%s 解码后的数据大小不符"), *Name));
+			continue;
+		}
+
+		// 无损编码解码后应与半精度量化的结果逐位相同
+		const FFloat16Color* Decoded = reinterpret_cast<const FFloat16Color*>(Raw.GetData());
+		int32 Mismatched = 0;
+		for (int32 i = 0; i < Pixels.Num(); ++i)
+		{
+			const FFloat16Color Expected(Pixels[i]);
+			if (Decoded[i].R.Encoded != Expected.R.Encoded || Decoded[i].G.Encoded != Expected.G.Encoded || Decoded[i].B.Encoded != Expected.B.Encoded)
+			{
+				++Mismatched;
+			}
+		}
+		TestEqual(FString::Printf(TEXT("%s 解码后像素与半精度原图一致"), *Name), Mismatched, 0);
+	}
+	return true;
+}
+
+#endif
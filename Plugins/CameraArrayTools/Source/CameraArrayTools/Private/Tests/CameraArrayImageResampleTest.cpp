@@ -0,0 +1,159 @@
+#include "CameraArrayImageResample.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Math/RandomStream.h"
+
+namespace
+{
+	TArray<FLinearColor> MakeRandomImage(FRandomStream& Random, int32 Width, int32 Height)
+	{
+		TArray<FLinearColor> Pixels;
+		Pixels.SetNumUninitialized(Width * Height);
+		for (FLinearColor& Pixel : Pixels)
+		{
+			Pixel = FLinearColor(Random.FRand(), Random.FRand(), Random.FRand() * 4.0f, 1.0f);
+		}
+		return Pixels;
+	}
+
+	bool IsConstant(const TArray<FLinearColor>& Pixels, const FLinearColor& Value, float Tolerance)
+	{
+		for (const FLinearColor& Pixel : Pixels)
+		{
+			if (!Pixel.Equals(Value, Tolerance))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayBoxDownsampleTest, "CameraArrayTools.ImageResample.BoxDownsample",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayBoxDownsampleTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(7);
+	constexpr int32 SrcWidth = 64;
+	constexpr int32 SrcHeight = 48;
+	const TArray<FLinearColor> Src = MakeRandomImage(Random, SrcWidth, SrcHeight);
+
+	// 整数倍缩小时每个目标像素正好是2x2块的平均值
+	TArray<FLinearColor> Dst;
+	Dst.SetNumUninitialized(SrcWidth / 2 * SrcHeight / 2);
+	CameraArrayImageResample::BoxDownsample(Src.GetData(), SrcWidth, SrcHeight, Dst.GetData(), SrcWidth / 2, SrcHeight / 2);
+	int32 Mismatched = 0;
+	for (int32 Y = 0; Y < SrcHeight / 2; ++Y)
+	{
+		for (int32 X = 0; X < SrcWidth / 2; ++X)
+		{
+			const FLinearColor Expected = (Src[(2 * Y) * SrcWidth + 2 * X] + Src[(2 * Y) * SrcWidth + 2 * X + 1] +
+				Src[(2 * Y + 1) * SrcWidth + 2 * X] + Src[(2 * Y + 1) * SrcWidth + 2 * X + 1]) * 0.25f;
+			if (!Dst[Y * (SrcWidth / 2) + X].Equals(Expected, 1e-5f))
+			{
+				++Mismatched;
+			}
+		}
+	}
+	TestEqual(TEXT("浮点像素：2x2块的平均值"), Mismatched, 0);
+
+	// 8位像素四舍五入到最近的整数
+	TArray<FColor> LdrSrc;
+	for (const FLinearColor& Pixel : Src)
+	{
+		LdrSrc.Add(Pixel.QuantizeRound());
+	}
+	TArray<FColor> LdrDst;
+	LdrDst.SetNumUninitialized(Dst.Num());
+	CameraArrayImageResample::BoxDownsample(LdrSrc.GetData(), SrcWidth, SrcHeight, LdrDst.GetData(), SrcWidth / 2, SrcHeight / 2);
+	Mismatched = 0;
+	for (int32 Y = 0; Y < SrcHeight / 2; ++Y)
+	{
+		for (int32 X = 0; X < SrcWidth / 2; ++X)
+		{
+			const FColor* Block[4] = {
+				&LdrSrc[(2 * Y) * SrcWidth + 2 * X], &LdrSrc[(2 * Y) * SrcWidth + 2 * X + 1],
+				&LdrSrc[(2 * Y + 1) * SrcWidth + 2 * X], &LdrSrc[(2 * Y + 1) * SrcWidth + 2 * X + 1] };
+			const int32 ExpectedR = FMath::RoundToInt32((Block[0]->R + Block[1]->R + Block[2]->R + Block[3]->R) / 4.0f);
+			if (LdrDst[Y * (SrcWidth / 2) + X].R != ExpectedR)
+			{
+				++Mismatched;
+			}
+		}
+	}
+	TestEqual(TEXT("8位像素：2x2块的平均值"), Mismatched, 0);
+
+	// 非整数倍缩小与放大都不改变纯色图像
+	const FLinearColor Flat(0.25f, 0.5f, 2.0f, 1.0f);
+	TArray<FLinearColor> FlatSrc;
+	FlatSrc.Init(Flat, SrcWidth * SrcHeight);
+	const FIntPoint Sizes[] = { FIntPoint(17, 13), FIntPoint(63, 1), FIntPoint(100, 70) };
+	for (const FIntPoint& Size : Sizes)
+	{
+		TArray<FLinearColor> FlatDst;
+		FlatDst.SetNumUninitialized(Size.X * Size.Y);
+		CameraArrayImageResample::BoxDownsample(FlatSrc.GetData(), SrcWidth, SrcHeight, FlatDst.GetData(), Size.X, Size.Y);
+		TestTrue(FString::Printf(TEXT("缩放到 %dx%d 后纯色不变"), Size.X, Size.Y), IsConstant(FlatDst, Flat, 1e-5f));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayLanczosResampleTest, "CameraArrayTools.ImageResample.Lanczos",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayLanczosResampleTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 SrcWidth = 192;
+	constexpr int32 SrcHeight = 108;
+	const FLinearColor Flat(0.25f, 0.5f, 2.0f, 1.0f);
+	TArray<FLinearColor> FlatSrc;
+	FlatSrc.Init(Flat, SrcWidth * SrcHeight);
+
+	// 权重归一化：缩小、放大与不同比例的纯色图像都保持不变，边缘也一样
+	const FIntPoint Sizes[] = { FIntPoint(64, 36), FIntPoint(37, 29), FIntPoint(300, 200), FIntPoint(SrcWidth, SrcHeight) };
+	for (const FIntPoint& Size : Sizes)
+	{
+		CameraArrayImageResample::FLanczosKernel Kernel;
+		Kernel.Build(SrcWidth, SrcHeight, Size.X, Size.Y);
+		TestTrue(FString::Printf(TEXT("%dx%d 的权重表与尺寸匹配"), Size.X, Size.Y), Kernel.Matches(SrcWidth, SrcHeight, Size.X, Size.Y));
+		TestFalse(FString::Printf(TEXT("%dx%d 的权重表不匹配其他尺寸"), Size.X, Size.Y), Kernel.Matches(SrcWidth, SrcHeight, Size.X + 1, Size.Y));
+
+		int32 BadRows = 0;
+		for (int32 DstIndex = 0; DstIndex < Kernel.Horizontal.DstSize; ++DstIndex)
+		{
+			float Total = 0.0f;
+			for (int32 Tap = 0; Tap < Kernel.Horizontal.MaxTaps; ++Tap)
+			{
+				Total += Kernel.Horizontal.Weights[DstIndex * Kernel.Horizontal.MaxTaps + Tap];
+			}
+			BadRows += FMath::IsNearlyEqual(Total, 1.0f, 1e-4f) ? 0 : 1;
+		}
+		TestEqual(FString::Printf(TEXT("%dx%d 的每组权重之和为1"), Size.X, Size.Y), BadRows, 0);
+
+		TArray<FLinearColor> FlatDst;
+		FlatDst.SetNumUninitialized(Size.X * Size.Y);
+		CameraArrayImageResample::LanczosResample(Kernel, FlatSrc.GetData(), FlatDst.GetData());
+		TestTrue(FString::Printf(TEXT("缩放到 %dx%d 后纯色不变"), Size.X, Size.Y), IsConstant(FlatDst, Flat, 1e-4f));
+	}
+
+	// 尺寸不变时为恒等变换
+	FRandomStream Random(11);
+	const TArray<FLinearColor> Src = MakeRandomImage(Random, SrcWidth, SrcHeight);
+	CameraArrayImageResample::FLanczosKernel Identity;
+	Identity.Build(SrcWidth, SrcHeight, SrcWidth, SrcHeight);
+	TArray<FLinearColor> Dst;
+	Dst.SetNumUninitialized(Src.Num());
+	CameraArrayImageResample::LanczosResample(Identity, Src.GetData(), Dst.GetData());
+	int32 Mismatched = 0;
+	for (int32 i = 0; i < Src.Num(); ++i)
+	{
+		Mismatched += Dst[i].Equals(Src[i], 1e-4f) ? 0 : 1;
+	}
+	TestEqual(TEXT("尺寸不变时像素不变"), Mismatched, 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "CameraArrayMemoryBudget.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayMemoryBudgetTest, "CameraArrayTools.MemoryBudget.Accounting",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayMemoryBudgetTest::RunTest(const FString& Parameters)
+{
+	FCameraArrayMemoryBudget Budget(1000);
+	TestTrue(TEXT("第一帧预留"), Budget.TryReserve(600));
+	TestFalse(TEXT("超出预算时推迟"), Budget.TryReserve(600));
+	TestTrue(TEXT("预算以内继续预留"), Budget.TryReserve(300));
+	TestEqual(TEXT("峰值为在途帧之和"), Budget.GetHighWaterBytes(), static_cast<int64>(900));
+
+	// 归还后空出的预算可以再用，峰值不回落
+	Budget.Release(600);
+	TestTrue(TEXT("归还后再次预留"), Budget.TryReserve(600));
+	Budget.Release(600);
+	Budget.Release(300);
+	TestEqual(TEXT("归还后峰值不变"), Budget.GetHighWaterBytes(), static_cast<int64>(900));
+
+	// 没有在途帧时总是放行，单帧超出预算也能渲染
+	TestTrue(TEXT("没有在途帧时放行超出预算的帧"), Budget.TryReserve(5000));
+	TestFalse(TEXT("超出预算的帧在途时推迟其他帧"), Budget.TryReserve(1));
+	Budget.Release(5000);
+	TestEqual(TEXT("峰值记录超出预算的帧"), Budget.GetHighWaterBytes(), static_cast<int64>(5000));
+
+	// 常驻资源计入预算，合并任务中取各阵列的最大值
+	FCameraArrayMemoryBudget WithResident(1000);
+	WithResident.SetResidentBytes(300);
+	WithResident.SetResidentBytes(200);
+	TestTrue(TEXT("常驻资源之外的第一帧"), WithResident.TryReserve(500));
+	TestFalse(TEXT("常驻资源与在途帧一起超出预算"), WithResident.TryReserve(300));
+	TestTrue(TEXT("常驻资源与在途帧之和不超出预算"), WithResident.TryReserve(200));
+	TestEqual(TEXT("峰值包含常驻资源"), WithResident.GetHighWaterBytes(), static_cast<int64>(1000));
+
+	// 预算为0时不限制，只统计峰值
+	FCameraArrayMemoryBudget Unlimited(0);
+	bool bAllReserved = true;
+	for (int32 Frame = 0; Frame < 8; ++Frame)
+	{
+		bAllReserved &= Unlimited.TryReserve(1024ll * 1024 * 1024);
+	}
+	TestTrue(TEXT("不限预算时总是放行"), bAllReserved);
+	TestEqual(TEXT("不限预算时统计峰值"), Unlimited.GetHighWaterBytes(), 8ll * 1024 * 1024 * 1024);
+	TestEqual(TEXT("不限预算"), Unlimited.GetBudgetBytes(), static_cast<int64>(0));
+	return true;
+}
+
+#endif
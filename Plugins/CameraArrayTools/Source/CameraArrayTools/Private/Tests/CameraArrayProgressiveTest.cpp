@@ -0,0 +1,87 @@
+#include "CameraArrayProgressive.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayProgressiveScheduleTest, "CameraArrayTools.Progressive.CumulativeSamples",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayProgressiveScheduleTest::RunTest(const FString& Parameters)
+{
+	// 每一遍翻倍，最后一遍正好达到总采样数
+	const int32 Expected[] = { 8, 16, 32, 64 };
+	for (int32 Pass = 0; Pass < UE_ARRAY_COUNT(Expected); ++Pass)
+	{
+		TestEqual(FString::Printf(TEXT("第 %d 遍结束时的累计采样数"), Pass), CameraArrayProgressive::GetCumulativeSamples(Pass, 4, 64), Expected[Pass]);
+	}
+	TestEqual(TEXT("非2的幂的总采样数在最后一遍达到"), CameraArrayProgressive::GetCumulativeSamples(2, 3, 100), 100);
+	TestEqual(TEXT("只有一遍时直接渲染全部采样"), CameraArrayProgressive::GetCumulativeSamples(0, 1, 37), 37);
+	TestEqual(TEXT("越界的遍数按最后一遍处理"), CameraArrayProgressive::GetCumulativeSamples(9, 4, 64), 64);
+
+	// 总采样数少于遍数时每一遍至少一个采样，且不减少
+	int32 Previous = 0;
+	bool bMonotonic = true;
+	for (int32 Pass = 0; Pass < 6; ++Pass)
+	{
+		const int32 Samples = CameraArrayProgressive::GetCumulativeSamples(Pass, 6, 3);
+		bMonotonic &= Samples >= FMath::Max(Previous, 1);
+		Previous = Samples;
+	}
+	TestTrue(TEXT("采样数少于遍数时累计采样数不减少"), bMonotonic);
+	TestEqual(TEXT("采样数少于遍数时最后一遍等于总采样数"), Previous, 3);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayProgressiveMergeTest, "CameraArrayTools.Progressive.MergeAndStore",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayProgressiveMergeTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::ConvertRelativePathToFull(
+		CameraArrayProgressive::GetStateDirectory(FPaths::AutomationTransientDir() / TEXT("CameraArrayProgressive")));
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	constexpr int32 Width = 4;
+	constexpr int32 Height = 3;
+	constexpr uint64 Key = 0x1234;
+	FCameraArrayProgressiveMerge Merge;
+	Merge.StatePath = Directory / TEXT("Cam_000.state");
+	Merge.StateKey = Key;
+
+	TestEqual(TEXT("没有状态文件时没有采样"), CameraArrayProgressive::ReadStoredSamples(Merge.StatePath, Key, Width, Height), 0);
+
+	// 第一遍：4个采样的均值为1，原样写入状态
+	TArray<FLinearColor> Pixels;
+	Pixels.Init(FLinearColor(1.0f, 1.0f, 1.0f, 1.0f), Width * Height);
+	Merge.PriorSamples = 0;
+	Merge.PassSamples = 4;
+	TestTrue(TEXT("第一遍写入状态"), Merge.MergeAndStore(Pixels.GetData(), Width, Height));
+	TestEqual(TEXT("第一遍后的采样数"), CameraArrayProgressive::ReadStoredSamples(Merge.StatePath, Key, Width, Height), 4);
+	TestTrue(TEXT("第一遍的像素不变"), Pixels[0].Equals(FLinearColor(1.0f, 1.0f, 1.0f, 1.0f)));
+
+	// 第二遍：追加12个均值为3的采样，按采样数加权为 (4 * 1 + 12 * 3) / 16 = 2.5
+	Pixels.Init(FLinearColor(3.0f, 3.0f, 3.0f, 1.0f), Width * Height);
+	Merge.PriorSamples = 4;
+	Merge.PassSamples = 12;
+	TestTrue(TEXT("第二遍写入状态"), Merge.MergeAndStore(Pixels.GetData(), Width, Height));
+	TestEqual(TEXT("第二遍后的累计采样数"), CameraArrayProgressive::ReadStoredSamples(Merge.StatePath, Key, Width, Height), 16);
+	bool bMerged = true;
+	for (const FLinearColor& Pixel : Pixels)
+	{
+		bMerged &= Pixel.Equals(FLinearColor(2.5f, 2.5f, 2.5f, 1.0f), 1e-3f);
+	}
+	TestTrue(TEXT("合并后的像素为加权均值"), bMerged);
+
+	// 状态键或尺寸不一致的状态不能继续累积
+	TestEqual(TEXT("状态键不同时从头累积"), CameraArrayProgressive::ReadStoredSamples(Merge.StatePath, Key + 1, Width, Height), 0);
+	TestEqual(TEXT("尺寸不同时从头累积"), CameraArrayProgressive::ReadStoredSamples(Merge.StatePath, Key, Width * 2, Height), 0);
+	TestFalse(TEXT("原子写入不留下临时文件"), IFileManager::Get().FileExists(*(Merge.StatePath + TEXT(".tmp"))));
+
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+#endif
@@ -0,0 +1,222 @@
+#include "CameraArrayRigImport.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	// 测试用的小型模型写在自动化测试的临时目录中，结束时删除
+	struct FFixtureDirectory
+	{
+		FString Path;
+
+		explicit FFixtureDirectory(const TCHAR* Name)
+			: Path(FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / TEXT("CameraArrayRigImport") / Name))
+		{
+			IFileManager::Get().DeleteDirectory(*Path, false, true);
+			IFileManager::Get().MakeDirectory(*Path, true);
+		}
+
+		~FFixtureDirectory()
+		{
+			IFileManager::Get().DeleteDirectory(*Path, false, true);
+		}
+
+		void WriteText(const TCHAR* FileName, const TCHAR* Content) const
+		{
+			FFileHelper::SaveStringToFile(Content, *(Path / FileName));
+		}
+	};
+
+	// 与下面文本模型相同的两个相机：第一个不旋转，第二个绕Y轴转90°，中心在(5, 0, 0)
+	constexpr double HalfSqrt2 = 0.70710678118654752;
+	const double ColmapQ[2][4] = { { 1.0, 0.0, 0.0, 0.0 }, { HalfSqrt2, 0.0, HalfSqrt2, 0.0 } };
+	const double ColmapT[2][3] = { { 1.0, 2.0, 3.0 }, { 0.0, 0.0, 5.0 } };
+
+	void WriteColmapBinary(const FFixtureDirectory& Directory)
+	{
+		{
+			TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*(Directory.Path / TEXT("cameras.bin"))));
+			uint64 NumCameras = 2;
+			*Writer << NumCameras;
+
+			int32 CameraId = 1;
+			int32 ModelId = 1; // PINHOLE
+			uint64 Width = 640;
+			uint64 Height = 480;
+			double Pinhole[4] = { 500.0, 510.0, 320.0, 240.0 };
+			*Writer << CameraId << ModelId << Width << Height;
+			Writer->Serialize(Pinhole, sizeof(Pinhole));
+
+			CameraId = 2;
+			ModelId = 4; // OPENCV
+			Width = 800;
+			Height = 600;
+			double OpenCv[8] = { 600.0, 600.0, 400.0, 300.0, 0.1, -0.05, 0.001, 0.002 };
+			*Writer << CameraId << ModelId << Width << Height;
+			Writer->Serialize(OpenCv, sizeof(OpenCv));
+		}
+
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*(Directory.Path / TEXT("images.bin"))));
+		uint64 NumImages = 2;
+		*Writer << NumImages;
+		const ANSICHAR* Names[2] = { "cam_a.png", "cam_b.png" };
+		for (int32 Image = 0; Image < 2; ++Image)
+		{
+			int32 ImageId = Image + 1;
+			int32 CameraId = Image + 1;
+			double Q[4];
+			double T[3];
+			FMemory::Memcpy(Q, ColmapQ[Image], sizeof(Q));
+			FMemory::Memcpy(T, ColmapT[Image], sizeof(T));
+			*Writer << ImageId;
+			Writer->Serialize(Q, sizeof(Q));
+			Writer->Serialize(T, sizeof(T));
+			*Writer << CameraId;
+			Writer->Serialize(const_cast<ANSICHAR*>(Names[Image]), FCStringAnsi::Strlen(Names[Image]) + 1);
+
+			// 第一张图像带两个二维点，读取时要整段跳过
+			uint64 NumPoints2D = Image == 0 ? 2 : 0;
+			*Writer << NumPoints2D;
+			for (uint64 Point = 0; Point < NumPoints2D; ++Point)
+			{
+				double XY[2] = { 100.0, 200.0 };
+				int64 Point3DId = -1;
+				Writer->Serialize(XY, sizeof(XY));
+				*Writer << Point3DId;
+			}
+		}
+	}
+
+	void TestColmapCameras(FAutomationTestBase& Test, const TArray<CameraArrayRigImport::FImportedCamera>& Cameras, const TCHAR* Source)
+	{
+		if (!Test.TestEqual(FString::Printf(TEXT("%s：相机数"), Source), Cameras.Num(), 2))
+		{
+			return;
+		}
+
+		const CameraArrayRigImport::FImportedCamera& A = Cameras[0];
+		Test.TestEqual(FString::Printf(TEXT("%s：第一个相机的名称"), Source), A.Name, FString(TEXT("cam_a.png")));
+		Test.TestTrue(FString::Printf(TEXT("%s：第一个相机的中心为 -t"), Source), A.Center.Equals(FVector(-1.0, -2.0, -3.0), 1e-9));
+		Test.TestTrue(FString::Printf(TEXT("%s：第一个相机朝向+Z"), Source), A.Forward.Equals(FVector(0.0, 0.0, 1.0), 1e-9));
+		Test.TestEqual(FString::Printf(TEXT("%s：PINHOLE的fx"), Source), A.Intrinsics.Fx, 500.0);
+		Test.TestEqual(FString::Printf(TEXT("%s：PINHOLE的fy"), Source), A.Intrinsics.Fy, 510.0);
+		Test.TestEqual(FString::Printf(TEXT("%s：PINHOLE的图像宽度"), Source), A.Intrinsics.ImageWidth, 640);
+		Test.TestFalse(FString::Printf(TEXT("%s：PINHOLE没有畸变"), Source), A.Intrinsics.HasDistortion());
+
+		const CameraArrayRigImport::FImportedCamera& B = Cameras[1];
+		Test.TestEqual(FString::Printf(TEXT("%s：第二个相机的名称"), Source), B.Name, FString(TEXT("cam_b.png")));
+		Test.TestTrue(FString::Printf(TEXT("%s：第二个相机的中心"), Source), B.Center.Equals(FVector(5.0, 0.0, 0.0), 1e-6));
+		Test.TestTrue(FString::Printf(TEXT("%s：第二个相机朝向-X"), Source), B.Forward.Equals(FVector(-1.0, 0.0, 0.0), 1e-6));
+		Test.TestTrue(FString::Printf(TEXT("%s：第二个相机的右方向"), Source), B.Right.Equals(FVector(0.0, 0.0, 1.0), 1e-6));
+		Test.TestEqual(FString::Printf(TEXT("%s：OPENCV的cx"), Source), B.Intrinsics.Cx, 400.0);
+		Test.TestEqual(FString::Printf(TEXT("%s：OPENCV的k1"), Source), B.Intrinsics.K1, 0.1);
+		Test.TestEqual(FString::Printf(TEXT("%s：OPENCV的p2"), Source), B.Intrinsics.P2, 0.002);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayRigImportColmapTest, "CameraArrayTools.RigImport.Colmap",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayRigImportColmapTest::RunTest(const FString& Parameters)
+{
+	// 文本模型：第一张图像的二维点行为空行，注释行不占位置
+	FFixtureDirectory Text(TEXT("ColmapText"));
+	Text.WriteText(TEXT("cameras.txt"),
+		TEXT("# Camera list with one line of data per camera:\n")
+		TEXT("1 PINHOLE 640 480 500 510 320 240\n")
+		TEXT("2 OPENCV 800 600 600 600 400 300 0.1 -0.05 0.001 0.002\n"));
+	Text.WriteText(TEXT("images.txt"),
+		TEXT("# Image list with two lines of data per image:\n")
+		TEXT("#   IMAGE_ID, QW, QX, QY, QZ, TX, TY, TZ, CAMERA_ID, NAME\n")
+		TEXT("1 1 0 0 0 1 2 3 1 cam_a.png\n")
+		TEXT("\n")
+		TEXT("2 0.70710678118654752 0 0.70710678118654752 0 0 0 5 2 cam_b.png\n")
+		TEXT("100.0 200.0 -1 150.0 250.0 -1\n"));
+
+	TArray<CameraArrayRigImport::FImportedCamera> Cameras;
+	FString Error;
+	TestTrue(TEXT("读取COLMAP文本模型"), CameraArrayRigImport::Load(Text.Path, Cameras, Error));
+	TestColmapCameras(*this, Cameras, TEXT("文本模型"));
+
+	// 指向模型中的某个文件时读取所在目录
+	TestTrue(TEXT("按images.txt的路径读取"), CameraArrayRigImport::Load(Text.Path / TEXT("images.txt"), Cameras, Error));
+	TestEqual(TEXT("按文件路径读取的相机数"), Cameras.Num(), 2);
+
+	FFixtureDirectory Binary(TEXT("ColmapBinary"));
+	WriteColmapBinary(Binary);
+	TestTrue(TEXT("读取COLMAP二进制模型"), CameraArrayRigImport::Load(Binary.Path, Cameras, Error));
+	TestColmapCameras(*this, Cameras, TEXT("二进制模型"));
+
+	// COLMAP相机朝向+Z，转换到UE后朝向+X且不倾斜；米转为厘米
+	if (Cameras.Num() == 2)
+	{
+		const FTransform Transform = CameraArrayRigImport::ToUnrealTransform(Cameras[0], ECameraArrayImportAxes::YDown, 100.0);
+		TestTrue(TEXT("转换后的位置"), Transform.GetLocation().Equals(FVector(-300.0, -100.0, 200.0), 1e-6));
+		TestTrue(TEXT("转换后的朝向"), Transform.GetRotation().Equals(FQuat::Identity, 1e-6));
+	}
+
+	FFixtureDirectory Empty(TEXT("Empty"));
+	TestFalse(TEXT("没有images文件时读取失败"), CameraArrayRigImport::Load(Empty.Path, Cameras, Error));
+	TestFalse(TEXT("读取失败时给出原因"), Error.IsEmpty());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayRigImportJsonTest, "CameraArrayTools.RigImport.TransformsJson",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayRigImportJsonTest::RunTest(const FString& Parameters)
+{
+	// 顶层只给出水平视角，第二帧单独给出焦距；矩阵为OpenGL约定的相机到世界
+	FFixtureDirectory Directory(TEXT("Json"));
+	Directory.WriteText(TEXT("transforms.json"), TEXT(R"json({
+	"camera_angle_x": 0.6911112070083618,
+	"w": 800,
+	"h": 600,
+	"frames": [
+		{ "file_path": "./train/r_0", "transform_matrix": [[1, 0, 0, 0], [0, 1, 0, 0], [0, 0, 1, 4], [0, 0, 0, 1]] },
+		{ "file_path": "./train/r_1", "fl_x": 700, "transform_matrix": [[0, 0, 1, 4], [0, 1, 0, 0], [-1, 0, 0, 0], [0, 0, 0, 1]] }
+	]
+})json"));
+
+	TArray<CameraArrayRigImport::FImportedCamera> Cameras;
+	FString Error;
+	if (!TestTrue(TEXT("读取transforms.json"), CameraArrayRigImport::Load(Directory.Path / TEXT("transforms.json"), Cameras, Error)) ||
+		!TestEqual(TEXT("相机数"), Cameras.Num(), 2))
+	{
+		return false;
+	}
+
+	const CameraArrayRigImport::FImportedCamera& A = Cameras[0];
+	TestEqual(TEXT("第一帧的名称"), A.Name, FString(TEXT("./train/r_0")));
+	TestTrue(TEXT("第一帧的中心"), A.Center.Equals(FVector(0.0, 0.0, 4.0), 1e-9));
+	TestTrue(TEXT("OpenGL相机朝向-Z"), A.Forward.Equals(FVector(0.0, 0.0, -1.0), 1e-9));
+	TestTrue(TEXT("OpenGL相机的Y轴向上"), A.Down.Equals(FVector(0.0, -1.0, 0.0), 1e-9));
+	const double ExpectedFocal = 0.5 * 800.0 / FMath::Tan(0.5 * 0.6911112070083618);
+	TestTrue(TEXT("按水平视角换算焦距"), FMath::IsNearlyEqual(A.Intrinsics.Fx, ExpectedFocal, 1e-6));
+	TestEqual(TEXT("fy与fx相同"), A.Intrinsics.Fy, A.Intrinsics.Fx);
+	TestEqual(TEXT("顶层的图像高度"), A.Intrinsics.ImageHeight, 600);
+
+	const CameraArrayRigImport::FImportedCamera& B = Cameras[1];
+	TestTrue(TEXT("第二帧的中心"), B.Center.Equals(FVector(4.0, 0.0, 0.0), 1e-9));
+	TestTrue(TEXT("第二帧朝向原点"), B.Forward.Equals(FVector(-1.0, 0.0, 0.0), 1e-9));
+	TestEqual(TEXT("每帧的焦距覆盖顶层"), B.Intrinsics.Fx, 700.0);
+	TestEqual(TEXT("只给出fl_x时fy取相同的值"), B.Intrinsics.Fy, 700.0);
+	TestEqual(TEXT("每帧继承顶层的图像宽度"), B.Intrinsics.ImageWidth, 800);
+
+	// 与COLMAP同样朝向前方的相机转换后也朝向+X
+	const FTransform Transform = CameraArrayRigImport::ToUnrealTransform(A, ECameraArrayImportAxes::YUp, 100.0);
+	TestTrue(TEXT("转换后的位置"), Transform.GetLocation().Equals(FVector(-400.0, 0.0, 0.0), 1e-6));
+	TestTrue(TEXT("转换后的朝向"), Transform.GetRotation().Equals(FQuat::Identity, 1e-6));
+
+	Directory.WriteText(TEXT("broken.json"), TEXT("{ \"w\": 800 }"));
+	TestFalse(TEXT("缺少frames时读取失败"), CameraArrayRigImport::Load(Directory.Path / TEXT("broken.json"), Cameras, Error));
+	TestFalse(TEXT("读取失败时给出原因"), Error.IsEmpty());
+	return true;
+}
+
+#endif
@@ -0,0 +1,180 @@
+#include "CameraArraySpatialIndex.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Math/RandomStream.h"
+
+namespace
+{
+	FCameraArraySpatialEntry MakeRandomEntry(FRandomStream& Random, int32 CameraIndex)
+	{
+		const FVector Location(Random.FRandRange(-5000.0f, 5000.0f), Random.FRandRange(-5000.0f, 5000.0f), Random.FRandRange(0.0f, 2000.0f));
+		const FRotator Rotation(Random.FRandRange(-80.0f, 80.0f), Random.FRandRange(-180.0f, 180.0f), 0.0);
+		return FCameraArraySpatialEntry::Make(CameraIndex, FTransform(Rotation, Location), Random.FRandRange(30.0f, 100.0f),
+			Random.FRandRange(1.0f, 2.0f), Random.FRandRange(500.0f, 3000.0f));
+	}
+
+	FVector RandomPoint(FRandomStream& Random)
+	{
+		return FVector(Random.FRandRange(-6000.0f, 6000.0f), Random.FRandRange(-6000.0f, 6000.0f), Random.FRandRange(-500.0f, 2500.0f));
+	}
+
+	// 暴力搜索的结果，作为索引查询的参照
+	struct FBruteForce
+	{
+		TArray<FCameraArraySpatialEntry> Entries;
+
+		double NearestDistance(const FVector& Point, int32 ExcludeCameraIndex) const
+		{
+			double Best = TNumericLimits<double>::Max();
+			for (const FCameraArraySpatialEntry& Entry : Entries)
+			{
+				if (Entry.CameraIndex != ExcludeCameraIndex)
+				{
+					Best = FMath::Min(Best, FVector::Dist(Entry.Location, Point));
+				}
+			}
+			return Best;
+		}
+
+		TArray<int32> InRadius(const FVector& Point, double Radius) const
+		{
+			TArray<int32> Result;
+			for (const FCameraArraySpatialEntry& Entry : Entries)
+			{
+				if (FVector::DistSquared(Entry.Location, Point) <= Radius * Radius)
+				{
+					Result.Add(Entry.CameraIndex);
+				}
+			}
+			Result.Sort();
+			return Result;
+		}
+
+		TArray<int32> ContainingPoint(const FVector& Point) const
+		{
+			TArray<int32> Result;
+			for (const FCameraArraySpatialEntry& Entry : Entries)
+			{
+				if (Entry.ContainsPoint(Point))
+				{
+					Result.Add(Entry.CameraIndex);
+				}
+			}
+			Result.Sort();
+			return Result;
+		}
+
+		TArray<int32> SeeingBox(const FBox& Box, bool bFullyInside) const
+		{
+			TArray<int32> Result;
+			for (const FCameraArraySpatialEntry& Entry : Entries)
+			{
+				if (Entry.TestBox(Box, bFullyInside))
+				{
+					Result.Add(Entry.CameraIndex);
+				}
+			}
+			Result.Sort();
+			return Result;
+		}
+	};
+
+	void CompareQueries(FAutomationTestBase& Test, const FCameraArraySpatialIndex& Index, const FBruteForce& Reference, FRandomStream& Random, const TCHAR* Stage)
+	{
+		int32 NearestMismatches = 0;
+		int32 RadiusMismatches = 0;
+		int32 RadiusOrderErrors = 0;
+		int32 PointMismatches = 0;
+		int32 BoxMismatches = 0;
+		for (int32 Query = 0; Query < 200; ++Query)
+		{
+			const FVector Point = RandomPoint(Random);
+
+			// 距离相同时可能返回不同的相机，比较距离而不是索引
+			const int32 Exclude = Query % 2 == 0 ? INDEX_NONE : Reference.Entries[Random.RandHelper(Reference.Entries.Num())].CameraIndex;
+			const int32 Nearest = Index.FindNearest(Point, Exclude);
+			const FCameraArraySpatialEntry* NearestEntry = Reference.Entries.FindByPredicate(
+				[Nearest](const FCameraArraySpatialEntry& Entry) { return Entry.CameraIndex == Nearest; });
+			if (!NearestEntry || Nearest == Exclude ||
+				!FMath::IsNearlyEqual(FVector::Dist(NearestEntry->Location, Point), Reference.NearestDistance(Point, Exclude)))
+			{
+				++NearestMismatches;
+			}
+
+			const double Radius = Random.FRandRange(100.0f, 2500.0f);
+			TArray<int32> InRadius;
+			Index.FindInRadius(Point, Radius, InRadius);
+			for (int32 i = 1; i < InRadius.Num(); ++i)
+			{
+				const FCameraArraySpatialEntry* Previous = Reference.Entries.FindByPredicate(
+					[&](const FCameraArraySpatialEntry& Entry) { return Entry.CameraIndex == InRadius[i - 1]; });
+				const FCameraArraySpatialEntry* Current = Reference.Entries.FindByPredicate(
+					[&](const FCameraArraySpatialEntry& Entry) { return Entry.CameraIndex == InRadius[i]; });
+				if (Previous && Current && FVector::Dist(Previous->Location, Point) > FVector::Dist(Current->Location, Point))
+				{
+					++RadiusOrderErrors;
+					break;
+				}
+			}
+			InRadius.Sort();
+			RadiusMismatches += InRadius != Reference.InRadius(Point, Radius) ? 1 : 0;
+
+			TArray<int32> Containing;
+			Index.FindContainingPoint(Point, Containing);
+			PointMismatches += Containing != Reference.ContainingPoint(Point) ? 1 : 0;
+
+			const FBox Box = FBox::BuildAABB(Point, FVector(Random.FRandRange(10.0f, 800.0f)));
+			const bool bFullyInside = Query % 3 == 0;
+			TArray<int32> Seeing;
+			Index.FindSeeingBox(Box, bFullyInside, Seeing);
+			BoxMismatches += Seeing != Reference.SeeingBox(Box, bFullyInside) ? 1 : 0;
+		}
+
+		Test.TestEqual(FString::Printf(TEXT("%s：最近相机与暴力搜索一致"), Stage), NearestMismatches, 0);
+		Test.TestEqual(FString::Printf(TEXT("%s：半径查询与暴力搜索一致"), Stage), RadiusMismatches, 0);
+		Test.TestEqual(FString::Printf(TEXT("%s：半径查询按距离排列"), Stage), RadiusOrderErrors, 0);
+		Test.TestEqual(FString::Printf(TEXT("%s：包含点的视锥与暴力搜索一致"), Stage), PointMismatches, 0);
+		Test.TestEqual(FString::Printf(TEXT("%s：看到包围盒的视锥与暴力搜索一致"), Stage), BoxMismatches, 0);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArraySpatialIndexTest, "CameraArrayTools.SpatialIndex.MatchesBruteForce",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArraySpatialIndexTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(42);
+
+	// 相机索引不连续，检查索引与条目之间的映射
+	FBruteForce Reference;
+	for (int32 i = 0; i < 500; ++i)
+	{
+		Reference.Entries.Add(MakeRandomEntry(Random, i * 3 + 1));
+	}
+
+	FCameraArraySpatialIndex Index;
+	TestEqual(TEXT("空索引找不到最近相机"), Index.FindNearest(FVector::ZeroVector), static_cast<int32>(INDEX_NONE));
+
+	TArray<FCameraArraySpatialEntry> Entries = Reference.Entries;
+	Index.Build(MoveTemp(Entries));
+	TestEqual(TEXT("索引中的相机数"), Index.Num(), Reference.Entries.Num());
+	CompareQueries(*this, Index, Reference, Random, TEXT("构建后"));
+
+	// 移动一部分相机，只更新叶子与祖先的包围盒
+	for (int32 i = 0; i < 100; ++i)
+	{
+		FCameraArraySpatialEntry& Entry = Reference.Entries[Random.RandHelper(Reference.Entries.Num())];
+		Entry = MakeRandomEntry(Random, Entry.CameraIndex);
+		TestTrue(TEXT("更新索引中的相机"), Index.Update(Entry));
+	}
+	TestFalse(TEXT("不在索引中的相机不能更新"), Index.Update(MakeRandomEntry(Random, 2)));
+	CompareQueries(*this, Index, Reference, Random, TEXT("更新后"));
+
+	Index.Reset();
+	TestEqual(TEXT("重置后索引为空"), Index.Num(), 0);
+	return true;
+}
+
+#endif
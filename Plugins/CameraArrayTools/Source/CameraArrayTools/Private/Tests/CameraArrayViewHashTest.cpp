@@ -0,0 +1,153 @@
+#include "CameraArrayViewHash.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Camera/CameraTypes.h"
+#include "Components/PoseableMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+
+namespace
+{
+	// 不加入引擎世界列表的临时场景，测试结束时销毁
+	struct FSyntheticScene
+	{
+		UWorld* World = nullptr;
+
+		FSyntheticScene()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+		}
+
+		~FSyntheticScene()
+		{
+			if (World)
+			{
+				World->DestroyWorld(false);
+			}
+		}
+
+		UStaticMeshComponent* SpawnCube(UStaticMesh* Mesh, const FVector& Location, bool bCastShadow) const
+		{
+			AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator);
+			UStaticMeshComponent* Component = Actor->GetStaticMeshComponent();
+			Component->SetMobility(EComponentMobility::Movable);
+			Component->SetStaticMesh(Mesh);
+			Component->SetCastShadow(bCastShadow);
+			return Component;
+		}
+
+		FCameraArraySceneSnapshot Capture() const
+		{
+			FCameraArraySceneSnapshot Snapshot;
+			Snapshot.Capture(World, TSet<const AActor*>(), false);
+			return Snapshot;
+		}
+	};
+
+	FMinimalViewInfo MakeView(const FRotator& Rotation)
+	{
+		FMinimalViewInfo View;
+		View.Location = FVector::ZeroVector;
+		View.Rotation = Rotation;
+		View.FOV = 60.0f;
+		View.AspectRatio = 1.0f;
+		return View;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCameraArrayViewHashTest, "CameraArrayTools.ViewHash.DetectsSceneChanges",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCameraArrayViewHashTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!TestNotNull(TEXT("引擎立方体网格"), Cube))
+	{
+		return false;
+	}
+
+	FSyntheticScene Scene;
+	const FMinimalViewInfo ViewTowardCube = MakeView(FRotator::ZeroRotator);
+	const FMinimalViewInfo ViewAway = MakeView(FRotator(0.0, 180.0, 0.0));
+
+	// 投射阴影的图元计入全局状态，不投射阴影的只影响能看到它的视角
+	UStaticMeshComponent* ShadowCaster = Scene.SpawnCube(Cube, FVector(0.0, 0.0, -500.0), true);
+	UStaticMeshComponent* LocalCube = Scene.SpawnCube(Cube, FVector(1000.0, 0.0, 0.0), false);
+
+	FCameraArraySceneSnapshot Before = Scene.Capture();
+	TestEqual(TEXT("场景不变时哈希不变"), Scene.Capture().HashView(ViewTowardCube, 0), Before.HashView(ViewTowardCube, 0));
+	TestNotEqual(TEXT("渲染设置计入哈希"), Before.HashView(ViewTowardCube, 1), Before.HashView(ViewTowardCube, 0));
+
+	ShadowCaster->SetWorldLocation(FVector(0.0, 100.0, -500.0));
+	FCameraArraySceneSnapshot After = Scene.Capture();
+	TestNotEqual(TEXT("移动投射阴影的图元改变全局哈希"), After.GlobalStateHash, Before.GlobalStateHash);
+
+	Before = MoveTemp(After);
+	LocalCube->SetMaterial(0, UMaterial::GetDefaultMaterial(MD_Surface));
+	After = Scene.Capture();
+	TestEqual(TEXT("不投射阴影的图元不改变全局哈希"), After.GlobalStateHash, Before.GlobalStateHash);
+	TestNotEqual(TEXT("更换材质改变看到它的视角"), After.HashView(ViewTowardCube, 0), Before.HashView(ViewTowardCube, 0));
+	TestEqual(TEXT("更换材质不影响看不到它的视角"), After.HashView(ViewAway, 0), Before.HashView(ViewAway, 0));
+
+	Before = MoveTemp(After);
+	LocalCube->SetVisibility(false);
+	After = Scene.Capture();
+	TestNotEqual(TEXT("隐藏图元改变看到它的视角"), After.HashView(ViewTowardCube, 0), Before.HashView(ViewTowardCube, 0));
+
+	// 材质参数集合的值属于世界，不改变任何材质
+	UMaterialParameterCollection* Collection = NewObject<UMaterialParameterCollection>(GetTransientPackage());
+	FCollectionScalarParameter ScalarParameter;
+	ScalarParameter.ParameterName = TEXT("Exposure");
+	Collection->ScalarParameters.Add(ScalarParameter);
+	FCollectionVectorParameter VectorParameter;
+	VectorParameter.ParameterName = TEXT("Tint");
+	Collection->VectorParameters.Add(VectorParameter);
+	Scene.World->AddParameterCollectionInstance(Collection, false);
+	UMaterialParameterCollectionInstance* CollectionInstance = Scene.World->GetParameterCollectionInstance(Collection);
+	if (TestNotNull(TEXT("材质参数集合实例"), CollectionInstance))
+	{
+		Before = Scene.Capture();
+		CollectionInstance->SetScalarParameterValue(TEXT("Exposure"), 2.0f);
+		After = Scene.Capture();
+		TestNotEqual(TEXT("修改标量参数改变全局哈希"), After.GlobalStateHash, Before.GlobalStateHash);
+
+		Before = MoveTemp(After);
+		CollectionInstance->SetVectorParameterValue(TEXT("Tint"), FLinearColor::Red);
+		After = Scene.Capture();
+		TestNotEqual(TEXT("修改向量参数改变全局哈希"), After.GlobalStateHash, Before.GlobalStateHash);
+	}
+
+	// 骨骼网格：只改变骨骼姿势，组件变换与资产都不变
+	USkeletalMesh* SkeletalCube = LoadObject<USkeletalMesh>(nullptr, TEXT("/Engine/EngineMeshes/SkeletalCube.SkeletalCube"));
+	if (!SkeletalCube)
+	{
+		AddWarning(TEXT("找不到引擎骨骼网格 SkeletalCube，跳过骨骼姿势的检查。"));
+		return true;
+	}
+
+	AActor* SkeletalActor = Scene.World->SpawnActor<AActor>();
+	UPoseableMeshComponent* Poseable = NewObject<UPoseableMeshComponent>(SkeletalActor);
+	SkeletalActor->SetRootComponent(Poseable);
+	Poseable->SetSkinnedAssetAndUpdate(SkeletalCube);
+	Poseable->RegisterComponent();
+	Poseable->RefreshBoneTransforms();
+
+	Before = Scene.Capture();
+	const FName BoneName = Poseable->GetBoneName(Poseable->GetNumBones() - 1);
+	Poseable->SetBoneLocationByName(BoneName, Poseable->GetBoneLocationByName(BoneName, EBoneSpaces::ComponentSpace) + FVector(0.0, 0.0, 10.0),
+		EBoneSpaces::ComponentSpace);
+	Poseable->RefreshBoneTransforms();
+	After = Scene.Capture();
+	TestNotEqual(TEXT("改变骨骼姿势改变全局哈希"), After.GlobalStateHash, Before.GlobalStateHash);
+	return true;
+}
+
+#endif
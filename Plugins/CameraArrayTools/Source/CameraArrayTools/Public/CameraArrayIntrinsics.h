@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CameraArrayIntrinsics.generated.h"
+
+// 单个相机的标定内参与Brown-Conrady畸变系数，像素单位基于标定时的图像尺寸，渲染时按输出分辨率缩放
+USTRUCT(BlueprintType)
+struct CAMERAARRAYTOOLS_API FCameraArrayIntrinsics
+{
+	GENERATED_BODY()
+
+	// 标定图像尺寸，为0时视为与输出分辨率相同
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics", meta = (DisplayName = "标定宽度"))
+	int32 ImageWidth = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics", meta = (DisplayName = "标定高度"))
+	int32 ImageHeight = 0;
+
+	// 焦距（像素）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics")
+	double Fx = 0.0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics")
+	double Fy = 0.0;
+
+	// 主点（像素，左上角像素中心为0）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics")
+	double Cx = 0.0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics")
+	double Cy = 0.0;
+
+	// 径向畸变
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics")
+	double K1 = 0.0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics")
+	double K2 = 0.0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics")
+	double K3 = 0.0;
+
+	// 切向畸变
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics")
+	double P1 = 0.0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intrinsics")
+	double P2 = 0.0;
+
+	bool IsValid() const { return Fx > 0.0 && Fy > 0.0; }
+
+	bool HasDistortion() const { return K1 != 0.0 || K2 != 0.0 || K3 != 0.0 || P1 != 0.0 || P2 != 0.0; }
+
+	// 缩放到指定输出分辨率后的内参
+	FCameraArrayIntrinsics ScaledTo(int32 Width, int32 Height) const
+	{
+		FCameraArrayIntrinsics Result = *this;
+		const double ScaleX = ImageWidth > 0 ? static_cast<double>(Width) / ImageWidth : 1.0;
+		const double ScaleY = ImageHeight > 0 ? static_cast<double>(Height) / ImageHeight : 1.0;
+		Result.ImageWidth = Width;
+		Result.ImageHeight = Height;
+		Result.Fx *= ScaleX;
+		Result.Fy *= ScaleY;
+		Result.Cx = (Cx + 0.5) * ScaleX - 0.5;
+		Result.Cy = (Cy + 0.5) * ScaleY - 0.5;
+		return Result;
+	}
+
+	// 不考虑畸变时的水平视角（度）
+	float GetHorizontalFOV(int32 Width) const
+	{
+		const double ScaledFx = ImageWidth > 0 ? Fx * Width / ImageWidth : Fx;
+		return static_cast<float>(FMath::RadiansToDegrees(2.0 * FMath::Atan(Width / (2.0 * ScaledFx))));
+	}
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "CameraArrayJobSubsystem.generated.h"
+
+class ACameraArrayManager;
+class FCameraArrayMemoryBudget;
+
+// 世界级的相机阵列任务调度：把多个 ACameraArrayManager 排进同一个队列依次渲染
+// 视口状态只保存/恢复一次，场景捕获组件与RenderTarget在阵列之间复用，
+// 所有阵列的后台编码共用一个待写计数与在途帧内存预算，只在整个任务结束时统一等待与收尾
+UCLASS()
+class CAMERAARRAYTOOLS_API UCameraArrayJobSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Managers为空时渲染场景中的所有相机阵列；返回是否成功开始
+	UFUNCTION(BlueprintCallable, Category = "Camera Array")
+	bool RenderCameraArrays(const TArray<ACameraArrayManager*>& Managers);
+
+	UFUNCTION(BlueprintCallable, Category = "Camera Array")
+	void CancelJob();
+
+	UFUNCTION(BlueprintPure, Category = "Camera Array")
+	bool IsJobRunning() const { return CurrentManagerIndex != INDEX_NONE; }
+
+	// 由管理器在自己的相机遍历提交完毕后调用，立即开始下一个阵列
+	void NotifyManagerFinished(ACameraArrayManager* Manager);
+
+	TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> GetPendingWrites() const { return PendingWrites; }
+
+	// 提供场景捕获组件、RenderTarget并负责保存视口状态的阵列（队列中的第一个）
+	ACameraArrayManager* GetResourceOwner() const;
+
+	virtual void Deinitialize() override;
+
+private:
+	void StartNextManager();
+	void FinishJob();
+	void ResetJob();
+
+	UPROPERTY()
+	TArray<TObjectPtr<ACameraArrayManager>> JobManagers;
+
+	int32 CurrentManagerIndex = INDEX_NONE;
+	bool bSavedViewportState = false;
+	double JobStartTime = 0.0;
+	FTimerHandle FinishTimerHandle;
+	TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> PendingWrites;
+
+	// 预算取自提供资源的阵列
+	TSharedPtr<FCameraArrayMemoryBudget, ESPMode::ThreadSafe> MemoryBudget;
+};
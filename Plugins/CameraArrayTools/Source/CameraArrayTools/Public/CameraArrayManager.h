@@ -1,10 +1,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/FrameTime.h"
 #include "GameFramework/Actor.h"
 #include "Math/Vector.h"
 #include "Math/Rotator.h"
 #include "Engine/EngineTypes.h"
+#include "CameraArrayRenderJournal.h"
+#include "CameraArrayIntrinsics.h"
 
 #if WITH_EDITOR
 #include "Editor/UnrealEdTypes.h"
@@ -13,8 +17,27 @@
 #include "CameraArrayManager.generated.h"
 
 class USceneCaptureComponent2D; // Forward declaration
+class ULineBatchComponent;
 class UTextureRenderTarget2D;
 class APostProcessVolume;
+class ALevelSequenceActor;
+class ACineCameraActor;
+class FCameraArrayContactSheet;
+class UCameraArrayJobSubsystem;
+class FCameraArrayStereoPacker;
+namespace CameraArrayPanorama { struct FEquirectLut; }
+struct FCameraArrayDistortionMap;
+struct FCameraArrayEncodeSettings;
+struct FCameraArrayFrameWriteRequest;
+class FCameraArrayMemoryBudget;
+class FCameraArrayReadbackStaging;
+class FCameraArrayReadinessGate;
+struct FCameraArrayReadinessStats;
+struct FCameraArrayWarmUpStats;
+class FCameraArrayDenoiseStats;
+class FCameraArraySpatialIndex;
+struct FCameraArraySpatialEntry;
+struct FBatchedLine;
 
 UENUM(BlueprintType)
 enum class ECameraArrayImageFormat : uint8
@@ -23,13 +46,99 @@ enum class ECameraArrayImageFormat : uint8
 	JPEG UMETA(DisplayName = "JPEG (8-bit)"),
 	BMP UMETA(DisplayName = "BMP (8-bit)"),
 	TGA UMETA(DisplayName = "TGA (8-bit)"),
+	QOI UMETA(DisplayName = "QOI (8-bit, 快速无损)"),
 
 	// High Bit-Depth Formats
 	EXR UMETA(DisplayName = "EXR (16-bit Float)"),
-	//TIFF UMETA(DisplayName = "TIFF (16-bit)"),
+	PNG16 UMETA(DisplayName = "PNG (16-bit 线性)"),
+	TIFF UMETA(DisplayName = "TIFF (16-bit 线性)"),
 	//HDR UMETA(DisplayName = "HDR (Radiance)")
 };
 
+// PNG逐行预测滤波，压缩前对每行做差分；自适应每行尝试全部五种并取最小
+UENUM(BlueprintType)
+enum class ECameraArrayPngFilter : uint8
+{
+	None UMETA(DisplayName = "无（最快）"),
+	Sub UMETA(DisplayName = "Sub"),
+	Up UMETA(DisplayName = "Up"),
+	Paeth UMETA(DisplayName = "Paeth"),
+	Adaptive UMETA(DisplayName = "逐行自适应（最小）"),
+};
+
+UENUM(BlueprintType)
+enum class ECameraArrayExrCodec : uint8
+{
+	None UMETA(DisplayName = "不压缩"),
+	ZIP UMETA(DisplayName = "ZIP（无损）"),
+	PIZ UMETA(DisplayName = "PIZ（无损，适合噪点多的图像）"),
+	DWAA UMETA(DisplayName = "DWAA（有损，最小）"),
+};
+
+UENUM(BlueprintType)
+enum class ECameraArrayContactSheetFilter : uint8
+{
+	Box UMETA(DisplayName = "盒式（最快）"),
+	Lanczos UMETA(DisplayName = "Lanczos-3（更锐利）"),
+};
+
+UENUM(BlueprintType)
+enum class ECameraArrayCaptureOrder : uint8
+{
+	// 按相机索引 0..N-1
+	Index UMETA(DisplayName = "按索引顺序"),
+
+	// 先每隔8个（首尾优先），再每隔4个、2个……，中途停止时得到均匀分布的视角
+	CoarseToFine UMETA(DisplayName = "由粗到细"),
+
+	// 按渲染日志中上次的耗时从长到短，未知耗时按平均值估计
+	LongestCostFirst UMETA(DisplayName = "耗时最长优先"),
+};
+
+UENUM(BlueprintType)
+enum class ECameraArrayCaptureBackend : uint8
+{
+	// 接管当前编辑器视口，与视口中的画面完全一致
+	HighResScreenshot UMETA(DisplayName = "视口高清截图"),
+
+	// 使用场景捕获组件渲染到RenderTarget，回读后在后台线程编码
+	SceneCapture UMETA(DisplayName = "场景捕获组件"),
+};
+UENUM(BlueprintType)
+enum class ECameraArrayRigPreset : uint8
+{
+	// 每个阵列位置一个相机
+	Mono UMETA(DisplayName = "单目"),
+
+	// 每个阵列位置左右两个相机
+	Stereo UMETA(DisplayName = "立体（左/右）"),
+
+	// 每个阵列位置沿水平方向等距排列多个相机
+	MultiEye UMETA(DisplayName = "多目"),
+};
+
+UENUM(BlueprintType)
+enum class ECameraArrayStereoPacking : uint8
+{
+	Separate UMETA(DisplayName = "分别输出"),
+	SideBySide UMETA(DisplayName = "左右并排"),
+	OverUnder UMETA(DisplayName = "上下排列"),
+};
+
+// 导入相机阵列时源文件的世界坐标系约定，均为右手系
+UENUM(BlueprintType)
+enum class ECameraArrayImportAxes : uint8
+{
+	// COLMAP/OpenCV：Y向下，Z向前
+	YDown UMETA(DisplayName = "Y向下（COLMAP/OpenCV）"),
+
+	// OpenGL/NeRF：Y向上，Z向后
+	YUp UMETA(DisplayName = "Y向上（OpenGL/NeRF）"),
+
+	// Z向上，X向前（Blender等）
+	ZUp UMETA(DisplayName = "Z向上"),
+};
+
 
 UCLASS()
 class CAMERAARRAYTOOLS_API ACameraArrayManager : public AActor
@@ -41,11 +150,14 @@ public:
 
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
 #endif
 
 protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override; // Cleanup
+	virtual void PostRegisterAllComponents() override;
+	virtual void Destroyed() override;
 
 public:
 	virtual void Tick(float DeltaTime) override;
@@ -88,11 +200,11 @@ public:
 
 	// 相机FOV
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Settings", 
-		meta = (DisplayName = "相机FOV", EditCondition = "!bIsRenderingLocked"))
+		meta = (DisplayName = "相机FOV", EditCondition = "!bIsRenderingLocked", AffectsRender, AffectsAccumulation))
 	float CameraFOV = 50.0f;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Others", 
-		meta = (DisplayName = "后处理引用", EditCondition = "!bIsRenderingLocked"))
+		meta = (DisplayName = "后处理引用", EditCondition = "!bIsRenderingLocked", AffectsRender, AffectsAccumulation))
 	TObjectPtr<APostProcessVolume> PostProcessVolumeRef;
 
 	// 是否启用LookAtTarget功能
@@ -104,17 +216,146 @@ public:
 		meta = (DisplayName = "场景目标点", EditCondition = "!bIsRenderingLocked"))
 	TObjectPtr<AActor> LookAtTarget;
 
+	// 相机很多时分帧生成，每帧最多占用这么多毫秒，避免编辑器卡住；整个生成过程是一次撤销
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Others",
+		meta = (DisplayName = "每帧生成预算 (毫秒)", ClampMin = "1", UIMax = "50", EditCondition = "!bIsRenderingLocked"))
+	float SpawnFrameBudgetMs = 8.0f;
+
+	// 空间查询中视锥截止的距离，超过该距离的物体不算被相机看到
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "空间查询",
+		meta = (DisplayName = "视锥查询距离 (米)", ClampMin = "0.01", EditCondition = "!bIsRenderingLocked"))
+	float SpatialQueryDistance = 100.0f;
+
+	// 由管理器的一个线框组件一次绘制所有相机的机身与视锥，并隐藏各相机自带的模型与视锥，相机很多时视口保持流畅
+	// 隐藏后视口中不能直接点选相机，可在大纲视图中选择或使用空间查询
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "相机显示",
+		meta = (DisplayName = "合批绘制相机", EditCondition = "!bIsRenderingLocked"))
+	bool bBatchedCameraDisplay = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "相机显示",
+		meta = (DisplayName = "视锥显示长度 (米)", ClampMin = "0.01", EditCondition = "bBatchedCameraDisplay && !bIsRenderingLocked"))
+	float CameraDisplayLength = 0.3f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "相机显示",
+		meta = (DisplayName = "线框颜色", EditCondition = "bBatchedCameraDisplay && !bIsRenderingLocked"))
+	FLinearColor CameraDisplayColor = FLinearColor(1.0f, 0.45f, 0.05f);
+
+	// 覆盖分析的对象，为空时使用场景目标点；只统计其静态网格组件的表面
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "覆盖分析",
+		meta = (DisplayName = "分析目标", EditCondition = "!bIsRenderingLocked"))
+	TObjectPtr<AActor> CoverageTarget;
+
+	// 在目标表面按面积均匀取的点数，越多结果越细，耗时与点数和相机数成正比
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "覆盖分析",
+		meta = (DisplayName = "采样点数", ClampMin = "100", UIMax = "200000", EditCondition = "!bIsRenderingLocked"))
+	int32 CoverageSampleCount = 20000;
+
+	// 被至少这么多相机看到的点算作覆盖充分（例如重建所需的视角数）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "覆盖分析",
+		meta = (DisplayName = "最少可见相机数", ClampMin = "1", UIMax = "16", EditCondition = "!bIsRenderingLocked"))
+	int32 CoverageMinViews = 3;
+
+	// 视线与表面法线的夹角超过该角度时，即使没有遮挡也不算看到（掠射角下的画面对重建没有帮助）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "覆盖分析",
+		meta = (DisplayName = "最大观察角 (度)", ClampMin = "0", ClampMax = "90", EditCondition = "!bIsRenderingLocked"))
+	float CoverageMaxViewAngle = 75.0f;
+
+	// 每个阵列位置生成的相机组合
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "立体/多目",
+		meta = (DisplayName = "相机组合", EditCondition = "!bIsRenderingLocked"))
+	ECameraArrayRigPreset RigPreset = ECameraArrayRigPreset::Mono;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "立体/多目",
+		meta = (DisplayName = "目数", ClampMin = "2", UIMax = "16", EditCondition = "RigPreset == ECameraArrayRigPreset::MultiEye && !bIsRenderingLocked"))
+	int32 NumEyes = 4;
+
+	// 相邻两目之间的距离
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "立体/多目",
+		meta = (DisplayName = "瞳距 (厘米)", ClampMin = "0", EditCondition = "RigPreset != ECameraArrayRigPreset::Mono && !bIsRenderingLocked"))
+	float InteraxialDistance = 6.5f;
+
+	// 各目内转对准正前方该距离处的汇聚点，0为平行
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "立体/多目",
+		meta = (DisplayName = "汇聚距离 (米)", ClampMin = "0", EditCondition = "RigPreset != ECameraArrayRigPreset::Mono && !bIsRenderingLocked"))
+	float ConvergenceDistance = 0.0f;
+
+	// 打包输出需要场景捕获方式，视口截图时总是分别输出
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "立体/多目",
+		meta = (DisplayName = "输出方式", EditCondition = "RigPreset != ECameraArrayRigPreset::Mono && !bIsRenderingLocked", AffectsRender))
+	ECameraArrayStereoPacking StereoPacking = ECameraArrayStereoPacking::Separate;
+
+	// 每个相机位置捕获6个立方体面并输出一张等距柱状全景图，需要场景捕获方式（启用后自动使用）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "全景360",
+		meta = (DisplayName = "输出360°全景", EditCondition = "!bIsRenderingLocked", AffectsRender))
+	bool bCapturePanorama = false;
+
+	// 全景图宽度，高度为宽度的一半，立方体面边长为宽度的四分之一
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "全景360",
+		meta = (DisplayName = "全景宽度", ClampMin = "64", EditCondition = "bCapturePanorama && !bIsRenderingLocked", AffectsRender))
+	int32 PanoramaWidth = 4096;
+
+	// 按相机索引排列的标定内参，只有一项时用于所有相机；为空时使用统一的相机FOV
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "镜头标定",
+		meta = (DisplayName = "相机内参", EditCondition = "!bIsRenderingLocked", AffectsRender, AffectsAccumulation))
+	TArray<FCameraArrayIntrinsics> CameraIntrinsics;
+
+	// 捕获后按内参中的畸变系数重映射，每帧只多一次重采样；需要场景捕获方式（启用后自动使用）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "镜头标定",
+		meta = (DisplayName = "应用镜头畸变", EditCondition = "!bIsRenderingLocked", AffectsRender))
+	bool bApplyLensDistortion = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "镜头标定",
+		meta = (DisplayName = "标定文件", FilePathFilter = "json", EditCondition = "!bIsRenderingLocked"))
+	FFilePath CalibrationFile;
+
+	// COLMAP模型（cameras/images 的 .bin 或 .txt）或 transforms.json，导入后替换当前相机
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "导入相机",
+		meta = (DisplayName = "相机阵列文件", FilePathFilter = "Rig files (*.txt;*.bin;*.json)|*.txt;*.bin;*.json", EditCondition = "!bIsRenderingLocked"))
+	FFilePath RigImportFile;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "导入相机",
+		meta = (DisplayName = "源坐标系", EditCondition = "!bIsRenderingLocked"))
+	ECameraArrayImportAxes ImportAxes = ECameraArrayImportAxes::YDown;
+
+	// 源文件中一个单位对应的厘米数，COLMAP重建通常需要按实际尺度调整
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "导入相机",
+		meta = (DisplayName = "缩放（厘米/单位）", ClampMin = "0.0001", EditCondition = "!bIsRenderingLocked"))
+	double ImportScale = 100.0;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Settings", 
-		meta = (DisplayName = "输出宽度", EditCondition = "!bIsRenderingLocked"))
+		meta = (DisplayName = "输出宽度", EditCondition = "!bIsRenderingLocked", AffectsRender, AffectsAccumulation))
 	int32 RenderTargetX = 1920;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Settings", 
-		meta = (DisplayName = "输出高度", EditCondition = "!bIsRenderingLocked"))
+		meta = (DisplayName = "输出高度", EditCondition = "!bIsRenderingLocked", AffectsRender, AffectsAccumulation))
 	int32 RenderTargetY = 1080;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Settings", 
-		meta = (DisplayName = "格式", EditCondition = "!bIsRenderingLocked"))
+		meta = (DisplayName = "格式", EditCondition = "!bIsRenderingLocked", AffectsRender))
 	ECameraArrayImageFormat FileFormat = ECameraArrayImageFormat::PNG;
 
+	// 0为只存储不压缩，9为最小文件；每帧按行分块并行压缩，16位TIFF使用同一级别
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "编码",
+		meta = (DisplayName = "PNG/TIFF压缩级别", ClampMin = "0", ClampMax = "9", EditCondition = "(FileFormat == ECameraArrayImageFormat::PNG || FileFormat == ECameraArrayImageFormat::PNG16 || FileFormat == ECameraArrayImageFormat::TIFF) && !bIsRenderingLocked"))
+	int32 PngCompressionLevel = 3;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "编码",
+		meta = (DisplayName = "PNG滤波", EditCondition = "(FileFormat == ECameraArrayImageFormat::PNG || FileFormat == ECameraArrayImageFormat::PNG16) && !bIsRenderingLocked"))
+	ECameraArrayPngFilter PngFilter = ECameraArrayPngFilter::Up;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "编码",
+		meta = (DisplayName = "JPEG质量", ClampMin = "1", ClampMax = "100", EditCondition = "FileFormat == ECameraArrayImageFormat::JPEG && !bIsRenderingLocked", AffectsRender))
+	int32 JpegQuality = 85;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "编码",
+		meta = (DisplayName = "EXR压缩", EditCondition = "FileFormat == ECameraArrayImageFormat::EXR && !bIsRenderingLocked", AffectsRender))
+	ECameraArrayExrCodec ExrCodec = ECameraArrayExrCodec::ZIP;
+
+	// 场景捕获路径同时在途（回读、像素处理、编码中）的帧所占内存上限，包括RenderTarget；0为不限制
+	// 超出时暂停提交新相机，等后台写完已有的帧再继续
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "内存",
+		meta = (DisplayName = "在途帧内存预算 (MB)", ClampMin = "0", EditCondition = "!bIsRenderingLocked"))
+	int32 InFlightMemoryBudgetMB = 8192;
+
 	// 输出路径
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Settings",
 		meta = (DisplayName = "输出路径", Subtype = "DirPath", EditCondition = "!bIsRenderingLocked"))
@@ -128,14 +369,154 @@ public:
 		meta = (DisplayName = "相机前缀", EditCondition = "!bIsRenderingLocked"))
 	FString CameraNamePrefix = TEXT("Camera");
 
+	// 光栅化截图前固定累积的帧数；启用“等待画面就绪”后普通视角改为按就绪检测等待，全景的每个面仍按此累积
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Settings", 
-			meta = (DisplayName = "截图前采样数", EditCondition = "!bIsRenderingLocked"))
+			meta = (DisplayName = "截图前采样数", EditCondition = "!bIsRenderingLocked", AffectsRender))
 	int32 SPPLit = 16;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Settings",
+		meta = (DisplayName = "捕获方式", EditCondition = "!bIsRenderingLocked", AffectsRender))
+	ECameraArrayCaptureBackend CaptureBackend = ECameraArrayCaptureBackend::HighResScreenshot;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Settings",
+		meta = (DisplayName = "渲染顺序", EditCondition = "!bIsRenderingLocked"))
+	ECameraArrayCaptureOrder CaptureOrderMode = ECameraArrayCaptureOrder::Index;
+
+	// 总是用场景捕获组件离屏渲染，不接管编辑器视口；每个编辑器帧只做少量捕获，渲染期间编辑器仍可正常操作
+	// 渲染期间对关卡的修改会出现在之后的相机中
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "后台渲染",
+		meta = (DisplayName = "后台渲染", EditCondition = "!bIsRenderingLocked"))
+	bool bRenderInBackground = false;
+
+	// 数值越大渲染越快，编辑器越卡顿
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "后台渲染",
+		meta = (DisplayName = "每帧捕获次数", ClampMin = "1", EditCondition = "bRenderInBackground && !bIsRenderingLocked"))
+	int32 BackgroundCapturesPerTick = 1;
+
+	// 每次移动相机后等待纹理流送完成、GPU反馈与时域历史稳定再截图，不再固定等待截图前采样数；快速预览不等待
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "就绪检测",
+		meta = (DisplayName = "等待画面就绪", EditCondition = "!bIsRenderingLocked"))
+	bool bWaitForViewReady = true;
+
+	// 启用TAA/TSR或Lumen时至少等待的帧数，其余情况只等待GPU反馈往返的几帧
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "就绪检测",
+		meta = (DisplayName = "时域历史帧数", ClampMin = "1", EditCondition = "bWaitForViewReady && !bIsRenderingLocked"))
+	int32 ReadyHistoryFrames = 8;
+
+	// 超时后不再等待流送，直接截图并在日志中记录
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "就绪检测",
+		meta = (DisplayName = "就绪超时（秒）", ClampMin = "0.1", EditCondition = "bWaitForViewReady && !bIsRenderingLocked"))
+	float ReadyTimeoutSeconds = 5.0f;
+
+	// 正式批量前以极小分辨率把各相机位姿捕获一遍，等着色器与PSO编译完成后再开始，前几个相机不再卡顿或缺失材质
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "着色器预热",
+		meta = (DisplayName = "批量前预热着色器", EditCondition = "!bIsRenderingLocked"))
+	bool bWarmUpShaders = false;
+
+	// 相机很多时均匀抽取部分位姿预热，0为全部
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "着色器预热",
+		meta = (DisplayName = "预热位姿上限", ClampMin = "0", EditCondition = "bWarmUpShaders && !bIsRenderingLocked"))
+	int32 WarmUpMaxPoses = 0;
+
+	// 光栅化时不再依赖实时帧的TAA/TSR：每个相机以亚像素抖动捕获若干次，在GPU浮点缓冲中求平均，画质只由采样数决定
+	// 自动使用场景捕获方式；全景与路径追踪不使用
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "抖动累积",
+		meta = (DisplayName = "抖动累积", EditCondition = "!bIsRenderingLocked", AffectsRender))
+	bool bJitteredAccumulation = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "抖动累积",
+		meta = (DisplayName = "累积采样数", ClampMin = "1", ClampMax = "256", EditCondition = "bJitteredAccumulation && !bIsRenderingLocked", AffectsRender))
+	int32 AccumulationSamples = 16;
+
+	// 按帧范围渲染且指定了关卡序列时，各采样在以当前帧为中心、这么多帧的快门内分布，得到运动模糊；0为不模糊
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "抖动累积",
+		meta = (DisplayName = "运动模糊快门（帧）", ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bJitteredAccumulation && !bIsRenderingLocked", AffectsRender))
+	float AccumulationShutter = 0.0f;
+
+	// 路径追踪时以较低的每像素采样数渲染，在后台线程用Open Image Denoise降噪，降噪与下一个相机的渲染同时进行
+	// 反照率与法线辅助通道由光栅化额外捕获；启用后使用场景捕获方式，并关闭引擎自带的路径追踪降噪；全景不使用，仅Windows
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "降噪",
+		meta = (DisplayName = "路径追踪降噪", EditCondition = "!bIsRenderingLocked", AffectsRender))
+	bool bDenoisePathTracing = false;
+
+	// 路径追踪时先以少量采样渲染所有相机并写出，之后每一遍为每个视角追加采样并整体替换文件，中途停止时所有视角都有可用的结果
+	// 每个视角的累积状态保存在输出目录的.progressive文件夹中，重新开始时从已有的采样继续；使用场景捕获方式，全景与快速预览不使用
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "渐进渲染",
+		meta = (DisplayName = "渐进渲染", EditCondition = "!bIsRenderingLocked", AffectsRender))
+	bool bProgressiveRefinement = false;
+
+	// 每一遍的累计采样数翻倍，最后一遍达到后处理体积中的每像素采样数
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "渐进渲染",
+		meta = (DisplayName = "渐进遍数", ClampMin = "1", ClampMax = "8", EditCondition = "bProgressiveRefinement && !bIsRenderingLocked"))
+	int32 ProgressivePasses = 4;
+
+	// 把场景目标点的包围盒投影到每个相机，只渲染包含它的矩形区域（离轴投影），图像旁写出记录像素偏移的.roi.json
+	// 看不到完整目标的相机渲染整幅画面；使用场景捕获方式，全景、镜头畸变、多目打包与快速预览不使用
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "区域捕获",
+		meta = (DisplayName = "只渲染目标区域", EditCondition = "!bIsRenderingLocked", AffectsRender, AffectsAccumulation))
+	bool bCaptureRegionOfInterest = false;
+
+	// 区域四周各留出区域尺寸的这一比例
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "区域捕获",
+		meta = (DisplayName = "区域边距", ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bCaptureRegionOfInterest && !bIsRenderingLocked", AffectsRender, AffectsAccumulation))
+	float RegionPadding = 0.1f;
+
+	// 预览相对于输出分辨率的缩放比例
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "快速预览",
+		meta = (DisplayName = "预览分辨率比例", ClampMin = "0.05", ClampMax = "1.0", EditCondition = "!bIsRenderingLocked"))
+	float PreviewResolutionScale = 0.25f;
+
+	// 预览时路径追踪每像素采样数
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "快速预览",
+		meta = (DisplayName = "预览采样数", ClampMin = "1", EditCondition = "!bIsRenderingLocked"))
+	int32 PreviewSamplesPerPixel = 1;
+
+	// 批量渲染时在帧写出的同时增量拼出所有视角的联系表（快速预览总是会生成）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "联系表",
+		meta = (DisplayName = "批量时生成联系表", EditCondition = "!bIsRenderingLocked"))
+	bool bBuildContactSheet = false;
+
+	// 联系表中每个视角缩略图的宽度（像素）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "联系表",
+		meta = (DisplayName = "联系表格子宽度", ClampMin = "16", EditCondition = "!bIsRenderingLocked"))
+	int32 ContactSheetTileWidth = 320;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "联系表",
+		meta = (DisplayName = "缩放滤波", EditCondition = "!bIsRenderingLocked"))
+	ECameraArrayContactSheetFilter ContactSheetFilter = ECameraArrayContactSheetFilter::Box;
+
 	/*UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Array Settings",
 		meta = (DisplayName = "路径追踪渲染时间 (秒)", EditCondition = "!bIsRenderingLocked"))
 	float PathTracingRenderTime = 3.0f;*/
 
+	// 按相机计算影响画面的输入哈希（变换、FOV、渲染设置、视锥内的场景状态），与上次的渲染日志一致且文件存在时跳过该相机
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "增量渲染",
+		meta = (DisplayName = "跳过未变化的视角", EditCondition = "!bIsRenderingLocked"))
+	bool bSkipUnchangedViews = false;
+
+	// 按关卡序列的帧范围逐帧渲染整个阵列，输出到 Frame_XXXX/相机文件 的目录结构
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "时间采样",
+		meta = (DisplayName = "按帧范围渲染", EditCondition = "!bIsRenderingLocked"))
+	bool bRenderTimeRange = false;
+
+	// 每个时间步把该序列跳转到对应帧；为空时各帧画面相同
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "时间采样",
+		meta = (DisplayName = "关卡序列", EditCondition = "bRenderTimeRange && !bIsRenderingLocked"))
+	TObjectPtr<ALevelSequenceActor> LevelSequenceActorRef;
+
+	// 帧号使用序列的显示帧率
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "时间采样",
+		meta = (DisplayName = "起始帧", EditCondition = "bRenderTimeRange && !bIsRenderingLocked"))
+	int32 TimeRangeStartFrame = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "时间采样",
+		meta = (DisplayName = "结束帧（包含）", EditCondition = "bRenderTimeRange && !bIsRenderingLocked"))
+	int32 TimeRangeEndFrame = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "时间采样",
+		meta = (DisplayName = "帧间隔", ClampMin = "1", EditCondition = "bRenderTimeRange && !bIsRenderingLocked"))
+	int32 TimeRangeFrameStep = 1;
+
 	UPROPERTY(VisibleAnywhere, Category = "[READONLY]",
 		meta = (DisplayName = "渲染进度", UIMin = "0", UIMax = "100", Delta = "1"))
 	int32 RenderProgress = 0;
@@ -166,6 +547,38 @@ public:
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "执行函数", 
 		meta = (DisplayName = "选择最后一个相机", CallInEditorCondition = "!bIsRenderingLocked"))
 	void SelectLastCamera();
+
+	// 选中视锥能看到场景目标点的相机
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "执行函数",
+		meta = (DisplayName = "选择能看到目标的相机", CallInEditorCondition = "!bIsRenderingLocked"))
+	void SelectCamerasSeeingTarget();
+
+	// 统计目标表面被多少相机看到、每个相机的独有区域与相邻相机的重叠，结果写入日志与输出目录的CSV
+	// 视锥截止于空间查询的视锥查询距离
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "执行函数",
+		meta = (DisplayName = "分析覆盖范围", CallInEditorCondition = "!bIsRenderingLocked"))
+	void AnalyzeCoverage();
+
+	// 空间查询返回相机索引（ManagedCameras的下标）。相机位置与视锥保存在层次包围盒中，
+	// 相机生成、删除或阵列参数变化后在下次查询前重建，编辑器中拖动单个相机时只更新该相机
+	UFUNCTION(BlueprintCallable, Category = "空间查询")
+	int32 FindNearestCamera(const FVector& Location);
+
+	// 按距离从近到远排列
+	UFUNCTION(BlueprintCallable, Category = "空间查询")
+	TArray<int32> FindCamerasInRadius(const FVector& Location, float Radius);
+
+	// 视锥包含该点的相机
+	UFUNCTION(BlueprintCallable, Category = "空间查询")
+	TArray<int32> FindCamerasSeeingPoint(const FVector& Location);
+
+	// 视锥与Actor的包围盒相交的相机；bRequireFullyVisible时包围盒须完全在视锥内
+	UFUNCTION(BlueprintCallable, Category = "空间查询")
+	TArray<int32> FindCamerasSeeingActor(AActor* Actor, bool bRequireFullyVisible = false);
+
+	// 在编辑器中选中这些相机
+	UFUNCTION(BlueprintCallable, Category = "空间查询")
+	void SelectCameras(const TArray<int32>& CameraIndices);
 	
 	// 打开输出文件夹
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "批处理", 
@@ -177,6 +590,38 @@ public:
 		meta = (DisplayName = "为所有相机拍摄高清截图", CallInEditorCondition = "!bIsRenderingLocked"))
 	void TakeHighResScreenshots();
 
+	// 以低分辨率和最少采样数快速渲染所有相机，输出缩略图和一张联系表，不修改当前设置
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "批处理",
+		meta = (DisplayName = "快速预览（低分辨率）", CallInEditorCondition = "!bIsRenderingLocked"))
+	void RenderPreviewPass();
+
+	// 按当前渲染顺序策略返回相机索引序列，可用于把阵列拆分到多台机器
+	UFUNCTION(BlueprintCallable, Category = "批处理")
+	TArray<int32> BuildCaptureOrder() const;
+
+	// 从标定文件读取相机内参并更新相机的FOV
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "镜头标定",
+		meta = (DisplayName = "导入标定内参", CallInEditorCondition = "!bIsRenderingLocked"))
+	void ImportCalibration();
+
+	// 相机的水平视角：有标定内参时由焦距换算，否则为统一的相机FOV
+	UFUNCTION(BlueprintPure, Category = "镜头标定")
+	float GetCameraFOV(int32 CameraIndex) const;
+
+	// 用第一个相机已渲染的图像（没有时用测试图）在后台逐个测试各编码设置，输出耗时与大小
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "编码",
+		meta = (DisplayName = "编码性能测试"))
+	void BenchmarkImageEncoders();
+
+	// 按相机阵列文件中的位姿和内参重建相机，结果相对于本Actor放置
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "导入相机",
+		meta = (DisplayName = "导入相机阵列", CallInEditorCondition = "!bIsRenderingLocked"))
+	void ImportCameraRig();
+
+	// 每个阵列位置的相机数，相机索引 = 位置索引 * 目数 + 目索引
+	UFUNCTION(BlueprintPure, Category = "立体/多目")
+	int32 GetEyesPerPosition() const;
+
 	 // 为第一个相机渲染
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "执行函数", meta = (DisplayName = "为第一个相机拍摄高清截图", CallInEditorCondition = "!bIsRenderingLocked"))
 	void TakeFirstCameraScreenshot();
@@ -185,7 +630,17 @@ public:
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "执行函数", meta = (DisplayName = "为最后一个相机拍摄高清截图", CallInEditorCondition = "!bIsRenderingLocked"))
 	void TakeLastCameraScreenshot();
 	
-	// 强行终止所有截图任务
+	// 清除渲染日志与渐进渲染的累积状态，下次批量渲染时所有相机都会重新渲染
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "增量渲染",
+		meta = (DisplayName = "清除渲染日志", CallInEditorCondition = "!bIsRenderingLocked"))
+	void ClearRenderJournal();
+
+	// 把选中的相机阵列（只选中当前阵列时为场景中的所有阵列）合并成一个任务依次渲染
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "批处理",
+		meta = (DisplayName = "合并渲染多个相机阵列", CallInEditorCondition = "!bIsRenderingLocked"))
+	void RenderCameraArraysAsOneJob();
+
+	// 强行终止所有截图任务，分帧生成相机时停止生成
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "[READONLY]", meta = (DisplayName = "强行终止所有截图任务"))
 	void ForceStopAllTasks();
 
@@ -199,25 +654,62 @@ public:
 	void RenderAllViews();*/
 	
 private:
+	friend class UCameraArrayJobSubsystem;
+
 	UPROPERTY()
 	TArray<TObjectPtr<AActor>> ManagedCameras;
 
 	UPROPERTY()
 	TObjectPtr<USceneCaptureComponent2D> ReusableCaptureComponent;
 
+	// 合批绘制的相机线框，线段不保存，加载后与布局变化时重建
+	UPROPERTY()
+	TObjectPtr<ULineBatchComponent> CameraDisplayComponent;
+
 	UPROPERTY()
 	TObjectPtr<UTextureRenderTarget2D> ReusableLdrRenderTarget; // LDR
 
 	UPROPERTY()
 	TObjectPtr<UTextureRenderTarget2D> ReusableHdrRenderTarget; // HDR
 
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> ReusablePanoramaFaceTarget; // 全景立方体面
+
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> WarmUpRenderTarget; // 着色器预热
+
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> AccumulationTarget; // 抖动累积，32位浮点
+
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> DenoiseAlbedoTarget; // 降噪辅助通道：反照率
+
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> DenoiseNormalTarget; // 降噪辅助通道：法线
+
+	// 异步回读的暂存纹理，在渲染线程上跨帧复用；降噪辅助通道与全景各面也用它，按入队顺序完成
+	TSharedPtr<FCameraArrayReadbackStaging, ESPMode::ThreadSafe> ReadbackStaging;
+
+	// 等距柱状查找表，只在全景尺寸变化时重建，所有相机共用
+	TSharedPtr<const CameraArrayPanorama::FEquirectLut, ESPMode::ThreadSafe> PanoramaLut;
+
 	void InitializeCaptureComponents();
+	FIntPoint GetCaptureResolution() const;
+
+	// 合并任务中没有自己捕获组件的阵列借用第一个阵列的组件，分辨率与格式一致时也借用其RenderTarget，结束时归还
+	void BorrowCaptureResources(ACameraArrayManager* Owner);
+	void ReleaseBorrowedCaptureResources();
+	bool bBorrowedCaptureResources = false;
+
+	// 所属的合并渲染任务，单独渲染时为空
+	TWeakObjectPtr<UCameraArrayJobSubsystem> ActiveJob;
 
 	bool bIsTaskRunning = false;
 	FTransform GetCameraTransform(int32 CameraIndex) const;
 	int32 CurrentRenderIndex;
 	FTimerHandle RenderTimerHandle;
 	bool IsHdrFormat() const;
+	bool IsEngineScreenshotFormat() const;
 
 	/*void PerformSingleCapture();
 	void PerformSingleCaptureForSpecificIndex(int32 IndexToCapture);
@@ -226,12 +718,93 @@ private:
 	void SaveRenderTargetToFileAsync(const FString& FullOutputPath, const FString& FileName, UTextureRenderTarget2D* RenderTargetToSave);*/
 
 	FString GetFileExtension() const;
-	void OrganizeCamerasInFolder();
+	FCameraArrayEncodeSettings MakeEncodeSettings(ECameraArrayImageFormat Format) const;
+	FString GetCameraFileName(int32 CameraIndex) const;
+	FString GetCameraBaseName(int32 CameraIndex) const;
+	const FCameraArrayIntrinsics* FindIntrinsics(int32 CameraIndex) const;
+	ACineCameraActor* SpawnManagedCamera(int32 CameraIndex, const FTransform& CameraTransform);
+	void DestroyManagedCameras();
+
+	// 空间查询的索引
+	TSharedPtr<FCameraArraySpatialIndex> SpatialIndex;
+	bool bSpatialIndexDirty = true;
+	FCameraArraySpatialIndex& GetSpatialIndex();
+	FCameraArraySpatialEntry MakeSpatialEntry(int32 CameraIndex) const;
+
+	// 合批绘制：布局变化时整体重建，编辑器中拖动单个相机时只改写它的线段
+	void RebuildCameraDisplay();
+	void UpdateCameraDisplay(int32 CameraIndex);
+	void WriteCameraDisplayLines(int32 CameraIndex, FBatchedLine* OutLines) const;
+
+	// 编辑器中移动了某个相机时更新空间索引与线框
+	void BindActorMoved();
+	void OnActorMoved(AActor* Actor);
+	FDelegateHandle ActorMovedHandle;
+
+	// 分帧生成：每帧在预算内生成一部分相机，期间按渲染任务锁定属性并更新进度
+	// 清除旧相机与生成新相机在同一个编辑器事务中，完成、终止、EndPlay或ClearAllTimers时结束事务与定时器
+	void BeginCameraSpawn(const TCHAR* Context);
+	void StartTimeSlicedSpawn(TArray<FTransform>&& Transforms);
+	void SpawnNextCameraSlice();
+	void FinishCameraSpawn(bool bCancelled);
+	TArray<FTransform> PendingSpawnTransforms;
+	int32 NextSpawnIndex = 0;
+	double SpawnStartTime = 0.0;
+	const TCHAR* SpawnContext = TEXT("");
+	bool bIsSpawningCameras = false;
+	bool bSpawnTransactionOpen = false;
+	FTimerHandle SpawnTimerHandle;
+
+	// 导入的相机按源图像命名，输出文件与原始照片一一对应；参数化生成相机时清空
+	UPROPERTY()
+	TArray<FString> ImportedCameraNames;
+
+	// 相机内参随相机阵列一起导入时为true，参数化生成相机时一并清空；导入标定文件后内参归标定所有
+	UPROPERTY()
+	bool bIntrinsicsFromRigImport = false;
+	FString GetFullOutputDirectory() const;
+
+	FString GetPreviewDirectory() const;
+
+	// 本次批量的运行状态：是否为预览、是否走场景捕获路径，以及后台尚未写完的帧
+	bool bIsPreviewPass = false;
+	bool bBatchUsesSceneCapture = false;
+	TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> PendingFrameWrites;
+	TSharedPtr<FCameraArrayContactSheet, ESPMode::ThreadSafe> ActiveContactSheet;
+
+	// 在途帧的内存预算，合并任务中所有阵列共用一个；AdmittedFrameBytes是已为当前相机预留、尚未交给写出请求的字节数
+	TSharedPtr<FCameraArrayMemoryBudget, ESPMode::ThreadSafe> ActiveMemoryBudget;
+	int64 AdmittedFrameBytes = 0;
+
+	// 立体/多目打包输出时有效，同一位置的各目写入同一个文件
+	TSharedPtr<FCameraArrayStereoPacker, ESPMode::ThreadSafe> ActiveStereoPacker;
+
+	// 渲染日志与本次批量中每个相机的视角哈希（仅在启用增量渲染时计算）
+	FCameraArrayRenderJournal RenderJournal;
+	TMap<int32, uint64> CurrentViewHashes;
+
+	// 不含渲染设置的视角哈希（变换、FOV与视锥内的场景状态），用于渐进渲染的状态键
+	TMap<int32, uint64> CurrentSceneViewHashes;
+
+	// 本次批量测得的每个文件从开始捕获到写完的耗时，保存日志时写入
+	TSharedPtr<FCameraArrayRenderCosts, ESPMode::ThreadSafe> ActiveRenderCosts;
 
 	int32 CurrentScreenshotIndex;
+
+	// 本次批量的相机渲染顺序，CurrentScreenshotIndex是它的下标
+	TArray<int32> CaptureOrder;
 	FTimerHandle ScreenshotTimerHandle;
 	FTimerHandle PathTracingLogTimerHandle;
 
+	// 按帧范围渲染时本次批量的帧号列表，CurrentTimeSampleIndex为INDEX_NONE表示只渲染当前时刻
+	TArray<int32> TimeSampleFrames;
+	int32 CurrentTimeSampleIndex = INDEX_NONE;
+	bool IsTimeSampling() const { return TimeSampleFrames.IsValidIndex(CurrentTimeSampleIndex); }
+	FString GetTimeSampleDirectoryName() const;
+
+	// 渲染日志中的条目名，按帧范围渲染时带上帧目录
+	FString GetJournalKey(int32 CameraIndex) const;
+
 #if WITH_EDITOR
 	// 添加保存视口原始状态的变量
 	FViewportState OriginalViewportState;
@@ -242,8 +815,136 @@ private:
 	float GetPathTracingProgress(int32& CurrentSPP, int32& TotalSPP);
 	void LogPathTracingProgress();
 	void TakeSingleHighResScreenshot(int32 CameraIndex);
+
+	// 单张截图的文件全部写出后结束任务并打开输出文件夹
+	void FinishSingleScreenshot();
+
 	void ExecuteScreenshotForCamera(int32 CameraIndex, TFunction<void()> OnComplete);
+	void ExecuteViewportScreenshotForCamera(int32 CameraIndex, const FString& FullFilePath, TFunction<void()> OnComplete);
 	void TakeNextHighResScreenshot_Recursive();
+
+	// 批量流程的开始与收尾，正式批量和快速预览共用同一套相机遍历
+	void StartBatchCapture(bool bPreview);
+	void FinishBatchCapture();
+	void FinalizeBatchOutputs();
+
+	// 联系表：按帧范围渲染时每个时间步一张，切换时间步后旧表在其帧全部写出后保存
+	void CreateContactSheet();
+	FString GetContactSheetPath() const;
+	void RetireContactSheet();
+	void SaveRetiredContactSheets();
+
+	struct FRetiredContactSheet
+	{
+		TSharedPtr<FCameraArrayContactSheet, ESPMode::ThreadSafe> Sheet;
+		TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> PendingWrites;
+		FString FilePath;
+	};
+	TArray<FRetiredContactSheet> RetiredContactSheets;
+	FTimerHandle ContactSheetTimerHandle;
+	void EndCaptureTask();
+	FString GetCameraOutputFilePath(int32 CameraIndex) const;
+
+	// 场景捕获路径：渲染到RenderTarget，在渲染线程回读后交给后台线程编码
+	void PrepareSceneCapture();
+	int32 GetSceneCaptureSampleCount() const;
+	void ExecuteSceneCaptureForCamera(int32 CameraIndex, const FString& FullFilePath, TFunction<void()> OnComplete);
+	void QueueContactSheetFromFile(int32 CameraIndex, const FString& FullFilePath, bool bWaitForNewFile, const FDateTime& PreviousTimeStamp);
+	void PollContactSheetFile(TSharedPtr<FCameraArrayContactSheet, ESPMode::ThreadSafe> ContactSheet, TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> PendingWrites,
+		int32 CameraIndex, const FString& FilePath, const FDateTime& PreviousTimeStamp, int64 LastSize, double Deadline);
+	static void LoadContactSheetFrameAsync(TSharedPtr<FCameraArrayContactSheet, ESPMode::ThreadSafe> ContactSheet, TSharedPtr<FThreadSafeCounter, ESPMode::ThreadSafe> PendingWrites,
+		int32 CameraIndex, const FString& FilePath);
+
+	// 内存预算：按分辨率与输出格式估算每帧的在途内存，预算不足时推迟捕获直到后台写出腾出空间
+	TSharedRef<FCameraArrayMemoryBudget, ESPMode::ThreadSafe> CreateFrameMemoryBudget() const;
+	int64 EstimateResidentBytes() const;
+	int64 EstimateInFlightFrameBytes() const;
+	void AdmitAndCaptureForCamera(int32 CameraIndex, const FString& FullFilePath, TFunction<void()> OnComplete, double WaitStartTime);
+	void AttachFrameReservation(FCameraArrayFrameWriteRequest& Request);
+	void AttachRenderCost(FCameraArrayFrameWriteRequest& Request, int32 CameraIndex, double CaptureStartTime) const;
+	void ReleaseFrameReservation();
+
+	// 立体/多目打包：某一目失败时放弃该位置，任务结束时报告并丢弃未到齐的位置
+	void FailStereoEye(int32 CameraIndex);
+	void DiscardIncompleteStereoPairs();
+
+	// 依次执行捕获步骤；后台渲染时每个编辑器帧只执行BackgroundCapturesPerTick步，全部完成后调用OnDone
+	bool UsesSceneCapture(bool bPreview) const;
+	void RunCaptureSteps(int32 FirstStep, int32 NumSteps, TFunction<void(int32)> Step, TFunction<void()> OnDone);
+
+	// 就绪检测：移动相机后每个编辑器帧检查一次，等待期间执行OnWaitFrame（场景捕获用来预热），就绪或超时后调用OnReady
+	bool ShouldWaitForViewReady() const { return bWaitForViewReady && !bIsPreviewPass; }
+	void WaitForViewReady(const FVector& ViewOrigin, float FOVDegrees, int32 ViewWidth, bool bNeedsHistory, TFunction<void()> OnWaitFrame, TFunction<void()> OnReady);
+	void PollViewReady(TSharedRef<FCameraArrayReadinessGate> Gate, TFunction<void()> OnWaitFrame, TFunction<void()> OnReady);
+	TSharedPtr<FCameraArrayReadinessStats> ActiveReadinessStats;
+
+	// 着色器预热：逐轮捕获所有预热位姿，每轮结束后等待编译完成；某一轮没有触发编译或达到轮数上限时调用OnDone
+	void StartWarmUpPass(TFunction<void()> OnDone);
+	void RunWarmUpRound(int32 Round, TFunction<void()> OnDone);
+	void WaitForWarmUpCompilation(int32 Round, bool bCompiledThisRound, uint64 WaitStartFrame, double WaitStartTime, TFunction<void()> OnDone);
+	TArray<int32> WarmUpPoses;
+	TSharedPtr<FCameraArrayWarmUpStats> ActiveWarmUpStats;
+
+	// 全景：准备立方体面RenderTarget与查找表，逐面捕获后在后台线程重投影
+	void PrepareSceneCapturePanorama();
+	void ExecutePanoramaCaptureForCamera(int32 CameraIndex, const FString& FullFilePath, TFunction<void()> OnComplete);
+	bool bBatchUsesPanorama = false;
+
+	// 镜头畸变：批量开始时为每个相机找到或生成重映射表，内参相同的相机共用，表在批量之间保留
+	void PrepareLensDistortion();
+	float GetCaptureFOV(int32 CameraIndex) const;
+	bool bBatchUsesLensDistortion = false;
+
+	// 抖动累积：准备浮点累积缓冲，按采样设置抖动投影与快门时间，最后把平均值写回半精度RenderTarget
+	void PrepareAccumulation();
+	void CaptureAccumulationSample(int32 SampleIndex, int32 NumSamples);
+	void SetSequenceFrameOffset(double FrameOffset);
+	bool bBatchUsesAccumulation = false;
+
+	// 路径追踪降噪：准备辅助通道RenderTarget，每个相机渲染完后以光栅化捕获反照率与法线，与渲染图像一起回读
+	void PrepareDenoiser();
+	void CaptureDenoiseAovs();
+	bool bBatchUsesDenoiser = false;
+	TSharedPtr<FCameraArrayDenoiseStats, ESPMode::ThreadSafe> ActiveDenoiseStats;
+
+	// 渐进渲染：每一遍遍历所有相机，遍与遍之间等待后台写完，下一遍读到的总是最新的累积状态
+	// ProgressivePriorSamples与ProgressivePassSamples是当前相机已有的与这一遍追加的采样数
+	void PrepareProgressive();
+	bool PrepareProgressiveCamera(int32 CameraIndex, const FString& FullFilePath);
+	void StartNextProgressivePass();
+	FString GetProgressiveStatePath(int32 CameraIndex) const;
+	uint64 GetProgressiveStateKey(int32 CameraIndex) const;
+	bool bBatchUsesProgressive = false;
+	int32 CurrentProgressivePass = 0;
+	int32 ProgressivePriorSamples = 0;
+	int32 ProgressivePassSamples = 0;
+	uint64 ProgressiveSettingsHash = 0;
+
+	// 区域捕获：每个相机捕获前按目标的包围盒算出区域，把RenderTarget调整到区域大小并设置离轴投影
+	// CurrentCaptureRect是当前相机的区域，在回读时写入写出请求
+	FIntRect GetCaptureRect(int32 CameraIndex) const;
+	void ResizeSceneCaptureTargets(const FIntPoint& Size);
+	bool bBatchUsesRegion = false;
+	FIntRect CurrentCaptureRect;
+	TArray<TSharedPtr<const FCameraArrayDistortionMap, ESPMode::ThreadSafe>> CameraDistortionMaps;
+	TMap<uint64, TSharedPtr<const FCameraArrayDistortionMap, ESPMode::ThreadSafe>> DistortionMapCache;
+	void ReadbackAndSaveAsync(UTextureRenderTarget2D* RenderTarget, int32 CameraIndex, const FString& FullFilePath, ECameraArrayImageFormat Format, double CaptureStartTime);
+
+	// 增量渲染：批量开始时计算哈希，截图前判断是否跳过，完成后写入日志
+	void PrepareRenderJournal(bool bIsPathTracing);
+	void ComputeViewHashes();
+	bool bBatchIsPathTracing = false;
+	// 带有MetaTag标记的设置的哈希：增量渲染用 meta=(AffectsRender)，渐进渲染的状态键用 meta=(AffectsAccumulation)
+	uint64 ComputeRenderSettingsHash(bool bIsPathTracing, const TCHAR* MetaTag) const;
+	bool ShouldSkipUnchangedView(int32 CameraIndex, const FString& FullFilePath) const;
+	void RecordRenderedView(int32 CameraIndex);
+	void SaveRenderJournal();
+
+	// 时间采样：每个时间步只跳转一次序列，该时刻的所有相机共用同一份场景状态
+	void ApplyTimeSample(int32 SampleIndex);
+	void RestoreSequencePosition();
+	FFrameTime OriginalSequenceTime;
+	bool bHasOriginalSequenceTime = false;
 	
 	// 添加清理定时器的函数
 	void ClearAllTimers();
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 渲染日志：记录每个输出文件上一次渲染时的视角哈希与耗时
+// 增量渲染用哈希判断视角是否变化，排序策略用耗时估算相机成本
+class CAMERAARRAYTOOLS_API FCameraArrayRenderJournal
+{
+public:
+	struct FEntry
+	{
+		uint64 ViewHash = 0;
+		double RenderSeconds = 0.0;
+	};
+
+	static FString GetJournalFilePath(const FString& OutputDirectory);
+
+	// 从输出目录读取日志，文件不存在时返回false并保持为空
+	bool Load(const FString& OutputDirectory);
+	bool Save(const FString& OutputDirectory) const;
+
+	const FEntry* Find(const FString& FileName) const { return Entries.Find(FileName); }
+
+	// 渲染时记录视角哈希，耗时保留上一次的值，直到写完后由FCameraArrayRenderCosts更新
+	void Record(const FString& FileName, uint64 ViewHash);
+	void SetRenderSeconds(const FString& FileName, double RenderSeconds);
+	void Empty() { Entries.Empty(); }
+	int32 Num() const { return Entries.Num(); }
+
+private:
+	TMap<FString, FEntry> Entries;
+};
+
+// 一次批量中每个输出文件从开始捕获到写完的耗时，用于“耗时最长优先”的排序
+// 场景捕获路径由后台线程在写出结束时记录；视口截图的文件由引擎写出，按文件的修改时间计算
+class CAMERAARRAYTOOLS_API FCameraArrayRenderCosts
+{
+public:
+	// 可在任意线程调用；同一文件多次写出（渐进渲染的各遍）时累加
+	void Add(const FString& FileName, double Seconds);
+
+	void AddEngineWrittenFile(const FString& FileName, const FString& FilePath, const FDateTime& StartTimeUtc);
+
+	// 把测得的耗时写入日志并清空，尚未写出的文件不计入
+	void ApplyTo(FCameraArrayRenderJournal& Journal);
+
+private:
+	struct FEngineWrittenFile
+	{
+		FString FileName;
+		FString FilePath;
+		FDateTime StartTimeUtc;
+	};
+
+	FCriticalSection Mutex;
+	TMap<FString, double> MeasuredSeconds;
+	TArray<FEngineWrittenFile> EngineWrittenFiles;
+};
@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// OpenEXR通过异常报告错误，只在这个模块中启用异常；对外接口不抛出异常
+public class CameraArrayToolsExr : ModuleRules
+{
+	public CameraArrayToolsExr(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new[]
+			{
+				"Core"
+			}
+		);
+
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "UEOpenExr");
+		bEnableExceptions = true;
+	}
+}
@@ -0,0 +1,96 @@
+#include "CameraArrayExrEncoder.h"
+#include "Misc/ScopeLock.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "OpenEXR/ImfIO.h"
+#include "OpenEXR/ImfHeader.h"
+#include "OpenEXR/ImfRgbaFile.h"
+#include "OpenEXR/ImfThreading.h"
+THIRD_PARTY_INCLUDES_END
+
+// 两者都是按RGBA排列的四个半精度浮点数，像素可以直接交给OpenEXR
+static_assert(sizeof(FFloat16Color) == sizeof(Imf::Rgba), "FFloat16Color与Imf::Rgba的布局必须一致");
+
+namespace CameraArrayExr
+{
+	class FExrMemoryStream : public Imf::OStream
+	{
+	public:
+		explicit FExrMemoryStream(TArray64<uint8>& InData)
+			: Imf::OStream("CameraArrayExr")
+			, Data(InData)
+		{
+		}
+
+		virtual void write(const char Bytes[], int Count) override
+		{
+			const int64 End = Position + Count;
+			if (End > Data.Num())
+			{
+				Data.SetNumUninitialized(End, false);
+			}
+			FMemory::Memcpy(Data.GetData() + Position, Bytes, Count);
+			Position = End;
+		}
+
+		virtual uint64_t tellp() override
+		{
+			return Position;
+		}
+
+		virtual void seekp(uint64_t InPosition) override
+		{
+			Position = static_cast<int64>(InPosition);
+		}
+
+	private:
+		TArray64<uint8>& Data;
+		int64 Position = 0;
+	};
+
+	static Imf::Compression ToExrCompression(ECompression Compression)
+	{
+		switch (Compression)
+		{
+		case ECompression::None: return Imf::NO_COMPRESSION;
+		case ECompression::Piz:  return Imf::PIZ_COMPRESSION;
+		case ECompression::Dwaa: return Imf::DWAA_COMPRESSION;
+		case ECompression::Zip:
+		default:                 return Imf::ZIP_COMPRESSION;
+		}
+	}
+
+	bool EncodeRgbaHalf(const FFloat16Color* Pixels, int32 Width, int32 Height, ECompression Compression, TArray64<uint8>& OutData)
+	{
+		static FCriticalSection ThreadPoolMutex;
+		{
+			FScopeLock Lock(&ThreadPoolMutex);
+			if (Imf::globalThreadCount() == 0)
+			{
+				Imf::setGlobalThreadCount(FMath::Clamp(FPlatformMisc::NumberOfCores(), 1, 16));
+			}
+		}
+
+		OutData.Reset(static_cast<int64>(Width) * Height * sizeof(Imf::Rgba) / 2);
+		try
+		{
+			FExrMemoryStream Stream(OutData);
+			Imf::Header Header(Width, Height);
+			Header.compression() = ToExrCompression(Compression);
+			Imf::RgbaOutputFile File(Stream, Header, Imf::WRITE_RGBA, Imf::globalThreadCount());
+			File.setFrameBuffer(reinterpret_cast<const Imf::Rgba*>(Pixels), 1, Width);
+			File.writePixels(Height);
+		}
+		catch (const std::exception& Exception)
+		{
+			UE_LOG(LogTemp, Error, TEXT("EXR编码失败: %s"), UTF8_TO_TCHAR(Exception.what()));
+			return false;
+		}
+		catch (...)
+		{
+			UE_LOG(LogTemp, Error, TEXT("EXR编码失败: 未知错误"));
+			return false;
+		}
+		return true;
+	}
+}
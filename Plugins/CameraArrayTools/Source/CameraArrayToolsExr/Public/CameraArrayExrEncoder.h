@@ -0,0 +1,18 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// EXR编码：直接使用OpenEXR以选择压缩方式，并使用OpenEXR的线程池按扫描线块并行压缩
+namespace CameraArrayExr
+{
+	enum class ECompression : uint8
+	{
+		None,
+		Zip,
+		Piz,
+		Dwaa
+	};
+
+	// 半精度RGBA像素编码为EXR文件数据；OpenEXR的异常在模块内部捕获，失败时记录日志并返回false
+	CAMERAARRAYTOOLSEXR_API bool EncodeRgbaHalf(const FFloat16Color* Pixels, int32 Width, int32 Height, ECompression Compression, TArray64<uint8>& OutData);
+}